@@ -9,17 +9,76 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb/stb_image_write.h>
 
+#include <charconv>
+#include <string_view>
+
+#include <fmt/format.h>
+
 #include "engine/core/engine.h"
 
+static void printUsage()
+{
+    fmt::print("Usage: WillEngineV2 [--headless] [--frames N] [--warmup N] [--width W] [--height H] [--camera-path path.json] "
+        "[--output result.json] [--trace trace.json]\n");
+}
+
+static bool parseNumber(const std::string_view text, uint32_t& out)
+{
+    return std::from_chars(text.data(), text.data() + text.size(), out).ec == std::errc{};
+}
+
+/**
+ * Runs the engine in a window, or with \code --headless\endcode renders a fixed number of frames offscreen and reports frame timings.
+ * \n Returns 1 if the arguments are invalid or the headless results could not be written.
+ */
 int main(int argc, char* argv[])
 {
+    will_engine::HeadlessSettings headless{};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--headless") {
+            headless.bEnabled = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            fmt::print("Missing value for {}\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const std::string_view value = argv[++i];
+        bool bValid = true;
+        if (arg == "--frames") { bValid = parseNumber(value, headless.frameCount) && headless.frameCount > 0; }
+        else if (arg == "--warmup") { bValid = parseNumber(value, headless.warmupFrames); }
+        else if (arg == "--width") { bValid = parseNumber(value, headless.extent.width) && headless.extent.width > 0; }
+        else if (arg == "--height") { bValid = parseNumber(value, headless.extent.height) && headless.extent.height > 0; }
+        else if (arg == "--camera-path") { headless.cameraPath = value; }
+        else if (arg == "--output") { headless.outputPath = value; }
+        else if (arg == "--trace") { headless.tracePath = value; }
+        else { bValid = false; }
+
+        if (!bValid) {
+            fmt::print("Invalid argument {} {}\n", arg, value);
+            printUsage();
+            return 1;
+        }
+    }
+
     will_engine::Engine engine;
 
-    engine.init();
+    engine.init(headless);
 
-    engine.run();
+    bool bSuccess = true;
+    if (headless.bEnabled) {
+        bSuccess = engine.runHeadless();
+    }
+    else {
+        engine.run();
+    }
 
     engine.cleanup();
 
-    return 0;
+    return bSuccess ? 0 : 1;
 }
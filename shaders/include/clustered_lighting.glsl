@@ -0,0 +1,114 @@
+#ifndef CLUSTERED_LIGHTING_GLSL
+#define CLUSTERED_LIGHTING_GLSL
+
+#include "pbr.glsl"
+
+// Requires GL_EXT_buffer_reference
+
+// Must match MAX_LIGHTS_PER_CLUSTER in light_culling_pipeline_types.h
+const uint MAX_LIGHTS_PER_CLUSTER = 128;
+const uint CLUSTER_STRIDE = MAX_LIGHTS_PER_CLUSTER + 1;
+
+const uint LOCAL_LIGHT_POINT = 0;
+const uint LOCAL_LIGHT_SPOT = 1;
+
+// View space, see LocalLightData
+struct LocalLight {
+    vec3 position;
+    float range;
+    vec3 color;
+    float intensity;
+    vec3 direction;
+    float spotCosOuter;
+    float spotCosInner;
+    uint type;
+    vec2 pad;
+};
+
+layout (buffer_reference, std430) readonly buffer LocalLightBuffer {
+    LocalLight lights[];
+};
+
+// Per cluster, a light count followed by MAX_LIGHTS_PER_CLUSTER light indices
+layout (buffer_reference, std430) buffer ClusterLightBuffer {
+    uint data[];
+};
+
+struct ClusteredLighting {
+    LocalLightBuffer lightBuffer;
+    ClusterLightBuffer clusterBuffer;
+    ivec4 gridSize;// w is the light count
+    float depthSliceScale;
+    float depthSliceBias;
+    float nearPlane;
+    float farPlane;
+};
+
+/**
+ * Screen uv + positive view depth to the cluster that covers it
+ */
+uint getClusterIndex(ClusteredLighting clusters, vec2 uv, float viewDepth) {
+    ivec2 tile = clamp(ivec2(uv * vec2(clusters.gridSize.xy)), ivec2(0), clusters.gridSize.xy - 1);
+    int slice = int(floor(log(max(viewDepth, clusters.nearPlane)) * clusters.depthSliceScale + clusters.depthSliceBias));
+    slice = clamp(slice, 0, clusters.gridSize.z - 1);
+    return uint(tile.x + tile.y * clusters.gridSize.x + slice * clusters.gridSize.x * clusters.gridSize.y);
+}
+
+/**
+ * Inverse square falloff windowed to reach exactly 0 at the light's range
+ */
+float getLocalLightAttenuation(float distanceSquared, float range) {
+    float ratio = distanceSquared / (range * range);
+    float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+    return window * window / max(distanceSquared, 0.0001);
+}
+
+vec3 evaluateLocalLight(LocalLight light, vec3 viewPosition, vec3 N, vec3 V, vec3 albedo, float roughness, float metallic, vec3 F0) {
+    vec3 toLight = light.position - viewPosition;
+    float distanceSquared = dot(toLight, toLight);
+    if (distanceSquared >= light.range * light.range) {
+        return vec3(0.0);
+    }
+
+    vec3 L = toLight * inversesqrt(max(distanceSquared, 0.0001));
+    float nDotL = max(dot(N, L), 0.0);
+    if (nDotL <= 0.0) {
+        return vec3(0.0);
+    }
+
+    float attenuation = getLocalLightAttenuation(distanceSquared, light.range);
+    if (light.type == LOCAL_LIGHT_SPOT) {
+        attenuation *= smoothstep(light.spotCosOuter, light.spotCosInner, dot(-L, light.direction));
+    }
+
+    vec3 H = normalize(V + L);
+    float NDF = D_GGX(N, H, roughness);
+    float G = G_SCHLICKGGX_SMITH(N, V, L, roughness);
+    vec3 F = F_SCHLICK(V, H, F0);
+    vec3 specular = NDF * G * F / max(4.0 * max(dot(N, V), 0.0) * nDotL, 0.001);
+
+    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
+    vec3 diffuse = Lambert(kD, albedo);
+
+    return (diffuse + specular) * nDotL * attenuation * light.intensity * light.color;
+}
+
+/**
+ * Sum of every local light in the cluster of this pixel. Cost scales with the lights overlapping the cluster, not the total light count.
+ */
+vec3 evaluateClusteredLights(ClusteredLighting clusters, vec2 uv, vec3 viewPosition, vec3 N, vec3 V, vec3 albedo, float roughness, float metallic, vec3 F0) {
+    vec3 result = vec3(0.0);
+    if (clusters.gridSize.w == 0) {
+        return result;
+    }
+
+    uint clusterOffset = getClusterIndex(clusters, uv, -viewPosition.z) * CLUSTER_STRIDE;
+    uint lightCount = min(clusters.clusterBuffer.data[clusterOffset], MAX_LIGHTS_PER_CLUSTER);
+    for (uint i = 0; i < lightCount; ++i) {
+        uint lightIndex = clusters.clusterBuffer.data[clusterOffset + 1 + i];
+        result += evaluateLocalLight(clusters.lightBuffer.lights[lightIndex], viewPosition, N, V, albedo, roughness, metallic, F0);
+    }
+    return result;
+}
+
+#endif // CLUSTERED_LIGHTING_GLSL
@@ -6,6 +6,9 @@ layout (push_constant) uniform PushConstants {
 
     vec2 ndcToViewMul_x_PixelSize;
 
+    vec2 aoUvToTextureUv;
+    vec2 aoTexelSize;
+
     float depthLinearizeMult;
     float depthLinearizeAdd;
 
@@ -25,8 +28,44 @@ layout (push_constant) uniform PushConstants {
     float stepsPerSliceCount;
 
     int debug;
+
+    int resolutionDivisor;
+    float temporalBlend;
+    int bHistoryValid;
 } pushConstants;
 
+// Debug variants only, production variants never touch debugImage
+layout (constant_id = 0) const bool DEBUG_OUTPUT = false;
+
+// AO images may be a fraction of the render target resolution, each AO texel covers resolutionDivisor x resolutionDivisor pixels.
+// Requires scene.glsl
+
+// Size of the rendered region in AO texels
+ivec2 aoViewportSize() {
+    return ivec2(ceil(sceneData.renderTargetSize / float(pushConstants.resolutionDivisor)));
+}
+
+vec2 aoUvToTextureUv(vec2 aoUv) {
+    return aoUv * pushConstants.aoUvToTextureUv;
+}
+
+// The full resolution pixel an AO texel takes its depth and normal from
+ivec2 aoPixelToFullResolutionPixel(ivec2 aoPixel) {
+    return aoPixel * pushConstants.resolutionDivisor + pushConstants.resolutionDivisor / 2;
+}
+
+float screenToViewSpaceDepth(float screenDepth, float depthLinearizeMul, float depthLinearizeAdd) {
+    // Optimization by XeGTAO
+    // https://github.com/GameTechDev/XeGTAO/blob/a5b1686c7ea37788eeb3576b5be47f7c03db532c/Source/Rendering/Shaders/XeGTAO.hlsli#L112
+    return depthLinearizeMul / (depthLinearizeAdd - screenDepth);
+}
+
+float clampDepth(float depth){
+    // kind of redundant, the view space depth can only be as far as the depth buffer (which is 1000.0f at time of writing)
+    // using half float precision
+    return clamp(depth, 0.0, 65504.0);
+}
+
 
 // packing/unpacking for edges; 2 bits per edge mean 4 gradient values (0, 0.33, 0.66, 1) for smoother transitions!
 float XeGTAO_PackEdges(vec4 edgesLRTB)
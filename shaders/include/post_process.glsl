@@ -0,0 +1,61 @@
+#ifndef POST_PROCESS_GLSL
+#define POST_PROCESS_GLSL
+
+#include "common.glsl"
+#include "fxaa.glsl"
+
+// Selected per pipeline variant, disabled effects are compiled out
+layout (constant_id = 0) const bool TONEMAPPING = true;
+layout (constant_id = 1) const bool SHARPENING = true;
+layout (constant_id = 2) const bool FXAA = true;
+
+
+vec3 sharpen(sampler2D inputImage, vec3 centerColor, vec2 texelSize, vec2 uv) {
+    // Sample neighboring pixels
+    vec3 n = texture(inputImage, uv + vec2(0, -texelSize.y)).rgb;
+    vec3 s = texture(inputImage, uv + vec2(0, texelSize.y)).rgb;
+    vec3 e = texture(inputImage, uv + vec2(texelSize.x, 0)).rgb;
+    vec3 w = texture(inputImage, uv + vec2(-texelSize.x, 0)).rgb;
+
+    if (TONEMAPPING) {
+        n = aces(n);
+        s = aces(s);
+        e = aces(e);
+        w = aces(w);
+    }
+
+    float sharpenStrength = 0.5;// Adjust this value
+    vec3 sharpened = centerColor * (1.0 + 4.0 * sharpenStrength) - (n + s + e + w) * sharpenStrength;
+    return max(vec3(0.0), sharpened);// Prevent negative values
+}
+
+/**
+ * @param uv texture uv of the render target, the same uv the output pixel would have in a render target sized output
+ */
+vec4 postProcess(sampler2D inputImage, vec2 uv, vec2 texelSize, vec2 jitter) {
+    // Flip final image (cause vulkan images starts from top-left)
+    uv.y = 1 - uv.y;
+
+    // Unjitter
+    uv += jitter / 2.0f;
+
+    vec4 fullColor = texture(inputImage, uv);
+    vec3 color = fullColor.rgb;
+
+    if (TONEMAPPING) {
+        color = aces(color);
+        //color = aces(color);
+    }
+
+    if (FXAA) {
+        color = FXAA_Apply(color, inputImage, uv, texelSize, TONEMAPPING);
+    }
+
+    if (SHARPENING) {
+        color = sharpen(inputImage, color, texelSize, uv);
+    }
+
+    return vec4(color, fullColor.a);
+}
+
+#endif // POST_PROCESS_GLSL
@@ -25,6 +25,7 @@ layout (std140, set = 0, binding = 0) uniform SceneData {
     vec4 prevCameraPos;
 
     vec4 jitter;
+    vec4 viewportScale;
 
     DirectionalLight directionalLightData;
 
@@ -33,4 +34,18 @@ layout (std140, set = 0, binding = 0) uniform SceneData {
     vec2 texelSize;
     vec2 cameraPlanes;
     float deltaTime;
-} sceneData;
\ No newline at end of file
+} sceneData;
+
+// Render targets are allocated at the maximum render resolution and only the top left `renderTargetSize` pixels are rendered to.
+// texelSize is relative to the allocated size, so (pixel + 0.5) * texelSize addresses render targets directly.
+vec2 textureUvToScreenUv(vec2 uv) {
+    return uv / sceneData.viewportScale.xy;
+}
+
+vec2 screenUvToTextureUv(vec2 screenUv) {
+    return screenUv * sceneData.viewportScale.xy;
+}
+
+vec2 screenUvToPreviousTextureUv(vec2 screenUv) {
+    return screenUv * sceneData.viewportScale.zw;
+}
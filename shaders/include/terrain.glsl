@@ -0,0 +1,217 @@
+#ifndef TERRAIN_GLSL
+#define TERRAIN_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+// Terrain patches are quads with corners ordered (u,v): 0 = (0,0), 1 = (1,0), 2 = (0,1), 3 = (1,1)
+// gl_TessLevelOuter[0..3] map to the edges u = 0, v = 0, u = 1 and v = 1 respectively
+
+/**
+ * Heightmap texels along each edge of a patch, must match TERRAIN_PATCH_TEXELS in terrain_constants.h
+ */
+const int PATCH_TEXELS = 16;
+
+/**
+ * Patches along x and z, same as TerrainChunk::getPatchCount
+ */
+ivec2 getPatchCount(ivec2 gridSize) {
+    return (gridSize - 1 + PATCH_TEXELS - 1) / PATCH_TEXELS;
+}
+
+/**
+ * Terrain is drawn without vertex buffers, every 4 vertices form one patch covering up to PATCH_TEXELS x PATCH_TEXELS heightmap cells,
+ * rows of patches run along x. Patches on the far edges are clamped to the map.
+ * \n Chunks with skirts append one skirt patch per edge patch (south z = 0, north, west x = 0, east). Corners 0 and 1 run along the chunk edge and
+ * 2 and 3 hang below them, the direction along the edge is picked so every skirt faces outwards. Skirts hide the cracks where a neighbouring tile
+ * has a different quadtree level and so a different sample spacing.
+ * @param outTexel heightmap texel of this vertex's corner
+ * @return 1 for the lower corners of a skirt patch, otherwise 0
+ */
+float getPatchVertex(int vertexIndex, ivec2 gridSize, out ivec2 outTexel) {
+    int patchIndex = vertexIndex >> 2;
+    int corner = vertexIndex & 3;
+    ivec2 patchCount = getPatchCount(gridSize);
+    ivec2 maxTexel = gridSize - 1;
+
+    int gridPatchCount = patchCount.x * patchCount.y;
+    if (patchIndex < gridPatchCount) {
+        ivec2 patchCoord = ivec2(patchIndex % patchCount.x, patchIndex / patchCount.x);
+        outTexel = min((patchCoord + ivec2(corner & 1, corner >> 1)) * PATCH_TEXELS, maxTexel);
+        return 0.0;
+    }
+
+    int skirtIndex = patchIndex - gridPatchCount;
+    int edge;
+    int edgePatch;
+    if (skirtIndex < patchCount.x * 2) {
+        edge = skirtIndex / patchCount.x;
+        edgePatch = skirtIndex % patchCount.x;
+    } else {
+        skirtIndex -= patchCount.x * 2;
+        edge = 2 + skirtIndex / patchCount.y;
+        edgePatch = skirtIndex % patchCount.y;
+    }
+
+    bool bReversed = edge == 0 || edge == 3;
+    int along = min((edgePatch + ((corner & 1) ^ (bReversed ? 1 : 0))) * PATCH_TEXELS, edge < 2 ? maxTexel.x : maxTexel.y);
+    if (edge == 0) { outTexel = ivec2(along, 0); }
+    else if (edge == 1) { outTexel = ivec2(along, maxTexel.y); }
+    else if (edge == 2) { outTexel = ivec2(0, along); }
+    else { outTexel = ivec2(maxTexel.x, along); }
+    return float(corner >> 1);
+}
+
+/**
+ * Inverse of TerrainChunk::encodeNormal, y is up
+ */
+vec3 octDecode(vec2 encoded) {
+    vec3 normal = vec3(encoded.x, 1.0 - abs(encoded.x) - abs(encoded.y), encoded.y);
+    float fold = max(-normal.y, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.z += normal.z >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+/**
+ * Corner texels and weights for a fractional heightmap texel coordinate (texel centers at integers), clamped to the map
+ */
+void getBilinearTexels(ivec2 mapSize, vec2 texelCoord, out ivec2 texel00, out ivec2 texel11, out vec2 weight) {
+    ivec2 maxTexel = mapSize - 1;
+    vec2 clampedCoord = clamp(texelCoord, vec2(0.0), vec2(maxTexel));
+    texel00 = clamp(ivec2(floor(clampedCoord)), ivec2(0), max(maxTexel - 1, ivec2(0)));
+    texel11 = min(texel00 + 1, maxTexel);
+    weight = clamp(clampedCoord - vec2(texel00), 0.0, 1.0);
+}
+
+/**
+ * Height between texels, filtered by hand as the heightmap is bound with a nearest sampler (32 bit float formats may not support linear filtering)
+ */
+float sampleTerrainHeight(sampler2D heightMap, vec2 texelCoord) {
+    ivec2 texel00;
+    ivec2 texel11;
+    vec2 weight;
+    getBilinearTexels(textureSize(heightMap, 0), texelCoord, texel00, texel11, weight);
+
+    float h00 = texelFetch(heightMap, texel00, 0).r;
+    float h10 = texelFetch(heightMap, ivec2(texel11.x, texel00.y), 0).r;
+    float h01 = texelFetch(heightMap, ivec2(texel00.x, texel11.y), 0).r;
+    float h11 = texelFetch(heightMap, texel11, 0).r;
+    return mix(mix(h00, h10, weight.x), mix(h01, h11, weight.x), weight.y);
+}
+
+/**
+ * Normal between texels, the decoded corner normals are blended rather than the encoded values
+ */
+vec3 sampleTerrainNormal(sampler2D normalMap, vec2 texelCoord) {
+    ivec2 texel00;
+    ivec2 texel11;
+    vec2 weight;
+    getBilinearTexels(textureSize(normalMap, 0), texelCoord, texel00, texel11, weight);
+
+    vec3 n00 = octDecode(texelFetch(normalMap, texel00, 0).rg);
+    vec3 n10 = octDecode(texelFetch(normalMap, ivec2(texel11.x, texel00.y), 0).rg);
+    vec3 n01 = octDecode(texelFetch(normalMap, ivec2(texel00.x, texel11.y), 0).rg);
+    vec3 n11 = octDecode(texelFetch(normalMap, texel11, 0).rg);
+    return normalize(mix(mix(n00, n10, weight.x), mix(n01, n11, weight.x), weight.y));
+}
+
+/**
+ * Same as TerrainChunk::encodeNormal, packs a unit vector into two snorm16 (x in the low bits)
+ */
+uint octEncode(vec3 normal) {
+    vec2 oct = normal.xz / (abs(normal.x) + abs(normal.y) + abs(normal.z));
+    if (normal.y < 0.0) {
+        vec2 signs = vec2(oct.x >= 0.0 ? 1.0 : -1.0, oct.y >= 0.0 ? 1.0 : -1.0);
+        oct = (1.0 - abs(oct.yx)) * signs;
+    }
+    return packSnorm2x16(oct);
+}
+
+/**
+ * Tessellation level of an edge from its projected size. Only depends on the two edge vertices so neighbouring patches always agree (crack-free).
+ * The edge is treated as a sphere so the result does not change with the edge's orientation to the camera.
+ * \n edgeTexels caps the level at one segment per heightmap cell, finer segments add no detail.
+ */
+float getEdgeTessLevel(vec3 p0, vec3 p1, vec3 cameraPosition, float projScaleY, float viewportHeight, float targetEdgeLength, float maxTessLevel, float edgeTexels) {
+    float diameter = distance(p0, p1);
+    float dist = max(distance(0.5 * (p0 + p1), cameraPosition), 0.0001);
+    float projectedPixels = diameter * projScaleY * 0.5 * viewportHeight / dist;
+    return clamp(projectedPixels / targetEdgeLength, 1.0, max(min(maxTessLevel, edgeTexels), 1.0));
+}
+
+/**
+ * Tessellation level of an edge already in orthographic clip space (shadow cascades), measured in shadow map texels.
+ */
+float getClipEdgeTessLevel(vec2 c0, vec2 c1, float viewportSize, float targetEdgeLength, float maxTessLevel, float edgeTexels) {
+    float projectedTexels = distance(c0, c1) * 0.5 * viewportSize;
+    return clamp(projectedTexels / targetEdgeLength, 1.0, max(min(maxTessLevel, edgeTexels), 1.0));
+}
+
+/**
+ * Computed once per grid patch by terrain_patch_bounds.comp, covers the patch's texels inclusive of its far edges
+ */
+struct PatchBounds
+{
+    float minHeight;
+    float maxHeight;
+    uint coneAxis; // octEncode'd average normal
+    float coneCutoff; // sine of the cone's half angle, 1 if the patch has normals facing every way
+};
+
+layout (buffer_reference, std430) readonly buffer PatchBoundsBuffer
+{
+    PatchBounds bounds[];
+};
+
+/**
+ * Bounds of the grid patch starting at texelMin. Skirt patches take the bounds of the grid patch they hang from.
+ */
+PatchBounds getPatchBounds(PatchBoundsBuffer patchBounds, ivec2 gridSize, ivec2 texelMin) {
+    ivec2 patchCount = getPatchCount(gridSize);
+    ivec2 patchCoord = min(texelMin / PATCH_TEXELS, patchCount - 1);
+    return patchBounds.bounds[patchCoord.y * patchCount.x + patchCoord.x];
+}
+
+/**
+ * True if all 8 corners of the box are outside the same clip plane. Depth is only tested against the z = w plane (the reverse-z near plane of the main pass).
+ */
+bool isBoxOutsideFrustum(mat4 viewProj, vec3 boxMin, vec3 boxMax, float margin) {
+    bool bOutsideLeft = true;
+    bool bOutsideRight = true;
+    bool bOutsideBottom = true;
+    bool bOutsideTop = true;
+    bool bOutsideNear = true;
+    for (int i = 0; i < 8; ++i) {
+        vec3 corner = vec3((i & 1) != 0 ? boxMax.x : boxMin.x, (i & 2) != 0 ? boxMax.y : boxMin.y, (i & 4) != 0 ? boxMax.z : boxMin.z);
+        vec4 clip = viewProj * vec4(corner, 1.0);
+        float w = clip.w * (1.0 + margin);
+        bOutsideLeft = bOutsideLeft && clip.x < -w;
+        bOutsideRight = bOutsideRight && clip.x > w;
+        bOutsideBottom = bOutsideBottom && clip.y < -w;
+        bOutsideTop = bOutsideTop && clip.y > w;
+        bOutsideNear = bOutsideNear && clip.z > clip.w;
+    }
+    return bOutsideLeft || bOutsideRight || bOutsideBottom || bOutsideTop || bOutsideNear;
+}
+
+/**
+ * True if no normal of the patch's cone can face the camera from anywhere in the box. Tessellated vertices take their normals from the patch's texels,
+ * so the corners alone are not enough.
+ */
+bool isPatchBackFacing(PatchBounds bounds, vec3 boxMin, vec3 boxMax, vec3 cameraPosition, float tolerance) {
+    vec3 center = 0.5 * (boxMin + boxMax);
+    float radius = 0.5 * distance(boxMin, boxMax);
+    vec3 fromCamera = center - cameraPosition;
+    vec3 coneAxis = octDecode(unpackSnorm2x16(bounds.coneAxis));
+    return dot(fromCamera, coneAxis) >= (bounds.coneCutoff + tolerance) * length(fromCamera) + radius;
+}
+
+/**
+ * Directional variant of isPatchBackFacing, used by shadow casters. toLight points from the surface towards the light.
+ */
+bool isPatchBackFacingDirectional(PatchBounds bounds, vec3 toLight, float tolerance) {
+    vec3 coneAxis = octDecode(unpackSnorm2x16(bounds.coneAxis));
+    return dot(coneAxis, toLight) < -(bounds.coneCutoff + tolerance);
+}
+
+#endif // TERRAIN_GLSL
@@ -0,0 +1,132 @@
+#ifndef TERRAIN_GENERATION_GLSL
+#define TERRAIN_GENERATION_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+layout (buffer_reference, std430) buffer HeightBuffer
+{
+    float heights[];
+};
+
+layout (buffer_reference, std430) buffer NormalBuffer
+{
+    vec4 normals[];
+};
+
+layout (buffer_reference, std430) buffer EncodedNormalBuffer
+{
+    uint encodedNormals[];
+};
+
+/**
+ * Min/max of the raw noise, stored as order preserving uints so they can be reduced with integer atomics
+ */
+layout (buffer_reference, std430) buffer HeightRangeBuffer
+{
+    uint minHeight;
+    uint maxHeight;
+};
+
+layout (buffer_reference, std430) readonly buffer OctaveOffsetBuffer
+{
+    vec2 octaveOffsets[];
+};
+
+layout (push_constant) uniform PushConstants {
+    HeightBuffer heightBuffer;
+    NormalBuffer normalBuffer;
+    EncodedNormalBuffer encodedNormalBuffer;
+    HeightRangeBuffer heightRangeBuffer;
+    OctaveOffsetBuffer octaveOffsetBuffer;
+    ivec2 size;
+    int seed;
+    int octaves;
+    float invScale;
+    float persistence;
+    float lacunarity;
+    float heightScale;
+} push;
+
+uint floatToOrderedUint(float value) {
+    uint bits = floatBitsToUint(value);
+    return (bits & 0x80000000u) != 0u ? ~bits : bits | 0x80000000u;
+}
+
+float orderedUintToFloat(uint value) {
+    return uintBitsToFloat((value & 0x80000000u) != 0u ? value & 0x7FFFFFFFu : ~value);
+}
+
+int getSampleIndex(ivec2 coord) {
+    return coord.y * push.size.x + coord.x;
+}
+
+// Port of FastNoiseLite's 2D Perlin (NoiseType_Perlin, frequency 1, no fractal) so GPU heights match HeightmapUtil
+
+// FastNoiseLite's Gradients2D is these 24 gradients repeated 5 times followed by the 8 below
+const vec2 PERLIN_GRADIENTS[24] = vec2[24](
+    vec2(0.130526192220052, 0.99144486137381), vec2(0.38268343236509, 0.923879532511287),
+    vec2(0.608761429008721, 0.793353340291235), vec2(0.793353340291235, 0.608761429008721),
+    vec2(0.923879532511287, 0.38268343236509), vec2(0.99144486137381, 0.130526192220051),
+    vec2(0.99144486137381, -0.130526192220051), vec2(0.923879532511287, -0.38268343236509),
+    vec2(0.793353340291235, -0.60876142900872), vec2(0.608761429008721, -0.793353340291235),
+    vec2(0.38268343236509, -0.923879532511287), vec2(0.130526192220052, -0.99144486137381),
+    vec2(-0.130526192220052, -0.99144486137381), vec2(-0.38268343236509, -0.923879532511287),
+    vec2(-0.608761429008721, -0.793353340291235), vec2(-0.793353340291235, -0.608761429008721),
+    vec2(-0.923879532511287, -0.38268343236509), vec2(-0.99144486137381, -0.130526192220052),
+    vec2(-0.99144486137381, 0.130526192220051), vec2(-0.923879532511287, 0.38268343236509),
+    vec2(-0.793353340291235, 0.608761429008721), vec2(-0.608761429008721, 0.793353340291235),
+    vec2(-0.38268343236509, 0.923879532511287), vec2(-0.130526192220052, 0.99144486137381)
+);
+
+const vec2 PERLIN_GRADIENTS_TAIL[8] = vec2[8](
+    vec2(0.38268343236509, 0.923879532511287), vec2(0.923879532511287, 0.38268343236509),
+    vec2(0.923879532511287, -0.38268343236509), vec2(0.38268343236509, -0.923879532511287),
+    vec2(-0.38268343236509, -0.923879532511287), vec2(-0.923879532511287, -0.38268343236509),
+    vec2(-0.923879532511287, 0.38268343236509), vec2(-0.38268343236509, 0.923879532511287)
+);
+
+const int PERLIN_PRIME_X = 501125321;
+const int PERLIN_PRIME_Y = 1136930381;
+
+int perlinFastFloor(float f) {
+    return f >= 0.0 ? int(f) : int(f) - 1;
+}
+
+float perlinInterpQuintic(float t) {
+    return t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+}
+
+float perlinGradCoord(int seed, int xPrimed, int yPrimed, float xd, float yd) {
+    // Signed overflow wraps, same as the CPU implementation
+    int hash = (seed ^ xPrimed ^ yPrimed) * 0x27d4eb2d;
+    hash ^= hash >> 15;
+    int gradientIndex = (hash & (127 << 1)) >> 1;
+
+    vec2 gradient = gradientIndex < 120 ? PERLIN_GRADIENTS[gradientIndex % 24] : PERLIN_GRADIENTS_TAIL[gradientIndex - 120];
+    return xd * gradient.x + yd * gradient.y;
+}
+
+float perlinNoise(int seed, float x, float y) {
+    int x0 = perlinFastFloor(x);
+    int y0 = perlinFastFloor(y);
+
+    float xd0 = x - float(x0);
+    float yd0 = y - float(y0);
+    float xd1 = xd0 - 1.0;
+    float yd1 = yd0 - 1.0;
+
+    float xs = perlinInterpQuintic(xd0);
+    float ys = perlinInterpQuintic(yd0);
+
+    x0 *= PERLIN_PRIME_X;
+    y0 *= PERLIN_PRIME_Y;
+    int x1 = x0 + PERLIN_PRIME_X;
+    int y1 = y0 + PERLIN_PRIME_Y;
+
+    float xf0 = mix(perlinGradCoord(seed, x0, y0, xd0, yd0), perlinGradCoord(seed, x1, y0, xd1, yd0), xs);
+    float xf1 = mix(perlinGradCoord(seed, x0, y1, xd0, yd1), perlinGradCoord(seed, x1, y1, xd1, yd1), xs);
+
+    return mix(xf0, xf1, ys) * 1.4247691104677813;
+}
+
+#endif // TERRAIN_GENERATION_GLSL
@@ -1,27 +1,32 @@
 #version 460
-#extension GL_EXT_buffer_reference: require
-#extension GL_EXT_nonuniform_qualifier: enable
 
-#include "structure.glsl"
-#include "shadows.glsl"
-#include "lights.glsl"
-
-layout (std140, set = 0, binding = 0) uniform ShadowCascadeData {
-    CascadeSplit cascadeSplits[4];
-    mat4 lightViewProj[4];
-    DirectionalLight directionalLightData; // w is intensity
-} shadowCascadeData;
-
-layout (location = 0) in vec3 position;
+#include "terrain.glsl"
 
 layout (location = 0) out vec3 outPosition;
+layout (location = 1) out vec2 outTexelCoord;
+layout (location = 2) out float outSkirtOffset;
+
+layout (set = 1, binding = 0) uniform sampler2D heightMap;
 
 layout (push_constant) uniform PushConstants {
+    vec2 origin;
+    float sampleSpacing;
     int cascadeIndex;
-    int tessLevel;
+    float targetEdgeLength;
+    float maxTessLevel;
+    float cascadeResolution;
+    int bCullPatches;
+    float skirtDepth;
 } push;
 
 void main() {
-    gl_Position = shadowCascadeData.lightViewProj[push.cascadeIndex] * vec4(position, 1.0);
-    outPosition = gl_Position.xyz;
-}
\ No newline at end of file
+    // No vertex buffer, positions are pulled from the chunk's height map
+    ivec2 sampleCoord;
+    outSkirtOffset = getPatchVertex(gl_VertexIndex, textureSize(heightMap, 0), sampleCoord) * push.skirtDepth;
+    vec2 gridPosition = push.origin + vec2(sampleCoord) * push.sampleSpacing;
+
+    // Transformed into light space after tessellation, patch culling needs world space positions
+    outPosition = vec3(gridPosition.x, texelFetch(heightMap, sampleCoord, 0).r - outSkirtOffset, gridPosition.y);
+    outTexelCoord = vec2(sampleCoord);
+    gl_Position = vec4(outPosition, 1.0);
+}
@@ -11,7 +11,6 @@
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inNormal;
 layout (location = 2) in vec2 inUV;
-layout (location = 3) flat in int inMaterialIndex;
 layout (location = 4) in vec4 inColor;
 layout (location = 5) in vec4 inCurrMvpPosition;
 layout (location = 6) in vec4 inPrevMvpPosition;
@@ -1,42 +1,42 @@
 #version 460
 
-#include "scene.glsl"
-
-layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 normal;
-layout (location = 2) in vec2 uv;
-layout (location = 3) in int materialIndex;
-layout (location = 4) in vec4 color;
+#include "terrain.glsl"
 
 layout (location = 0) out vec3 outPosition;
 layout (location = 1) out vec3 outNormal;
 layout (location = 2) out vec2 outUV;
-layout (location = 3) flat out int outMaterialIndex;
+layout (location = 3) out vec2 outTexelCoord;
 layout (location = 4) out vec4 outColor;
-
-// layout (std140, set = 0, binding = 0) uniform SceneData - scene.glsl
-
-mat3 adjugate(mat4 m) {
-    return mat3(
-    cross(m[1].xyz, m[2].xyz),
-    cross(m[2].xyz, m[0].xyz),
-    cross(m[0].xyz, m[1].xyz)
-    );
-
-}
+layout (location = 5) out float outSkirtOffset;
+
+layout (set = 3, binding = 0) uniform sampler2D heightMap;
+layout (set = 3, binding = 1) uniform sampler2D normalMap;
+
+layout (push_constant) uniform PushConstants {
+    vec4 baseColor;
+    vec2 origin;
+    vec2 uvScale;
+    vec2 uvOffset;
+    float sampleSpacing;
+    float targetEdgeLength;
+    float maxTessLevel;
+    int bCullPatches;
+    float skirtDepth;
+} pushConstants;
 
 void main() {
-    // Model models = bufferAddresses.modelBufferDeviceAddress.models[gl_InstanceIndex];
-    // would have a model matrix eventually
-
-    vec4 worldPos = vec4(position, 1.0);
-
-    outPosition = worldPos.xyz;
-    outMaterialIndex = materialIndex;
-    //outNormal = adjugate(models.currentModelMatrix) * normal;
-    outNormal = normal;
-    outUV = uv;
-    outColor = color;
-    // pass the model position, not the world pos if model matrix is used
+    // No vertex buffer, positions are pulled from the chunk's height map
+    ivec2 gridSize = textureSize(heightMap, 0);
+    ivec2 sampleCoord;
+    outSkirtOffset = getPatchVertex(gl_VertexIndex, gridSize, sampleCoord) * pushConstants.skirtDepth;
+
+    float height = texelFetch(heightMap, sampleCoord, 0).r - outSkirtOffset;
+    vec2 gridPosition = pushConstants.origin + vec2(sampleCoord) * pushConstants.sampleSpacing;
+
+    outPosition = vec3(gridPosition.x, height, gridPosition.y);
+    outNormal = octDecode(texelFetch(normalMap, sampleCoord, 0).rg);
+    outUV = vec2(sampleCoord) / vec2(gridSize - 1) * pushConstants.uvScale + pushConstants.uvOffset;
+    outTexelCoord = vec2(sampleCoord);
+    outColor = pushConstants.baseColor;
     gl_Position = vec4(outPosition, 1.0);
 }
@@ -10,6 +10,7 @@
 #include "lights.glsl"
 #include "shadows.glsl"
 #include "transparent.glsl"
+#include "clustered_lighting.glsl"
 
 // world space
 layout (location = 0) in vec3 inViewPosition;
@@ -54,6 +55,8 @@ layout (push_constant) uniform PushConstants {
     int enabled;
     int disableShadows;
     int disableContactShadows;
+    int pad;
+    ClusteredLighting clusters;
 } pushConstants;
 
 void main() {
@@ -139,7 +142,9 @@ void main() {
     float ao = 1.0f;
     vec3 ambient = (kD * reflectionDiffuse + reflectionSpecular) * ao;
     ambient *= mix(0.4, 1.0, min(shadowFactor, nDotL));
-    vec3 finalColor = directLight + ambient;
+    vec2 screenUV = gl_FragCoord.xy / sceneData.renderTargetSize;
+    vec3 localLight = evaluateClusteredLights(pushConstants.clusters, screenUV, inViewPosition, N, V, albedo.xyz, roughness, metallic, F0);
+    vec3 finalColor = directLight + localLight + ambient;
 
     float z = gl_FragCoord.z;
     // inverted depth buffer
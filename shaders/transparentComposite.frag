@@ -9,8 +9,10 @@ layout (set = 0, binding = 1) uniform sampler2D revealageTexture;
 const float EPSILON = 0.00001f;
 
 void main() {
-    float revealage = texture(revealageTexture, inUV).r;
-    vec4 accum = texture(accumulationTexture, inUV);
+    // Fetch by pixel, with dynamic resolution only part of the accumulation targets is rendered to
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(revealageTexture, pixel, 0).r;
+    vec4 accum = texelFetch(accumulationTexture, pixel, 0);
 
     float maxComp = max(max(abs(accum.r), abs(accum.g)), abs(accum.b));
 
@@ -0,0 +1,32 @@
+//
+// Created by William on 2025-07-13.
+//
+
+#ifndef BENCHMARK_RANDOM_H
+#define BENCHMARK_RANDOM_H
+
+#include <cstdint>
+
+namespace will_engine::benchmark
+{
+/**
+ * splitmix64, used instead of std distributions so generated input and scenes are identical on every standard library
+ */
+inline uint64_t nextRandom(uint64_t& state)
+{
+    uint64_t z = state += 0x9E3779B97F4A7C15ull;
+    z = (z ^ z >> 30) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ z >> 27) * 0x94D049BB133111EBull;
+    return z ^ z >> 31;
+}
+
+/**
+ * [-1, 1)
+ */
+inline float nextRandomFloat(uint64_t& state)
+{
+    return static_cast<float>(nextRandom(state) >> 40) / static_cast<float>(1ull << 23) - 1.0f;
+}
+}
+
+#endif //BENCHMARK_RANDOM_H
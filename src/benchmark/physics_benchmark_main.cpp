@@ -0,0 +1,134 @@
+//
+// Created by William on 2025-06-28.
+//
+
+#include <charconv>
+#include <fstream>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "physics_replay.h"
+#include "engine/physics/physics.h"
+
+using namespace will_engine;
+
+static void printUsage()
+{
+    fmt::print("Usage: PhysicsBenchmark <map.willmap> [--ticks N] [--warmup N] [--seed N] [--input-interval N] [--step-rate HZ] "
+        "[--output result.json] [--expect-hash HEX]\n");
+}
+
+template<typename T>
+static bool parseNumber(const std::string_view text, T& out, const int base = 10)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::from_chars(text.data(), text.data() + text.size(), out).ec == std::errc{};
+    }
+    else {
+        return std::from_chars(text.data(), text.data() + text.size(), out, base).ec == std::errc{};
+    }
+}
+
+/**
+ * Headless physics benchmark. Steps the rigidbodies of a map deterministically and reports step timings and a state hash.
+ * \n Returns 1 if the arguments are invalid, the map fails to load or the state hash does not match \code --expect-hash\endcode.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    const std::filesystem::path mapPath = argv[1];
+    benchmark::PhysicsReplaySettings settings{};
+    std::filesystem::path outputPath{};
+    bool bHasExpectedHash = false;
+    uint64_t expectedHash = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            fmt::print("Missing value for {}\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const std::string_view value = argv[++i];
+        bool bValid = true;
+        if (arg == "--ticks") { bValid = parseNumber(value, settings.tickCount); }
+        else if (arg == "--warmup") { bValid = parseNumber(value, settings.warmupTicks); }
+        else if (arg == "--seed") { bValid = parseNumber(value, settings.inputSeed); }
+        else if (arg == "--input-interval") { bValid = parseNumber(value, settings.inputInterval); }
+        else if (arg == "--step-rate") { bValid = parseNumber(value, settings.physicsSettings.stepRate); }
+        else if (arg == "--output") { outputPath = value; }
+        else if (arg == "--expect-hash") {
+            bValid = parseNumber(value.starts_with("0x") ? value.substr(2) : value, expectedHash, 16);
+            bHasExpectedHash = true;
+        }
+        else { bValid = false; }
+
+        if (!bValid) {
+            fmt::print("Invalid argument {} {}\n", arg, value);
+            printUsage();
+            return 1;
+        }
+    }
+
+    auto* physicsContext = new physics::Physics();
+    physics::Physics::set(physicsContext);
+
+    benchmark::PhysicsReplayResult result{};
+    bool bLoaded;
+    {
+        benchmark::PhysicsReplay replay{physicsContext};
+        bLoaded = replay.loadScene(mapPath);
+        if (bLoaded) {
+            result = replay.run(settings);
+        }
+    }
+
+    physics::Physics::set(nullptr);
+    delete physicsContext;
+
+    if (!bLoaded) {
+        fmt::print("Failed to load any rigidbodies from {}\n", mapPath.string());
+        return 1;
+    }
+
+    fmt::print("Physics Benchmark: {}\n", mapPath.string());
+    fmt::print("  Bodies:     {} ({} dynamic)\n", result.bodyCount, result.dynamicBodyCount);
+    fmt::print("  Ticks:      {} (+{} warmup) at {} Hz\n", result.tickCount, settings.warmupTicks, settings.physicsSettings.stepRate);
+    fmt::print("  Step (ms):  mean {:.4f} | p50 {:.4f} | p90 {:.4f} | p99 {:.4f} | max {:.4f}\n", result.meanMs, result.p50Ms, result.p90Ms, result.p99Ms, result.maxMs);
+    fmt::print("  Total (ms): {:.3f}\n", result.totalMs);
+    fmt::print("  State Hash: {:016x}\n", result.stateHash);
+
+    if (!outputPath.empty()) {
+        benchmark::ordered_json resultJ;
+        resultJ["map"] = mapPath.string();
+        resultJ["bodies"] = result.bodyCount;
+        resultJ["dynamicBodies"] = result.dynamicBodyCount;
+        resultJ["ticks"] = result.tickCount;
+        resultJ["warmupTicks"] = settings.warmupTicks;
+        resultJ["seed"] = settings.inputSeed;
+        resultJ["stepRate"] = settings.physicsSettings.stepRate;
+        resultJ["stepMs"]["mean"] = result.meanMs;
+        resultJ["stepMs"]["p50"] = result.p50Ms;
+        resultJ["stepMs"]["p90"] = result.p90Ms;
+        resultJ["stepMs"]["p99"] = result.p99Ms;
+        resultJ["stepMs"]["max"] = result.maxMs;
+        resultJ["totalMs"] = result.totalMs;
+        resultJ["stateHash"] = fmt::format("{:016x}", result.stateHash);
+
+        std::ofstream file(outputPath);
+        file << resultJ.dump(4);
+    }
+
+    if (bHasExpectedHash && expectedHash != result.stateHash) {
+        fmt::print("State hash mismatch, expected {:016x}\n", expectedHash);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+//
+// Created by William on 2025-06-28.
+//
+
+#include "physics_replay.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <fstream>
+
+#include <fmt/format.h>
+
+#include "benchmark_random.h"
+#include "engine/physics/physics.h"
+#include "engine/physics/physics_body.h"
+#include "engine/physics/physics_serialization.h"
+#include "engine/physics/physics_utils.h"
+
+namespace will_engine::benchmark
+{
+/**
+ * Stand-in for a game object's rigidbody, only holds the transform physics writes back
+ */
+class ReplayBody final : public IPhysicsBody
+{
+public:
+    ReplayBody(const glm::vec3& position, const glm::quat& rotation) : position(position), rotation(rotation) {}
+
+    void setTransform(const glm::vec3& _position, const glm::quat& _rotation) override
+    {
+        position = _position;
+        rotation = _rotation;
+    }
+
+    glm::vec3 getGlobalPosition() override { return position; }
+
+    glm::quat getGlobalRotation() override { return rotation; }
+
+    void setPhysicsBodyId(const JPH::BodyID _bodyId) override { bodyId = _bodyId; }
+
+    [[nodiscard]] JPH::BodyID getPhysicsBodyId() const override { return bodyId; }
+
+    void dirty() override { bIsDirty = true; }
+
+    void undirty() override { bIsDirty = false; }
+
+    bool isTransformDirty() override { return bIsDirty; }
+
+private:
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    JPH::BodyID bodyId{JPH::BodyID::cMaxBodyIndex};
+    bool bIsDirty{false};
+};
+
+static glm::vec3 readVec3(const ordered_json& j, const glm::vec3& fallback)
+{
+    if (!j.is_object()) { return fallback; }
+    return {j.value("x", fallback.x), j.value("y", fallback.y), j.value("z", fallback.z)};
+}
+
+static glm::quat readQuat(const ordered_json& j)
+{
+    if (!j.is_object()) { return {1.0f, 0.0f, 0.0f, 0.0f}; }
+    return {j.value("w", 1.0f), j.value("x", 0.0f), j.value("y", 0.0f), j.value("z", 0.0f)};
+}
+
+static void hashValue(uint64_t& hash, const float value)
+{
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    for (int32_t i = 0; i < 4; ++i) {
+        hash ^= bits & 0xFF;
+        hash *= 0x100000001B3ull;
+        bits >>= 8;
+    }
+}
+
+static double percentile(const std::vector<double>& sortedTimes, const double fraction)
+{
+    if (sortedTimes.empty()) { return 0.0; }
+    const auto index = static_cast<size_t>(fraction * static_cast<double>(sortedTimes.size() - 1) + 0.5);
+    return sortedTimes[std::min(index, sortedTimes.size() - 1)];
+}
+
+PhysicsReplay::PhysicsReplay(physics::Physics* physics) : physics(physics)
+{}
+
+PhysicsReplay::~PhysicsReplay()
+{
+    releaseBodies();
+}
+
+bool PhysicsReplay::loadScene(const std::filesystem::path& mapPath)
+{
+    if (!physics) {
+        fmt::print("Warning: PhysicsReplay has no physics context\n");
+        return false;
+    }
+
+    std::ifstream file(mapPath);
+    if (!file.is_open()) {
+        fmt::print("Warning: Failed to open map {}\n", mapPath.string());
+        return false;
+    }
+
+    ordered_json rootJ = ordered_json::parse(file, nullptr, false);
+    if (rootJ.is_discarded() || !rootJ.contains("gameObjects")) {
+        fmt::print("Warning: Map {} is not a valid map file\n", mapPath.string());
+        return false;
+    }
+
+    releaseBodies();
+    loadGameObject(rootJ["gameObjects"], glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+
+    return !bodies.empty();
+}
+
+void PhysicsReplay::loadGameObject(const ordered_json& j, const glm::vec3& parentPosition, const glm::quat& parentRotation, const glm::vec3& parentScale)
+{
+    glm::vec3 position = parentPosition;
+    glm::quat rotation = parentRotation;
+    glm::vec3 scale = parentScale;
+
+    if (j.contains("transform")) {
+        const ordered_json& transform = j["transform"];
+        position = parentPosition + parentRotation * (parentScale * readVec3(transform.value("position", ordered_json{}), glm::vec3(0.0f)));
+        rotation = parentRotation * readQuat(transform.value("rotation", ordered_json{}));
+        scale = parentScale * readVec3(transform.value("scale", ordered_json{}), glm::vec3(1.0f));
+    }
+
+    if (j.contains("components")) {
+        for (const auto& [componentName, componentData] : j["components"].items()) {
+            if (componentData.value("componentType", "") != "RigidBodyComponent" || !componentData.contains("properties")) {
+                continue;
+            }
+
+            const auto properties = componentData["properties"].get<physics::PhysicsProperties>();
+            auto body = std::make_unique<ReplayBody>(position + rotation * properties.offset, rotation);
+            if (!physics->deserializeProperties(body.get(), properties)) {
+                fmt::print("Warning: Failed to create rigidbody for {}\n", j.value("name", std::string{}));
+                continue;
+            }
+
+            if (static_cast<JPH::EMotionType>(properties.motionType) == JPH::EMotionType::Dynamic) {
+                dynamicBodies.push_back(body->getPhysicsBodyId());
+            }
+            bodies.push_back(std::move(body));
+        }
+    }
+
+    if (j.contains("children")) {
+        for (const auto& child : j["children"]) {
+            loadGameObject(child, position, rotation, scale);
+        }
+    }
+}
+
+PhysicsReplayResult PhysicsReplay::run(const PhysicsReplaySettings& settings)
+{
+    PhysicsReplayResult result;
+    if (!physics) { return result; }
+
+    physics->setPhysicsSettings(settings.physicsSettings);
+    const float timestep = physics->getPhysicsSettings().getFixedTimestep();
+
+    std::vector<double> stepTimes;
+    stepTimes.reserve(settings.tickCount);
+
+    uint64_t rngState = settings.inputSeed;
+    const uint32_t totalTicks = settings.warmupTicks + settings.tickCount;
+    for (uint32_t tick = 0; tick < totalTicks; ++tick) {
+        if (settings.inputInterval > 0 && tick % settings.inputInterval == 0) {
+            applyInput(rngState, settings);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        // Exactly one fixed step per tick, the accumulator never carries a remainder
+        physics->update(timestep);
+        const auto end = std::chrono::steady_clock::now();
+
+        if (tick >= settings.warmupTicks) {
+            stepTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+
+    result.bodyCount = static_cast<uint32_t>(bodies.size());
+    result.dynamicBodyCount = static_cast<uint32_t>(dynamicBodies.size());
+    result.tickCount = settings.tickCount;
+    result.stateHash = computeStateHash();
+
+    if (!stepTimes.empty()) {
+        for (const double time : stepTimes) {
+            result.totalMs += time;
+        }
+        result.meanMs = result.totalMs / static_cast<double>(stepTimes.size());
+
+        std::ranges::sort(stepTimes);
+        result.p50Ms = percentile(stepTimes, 0.50);
+        result.p90Ms = percentile(stepTimes, 0.90);
+        result.p99Ms = percentile(stepTimes, 0.99);
+        result.maxMs = stepTimes.back();
+    }
+
+    return result;
+}
+
+void PhysicsReplay::applyInput(uint64_t& rngState, const PhysicsReplaySettings& settings) const
+{
+    if (dynamicBodies.empty()) { return; }
+
+    const JPH::BodyID target = dynamicBodies[nextRandom(rngState) % dynamicBodies.size()];
+    const glm::vec3 direction{nextRandomFloat(rngState), glm::abs(nextRandomFloat(rngState)), nextRandomFloat(rngState)};
+    physics::PhysicsUtils::addImpulse(target, direction * settings.impulseStrength);
+}
+
+uint64_t PhysicsReplay::computeStateHash() const
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    if (!physics) { return hash; }
+
+    const JPH::BodyInterface& bodyInterface = physics->getBodyInterface();
+    for (const auto& body : bodies) {
+        const JPH::BodyID bodyId = body->getPhysicsBodyId();
+
+        JPH::RVec3 position;
+        JPH::Quat rotation;
+        bodyInterface.GetPositionAndRotation(bodyId, position, rotation);
+        const JPH::Vec3 linearVelocity = bodyInterface.GetLinearVelocity(bodyId);
+        const JPH::Vec3 angularVelocity = bodyInterface.GetAngularVelocity(bodyId);
+
+        for (const float value : {
+                 static_cast<float>(position.GetX()), static_cast<float>(position.GetY()), static_cast<float>(position.GetZ()),
+                 rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW(),
+                 linearVelocity.GetX(), linearVelocity.GetY(), linearVelocity.GetZ(),
+                 angularVelocity.GetX(), angularVelocity.GetY(), angularVelocity.GetZ()
+             }) {
+            hashValue(hash, value);
+        }
+    }
+
+    return hash;
+}
+
+void PhysicsReplay::releaseBodies()
+{
+    if (physics && !bodies.empty()) {
+        std::vector<IPhysicsBody*> physicsBodies;
+        physicsBodies.reserve(bodies.size());
+        for (const auto& body : bodies) {
+            physicsBodies.push_back(body.get());
+        }
+        physics->removeRigidBodies(physicsBodies);
+    }
+
+    bodies.clear();
+    dynamicBodies.clear();
+}
+}
@@ -0,0 +1,97 @@
+//
+// Created by William on 2025-06-28.
+//
+
+#ifndef PHYSICS_REPLAY_H
+#define PHYSICS_REPLAY_H
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <json/json.hpp>
+
+#include "engine/physics/physics_types.h"
+
+namespace will_engine::physics
+{
+class Physics;
+}
+
+namespace will_engine::benchmark
+{
+using ordered_json = nlohmann::ordered_json;
+
+class ReplayBody;
+
+struct PhysicsReplaySettings
+{
+    uint32_t tickCount{1000};
+    /**
+     * Ticks simulated before timing starts. Still part of the input stream and the state hash
+     */
+    uint32_t warmupTicks{60};
+    uint64_t inputSeed{1};
+    /**
+     * Ticks between generated impulses, 0 disables input
+     */
+    uint32_t inputInterval{10};
+    float impulseStrength{500.0f};
+    physics::PhysicsSettings physicsSettings{};
+};
+
+struct PhysicsReplayResult
+{
+    uint32_t bodyCount{0};
+    uint32_t dynamicBodyCount{0};
+    uint32_t tickCount{0};
+    double totalMs{0.0};
+    double meanMs{0.0};
+    double p50Ms{0.0};
+    double p90Ms{0.0};
+    double p99Ms{0.0};
+    double maxMs{0.0};
+    uint64_t stateHash{0};
+};
+
+/**
+ * Loads the rigidbodies of a map through \code Physics::deserializeProperties\endcode without any game objects or renderer, then steps them at a fixed timestep
+ * with a seeded input stream. Same scene, settings and seed should always produce the same state hash.
+ */
+class PhysicsReplay
+{
+public:
+    explicit PhysicsReplay(physics::Physics* physics);
+
+    ~PhysicsReplay();
+
+    PhysicsReplay(const PhysicsReplay&) = delete;
+
+    PhysicsReplay& operator=(const PhysicsReplay&) = delete;
+
+    bool loadScene(const std::filesystem::path& mapPath);
+
+    PhysicsReplayResult run(const PhysicsReplaySettings& settings);
+
+    /**
+     * FNV-1a over the position, rotation and velocities of every loaded body, in load order
+     */
+    [[nodiscard]] uint64_t computeStateHash() const;
+
+private:
+    void loadGameObject(const ordered_json& j, const glm::vec3& parentPosition, const glm::quat& parentRotation, const glm::vec3& parentScale);
+
+    void applyInput(uint64_t& rngState, const PhysicsReplaySettings& settings) const;
+
+    void releaseBodies();
+
+private:
+    physics::Physics* physics;
+    std::vector<std::unique_ptr<ReplayBody>> bodies;
+    std::vector<JPH::BodyID> dynamicBodies;
+};
+}
+
+#endif //PHYSICS_REPLAY_H
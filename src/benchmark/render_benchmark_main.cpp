@@ -0,0 +1,134 @@
+//
+// Created by William on 2025-07-13.
+//
+
+#define VMA_IMPLEMENTATION
+#include <vma/vk_mem_alloc.h>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb/stb_image_write.h>
+
+#include <charconv>
+#include <fstream>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "stress_scene.h"
+#include "engine/core/engine.h"
+
+using namespace will_engine;
+
+static void printUsage()
+{
+    fmt::print("Usage: RenderBenchmark [--instances N] [--models M] [--bodies K] [--terrain-chunks T] [--debug-primitives L] [--seed N] "
+        "[--frames N] [--warmup N] [--width W] [--height H] [--camera-path path.json] [--output result.json] [--trace trace.json]\n");
+}
+
+template<typename T>
+static bool parseNumber(const std::string_view text, T& out)
+{
+    return std::from_chars(text.data(), text.data() + text.size(), out).ec == std::errc{};
+}
+
+/**
+ * Builds a synthetic stress scene (see \code StressScene\endcode) and renders it headless along a fixed camera path,
+ * reporting per-stage CPU and GPU timings.
+ * \n Returns 1 if the arguments are invalid, the scene is empty or the results could not be written.
+ */
+int main(int argc, char* argv[])
+{
+    benchmark::StressSceneSettings sceneSettings{};
+    HeadlessSettings headless{};
+    headless.bEnabled = true;
+    headless.bLoadDefaultMap = false;
+    headless.frameCount = 600;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            fmt::print("Missing value for {}\n", arg);
+            printUsage();
+            return 1;
+        }
+
+        const std::string_view value = argv[++i];
+        bool bValid = true;
+        if (arg == "--instances") { bValid = parseNumber(value, sceneSettings.instanceCount); }
+        else if (arg == "--models") { bValid = parseNumber(value, sceneSettings.modelCount); }
+        else if (arg == "--bodies") { bValid = parseNumber(value, sceneSettings.physicsBodyCount); }
+        else if (arg == "--terrain-chunks") { bValid = parseNumber(value, sceneSettings.terrainChunkCount); }
+        else if (arg == "--debug-primitives") { bValid = parseNumber(value, sceneSettings.debugPrimitiveCount); }
+        else if (arg == "--seed") { bValid = parseNumber(value, sceneSettings.seed); }
+        else if (arg == "--frames") { bValid = parseNumber(value, headless.frameCount) && headless.frameCount > 0; }
+        else if (arg == "--warmup") { bValid = parseNumber(value, headless.warmupFrames); }
+        else if (arg == "--width") { bValid = parseNumber(value, headless.extent.width) && headless.extent.width > 0; }
+        else if (arg == "--height") { bValid = parseNumber(value, headless.extent.height) && headless.extent.height > 0; }
+        else if (arg == "--camera-path") { headless.cameraPath = value; }
+        else if (arg == "--output") { headless.outputPath = value; }
+        else if (arg == "--trace") { headless.tracePath = value; }
+        else { bValid = false; }
+
+        if (!bValid) {
+            fmt::print("Invalid argument {} {}\n", arg, value);
+            printUsage();
+            return 1;
+        }
+    }
+
+    Engine engine;
+    engine.init(headless);
+
+    bool bSuccess = true;
+    {
+        benchmark::StressScene scene{engine};
+        if (scene.build(sceneSettings)) {
+            CameraPath cameraPath{};
+            if (!headless.cameraPath.empty() && !cameraPath.load(headless.cameraPath)) {
+                fmt::print("Warning: Camera path {} could not be loaded, orbiting the scene instead\n", headless.cameraPath.string());
+            }
+            if (cameraPath.isEmpty()) {
+                cameraPath = scene.createOrbitCameraPath();
+            }
+
+            const benchmark::StressSceneStats& stats = scene.getStats();
+            fmt::print("Render Benchmark: {} instances of {} models, {} bodies, {} terrain chunks, {} debug primitives (seed {})\n",
+                       stats.instanceCount, stats.modelCount, stats.physicsBodyCount, stats.terrainChunkCount, stats.debugPrimitiveCount,
+                       sceneSettings.seed);
+
+            const HeadlessResult result = engine.runHeadlessFrames(cameraPath, [&scene](uint32_t) {
+                scene.drawDebugPrimitives();
+            });
+            Engine::printHeadlessResult(result);
+
+            if (!headless.outputPath.empty()) {
+                ordered_json resultJ;
+                resultJ["scene"]["instances"] = stats.instanceCount;
+                resultJ["scene"]["models"] = stats.modelCount;
+                resultJ["scene"]["bodies"] = stats.physicsBodyCount;
+                resultJ["scene"]["terrainChunks"] = stats.terrainChunkCount;
+                resultJ["scene"]["debugPrimitives"] = stats.debugPrimitiveCount;
+                resultJ["scene"]["seed"] = sceneSettings.seed;
+                resultJ.update(Serializer::headlessResultToJson(headless, result));
+
+                std::ofstream file(headless.outputPath);
+                if (file.is_open()) {
+                    file << resultJ.dump(4);
+                }
+                else {
+                    fmt::print("Failed to write results to {}\n", headless.outputPath.string());
+                    bSuccess = false;
+                }
+            }
+        }
+        else {
+            fmt::print("Stress scene is empty, nothing to benchmark\n");
+            bSuccess = false;
+        }
+    }
+
+    engine.cleanup();
+
+    return bSuccess ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+//
+// Created by William on 2025-07-13.
+//
+
+#include "stress_scene.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <fmt/format.h>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "benchmark_random.h"
+#include "engine/core/engine.h"
+#include "engine/core/game_object/game_object.h"
+#include "engine/core/game_object/components/component_factory.h"
+#include "engine/core/scene/map.h"
+#include "engine/physics/physics.h"
+#include "engine/physics/physics_filters.h"
+#include "engine/renderer/assets/asset_manager.h"
+#include "engine/renderer/assets/render_object/render_object.h"
+#include "engine/renderer/terrain/terrain_chunk.h"
+#include "engine/renderer/terrain/terrain_manager.h"
+#if WILL_ENGINE_DEBUG_DRAW
+#include "engine/renderer/pipelines/debug/debug_renderer.h"
+#endif
+
+namespace will_engine::benchmark
+{
+static constexpr int32_t TERRAIN_RESOLUTION = 129;
+static constexpr float TERRAIN_SAMPLE_SPACING = 2.0f;
+static constexpr float TERRAIN_HEIGHT = 20.0f;
+/**
+ * Instances and bodies sit above the terrain so they never intersect it
+ */
+static constexpr float GROUND_HEIGHT = TERRAIN_HEIGHT + 1.0f;
+static constexpr float BODY_SPACING = 1.5f;
+
+static uint32_t getGridSide(const uint32_t count)
+{
+    return static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+}
+
+StressScene::StressScene(Engine& engine) : engine(engine)
+{}
+
+StressScene::~StressScene()
+{
+    destroy();
+}
+
+bool StressScene::build(const StressSceneSettings& settings)
+{
+    destroy();
+
+    // Never loaded from or saved to disk
+    map = engine.createMap("stress_scene");
+    if (!map) {
+        fmt::print("Warning: Failed to create the stress scene map\n");
+        return false;
+    }
+    // Empty maps are not queued for begin play, children are only updated once their map has begun
+    engine.addToBeginQueue(map);
+
+    const uint32_t instanceSide = getGridSide(settings.instanceCount);
+    const uint32_t bodySide = getGridSide(settings.physicsBodyCount);
+    halfExtent = std::max(static_cast<float>(instanceSide) * settings.instanceSpacing, static_cast<float>(bodySide) * BODY_SPACING) * 0.5f;
+
+    // Each part draws from its own stream, so changing one count doesn't move everything else
+    uint64_t instanceRng = settings.seed;
+    uint64_t bodyRng = settings.seed ^ (1ull << 32);
+    uint64_t debugRng = settings.seed ^ (2ull << 32);
+
+    createInstances(settings, instanceRng);
+    createPhysicsBodies(settings, bodyRng);
+    createTerrainChunks(settings);
+    createDebugPrimitives(settings, debugRng);
+
+    return stats.instanceCount + stats.physicsBodyCount + stats.terrainChunkCount + stats.debugPrimitiveCount > 0;
+}
+
+void StressScene::createInstances(const StressSceneSettings& settings, uint64_t& rngState)
+{
+    if (settings.instanceCount == 0 || settings.modelCount == 0) { return; }
+
+    // Sorted so the same models are picked regardless of the order the assets were scanned in
+    std::vector<renderer::RenderObject*> renderObjects = engine.getAssetManager()->getAllRenderObjects();
+    std::ranges::sort(renderObjects, [](const renderer::RenderObject* a, const renderer::RenderObject* b) { return a->getName() < b->getName(); });
+    if (renderObjects.empty()) {
+        fmt::print("Warning: No render objects found, the stress scene has no instances\n");
+        return;
+    }
+    if (renderObjects.size() < settings.modelCount) {
+        fmt::print("Warning: Only {} render objects available, {} were requested\n", renderObjects.size(), settings.modelCount);
+    }
+    renderObjects.resize(std::min<size_t>(renderObjects.size(), settings.modelCount));
+
+    for (renderer::RenderObject* renderObject : renderObjects) {
+        if (!renderObject->isLoaded()) {
+            renderObject->load();
+        }
+    }
+    stats.modelCount = static_cast<uint32_t>(renderObjects.size());
+
+    const uint32_t side = getGridSide(settings.instanceCount);
+    const float start = -static_cast<float>(side - 1) * settings.instanceSpacing * 0.5f;
+    for (uint32_t i = 0; i < settings.instanceCount; ++i) {
+        renderer::RenderObject* renderObject = renderObjects[i % renderObjects.size()];
+
+        IHierarchical* hierarchical = Engine::createGameObject(map, fmt::format("Instance_{}", i));
+        auto* gameObject = dynamic_cast<game::GameObject*>(hierarchical);
+        if (!gameObject) { continue; }
+
+        const glm::vec3 position{start + static_cast<float>(i % side) * settings.instanceSpacing, GROUND_HEIGHT,
+                                 start + static_cast<float>(i / side) * settings.instanceSpacing};
+        const float yaw = nextRandomFloat(rngState) * glm::pi<float>();
+        gameObject->setLocalTransform({position, glm::angleAxis(yaw, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(1.0f)});
+
+        renderObject->generateMeshComponents(gameObject, Transform::Identity);
+        stats.instanceCount++;
+    }
+}
+
+void StressScene::createPhysicsBodies(const StressSceneSettings& settings, uint64_t& rngState)
+{
+    physics::Physics* physics = physics::Physics::get();
+    if (settings.physicsBodyCount == 0 || !physics) { return; }
+
+    const auto addRigidBody = [&](IHierarchical* hierarchical, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& halfExtents,
+                                  const JPH::EMotionType motionType, const JPH::ObjectLayer layer) {
+        auto* gameObject = dynamic_cast<game::GameObject*>(hierarchical);
+        if (!gameObject) { return false; }
+
+        gameObject->setLocalTransform({position, rotation, glm::vec3(1.0f)});
+        auto newComponent = game::ComponentFactory::getInstance().create(game::RigidBodyComponent::getStaticType(), "Rigid Body");
+        auto* rigidBody = dynamic_cast<game::RigidBodyComponent*>(gameObject->addComponent(std::move(newComponent)));
+        if (!rigidBody) { return false; }
+
+        physics->setupRigidbody(rigidBody, JPH::EShapeSubType::Box, halfExtents, motionType, layer);
+        return rigidBody->hasRigidBody();
+    };
+
+    const glm::quat identity{1.0f, 0.0f, 0.0f, 0.0f};
+    addRigidBody(Engine::createGameObject(map, "Ground"), {0.0f, GROUND_HEIGHT - 0.5f, 0.0f}, identity, {halfExtent + 1.0f, 0.5f, halfExtent + 1.0f},
+                 JPH::EMotionType::Static, physics::Layers::NON_MOVING);
+
+    // Dropped from above the ground, the jitter and rotation make them tumble and collide rather than settle straight down
+    const uint32_t side = getGridSide(settings.physicsBodyCount);
+    const float start = -static_cast<float>(side - 1) * BODY_SPACING * 0.5f;
+    for (uint32_t i = 0; i < settings.physicsBodyCount; ++i) {
+        const glm::vec3 jitter{nextRandomFloat(rngState) * 0.2f, nextRandomFloat(rngState), nextRandomFloat(rngState) * 0.2f};
+        const glm::vec3 position = glm::vec3{
+                                       start + static_cast<float>(i % side) * BODY_SPACING,
+                                       GROUND_HEIGHT + 5.0f,
+                                       start + static_cast<float>(i / side) * BODY_SPACING
+                                   } + jitter;
+        const glm::vec3 axis = glm::normalize(glm::vec3{nextRandomFloat(rngState), 1.0f, nextRandomFloat(rngState)});
+        const glm::quat rotation = glm::angleAxis(nextRandomFloat(rngState) * glm::pi<float>(), axis);
+
+        if (addRigidBody(Engine::createGameObject(map, fmt::format("Body_{}", i)), position, rotation, glm::vec3(0.5f), JPH::EMotionType::Dynamic,
+                         physics::Layers::MOVING)) {
+            stats.physicsBodyCount++;
+        }
+    }
+}
+
+void StressScene::createTerrainChunks(const StressSceneSettings& settings)
+{
+    if (settings.terrainChunkCount == 0) { return; }
+
+    const NoiseSettings noiseSettings{
+        .scale = 100.0f,
+        .persistence = 0.5f,
+        .lacunarity = 2.0f,
+        .octaves = 4,
+        .offset = {0.0f, 0.0f},
+        .heightScale = TERRAIN_HEIGHT
+    };
+    constexpr terrain::TerrainConfig terrainConfig{
+        .uvOffset = {0.0f, 0.0f},
+        .uvScale = {1.0f, 1.0f},
+        .baseColor = {1.0f, 1.0f, 1.0f, 1.0f}
+    };
+    terrain::TerrainProperties terrainProperties{};
+    terrainProperties.maxHeight = TERRAIN_HEIGHT;
+
+    const uint32_t side = getGridSide(settings.terrainChunkCount);
+    constexpr float chunkSize = static_cast<float>(TERRAIN_RESOLUTION - 1) * TERRAIN_SAMPLE_SPACING;
+    const float start = -static_cast<float>(side) * chunkSize * 0.5f;
+    halfExtent = std::max(halfExtent, static_cast<float>(side) * chunkSize * 0.5f);
+
+    for (uint32_t i = 0; i < settings.terrainChunkCount; ++i) {
+        const auto x = static_cast<int32_t>(i % side);
+        const auto z = static_cast<int32_t>(i / side);
+
+        // Physics is covered by the bodies, the chunks only add to rendering and shadows
+        const terrain::TerrainChunkPlacement placement{
+            .origin = {start + static_cast<float>(x) * chunkSize, start + static_cast<float>(z) * chunkSize},
+            .sampleSpacing = TERRAIN_SAMPLE_SPACING,
+            .border = 1,
+            .bCreatePhysics = false,
+        };
+
+        // Sampled in world space with the same height range for every chunk, so neighbours share their edge heights and normals
+        constexpr int32_t sampleCount = TERRAIN_RESOLUTION + 2;
+        const std::vector<float> heights = HeightmapUtil::generateTileFromNoise(sampleCount, sampleCount, static_cast<uint32_t>(settings.seed), noiseSettings,
+                                                                                placement.origin - glm::vec2(TERRAIN_SAMPLE_SPACING), TERRAIN_SAMPLE_SPACING);
+        terrain::TerrainMeshData meshData = terrain::TerrainChunk::buildMesh(heights, sampleCount, sampleCount, terrainConfig, placement);
+
+        auto chunk = std::make_unique<terrain::TerrainChunk>(*engine.getResourceManager(), std::move(meshData), placement);
+        chunk->setTerrainBufferData(terrainProperties, terrain::TerrainChunk::getDefaultTextureIds());
+
+        auto tile = std::make_unique<terrain::TerrainTile>(terrain::TerrainTileKey{0, x, z}, std::move(chunk));
+        engine.addToActiveTerrain(tile.get());
+        terrainTiles.push_back(std::move(tile));
+        stats.terrainChunkCount++;
+    }
+}
+
+void StressScene::createDebugPrimitives(const StressSceneSettings& settings, uint64_t& rngState)
+{
+#if WILL_ENGINE_DEBUG_DRAW
+    debugPrimitives.reserve(settings.debugPrimitiveCount);
+    for (uint32_t i = 0; i < settings.debugPrimitiveCount; ++i) {
+        DebugPrimitive primitive{};
+        primitive.center = {nextRandomFloat(rngState) * halfExtent, GROUND_HEIGHT + 2.0f + (nextRandomFloat(rngState) + 1.0f) * 10.0f,
+                            nextRandomFloat(rngState) * halfExtent};
+        primitive.size = glm::vec3(1.0f + (nextRandomFloat(rngState) + 1.0f));
+        primitive.color = glm::vec3(nextRandomFloat(rngState), nextRandomFloat(rngState), nextRandomFloat(rngState)) * 0.5f + 0.5f;
+        primitive.bSphere = i % 2 == 1;
+        debugPrimitives.push_back(primitive);
+    }
+    stats.debugPrimitiveCount = settings.debugPrimitiveCount;
+#else
+    if (settings.debugPrimitiveCount > 0) {
+        fmt::print("Warning: Debug draw is not available in this build, the stress scene has no debug primitives\n");
+    }
+#endif
+}
+
+void StressScene::drawDebugPrimitives() const
+{
+#if WILL_ENGINE_DEBUG_DRAW
+    for (const DebugPrimitive& primitive : debugPrimitives) {
+        if (primitive.bSphere) {
+            renderer::DebugRenderer::drawSphere(primitive.center, primitive.size.x * 0.5f, primitive.color);
+        }
+        else {
+            renderer::DebugRenderer::drawBox(primitive.center, primitive.size, primitive.color);
+        }
+    }
+#endif
+}
+
+void StressScene::destroy()
+{
+    for (const std::unique_ptr<terrain::TerrainTile>& tile : terrainTiles) {
+        engine.removeFromActiveTerrain(tile.get());
+    }
+    terrainTiles.clear();
+    debugPrimitives.clear();
+
+    // Removed from the active maps before cleanup, otherwise debug builds would save it on exit
+    if (map) {
+        map->destroy();
+        map = nullptr;
+    }
+
+    stats = {};
+    halfExtent = 0.0f;
+}
+
+CameraPath StressScene::createOrbitCameraPath(const float duration) const
+{
+    constexpr uint32_t keyframeCount = 32;
+    const float radius = halfExtent * 1.25f + 10.0f;
+    const glm::vec3 center{0.0f, GROUND_HEIGHT, 0.0f};
+
+    CameraPath cameraPath{};
+    for (uint32_t i = 0; i <= keyframeCount; ++i) {
+        const float progress = static_cast<float>(i) / static_cast<float>(keyframeCount);
+        const float angle = progress * glm::two_pi<float>();
+        const glm::vec3 position = center + glm::vec3{std::cos(angle) * radius, radius * 0.5f, std::sin(angle) * radius};
+        const glm::quat rotation = glm::quatLookAt(glm::normalize(center - position), glm::vec3(0.0f, 1.0f, 0.0f));
+        cameraPath.addKeyframe({progress * duration, position, rotation});
+    }
+    return cameraPath;
+}
+}
@@ -0,0 +1,133 @@
+//
+// Created by William on 2025-07-13.
+//
+
+#ifndef STRESS_SCENE_H
+#define STRESS_SCENE_H
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "engine/core/camera/camera_path.h"
+
+namespace will_engine
+{
+class Engine;
+}
+
+namespace will_engine::game
+{
+class Map;
+}
+
+namespace will_engine::terrain
+{
+class TerrainTile;
+}
+
+namespace will_engine::benchmark
+{
+struct StressSceneSettings
+{
+    /**
+     * Game objects on a grid, each a full copy of one of the models (round robin)
+     */
+    uint32_t instanceCount{1000};
+    /**
+     * Distinct render objects the instances are spread over, in name order. Capped by the render objects found in the assets
+     */
+    uint32_t modelCount{4};
+    /**
+     * Dynamic boxes dropped onto a static ground under the instances
+     */
+    uint32_t physicsBodyCount{200};
+    uint32_t terrainChunkCount{4};
+    /**
+     * Boxes and spheres drawn every frame, only in builds with \code WILL_ENGINE_DEBUG_DRAW\endcode
+     */
+    uint32_t debugPrimitiveCount{0};
+    uint64_t seed{1};
+    /**
+     * Distance between neighbouring instances
+     */
+    float instanceSpacing{6.0f};
+};
+
+struct StressSceneStats
+{
+    uint32_t instanceCount{0};
+    uint32_t modelCount{0};
+    uint32_t physicsBodyCount{0};
+    uint32_t terrainChunkCount{0};
+    uint32_t debugPrimitiveCount{0};
+};
+
+/**
+ * Procedurally builds a scene from \code StressSceneSettings\endcode in its own map. The same settings and assets always produce the same scene,
+ * so timings of different engine versions can be compared.
+ */
+class StressScene
+{
+public:
+    explicit StressScene(Engine& engine);
+
+    ~StressScene();
+
+    StressScene(const StressScene&) = delete;
+
+    StressScene& operator=(const StressScene&) = delete;
+
+    /**
+     * Replaces any previously built scene
+     * @return false if nothing could be created
+     */
+    bool build(const StressSceneSettings& settings);
+
+    /**
+     * Debug draws are cleared every frame, so this has to be called every frame before rendering
+     */
+    void drawDebugPrimitives() const;
+
+    void destroy();
+
+    /**
+     * One orbit around the scene, looking at its center
+     * @param duration seconds
+     */
+    [[nodiscard]] CameraPath createOrbitCameraPath(float duration = 16.0f) const;
+
+    [[nodiscard]] const StressSceneStats& getStats() const { return stats; }
+
+private:
+    struct DebugPrimitive
+    {
+        glm::vec3 center;
+        glm::vec3 size;
+        glm::vec3 color;
+        bool bSphere;
+    };
+
+    void createInstances(const StressSceneSettings& settings, uint64_t& rngState);
+
+    void createPhysicsBodies(const StressSceneSettings& settings, uint64_t& rngState);
+
+    void createTerrainChunks(const StressSceneSettings& settings);
+
+    void createDebugPrimitives(const StressSceneSettings& settings, uint64_t& rngState);
+
+    Engine& engine;
+    game::Map* map{nullptr};
+    std::vector<std::unique_ptr<terrain::TerrainTile> > terrainTiles;
+    std::vector<DebugPrimitive> debugPrimitives;
+
+    StressSceneStats stats{};
+    /**
+     * Half the side of the square the instances and bodies are placed in
+     */
+    float halfExtent{0.0f};
+};
+}
+
+#endif //STRESS_SCENE_H
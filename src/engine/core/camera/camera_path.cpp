@@ -0,0 +1,78 @@
+//
+// Created by William on 2025-07-12.
+//
+
+#include "camera_path.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <fmt/format.h>
+#include <json/json.hpp>
+
+namespace will_engine
+{
+bool CameraPath::load(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fmt::print("Warning: Failed to open camera path {}\n", path.string());
+        return false;
+    }
+
+    try {
+        const nlohmann::json rootJ = nlohmann::json::parse(file);
+        for (const auto& keyframeJ : rootJ.at("keyframes")) {
+            CameraPathKeyframe keyframe{};
+            keyframe.time = keyframeJ.at("time").get<float>();
+
+            const auto& positionJ = keyframeJ.at("position");
+            keyframe.position = {positionJ.at(0).get<float>(), positionJ.at(1).get<float>(), positionJ.at(2).get<float>()};
+
+            if (keyframeJ.contains("rotation")) {
+                const auto& rotationJ = keyframeJ["rotation"];
+                // glm::quat is constructed w first
+                keyframe.rotation = glm::normalize(glm::quat(rotationJ.at(3).get<float>(), rotationJ.at(0).get<float>(),
+                                                             rotationJ.at(1).get<float>(), rotationJ.at(2).get<float>()));
+            }
+
+            addKeyframe(keyframe);
+        }
+    } catch (const std::exception& e) {
+        fmt::print("Warning: Failed to parse camera path {}: {}\n", path.string(), e.what());
+        keyframes.clear();
+        return false;
+    }
+
+    return !keyframes.empty();
+}
+
+void CameraPath::addKeyframe(const CameraPathKeyframe& keyframe)
+{
+    const auto it = std::ranges::upper_bound(keyframes, keyframe.time, {}, &CameraPathKeyframe::time);
+    keyframes.insert(it, keyframe);
+}
+
+void CameraPath::sample(const float time, glm::vec3& position, glm::quat& rotation) const
+{
+    if (keyframes.empty()) { return; }
+
+    const auto next = std::ranges::upper_bound(keyframes, time, {}, &CameraPathKeyframe::time);
+    if (next == keyframes.begin()) {
+        position = keyframes.front().position;
+        rotation = keyframes.front().rotation;
+        return;
+    }
+    if (next == keyframes.end()) {
+        position = keyframes.back().position;
+        rotation = keyframes.back().rotation;
+        return;
+    }
+
+    const CameraPathKeyframe& from = *(next - 1);
+    const CameraPathKeyframe& to = *next;
+    const float t = (time - from.time) / glm::max(to.time - from.time, 0.0001f);
+    position = glm::mix(from.position, to.position, t);
+    rotation = glm::slerp(from.rotation, to.rotation, t);
+}
+}
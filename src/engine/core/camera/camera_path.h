@@ -0,0 +1,56 @@
+//
+// Created by William on 2025-07-12.
+//
+
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <filesystem>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace will_engine
+{
+struct CameraPathKeyframe
+{
+    /**
+     * In seconds from the start of the path
+     */
+    float time{0.0f};
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * Keyframed camera transforms, so headless runs render the same views every time
+ */
+class CameraPath
+{
+public:
+    /**
+     * Loads \code {"keyframes": [{"time": 0.0, "position": [x, y, z], "rotation": [x, y, z, w]}, ...]}\endcode
+     */
+    bool load(const std::filesystem::path& path);
+
+    /**
+     * Keyframes are kept sorted by time
+     */
+    void addKeyframe(const CameraPathKeyframe& keyframe);
+
+    /**
+     * Interpolates linearly between the surrounding keyframes, clamped to the first and last
+     */
+    void sample(float time, glm::vec3& position, glm::quat& rotation) const;
+
+    [[nodiscard]] float getDuration() const { return keyframes.empty() ? 0.0f : keyframes.back().time; }
+
+    [[nodiscard]] bool isEmpty() const { return keyframes.empty(); }
+
+private:
+    std::vector<CameraPathKeyframe> keyframes;
+};
+}
+
+#endif //CAMERA_PATH_H
@@ -4,31 +4,41 @@
 
 #include "engine.h"
 
+#include <chrono>
 #include <thread>
 
 #include <vk-bootstrap/VkBootstrap.h>
 
 #include <Jolt/Jolt.h>
 
+#include "camera/camera_path.h"
 #include "camera/free_camera.h"
 #include "game_object/game_object.h"
+#include "game_object/local_light_source.h"
 #include "scene/serializer.h"
 #include "engine/engine_constants.h"
 #include "engine/core/input.h"
+#include "engine/core/profiler/memory_tracker.h"
+#include "engine/core/profiler/trace_profiler.h"
 #include "engine/core/time.h"
 #include "engine/physics/physics.h"
 #include "engine/physics/physics_utils.h"
+#include "engine/renderer/dynamic_resolution.h"
 #include "engine/renderer/immediate_submitter.h"
 #include "engine/renderer/resource_manager.h"
 #include "engine/renderer/assets/render_object/render_object.h"
 #include "engine/renderer/environment/environment.h"
 #include "engine/core/game_object/game_object_factory.h"
 #include "engine/renderer/render_context.h"
+#include "engine/renderer/render_graph/render_graph.h"
 #include "engine/renderer/pipelines/shadows/cascaded_shadow_map/cascaded_shadow_map.h"
 #include "engine/renderer/pipelines/geometry/deferred_mrt/deferred_mrt_pipeline.h"
 #include "engine/renderer/pipelines/geometry/deferred_resolve/deferred_resolve_pipeline.h"
 #include "engine/renderer/pipelines/geometry/environment/environment_pipeline.h"
 #include "engine/renderer/pipelines/geometry/terrain/terrain_pipeline.h"
+#include "engine/renderer/pipelines/lighting/light_culling/light_culling_pipeline.h"
+#include "engine/renderer/terrain/terrain_manager.h"
+#include "engine/renderer/terrain/terrain_generator.h"
 #include "engine/renderer/pipelines/post/post_process/post_process_pipeline.h"
 #include "engine/renderer/pipelines/post/temporal_antialiasing/temporal_antialiasing_pipeline.h"
 #include "engine/renderer/pipelines/shadows/contact_shadow/contact_shadows_pipeline_types.h"
@@ -50,6 +60,7 @@
 #define USE_VALIDATION_LAYERS false
 #endif
 
+// Initial present mode, can be changed at runtime through the frame pacing settings
 #ifdef  WILL_ENGINE_DEBUG
 // vsync
 #define PRESENT_MODE VK_PRESENT_MODE_FIFO_KHR
@@ -62,7 +73,7 @@ namespace will_engine
 {
 Engine* Engine::instance = nullptr;
 
-void Engine::init()
+void Engine::init(const HeadlessSettings& headless)
 {
     if (instance != nullptr) {
         throw std::runtime_error("More than 1 engine instance created, this is not allowed.");
@@ -71,20 +82,29 @@ void Engine::init()
     fmt::print("----------------------------------------\n");
     fmt::print("Initializing {}\n", ENGINE_NAME);
     startupProfiler.addEntry("Start");
+    WILL_PROFILE_THREAD("Main");
     const auto start = std::chrono::system_clock::now();
 
 
-    // We initialize SDL and create a window with it.
-    SDL_Init(SDL_INIT_VIDEO);
-    constexpr auto window_flags = SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE;
+    headlessSettings = headless;
 
-    renderContext = new renderer::RenderContext(DEFAULT_RENDER_EXTENT_2D, 1.0f);
+    if (headlessSettings.bEnabled) {
+        // No display is needed (or available, e.g. in containers), the window stays null
+        renderContext = new renderer::RenderContext(headlessSettings.extent, 1.0f);
+    }
+    else {
+        // We initialize SDL and create a window with it.
+        SDL_Init(SDL_INIT_VIDEO);
+        constexpr auto window_flags = SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE;
 
-    window = SDL_CreateWindow(
-        ENGINE_NAME,
-        static_cast<int32_t>(renderContext->windowExtent.width),
-        static_cast<int32_t>(renderContext->windowExtent.height),
-        window_flags);
+        renderContext = new renderer::RenderContext(DEFAULT_RENDER_EXTENT_2D, 1.0f);
+
+        window = SDL_CreateWindow(
+            ENGINE_NAME,
+            static_cast<int32_t>(renderContext->windowExtent.width),
+            static_cast<int32_t>(renderContext->windowExtent.height),
+            window_flags);
+    }
     input::Input::get().init(window, renderContext->windowExtent.width, renderContext->windowExtent.height);
     startupProfiler.addEntry("Windowing");
 
@@ -92,7 +112,10 @@ void Engine::init()
     context = new renderer::VulkanContext(window, USE_VALIDATION_LAYERS);
     startupProfiler.addEntry("Vulkan Context");
 
-    createSwapchain(renderContext->windowExtent.width, renderContext->windowExtent.height);
+    if (!headlessSettings.bEnabled) {
+        framePacingSettings.presentMode = PRESENT_MODE;
+        createSwapchain(renderContext->windowExtent.width, renderContext->windowExtent.height);
+    }
     startupProfiler.addEntry("Swapchain");
 
     // Command Pools
@@ -117,12 +140,23 @@ void Engine::init()
     startupProfiler.addEntry("Command Pool and Sync Structures");
 
     immediate = new renderer::ImmediateSubmitter(*context);
+    gpuProfiler = new renderer::GpuProfiler(*context);
+    dynamicResolution = new renderer::DynamicResolution(*gpuProfiler);
     resourceManager = new renderer::ResourceManager(*context, *immediate);
     assetManager = new renderer::AssetManager(*resourceManager);
     physics = new physics::Physics();
     physics::Physics::set(physics);
+    physics->setPhysicsSettings(physicsSettings);
+    terrainManager = new terrain::TerrainManager(*resourceManager);
+    terrain::TerrainManager::set(terrainManager);
+    terrainManager->setStreamingSettings(terrainStreamingSettings);
+    terrainGenerator = new terrain::TerrainGenerator(*resourceManager, *immediate);
 
-    startupProfiler.addEntry("Immediate, ResourceM, AssetM, Physics");
+    startupProfiler.addEntry("Immediate, ResourceM, AssetM, Physics, TerrainM");
+
+    if (headlessSettings.bEnabled) {
+        createHeadlessTarget(renderContext->windowExtent.width, renderContext->windowExtent.height);
+    }
 
     startupProfiler.addEntry("Draw Resources");
 
@@ -158,7 +192,7 @@ void Engine::init()
 
     startupProfiler.addEntry("CSM");
 
-    if (engine_constants::useImgui) {
+    if (engine_constants::useImgui && !headlessSettings.bEnabled) {
         imguiWrapper = new ImguiWrapper(*context, {window, swapchainImageFormat});
     }
 
@@ -166,7 +200,7 @@ void Engine::init()
     initGame();
 
     Serializer::deserializeEngineSettings(this, EngineSettingsTypeFlag::ALL_SETTINGS);
-    if (!generateDefaultMap()) {
+    if (headlessSettings.bLoadDefaultMap && !generateDefaultMap()) {
         createMap(file::getSampleScene());
     }
 
@@ -175,10 +209,11 @@ void Engine::init()
     const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     fmt::print("Finished Initialization in {} seconds\n", static_cast<float>(elapsed.count()) / 1000000.0f);
 
-    profiler.addTimer("0Physics");
-    profiler.addTimer("1Game");
-    profiler.addTimer("2Render");
-    profiler.addTimer("3Total");
+    constexpr std::array<const char*, ENGINE_TIMER_COUNT> timerNames{"Physics", "Game", "Render", "Total", "Frame Pacing Wait", "Input To Present"};
+    for (uint32_t timer = 0; timer < ENGINE_TIMER_COUNT; ++timer) {
+        [[maybe_unused]] const TimerId id = profiler.addTimer(timerNames[timer]);
+        assert(id == timer);
+    }
 
     resolutionChangedHandle = renderContext->resolutionChangedEvent.subscribe([this](const renderer::ResolutionChangedEvent& event) {
         this->handleResize(event);
@@ -205,7 +240,8 @@ void Engine::initRenderer()
 
     std::vector<DescriptorUniformData> sceneDataBufferData{1};
     for (int i{0}; i < FRAME_OVERLAP; i++) {
-        sceneDataBuffers[i] = resourceManager->createResource<renderer::Buffer>(renderer::BufferType::HostSequential, sizeof(SceneData));
+        // Read by GTAO and contact shadows, which may run on the async compute queue
+        sceneDataBuffers[i] = resourceManager->createResource<renderer::Buffer>(renderer::BufferType::HostSequential, sizeof(SceneData), 0, true);
         sceneDataBufferData[0] = DescriptorUniformData{.buffer = sceneDataBuffers[i]->buffer, .allocSize = sizeof(SceneData)};
         sceneDataDescriptorBuffer->setupData(sceneDataBufferData, i);
     }
@@ -218,6 +254,8 @@ void Engine::initRenderer()
 
     visibilityPassPipeline = new renderer::VisibilityPassPipeline(*resourceManager);
     startupProfiler.addEntry("Init Visibility Pass");
+    lightCullingPipeline = new renderer::LightCullingPipeline(*resourceManager);
+    startupProfiler.addEntry("Init Light Culling Pass");
     environmentPipeline = new renderer::EnvironmentPipeline(*resourceManager, environmentMap->getCubemapDescriptorSetLayout());
     startupProfiler.addEntry("Init Environment Pass");
     terrainPipeline = new renderer::TerrainPipeline(*resourceManager);
@@ -267,6 +305,12 @@ void Engine::run()
 
     // main loop
     while (!bQuit) {
+        // Otherwise render() waits after the game update, by which point the sampled input is already stale
+        if (framePacingSettings.bLowLatency && !bStopRendering) {
+            waitForFrameSlot();
+        }
+        profiler.beginTimer(ENGINE_TIMER_INPUT_TO_PRESENT);
+
         input::Input& input = input::Input::get();
         Time& time = Time::Get();
         input.frameReset();
@@ -303,14 +347,13 @@ void Engine::run()
             const bool res = renderContext->applyPendingChanges();
             assert(res);
 
-            vkDestroySwapchainKHR(context->device, swapchain, nullptr);
-            for (const auto swapchainImage : swapchainImageViews) {
-                vkDestroyImageView(context->device, swapchainImage, nullptr);
-            }
-
-            createSwapchain(renderContext->windowExtent.width, renderContext->windowExtent.height);
+            recreateSwapchain();
             input::Input::get().updateWindowExtent(renderContext->windowExtent.width, renderContext->windowExtent.height);
         }
+        else if (bSwapchainOutdated) {
+            vkDeviceWaitIdle(context->device);
+            recreateSwapchain();
+        }
 
         input.updateFocus(SDL_GetWindowFlags(window));
         time.update();
@@ -320,19 +363,20 @@ void Engine::run()
         }
 
         const float deltaTime = Time::Get().getDeltaTime();
-        profiler.beginTimer("3Total");
+        profiler.beginTimer(ENGINE_TIMER_TOTAL);
 
-        profiler.beginTimer("0Physics");
+        profiler.beginTimer(ENGINE_TIMER_PHYSICS);
         updatePhysics(deltaTime);
-        profiler.endTimer("0Physics");
+        profiler.endTimer(ENGINE_TIMER_PHYSICS);
 
-        profiler.beginTimer("1Game");
+        profiler.beginTimer(ENGINE_TIMER_GAME);
         updateGame(deltaTime);
-        profiler.endTimer("1Game");
+        profiler.endTimer(ENGINE_TIMER_GAME);
 
         updateDebug(deltaTime);
 
         if (bStopRendering) {
+            profiler.cancelTimer(ENGINE_TIMER_INPUT_TO_PRESENT);
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
         else {
@@ -343,12 +387,204 @@ void Engine::run()
         debugRenderer->clear();
 #endif
 
-        profiler.endTimer("3Total");
+        profiler.endTimer(ENGINE_TIMER_TOTAL);
+        WILL_PROFILE_FRAME();
+        profiling::MemoryTracker::markFrame();
+    }
+}
+
+bool Engine::runHeadless()
+{
+    CameraPath cameraPath{};
+    if (!headlessSettings.cameraPath.empty() && !cameraPath.load(headlessSettings.cameraPath)) {
+        fmt::print("Warning: Camera path {} could not be loaded, the camera stays in place\n", headlessSettings.cameraPath.string());
+    }
+
+    const HeadlessResult result = runHeadlessFrames(cameraPath);
+
+    printHeadlessResult(result);
+
+    if (!headlessSettings.outputPath.empty()) {
+        return Serializer::serializeHeadlessResult(headlessSettings, result, headlessSettings.outputPath);
+    }
+    return true;
+}
+
+void Engine::printHeadlessResult(const HeadlessResult& result)
+{
+    const auto printStatistics = [](const std::string_view name, const TimingStatistics& ms) {
+        fmt::print("  {:<28} mean {:8.3f} | p50 {:8.3f} | p90 {:8.3f} | p99 {:8.3f} | max {:8.3f}\n", name, ms.mean, ms.p50, ms.p90, ms.p99, ms.max);
+    };
+
+    fmt::print("Headless Run: {} frames in {:.1f} ms (all times in ms)\n", result.frameCount, result.totalMs);
+    printStatistics("CPU Frame", result.cpuFrameMs);
+    for (const HeadlessStageTiming& stage : result.cpuStages) {
+        printStatistics(fmt::format("  {}", stage.name), stage.ms);
+    }
+    if (!result.gpuStages.empty()) {
+        printStatistics("GPU Frame", result.gpuFrameMs);
+        for (const HeadlessStageTiming& stage : result.gpuStages) {
+            printStatistics(fmt::format("  {}", stage.name), stage.ms);
+        }
+    }
+
+    if constexpr (profiling::MemoryTracker::isEnabled()) {
+        printStatistics("Allocations / Frame", result.allocationsPerFrame);
+        const auto printMemory = [](const std::string_view name, const profiling::MemoryTagStatistics& memory) {
+            fmt::print("  {:<28} live {:10.1f} KB | peak {:10.1f} KB | peak allocations / frame {:6}\n", name, static_cast<double>(memory.liveBytes) / 1024.0,
+                       static_cast<double>(memory.peakLiveBytes) / 1024.0, memory.peakFrameAllocationCount);
+        };
+        printMemory("Heap", result.memoryTotal);
+        for (size_t tag = 0; tag < result.memory.size(); ++tag) {
+            if (result.memory[tag].allocationCount > 0) {
+                printMemory(fmt::format("  {}", profiling::MEMORY_TAG_NAMES[tag]), result.memory[tag]);
+            }
+        }
+    }
+}
+
+HeadlessResult Engine::runHeadlessFrames(const CameraPath& cameraPath, const HeadlessFrameCallback& onFrame)
+{
+    fmt::print("----------------------------------------\n");
+    fmt::print("Running {} headless ({}x{}, {} frames + {} warmup)\n", ENGINE_NAME, headlessSettings.extent.width, headlessSettings.extent.height,
+               headlessSettings.frameCount, headlessSettings.warmupFrames);
+
+    // Fixed timestep, so game and physics updates don't depend on how fast the device renders
+    constexpr float deltaTime = 1.0f / 60.0f;
+    const uint32_t totalFrames = headlessSettings.warmupFrames + headlessSettings.frameCount;
+    const bool bGpuTimings = gpuProfiler->isSupported();
+
+    enum CpuStage : uint32_t
+    {
+        CPU_STAGE_PHYSICS,
+        CPU_STAGE_GAME,
+        CPU_STAGE_DEBUG,
+        CPU_STAGE_FRAME_WAIT,
+        CPU_STAGE_RENDER,
+        CPU_STAGE_COUNT
+    };
+    constexpr std::array<const char*, CPU_STAGE_COUNT> cpuStageNames{"Physics", "Game", "Debug", "Frame Pacing Wait", "Render"};
+
+    std::vector<double> cpuFrameTimes;
+    std::vector<double> gpuFrameTimes;
+    std::vector<double> frameAllocationCounts;
+    std::array<std::vector<double>, CPU_STAGE_COUNT> cpuStageTimes;
+    std::vector<std::vector<double> > gpuStageTimes;
+    std::vector<uint32_t> gpuStageSampleCounts;
+    cpuFrameTimes.reserve(headlessSettings.frameCount);
+    gpuFrameTimes.reserve(headlessSettings.frameCount);
+    frameAllocationCounts.reserve(headlessSettings.frameCount);
+    for (std::vector<double>& stageTimes : cpuStageTimes) {
+        stageTimes.reserve(headlessSettings.frameCount);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto toMs = [](const Clock::time_point start, const Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    auto timedStart = Clock::now();
+    for (uint32_t frame = 0; frame < totalFrames; ++frame) {
+        const bool bTimed = frame >= headlessSettings.warmupFrames;
+        if (frame == headlessSettings.warmupFrames) {
+            timedStart = Clock::now();
+            // Warmup still streams in assets, which would dominate the peaks
+            profiling::MemoryTracker::resetPeaks();
+            if (!headlessSettings.tracePath.empty()) {
+                profiling::TraceProfiler::beginCapture();
+            }
+        }
+
+        if (!cameraPath.isEmpty() && fallbackCamera) {
+            // Warmup frames stay at the start of the path
+            const uint32_t pathFrame = bTimed ? frame - headlessSettings.warmupFrames : 0;
+            const float progress = headlessSettings.frameCount > 1 ? static_cast<float>(pathFrame) / static_cast<float>(headlessSettings.frameCount - 1) : 0.0f;
+            glm::vec3 position;
+            glm::quat rotation;
+            cameraPath.sample(progress * cameraPath.getDuration(), position, rotation);
+            fallbackCamera->setCameraTransform(position, rotation);
+        }
+
+        std::array<Clock::time_point, CPU_STAGE_COUNT + 1> stageBoundaries;
+        stageBoundaries[CPU_STAGE_PHYSICS] = Clock::now();
+        updatePhysics(deltaTime);
+        stageBoundaries[CPU_STAGE_GAME] = Clock::now();
+        updateGame(deltaTime);
+        stageBoundaries[CPU_STAGE_DEBUG] = Clock::now();
+        updateDebug(deltaTime);
+        if (onFrame) {
+            onFrame(frame);
+        }
+        // Waited on here rather than in render, so time spent blocked on the GPU is not counted as recording
+        stageBoundaries[CPU_STAGE_FRAME_WAIT] = Clock::now();
+        waitForFrameSlot();
+        stageBoundaries[CPU_STAGE_RENDER] = Clock::now();
+        render(deltaTime);
+#if WILL_ENGINE_DEBUG_DRAW
+        debugRenderer->clear();
+#endif
+        stageBoundaries[CPU_STAGE_COUNT] = Clock::now();
+        WILL_PROFILE_FRAME();
+        profiling::MemoryTracker::markFrame();
+
+        if (!bTimed) {
+            continue;
+        }
+
+        cpuFrameTimes.push_back(toMs(stageBoundaries[CPU_STAGE_PHYSICS], stageBoundaries[CPU_STAGE_COUNT]));
+        frameAllocationCounts.push_back(static_cast<double>(profiling::MemoryTracker::getTotalStatistics().frameAllocationCount));
+        for (uint32_t stage = 0; stage < CPU_STAGE_COUNT; ++stage) {
+            cpuStageTimes[stage].push_back(toMs(stageBoundaries[stage], stageBoundaries[stage + 1]));
+        }
+
+        // Timestamps are read back a few frames late, the first samples belong to the last warmup frames
+        if (bGpuTimings) {
+            gpuFrameTimes.push_back(gpuProfiler->getLastFrameDuration());
+
+            const std::vector<renderer::GpuProfilerScope>& scopes = gpuProfiler->getScopes();
+            gpuStageTimes.resize(scopes.size());
+            gpuStageSampleCounts.resize(scopes.size(), 0);
+            for (size_t i = 0; i < scopes.size(); ++i) {
+                // Passes that didn't run this frame (e.g. disabled effects) keep their old sample
+                if (scopes[i].sampleCount != gpuStageSampleCounts[i]) {
+                    gpuStageSampleCounts[i] = scopes[i].sampleCount;
+                    gpuStageTimes[i].push_back(scopes[i].lastTime);
+                }
+            }
+        }
+    }
+    vkDeviceWaitIdle(context->device);
+
+    if (!headlessSettings.tracePath.empty()) {
+        profiling::TraceProfiler::endCapture();
+        if (Serializer::serializeTraceCapture(profiling::TraceProfiler::collect(), startupProfiler.getEntries(), headlessSettings.tracePath)) {
+            fmt::print("Saved trace capture to {}\n", headlessSettings.tracePath.string());
+        }
+    }
+
+    HeadlessResult result{};
+    result.frameCount = headlessSettings.frameCount;
+    result.totalMs = toMs(timedStart, Clock::now());
+    result.cpuFrameMs = TimingStatistics::compute(std::move(cpuFrameTimes));
+    result.gpuFrameMs = TimingStatistics::compute(std::move(gpuFrameTimes));
+    for (uint32_t stage = 0; stage < CPU_STAGE_COUNT; ++stage) {
+        result.cpuStages.push_back({cpuStageNames[stage], TimingStatistics::compute(std::move(cpuStageTimes[stage]))});
+    }
+    const std::vector<renderer::GpuProfilerScope>& scopes = gpuProfiler->getScopes();
+    for (size_t i = 0; i < gpuStageTimes.size(); ++i) {
+        result.gpuStages.push_back({scopes[i].name, TimingStatistics::compute(std::move(gpuStageTimes[i]))});
+    }
+    result.allocationsPerFrame = TimingStatistics::compute(std::move(frameAllocationCounts));
+    for (size_t tag = 0; tag < result.memory.size(); ++tag) {
+        result.memory[tag] = profiling::MemoryTracker::getStatistics(static_cast<profiling::MemoryTag>(tag));
     }
+    result.memoryTotal = profiling::MemoryTracker::getTotalStatistics();
+    return result;
 }
 
 void Engine::updatePhysics(const float deltaTime) const
 {
+    WILL_PROFILE_ZONE("Update Physics");
     if (bEnablePhysics) {
         physics::Physics::get()->update(deltaTime);
     }
@@ -362,6 +598,7 @@ void Engine::updatePhysics(const float deltaTime) const
 
 void Engine::updateGame(const float deltaTime)
 {
+    WILL_PROFILE_ZONE("Update Game");
     if (fallbackCamera) { fallbackCamera->update(deltaTime); }
 
     const input::Input& input = input::Input::get();
@@ -429,6 +666,10 @@ void Engine::updateGame(const float deltaTime)
         hierarchical->beginDestructor();
     }
     hierarchicalDeletionQueue.clear();
+
+    if (terrainManager && fallbackCamera) {
+        terrainManager->update(fallbackCamera->getPosition());
+    }
 }
 
 void Engine::updateRender(VkCommandBuffer cmd, const float deltaTime, const int32_t currentFrameOverlap, const int32_t previousFrameOverlap)
@@ -443,12 +684,17 @@ void Engine::updateRender(VkCommandBuffer cmd, const float deltaTime, const int3
 
 
     const bool bIsFrameZero = frameNumber == 0;
+    const VkExtent2D viewportExtent = renderContext->viewportExtent;
+    const VkExtent2D renderExtent = renderContext->renderExtent;
+    // Jitter is relative to the rendered region, which can change size every frame
+    const glm::vec2 prevViewportExtent = bIsFrameZero
+                                             ? glm::vec2(viewportExtent.width, viewportExtent.height)
+                                             : pPreviousSceneData->renderTargetSize;
     glm::vec2 prevJitter = HaltonSequence::getJitterHardcoded(bIsFrameZero ? frameNumber : frameNumber - 1) - 0.5f;
-    prevJitter.x /= renderContext->renderExtent.width;
-    prevJitter.y /= renderContext->renderExtent.height;
+    prevJitter /= prevViewportExtent;
     glm::vec2 currentJitter = HaltonSequence::getJitterHardcoded(frameNumber) - 0.5f;
-    currentJitter.x /= renderContext->renderExtent.width;
-    currentJitter.y /= renderContext->renderExtent.height;
+    currentJitter.x /= viewportExtent.width;
+    currentJitter.y /= viewportExtent.height;
 
     pSceneData->jitter = taaSettings.bEnabled ? glm::vec4(currentJitter.x, currentJitter.y, prevJitter.x, prevJitter.y) : glm::vec4(0.0f);
 
@@ -478,8 +724,11 @@ void Engine::updateRender(VkCommandBuffer cmd, const float deltaTime, const int3
     pSceneData->cameraWorldPos = fallbackCamera->getPosition();
 
 
-    pSceneData->renderTargetSize = {renderContext->renderExtent.width, renderContext->renderExtent.height};
-    pSceneData->texelSize = 1.0f / pSceneData->renderTargetSize;
+    pSceneData->renderTargetSize = {viewportExtent.width, viewportExtent.height};
+    pSceneData->texelSize = 1.0f / glm::vec2(renderExtent.width, renderExtent.height);
+    const glm::vec2 viewportScale = pSceneData->renderTargetSize * pSceneData->texelSize;
+    const glm::vec2 prevViewportScale = bIsFrameZero ? viewportScale : glm::vec2(pPreviousSceneData->viewportScale);
+    pSceneData->viewportScale = glm::vec4(viewportScale, prevViewportScale);
     pSceneData->cameraPlanes = {fallbackCamera->getNearPlane(), fallbackCamera->getFarPlane()};
     pSceneData->mainLightData = mainLight.getData();
     pSceneData->deltaTime = deltaTime;
@@ -500,6 +749,7 @@ void Engine::updateRender(VkCommandBuffer cmd, const float deltaTime, const int3
 
 void Engine::updateDebug(float deltaTime)
 {
+    WILL_PROFILE_ZONE("Update Debug");
 #if WILL_ENGINE_DEBUG_DRAW
     if (selectedItem) {
         if (const auto gameObject = dynamic_cast<game::GameObject*>(selectedItem)) {
@@ -537,6 +787,8 @@ void Engine::updateDebug(float deltaTime)
 #endif
 
 #if WILL_ENGINE_DEBUG_DRAW
+    // Demo grid, kept out of headless runs so it doesn't skew benchmarks
+    if (headlessSettings.bEnabled) { return; }
     constexpr glm::vec3 offset{-100, 100, 0};
     for (int32_t i{0}; i < 100; i++) {
         for (int32_t j{0}; j < 100; j++) {
@@ -547,21 +799,50 @@ void Engine::updateDebug(float deltaTime)
 #endif
 }
 
-void Engine::render(float deltaTime)
+void Engine::waitForFrameSlot()
 {
-    // GPU -> VPU sync (fence)
+    WILL_PROFILE_ZONE("Frame Pacing Wait");
+    profiler.beginTimer(ENGINE_TIMER_FRAME_PACING_WAIT);
+
+    // GPU -> CPU sync (fence), the slot's per-frame resources are free once its last frame completes
     VK_CHECK(vkWaitForFences(context->device, 1, &getCurrentFrame()._renderFence, true, 1000000000));
-    VK_CHECK(vkResetFences(context->device, 1, &getCurrentFrame()._renderFence));
+
+    // Fewer frames in flight than slots, so also wait for the frame submitted framesInFlight frames ago
+    const int32_t framesInFlight = framePacingSettings.framesInFlight;
+    if (framesInFlight < FRAME_OVERLAP && frameNumber >= framesInFlight) {
+        const FrameData& pacingFrame = frames[(frameNumber - framesInFlight) % FRAME_OVERLAP];
+        VK_CHECK(vkWaitForFences(context->device, 1, &pacingFrame._renderFence, true, 1000000000));
+    }
+
+    profiler.endTimer(ENGINE_TIMER_FRAME_PACING_WAIT);
+    bFrameSlotReady = true;
+}
+
+void Engine::render(float deltaTime)
+{
+    WILL_PROFILE_ZONE("Render");
+    WILL_MEMORY_TAG(Renderer);
+    if (!bFrameSlotReady) {
+        waitForFrameSlot();
+    }
+    bFrameSlotReady = false;
 
     // GPU -> GPU sync (semaphore)
-    uint32_t swapchainImageIndex;
-    VkResult e = vkAcquireNextImageKHR(context->device, swapchain, 1000000000, getCurrentFrame()._swapchainSemaphore, nullptr, &swapchainImageIndex);
-    if (e == VK_ERROR_OUT_OF_DATE_KHR || e == VK_SUBOPTIMAL_KHR) {
-        bWindowChanged = true;
-        fmt::print("Swapchain out of date or suboptimal (Acquire)\n");
-        return;
+    uint32_t swapchainImageIndex{0};
+    if (!headlessSettings.bEnabled) {
+        VkResult e = vkAcquireNextImageKHR(context->device, swapchain, 1000000000, getCurrentFrame()._swapchainSemaphore, nullptr, &swapchainImageIndex);
+        if (e == VK_ERROR_OUT_OF_DATE_KHR || e == VK_SUBOPTIMAL_KHR) {
+            bWindowChanged = true;
+            fmt::print("Swapchain out of date or suboptimal (Acquire)\n");
+            // Nothing is presented this frame
+            profiler.cancelTimer(ENGINE_TIMER_INPUT_TO_PRESENT);
+            return;
+        }
     }
 
+    // Only reset once a submission is guaranteed, frame pacing waits on the fences of other slots
+    VK_CHECK(vkResetFences(context->device, 1, &getCurrentFrame()._renderFence));
+
     int32_t currentFrameOverlap = getCurrentFrameOverlap();
     int32_t previousFrameOverlap = getPreviousFrameOverlap();
 
@@ -574,7 +855,11 @@ void Engine::render(float deltaTime)
     // only submit once
     VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
 
-    profiler.beginTimer("2Render");
+    profiler.beginTimer(ENGINE_TIMER_RENDER);
+
+    gpuProfiler->beginFrame(cmd, currentFrameOverlap);
+    // Picks this frame's rendered region from the GPU time of the last frame that used this command buffer
+    renderContext->setViewportScale(dynamicResolution->beginFrame());
 
     const std::vector<renderer::RenderObject*>& allRenderObjects = assetManager->getAllRenderObjects();
 
@@ -585,9 +870,10 @@ void Engine::render(float deltaTime)
 
     for (ITerrain* terrain : activeTerrains) {
         if (auto chunk = terrain->getTerrainChunk()) {
-            chunk->update(currentFrameOverlap, previousFrameOverlap);
+            chunk->update(cmd, currentFrameOverlap, previousFrameOverlap);
         }
     }
+    terrainPipeline->updatePatchBounds(cmd, activeTerrains);
 
     // Updates Scene Data buffer
     updateRender(cmd, deltaTime, currentFrameOverlap, previousFrameOverlap);
@@ -598,398 +884,54 @@ void Engine::render(float deltaTime)
     // Updates Cascaded Shadow Map Properties
     cascadedShadowMap->update(mainLight, fallbackCamera, currentFrameOverlap);
 
-    // Clear Color
-    {
-        constexpr VkClearColorValue clearColor = {0.0f, 0.0f, 0.0f, 0.0f};
-#if WILL_ENGINE_DEBUG_DRAW
-        constexpr uint32_t COLOR_IMAGE_COUNT = 8;
-#else
-        constexpr uint32_t COLOR_IMAGE_COUNT = 7;
-#endif
-        // History buffer is not reset
-        std::array colorImages = {
-            drawImage.get(),
-            normalRenderTarget.get(),
-            albedoRenderTarget.get(),
-            pbrRenderTarget.get(),
-            velocityRenderTarget.get(),
-            taaResolveTarget.get(),
-            finalImageBuffer.get(),
-#if WILL_ENGINE_DEBUG_DRAW
-            debugTarget.get(),
-#endif
-        };
-
-        std::array<VkImageMemoryBarrier2, COLOR_IMAGE_COUNT + 1> barriers{};
-
-        for (uint32_t i = 0; i < COLOR_IMAGE_COUNT; ++i) {
-            VkImageMemoryBarrier2& barrier = barriers[i];
-            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
-            barrier.pNext = nullptr;
-            barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
-            barrier.srcAccessMask = VK_ACCESS_2_NONE;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-            barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.subresourceRange = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .baseMipLevel = 0,
-                .levelCount = 1,
-                .baseArrayLayer = 0,
-                .layerCount = 1
-            };
-            barrier.image = colorImages[i]->image;
-            colorImages[i]->imageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        }
-
-        VkImageMemoryBarrier2& depthBarrier = barriers[COLOR_IMAGE_COUNT];
-        depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
-        depthBarrier.pNext = nullptr;
-        depthBarrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
-        depthBarrier.srcAccessMask = VK_ACCESS_2_NONE;
-        depthBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        depthBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        depthBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-        depthBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        depthBarrier.subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1
-        };
-        depthBarrier.image = depthStencilImage->image;
-        depthStencilImage->imageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-
-        VkDependencyInfo depInfo{};
-        depInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-        depInfo.pNext = nullptr;
-        depInfo.imageMemoryBarrierCount = COLOR_IMAGE_COUNT + 1;
-        depInfo.pImageMemoryBarriers = barriers.data();
-        vkCmdPipelineBarrier2(cmd, &depInfo);
-
-        VkImageSubresourceRange colorRange{
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1
-        };
-
-        for (renderer::RenderTarget* rt : colorImages) {
-            vkCmdClearColorImage(cmd, rt->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &colorRange);
-        }
-
-        VkClearDepthStencilValue depthClear = {0.0f, 0};
-        VkImageSubresourceRange depthRange{
-            .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1
-        };
-
-        vkCmdClearDepthStencilImage(cmd, depthStencilImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &depthClear, 1, &depthRange);
-
-        for (uint32_t i = 0; i < COLOR_IMAGE_COUNT; ++i) {
-            VkImageMemoryBarrier2& barrier = barriers[i];
-            barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-            barrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-            barrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = colorImages[i]->afterClearFormat;
-            colorImages[i]->imageLayout = colorImages[i]->afterClearFormat;
-        }
-
-        VkImageMemoryBarrier2& finalDepthBarrier = barriers[COLOR_IMAGE_COUNT];
-        finalDepthBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        finalDepthBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-        finalDepthBarrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
-        finalDepthBarrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        finalDepthBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        finalDepthBarrier.newLayout = depthStencilImage->afterClearFormat;
-        depthStencilImage->imageLayout = depthStencilImage->afterClearFormat;
-
-        VkDependencyInfo finalDep{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-        finalDep.imageMemoryBarrierCount = COLOR_IMAGE_COUNT + 1;
-        finalDep.pImageMemoryBarriers = barriers.data();
-        vkCmdPipelineBarrier2(cmd, &finalDep);
-    }
-
-    renderer::VisibilityPassDrawInfo deferredFrustumCullDrawInfo{
-        currentFrameOverlap,
-        allRenderObjects,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-        true,
-    };
-#if WILL_ENGINE_DEBUG
-    if (bFreezeVisibilitySceneData) {
-        deferredFrustumCullDrawInfo.sceneDataOffset = sceneDataDescriptorBuffer->getDescriptorBufferSize() * FRAME_OVERLAP;
-    }
-#endif
-
-    visibilityPassPipeline->draw(cmd, deferredFrustumCullDrawInfo);
-
-    renderer::CascadedShadowMapDrawInfo csmDrawInfo{
-        csmSettings.bEnabled,
-        currentFrameOverlap,
-        allRenderObjects,
-        activeTerrains,
-    };
-
-    cascadedShadowMap->draw(cmd, csmDrawInfo);
-
-    renderer::EnvironmentDrawInfo environmentPipelineDrawInfo{
-        renderContext->renderExtent,
-        normalRenderTarget->imageView,
-        albedoRenderTarget->imageView,
-        pbrRenderTarget->imageView,
-        velocityRenderTarget->imageView,
-        depthImageView->imageView,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-        environmentMap->getCubemapDescriptorBuffer()->getBindingInfo(),
-        environmentMap->getCubemapDescriptorBuffer()->getDescriptorBufferSize() * environmentMapIndex,
-    };
-    environmentPipeline->draw(cmd, environmentPipelineDrawInfo);
-
-    renderer::TerrainDrawInfo terrainDrawInfo{
-        false,
-        currentFrameOverlap,
-        renderContext->renderExtent,
-        activeTerrains,
-        normalRenderTarget->imageView,
-        albedoRenderTarget->imageView,
-        pbrRenderTarget->imageView,
-        velocityRenderTarget->imageView,
-        depthImageView->imageView,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-    };
-    terrainPipeline->draw(cmd, terrainDrawInfo);
-
-    const renderer::DeferredMrtDrawInfo deferredMrtDrawInfo{
-        false,
-        currentFrameOverlap,
-        renderContext->renderExtent,
-        allRenderObjects,
-        normalRenderTarget->imageView,
-        albedoRenderTarget->imageView,
-        pbrRenderTarget->imageView,
-        velocityRenderTarget->imageView,
-        depthImageView->imageView,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-    };
-    deferredMrtPipeline->draw(cmd, deferredMrtDrawInfo);
-
-    renderer::TransparentAccumulateDrawInfo transparentDrawInfo{
-        true,
-        renderContext->renderExtent,
-        depthImageView->imageView,
-        currentFrameOverlap,
-        allRenderObjects,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-        environmentMap->getDiffSpecMapDescriptorBuffer()->getBindingInfo(),
-        environmentMap->getDiffSpecMapDescriptorBuffer()->getDescriptorBufferSize() * environmentMapIndex,
-        cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getBindingInfo(),
-        cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getDescriptorBufferSize() * currentFrameOverlap,
-        cascadedShadowMap->getCascadedShadowMapSamplerBuffer()->getBindingInfo(),
-    };
-    if (bDrawTransparents) {
-        transparentPipeline->drawAccumulate(cmd, transparentDrawInfo);
-    }
-
-    renderer::vk_helpers::imageBarrier(cmd, drawImage.get(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, depthStencilImage.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, normalRenderTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, albedoRenderTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, pbrRenderTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, velocityRenderTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-
-
-    renderer::GTAODrawInfo gtaoDrawInfo{
-        renderContext->renderExtent,
-        fallbackCamera,
-        gtaoSettings.bEnabled,
-        gtaoSettings.pushConstants,
-        frameNumber,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-    };
-    ambientOcclusionPipeline->draw(cmd, gtaoDrawInfo);
-
-    renderer::ContactShadowsDrawInfo contactDrawInfo{
-        fallbackCamera,
-        mainLight,
-        sssSettings.bEnabled,
-        sssSettings.pushConstants,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-    };
-
-    contactShadowsPipeline->draw(cmd, contactDrawInfo);
-
-    const renderer::DeferredResolveDrawInfo deferredResolveDrawInfo{
-        deferredDebug,
-        csmSettings.pcfLevel,
-        renderContext->renderExtent,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-        environmentMap->getDiffSpecMapDescriptorBuffer()->getBindingInfo(),
-        environmentMap->getDiffSpecMapDescriptorBuffer()->getDescriptorBufferSize() * environmentMapIndex,
-        cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getBindingInfo(),
-        cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getDescriptorBufferSize() * currentFrameOverlap,
-        cascadedShadowMap->getCascadedShadowMapSamplerBuffer()->getBindingInfo(),
-        fallbackCamera->getNearPlane(),
-        fallbackCamera->getFarPlane(),
-        bEnableShadows,
-        bEnableContactShadows
-    };
-    deferredResolvePipeline->draw(cmd, deferredResolveDrawInfo);
-
-    renderer::vk_helpers::imageBarrier(cmd, drawImage.get(), VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::TransparentCompositeDrawInfo compositeDrawInfo{
-        renderContext->renderExtent,
-        drawImage->imageView
-    };
-    if (bDrawTransparents) {
-        transparentPipeline->drawComposite(cmd, compositeDrawInfo);
-    }
-
-    renderer::vk_helpers::imageBarrier(cmd, drawImage.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, historyBuffer.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-
-    const renderer::TemporalAntialiasingDrawInfo taaDrawInfo{
-        taaSettings.blendValue,
-        taaSettings.bEnabled ? 0 : 1,
-        renderContext->renderExtent,
-        sceneDataDescriptorBuffer->getBindingInfo(),
-        sceneDataDescriptorBuffer->getDescriptorBufferSize() * currentFrameOverlap
-    };
-    temporalAntialiasingPipeline->draw(cmd, taaDrawInfo);
-
-    // Copy to TAA History
-    renderer::vk_helpers::imageBarrier(cmd, taaResolveTarget.get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, historyBuffer.get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::copyImageToImage(cmd, taaResolveTarget->image, historyBuffer->image, taaResolveTarget->imageExtent,
-                                           historyBuffer->imageExtent);
-    renderer::vk_helpers::imageBarrier(cmd, taaResolveTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-
-
-    const renderer::PostProcessDrawInfo postProcessDrawInfo{
-        postProcessData,
-        renderContext->renderExtent,
-        sceneDataBinding,
-        sceneDataBufferOffset,
-    };
-
-    postProcessPipeline->draw(cmd, postProcessDrawInfo);
-
-#if WILL_ENGINE_DEBUG_DRAW
-    // Ensure all real rendering happens before this step, as debug draws do write to the depth buffer.
-    // This should ALWAYS be the final step before copying to swapchain
-    if (bDrawDebugRendering) {
-        renderer::vk_helpers::imageBarrier(cmd, depthStencilImage.get(), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                                           VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-
+    frameRenderContext.currentFrameOverlap = currentFrameOverlap;
+    frameRenderContext.swapchainImageIndex = swapchainImageIndex;
+    frameRenderContext.sceneDataBinding = sceneDataBinding;
+    frameRenderContext.sceneDataBufferOffset = sceneDataBufferOffset;
+    frameRenderContext.bHighlightStencilDrawn = false;
 
-        renderer::DebugRendererDrawInfo debugRendererDrawInfo{
-            currentFrameOverlap,
-            renderContext->renderExtent,
-            debugTarget->imageView,
-            depthImageView->imageView,
-            sceneDataBinding,
-            sceneDataBufferOffset,
-        };
+    // All passes, barriers and layout transitions are recorded by the render graph
+    renderGraph->setImportedImage(swapchainGraphImage, swapchainImages[swapchainImageIndex]);
+    renderGraph->setImportedImage(taaResolveGraphImage, taaHistoryBuffers[taaHistoryIndex].get());
+    renderGraph->setImportedImage(taaHistoryGraphImage, taaHistoryBuffers[1 - taaHistoryIndex].get());
+    // With async compute, the graph submits the work before the compute passes itself and returns the command buffer holding the rest
+    VkCommandBuffer finalCmd = renderGraph->execute(cmd, currentFrameOverlap, gpuProfiler);
+    // This frame's resolve is the next frame's history
+    taaHistoryIndex = 1 - taaHistoryIndex;
 
-        debugRenderer->draw(cmd, debugRendererDrawInfo);
-
-        bool stencilDrawn = false;
-
-        renderer::DebugHighlighterDrawInfo highlightDrawInfo{
-            {},
-            renderContext->renderExtent,
-            depthStencilImage->imageView,
-            sceneDataBinding,
-            sceneDataBufferOffset,
-        };
-
-
-        if (auto cc = dynamic_cast<IComponentContainer*>(selectedItem)) {
-            std::vector<renderer::IRenderable*> meshRenderers = cc->getComponentsImplementing<renderer::IRenderable>();
-            if (!meshRenderers.empty()) {
-                highlightDrawInfo.highlightTargets = meshRenderers;
-                stencilDrawn = debugHighlighter->drawHighlightStencil(cmd, highlightDrawInfo);
-            }
-        }
-
-        if (stencilDrawn) {
-            renderer::vk_helpers::imageBarrier(cmd, debugTarget.get(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
-            renderer::vk_helpers::imageBarrier(cmd, depthStencilImage.get(), VK_IMAGE_LAYOUT_GENERAL,
-                                               VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-
-            debugHighlighter->drawHighlightProcessing(cmd, highlightDrawInfo);
-
-
-            renderer::vk_helpers::imageBarrier(cmd, debugTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-        }
-        else {
-            renderer::vk_helpers::imageBarrier(cmd, debugTarget.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-        }
-
-
-        renderer::DebugCompositePipelineDrawInfo drawInfo{
-            renderContext->renderExtent,
-            sceneDataBinding,
-            sceneDataBufferOffset,
-        };
-
-        // Composite all draws in the debug image into `finalImageBuffer`
-        debugPipeline->draw(cmd, drawInfo);
-    }
-#endif
-    renderer::vk_helpers::imageBarrier(cmd, finalImageBuffer.get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::imageBarrier(cmd, swapchainImages[swapchainImageIndex], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                       VK_IMAGE_ASPECT_COLOR_BIT);
-    renderer::vk_helpers::copyImageToImage(cmd, finalImageBuffer->image, swapchainImages[swapchainImageIndex], finalImageBuffer->imageExtent,
-                                           swapchainExtent);
-
-    if (engine_constants::useImgui) {
-        renderer::vk_helpers::imageBarrier(cmd, swapchainImages[swapchainImageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                           VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-        imguiWrapper->drawImgui(cmd, swapchainImageViews[swapchainImageIndex], swapchainExtent);
-
-        renderer::vk_helpers::imageBarrier(cmd, swapchainImages[swapchainImageIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                           VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                                           VK_IMAGE_ASPECT_COLOR_BIT);
-    }
-    else {
-        renderer::vk_helpers::imageBarrier(cmd, swapchainImages[swapchainImageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                           VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_ASPECT_COLOR_BIT);
-    }
+    gpuProfiler->endFrame(finalCmd);
 
     // End Command Buffer Recording
-    VK_CHECK(vkEndCommandBuffer(cmd));
+    VK_CHECK(vkEndCommandBuffer(finalCmd));
 
-    profiler.endTimer("2Render");
+    profiler.endTimer(ENGINE_TIMER_RENDER);
 
     // Submission
-    const VkCommandBufferSubmitInfo cmdSubmitInfo = renderer::vk_helpers::commandBufferSubmitInfo(cmd);
-    const VkSemaphoreSubmitInfo waitInfo = renderer::vk_helpers::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
-                                                                                     getCurrentFrame()._swapchainSemaphore);
+    const VkCommandBufferSubmitInfo cmdSubmitInfo = renderer::vk_helpers::commandBufferSubmitInfo(finalCmd);
+    const std::vector<VkSemaphoreSubmitInfo>& graphWaitInfos = renderGraph->getFinalWaitSemaphores();
+    submitWaitInfos.assign(graphWaitInfos.begin(), graphWaitInfos.end());
     const VkSemaphoreSubmitInfo signalInfo =
             renderer::vk_helpers::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, getCurrentFrame()._renderSemaphore);
-    const VkSubmitInfo2 submit = renderer::vk_helpers::submitInfo(&cmdSubmitInfo, &signalInfo, &waitInfo);
+    // Nothing is acquired or presented in headless mode
+    const bool bPresent = !headlessSettings.bEnabled;
+    if (bPresent) {
+        submitWaitInfos.push_back(renderer::vk_helpers::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                                                                      getCurrentFrame()._swapchainSemaphore));
+    }
+    VkSubmitInfo2 submit = renderer::vk_helpers::submitInfo(&cmdSubmitInfo, bPresent ? &signalInfo : nullptr, nullptr);
+    submit.waitSemaphoreInfoCount = static_cast<uint32_t>(submitWaitInfos.size());
+    submit.pWaitSemaphoreInfos = submitWaitInfos.data();
 
     //submit command buffer to the queue and execute it.
     // _renderFence will now block until the graphic commands finish execution
     VK_CHECK(vkQueueSubmit2(context->graphicsQueue, 1, &submit, getCurrentFrame()._renderFence));
 
+    if (!bPresent) {
+        frameNumber++;
+        renderContext->advanceFrame();
+        return;
+    }
+
 
     // Present
     VkPresentInfoKHR presentInfo = {};
@@ -1004,6 +946,7 @@ void Engine::render(float deltaTime)
     presentInfo.pImageIndices = &swapchainImageIndex;
 
     VkResult presentResult = vkQueuePresentKHR(context->graphicsQueue, &presentInfo);
+    profiler.endTimer(ENGINE_TIMER_INPUT_TO_PRESENT);
 
     //increase the number of frames drawn
     frameNumber++;
@@ -1039,6 +982,7 @@ void Engine::cleanup()
     vkDeviceWaitIdle(context->device);
 
     delete visibilityPassPipeline;
+    delete lightCullingPipeline;
     delete environmentPipeline;
     delete terrainPipeline;
     delete deferredMrtPipeline;
@@ -1069,17 +1013,7 @@ void Engine::cleanup()
         vkDestroySemaphore(context->device, frame._swapchainSemaphore, nullptr);
     }
 
-    resourceManager->destroyResource(std::move(drawImage));
-    resourceManager->destroyResource(std::move(depthStencilImage));
-    resourceManager->destroyResource(std::move(depthImageView));
-    resourceManager->destroyResource(std::move(stencilImageView));
-    resourceManager->destroyResource(std::move(normalRenderTarget));
-    resourceManager->destroyResource(std::move(albedoRenderTarget));
-    resourceManager->destroyResource(std::move(pbrRenderTarget));
-    resourceManager->destroyResource(std::move(velocityRenderTarget));
-    resourceManager->destroyResource(std::move(taaResolveTarget));
-    resourceManager->destroyResource(std::move(historyBuffer));
-    resourceManager->destroyResource(std::move(finalImageBuffer));
+    destroyDrawResources();
 
     for (const auto& map : activeMaps) {
         map->destroy();
@@ -1097,28 +1031,39 @@ void Engine::cleanup()
     hierarchicalDeletionQueue.clear();
     hierarchalBeginQueue.clear();
 
+    terrain::TerrainManager::set(nullptr);
+    delete terrainManager;
+    delete terrainGenerator;
+
     delete assetManager;
 
     delete cascadedShadowMap;
     delete environmentMap;
 #if WILL_ENGINE_DEBUG_DRAW
-    resourceManager->destroyResource(std::move(debugTarget));
     delete debugRenderer;
     delete debugHighlighter;
     delete debugPipeline;
 #endif
     delete physics;
+    delete dynamicResolution;
+    delete gpuProfiler;
     delete immediate;
+    // Owns the image and view listed as the swapchain's
+    resourceManager->destroyResource(std::move(headlessTarget));
     delete resourceManager;
 
-    vkDestroySwapchainKHR(context->device, swapchain, nullptr);
-    for (const VkImageView swapchainImageView : swapchainImageViews) {
-        vkDestroyImageView(context->device, swapchainImageView, nullptr);
+    if (swapchain != VK_NULL_HANDLE) {
+        vkDestroySwapchainKHR(context->device, swapchain, nullptr);
+        for (const VkImageView swapchainImageView : swapchainImageViews) {
+            vkDestroyImageView(context->device, swapchainImageView, nullptr);
+        }
     }
 
     delete context;
 
-    SDL_DestroyWindow(window);
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
 }
 
 #if WILL_ENGINE_DEBUG_DRAW
@@ -1187,26 +1132,120 @@ void Engine::removeFromActiveTerrain(ITerrain* terrain)
     }
 }
 
+void Engine::addToActiveLights(ILocalLightSource* light)
+{
+    activeLights.insert(light);
+}
+
+void Engine::removeFromActiveLights(ILocalLightSource* light)
+{
+    activeLights.erase(light);
+}
+
 void Engine::createSwapchain(const uint32_t width, const uint32_t height)
 {
     vkb::SwapchainBuilder swapchainBuilder{context->physicalDevice, context->device, context->surface};
 
     swapchainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
 
+    // Writing the swapchain from compute needs storage usage on the surface and storage image support for its format
+    VkSurfaceCapabilitiesKHR surfaceCapabilities{};
+    VK_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(context->physicalDevice, context->surface, &surfaceCapabilities));
+    VkFormatProperties formatProperties{};
+    vkGetPhysicalDeviceFormatProperties(context->physicalDevice, swapchainImageFormat, &formatProperties);
+    bSwapchainStorage = (surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) != 0
+                        && (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+
+    // Transfer destination is kept for the copy fallback
+    VkImageUsageFlags swapchainUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (bSwapchainStorage) {
+        swapchainUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    uint32_t presentModeCount{0};
+    VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(context->physicalDevice, context->surface, &presentModeCount, nullptr));
+    supportedPresentModes.resize(presentModeCount);
+    VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(context->physicalDevice, context->surface, &presentModeCount, supportedPresentModes.data()));
+
+    // FIFO is the only mode every surface has to support
+    VkPresentModeKHR presentMode = framePacingSettings.presentMode;
+    if (std::ranges::find(supportedPresentModes, presentMode) == supportedPresentModes.end()) {
+        fmt::print("Warning: {} is not supported by the surface, falling back to FIFO\n", string_VkPresentModeKHR(presentMode));
+        presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    }
+
     vkb::Swapchain vkbSwapchain = swapchainBuilder
             .set_desired_format(VkSurfaceFormatKHR{.format = swapchainImageFormat, .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR})
-            .set_desired_present_mode(PRESENT_MODE)
+            .set_desired_present_mode(presentMode)
             .set_desired_extent(width, height)
-            .add_image_usage_flags(VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+            .add_image_usage_flags(swapchainUsage)
             .build()
             .value();
 
+    // The desired format is only a preference, the storage shaders write rgba8
+    if (vkbSwapchain.image_format != swapchainImageFormat) {
+        fmt::print("Warning: Swapchain format is not R8G8B8A8_UNORM, copying the final image to the swapchain instead\n");
+        bSwapchainStorage = false;
+        swapchainImageFormat = vkbSwapchain.image_format;
+    }
+
     swapchainExtent = {vkbSwapchain.extent.width, vkbSwapchain.extent.height, 1};
 
     // Swapchain and SwapchainImages
     swapchain = vkbSwapchain.swapchain;
     swapchainImages = vkbSwapchain.get_images().value();
     swapchainImageViews = vkbSwapchain.get_image_views().value();
+    bSwapchainOutdated = false;
+}
+
+void Engine::recreateSwapchain()
+{
+    vkDestroySwapchainKHR(context->device, swapchain, nullptr);
+    for (const auto swapchainImage : swapchainImageViews) {
+        vkDestroyImageView(context->device, swapchainImage, nullptr);
+    }
+
+    createSwapchain(renderContext->windowExtent.width, renderContext->windowExtent.height);
+    if (bSwapchainStorage) {
+        // Post process and debug composite reference the swapchain image views
+        setupDescriptorBuffers();
+    }
+}
+
+void Engine::createHeadlessTarget(const uint32_t width, const uint32_t height)
+{
+    swapchainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    swapchainExtent = {width, height, 1};
+
+    VkFormatProperties formatProperties{};
+    vkGetPhysicalDeviceFormatProperties(context->physicalDevice, swapchainImageFormat, &formatProperties);
+    bSwapchainStorage = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+
+    // Same usages the swapchain would have, plus transfer source to read the result back
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (bSwapchainStorage) {
+        usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    const VkImageCreateInfo imageCreateInfo = renderer::vk_helpers::imageCreateInfo(swapchainImageFormat, usage, swapchainExtent);
+    constexpr VmaAllocationCreateInfo allocInfo = {
+        .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+    };
+    VkImageViewCreateInfo imageViewCreateInfo = renderer::vk_helpers::imageviewCreateInfo(swapchainImageFormat, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
+    headlessTarget = resourceManager->createResource<renderer::RenderTarget>(imageCreateInfo, allocInfo, imageViewCreateInfo);
+
+    swapchainImages = {headlessTarget->image};
+    swapchainImageViews = {headlessTarget->imageView};
+}
+
+void Engine::setFramePacingSettings(const FramePacingSettings& settings)
+{
+    if (settings.presentMode != framePacingSettings.presentMode) {
+        bSwapchainOutdated = true;
+    }
+    framePacingSettings = settings;
+    framePacingSettings.framesInFlight = std::clamp(framePacingSettings.framesInFlight, 1, FRAME_OVERLAP);
 }
 
 game::Map* Engine::createMap(const std::filesystem::path& path)
@@ -1220,46 +1259,31 @@ game::Map* Engine::createMap(const std::filesystem::path& path)
 
 void Engine::createDrawResources(VkExtent3D extents)
 {
-    // Draw Image
+    // TAA History, written by the TAA pass and sampled by the next frame's TAA and this frame's post process
     {
-        VkImageUsageFlags drawImageUsages{};
-        drawImageUsages |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-        drawImageUsages |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        drawImageUsages |= VK_IMAGE_USAGE_STORAGE_BIT;
-        drawImageUsages |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-        drawImageUsages |= VK_IMAGE_USAGE_SAMPLED_BIT;
-        VkImageCreateInfo createInfo = renderer::vk_helpers::imageCreateInfo(DRAW_FORMAT, drawImageUsages, extents);
-
-        VmaAllocationCreateInfo renderImageAllocationInfo = {
-            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-            .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        };
+        VkImageUsageFlags historyBufferUsages{};
+        historyBufferUsages |= VK_IMAGE_USAGE_STORAGE_BIT;
+        historyBufferUsages |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        historyBufferUsages |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
+        const VkImageCreateInfo imageCreateInfo = renderer::vk_helpers::imageCreateInfo(DRAW_FORMAT, historyBufferUsages, extents);
 
-        VkImageViewCreateInfo renderViewInfo = renderer::vk_helpers::imageviewCreateInfo(DRAW_FORMAT, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
-        drawImage = resourceManager->createResource<renderer::RenderTarget>(createInfo, renderImageAllocationInfo, renderViewInfo,
-                                                                            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    }
-    // Depth Image
-    {
-        VkImageUsageFlags depthImageUsages{};
-        depthImageUsages |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-        depthImageUsages |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-        depthImageUsages |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        depthImageUsages |= VK_IMAGE_USAGE_SAMPLED_BIT;
-        VkImageCreateInfo depthImageInfo = renderer::vk_helpers::imageCreateInfo(DEPTH_STENCIL_FORMAT, depthImageUsages, extents);
-
-        constexpr VmaAllocationCreateInfo depthImageAllocationInfo = {
+        constexpr VmaAllocationCreateInfo allocInfo = {
             .usage = VMA_MEMORY_USAGE_GPU_ONLY,
             .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         };
 
+        VkImageViewCreateInfo imageViewCreateInfo = renderer::vk_helpers::imageviewCreateInfo(DRAW_FORMAT, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
+        for (renderer::RenderTargetPtr& historyBuffer : taaHistoryBuffers) {
+            historyBuffer = resourceManager->createResource<renderer::RenderTarget>(imageCreateInfo, allocInfo, imageViewCreateInfo);
+        }
+        taaHistoryIndex = 0;
+    }
 
-        VkImageViewCreateInfo combinedViewInfo = renderer::vk_helpers::imageviewCreateInfo(DEPTH_STENCIL_FORMAT, VK_NULL_HANDLE,
-                                                                                           VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-        depthStencilImage = resourceManager->createResource<renderer::RenderTarget>(depthImageInfo, depthImageAllocationInfo, combinedViewInfo,
-                                                                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    createRenderGraph(extents);
 
+    // Depth/Stencil Views
+    {
         VkImageViewCreateInfo depthViewInfo = renderer::vk_helpers::imageviewCreateInfo(depthStencilImage->imageFormat, depthStencilImage->image,
                                                                                         VK_IMAGE_ASPECT_DEPTH_BIT);
         VkImageViewCreateInfo stencilViewInfo = renderer::vk_helpers::imageviewCreateInfo(depthStencilImage->imageFormat, depthStencilImage->image,
@@ -1267,107 +1291,439 @@ void Engine::createDrawResources(VkExtent3D extents)
         depthImageView = resourceManager->createResource<renderer::ImageView>(depthViewInfo);
         stencilImageView = resourceManager->createResource<renderer::ImageView>(stencilViewInfo);
     }
-    // Render Targets
-    {
-        const auto generateRenderTarget = std::function([this, extents](const VkFormat renderTargetFormat) {
-            VkImageUsageFlags usageFlags{};
-            usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-            usageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
-            usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-            usageFlags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-            usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
-            const VkImageCreateInfo imageInfo = renderer::vk_helpers::imageCreateInfo(renderTargetFormat, usageFlags, extents);
-            constexpr VmaAllocationCreateInfo allocInfo = {
-                .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-                .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            };
-
-            VkImageViewCreateInfo imageViewInfo = renderer::vk_helpers::imageviewCreateInfo(
-                renderTargetFormat, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
-
-
-            return resourceManager->createResource<renderer::RenderTarget>(imageInfo, allocInfo, imageViewInfo,
-                                                                           VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-        });
-
-        normalRenderTarget = generateRenderTarget(NORMAL_FORMAT);
-        albedoRenderTarget = generateRenderTarget(ALBEDO_FORMAT);
-        pbrRenderTarget = generateRenderTarget(PBR_FORMAT);
-        velocityRenderTarget = generateRenderTarget(VELOCITY_FORMAT);
-    }
-    // TAA Resolve
-    {
-        VkImageUsageFlags taaResolveUsages{};
-        taaResolveUsages |= VK_IMAGE_USAGE_STORAGE_BIT;
-        taaResolveUsages |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-        taaResolveUsages |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        taaResolveUsages |= VK_IMAGE_USAGE_SAMPLED_BIT;
+}
 
-        const VkImageCreateInfo imageCreateInfo = renderer::vk_helpers::imageCreateInfo(DRAW_FORMAT, taaResolveUsages, extents);
+void Engine::destroyDrawResources()
+{
+    resourceManager->destroyResource(std::move(depthImageView));
+    resourceManager->destroyResource(std::move(stencilImageView));
+    for (renderer::RenderTargetPtr& historyBuffer : taaHistoryBuffers) {
+        resourceManager->destroyResource(std::move(historyBuffer));
+    }
 
-        constexpr VmaAllocationCreateInfo allocInfo = {
-            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-            .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        };
+    // Defers destruction of the transient render targets
+    delete renderGraph;
+    renderGraph = nullptr;
+    drawImage = nullptr;
+    depthStencilImage = nullptr;
+    normalRenderTarget = nullptr;
+    albedoRenderTarget = nullptr;
+    pbrRenderTarget = nullptr;
+    velocityRenderTarget = nullptr;
+    finalImageBuffer = nullptr;
+#if WILL_ENGINE_DEBUG_DRAW
+    debugTarget = nullptr;
+#endif
+}
 
-        VkImageViewCreateInfo imageViewCreateInfo = renderer::vk_helpers::imageviewCreateInfo(DRAW_FORMAT, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
+void Engine::createRenderGraph(const VkExtent3D extents)
+{
+    using renderer::RenderGraphAccess;
+    using renderer::RenderGraphImageHandle;
 
+    renderGraph = new renderer::RenderGraph(*resourceManager);
+    if (bAsyncCompute) {
+        renderGraph->enableAsyncCompute(*context);
+    }
 
-        taaResolveTarget = resourceManager->createResource<renderer::RenderTarget>(imageCreateInfo, allocInfo, imageViewCreateInfo,
-                                                                                   VK_IMAGE_LAYOUT_GENERAL);
+    // Transfer source so render targets can be saved from the editor
+    constexpr VkImageUsageFlags renderTargetUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+                                                    | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    constexpr VkImageUsageFlags computeTargetUsage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+    const RenderGraphImageHandle drawImageHandle = renderGraph->createImage("Draw Image", {DRAW_FORMAT, extents, renderTargetUsage});
+    const RenderGraphImageHandle depthHandle = renderGraph->createImage("Depth Stencil", {
+                                                                            DEPTH_STENCIL_FORMAT, extents,
+                                                                            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                                                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                                                            VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT
+                                                                        });
+    const RenderGraphImageHandle normalHandle = renderGraph->createImage("Normal", {NORMAL_FORMAT, extents, renderTargetUsage});
+    const RenderGraphImageHandle albedoHandle = renderGraph->createImage("Albedo", {ALBEDO_FORMAT, extents, renderTargetUsage});
+    const RenderGraphImageHandle pbrHandle = renderGraph->createImage("PBR", {PBR_FORMAT, extents, renderTargetUsage});
+    const RenderGraphImageHandle velocityHandle = renderGraph->createImage("Velocity", {VELOCITY_FORMAT, extents, renderTargetUsage});
+    // Not needed if the post process writes the swapchain directly
+    RenderGraphImageHandle finalImageHandle{renderer::INVALID_RENDER_GRAPH_IMAGE};
+    if (!bSwapchainStorage) {
+        finalImageHandle = renderGraph->createImage("Final Image", {DRAW_FORMAT, extents, computeTargetUsage});
     }
-    // Draw History
-    {
-        VkImageUsageFlags historyBufferUsages{};
-        historyBufferUsages |= VK_IMAGE_USAGE_SAMPLED_BIT;
-        historyBufferUsages |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+#if WILL_ENGINE_DEBUG_DRAW
+    // Debug Output (Gizmos, Debug Draws, etc. Output here before combined w/ final image. Goes around normal pass stuff. Expects inputs to be jittered because to test against depth buffer, fragments need to be jittered cause depth buffer is jittered)
+    const RenderGraphImageHandle debugHandle = renderGraph->createImage("Debug", {
+                                                                            DEBUG_FORMAT, extents,
+                                                                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
+                                                                            VK_IMAGE_USAGE_SAMPLED_BIT
+                                                                        });
+#endif
 
-        const VkImageCreateInfo imageCreateInfo = renderer::vk_helpers::imageCreateInfo(DRAW_FORMAT, historyBufferUsages, extents);
+    // Ping-pong history buffers, which one is which is set every frame
+    taaResolveGraphImage = renderGraph->importImage("TAA Resolve", taaHistoryBuffers[0].get(), VK_IMAGE_ASPECT_COLOR_BIT);
+    renderGraph->markOutput(taaResolveGraphImage);
+    taaHistoryGraphImage = renderGraph->importImage("TAA History", taaHistoryBuffers[1].get(), VK_IMAGE_ASPECT_COLOR_BIT);
+    // The headless target is left ready to be copied out, present layouts need the swapchain extension
+    const VkImageLayout swapchainFinalLayout = headlessSettings.bEnabled ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    swapchainGraphImage = renderGraph->importImage("Swapchain", VK_IMAGE_ASPECT_COLOR_BIT, swapchainFinalLayout);
+    renderGraph->markOutput(swapchainGraphImage);
+    const RenderGraphImageHandle postProcessOutput = bSwapchainStorage ? swapchainGraphImage : finalImageHandle;
+
+    renderGraph->addPass("Visibility Pass", [this](VkCommandBuffer cmd) {
+        renderer::VisibilityPassDrawInfo deferredFrustumCullDrawInfo{
+            frameRenderContext.currentFrameOverlap,
+            assetManager->getAllRenderObjects(),
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+            true,
+        };
+#if WILL_ENGINE_DEBUG
+        if (bFreezeVisibilitySceneData) {
+            deferredFrustumCullDrawInfo.sceneDataOffset = sceneDataDescriptorBuffer->getDescriptorBufferSize() * FRAME_OVERLAP;
+        }
+#endif
 
-        constexpr VmaAllocationCreateInfo allocInfo = {
-            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-            .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        visibilityPassPipeline->draw(cmd, deferredFrustumCullDrawInfo);
+    }).setSideEffects();
+
+    renderGraph->addPass("Light Culling", [this](VkCommandBuffer cmd) {
+        frameLocalLights.clear();
+        for (ILocalLightSource* light : activeLights) {
+            if (LocalLightData lightData; light->getLocalLightData(lightData)) {
+                frameLocalLights.push_back(lightData);
+            }
+        }
+
+        const renderer::LightCullingDrawInfo lightCullingDrawInfo{
+            frameRenderContext.currentFrameOverlap,
+            frameLocalLights,
+            fallbackCamera->getViewMatrix(),
+            fallbackCamera->getNearPlane(),
+            fallbackCamera->getFarPlane(),
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
+        lightCullingPipeline->draw(cmd, lightCullingDrawInfo);
+    }).setSideEffects();
+
+    renderGraph->addPass("Environment", [this](VkCommandBuffer cmd) {
+        const renderer::EnvironmentDrawInfo environmentPipelineDrawInfo{
+            true,
+            renderContext->viewportExtent,
+            normalRenderTarget->imageView,
+            albedoRenderTarget->imageView,
+            pbrRenderTarget->imageView,
+            velocityRenderTarget->imageView,
+            depthImageView->imageView,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+            environmentMap->getCubemapDescriptorBuffer()->getBindingInfo(),
+            environmentMap->getCubemapDescriptorBuffer()->getDescriptorBufferSize() * environmentMapIndex,
+        };
+        environmentPipeline->draw(cmd, environmentPipelineDrawInfo);
+    })
+    .use(normalHandle, RenderGraphAccess::ColorAttachment)
+    .use(albedoHandle, RenderGraphAccess::ColorAttachment)
+    .use(pbrHandle, RenderGraphAccess::ColorAttachment)
+    .use(velocityHandle, RenderGraphAccess::ColorAttachment)
+    .use(depthHandle, RenderGraphAccess::DepthStencilAttachment);
+
+    renderGraph->addPass("Terrain", [this](VkCommandBuffer cmd) {
+        const renderer::TerrainDrawInfo terrainDrawInfo{
+            false,
+            frameRenderContext.currentFrameOverlap,
+            renderContext->viewportExtent,
+            activeTerrains,
+            normalRenderTarget->imageView,
+            albedoRenderTarget->imageView,
+            pbrRenderTarget->imageView,
+            velocityRenderTarget->imageView,
+            depthImageView->imageView,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+            terrainTessellationSettings,
+        };
+        terrainPipeline->draw(cmd, terrainDrawInfo);
+    })
+    .use(normalHandle, RenderGraphAccess::ColorAttachment)
+    .use(albedoHandle, RenderGraphAccess::ColorAttachment)
+    .use(pbrHandle, RenderGraphAccess::ColorAttachment)
+    .use(velocityHandle, RenderGraphAccess::ColorAttachment)
+    .use(depthHandle, RenderGraphAccess::DepthStencilAttachment);
+
+    renderGraph->addPass("Deferred MRT", [this](VkCommandBuffer cmd) {
+        const renderer::DeferredMrtDrawInfo deferredMrtDrawInfo{
+            false,
+            frameRenderContext.currentFrameOverlap,
+            renderContext->viewportExtent,
+            assetManager->getAllRenderObjects(),
+            normalRenderTarget->imageView,
+            albedoRenderTarget->imageView,
+            pbrRenderTarget->imageView,
+            velocityRenderTarget->imageView,
+            depthImageView->imageView,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
+        deferredMrtPipeline->draw(cmd, deferredMrtDrawInfo);
+    })
+    .use(normalHandle, RenderGraphAccess::ColorAttachment)
+    .use(albedoHandle, RenderGraphAccess::ColorAttachment)
+    .use(pbrHandle, RenderGraphAccess::ColorAttachment)
+    .use(velocityHandle, RenderGraphAccess::ColorAttachment)
+    .use(depthHandle, RenderGraphAccess::DepthStencilAttachment);
+
+    renderGraph->addPass("GTAO", [this](VkCommandBuffer cmd) {
+        const renderer::GTAODrawInfo gtaoDrawInfo{
+            renderContext->viewportExtent,
+            fallbackCamera,
+            gtaoSettings.bEnabled,
+            gtaoSettings.pushConstants,
+            gtaoSettings.bTemporalAccumulation,
+            frameNumber,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
+        ambientOcclusionPipeline->draw(cmd, gtaoDrawInfo);
+    })
+    .use(depthHandle, RenderGraphAccess::SampledCompute)
+    .use(normalHandle, RenderGraphAccess::SampledCompute)
+    .use(velocityHandle, RenderGraphAccess::SampledCompute)
+    .setSideEffects()
+    .setAsyncCompute();
+
+    renderGraph->addPass("Contact Shadows", [this](VkCommandBuffer cmd) {
+        const renderer::ContactShadowsDrawInfo contactDrawInfo{
+            renderContext->viewportExtent,
+            fallbackCamera,
+            mainLight,
+            sssSettings.bEnabled,
+            sssSettings.pushConstants,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
         };
 
-        VkImageViewCreateInfo imageViewCreateInfo = renderer::vk_helpers::imageviewCreateInfo(DRAW_FORMAT, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
-        historyBuffer = resourceManager->createResource<renderer::RenderTarget>(imageCreateInfo, allocInfo, imageViewCreateInfo,
-                                                                                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    }
-    // Final Image
-    {
-        VkImageUsageFlags usageFlags{};
-        usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-        usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-        usageFlags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
-        const VkImageCreateInfo imageCreateInfo = renderer::vk_helpers::imageCreateInfo(DRAW_FORMAT, usageFlags, extents);
+        contactShadowsPipeline->draw(cmd, contactDrawInfo);
+    })
+    .use(depthHandle, RenderGraphAccess::SampledCompute)
+    .setSideEffects()
+    .setAsyncCompute();
+
+    // Doesn't touch the G-Buffer, overlaps GTAO and contact shadows when they run on the compute queue
+    renderGraph->addPass("Cascaded Shadow Map", [this](VkCommandBuffer cmd) {
+        const renderer::CascadedShadowMapDrawInfo csmDrawInfo{
+            csmSettings.bEnabled,
+            frameRenderContext.currentFrameOverlap,
+            assetManager->getAllRenderObjects(),
+            activeTerrains,
+            terrainTessellationSettings,
+        };
 
-        constexpr VmaAllocationCreateInfo allocInfo = {
-            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-            .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        cascadedShadowMap->draw(cmd, csmDrawInfo);
+    }).setSideEffects();
+
+    // Accumulates into the transparent pipeline's own images
+    renderGraph->addPass("Transparent Accumulate", [this](VkCommandBuffer cmd) {
+        if (!bDrawTransparents) { return; }
+
+        const renderer::TransparentAccumulateDrawInfo transparentDrawInfo{
+            true,
+            renderContext->viewportExtent,
+            depthImageView->imageView,
+            frameRenderContext.currentFrameOverlap,
+            assetManager->getAllRenderObjects(),
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+            environmentMap->getDiffSpecMapDescriptorBuffer()->getBindingInfo(),
+            environmentMap->getDiffSpecMapDescriptorBuffer()->getDescriptorBufferSize() * environmentMapIndex,
+            cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getBindingInfo(),
+            cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getDescriptorBufferSize() * frameRenderContext.currentFrameOverlap,
+            cascadedShadowMap->getCascadedShadowMapSamplerBuffer()->getBindingInfo(),
+            lightCullingPipeline->getClusteredLightingData(),
+        };
+        transparentPipeline->drawAccumulate(cmd, transparentDrawInfo);
+    })
+    .use(depthHandle, RenderGraphAccess::DepthStencilAttachmentRead)
+    .setSideEffects();
+
+    renderGraph->addPass("Deferred Resolve", [this](VkCommandBuffer cmd) {
+        const renderer::DeferredResolveDrawInfo deferredResolveDrawInfo{
+            deferredDebug,
+            csmSettings.pcfLevel,
+            renderContext->viewportExtent,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+            environmentMap->getDiffSpecMapDescriptorBuffer()->getBindingInfo(),
+            environmentMap->getDiffSpecMapDescriptorBuffer()->getDescriptorBufferSize() * environmentMapIndex,
+            cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getBindingInfo(),
+            cascadedShadowMap->getCascadedShadowMapUniformBuffer()->getDescriptorBufferSize() * frameRenderContext.currentFrameOverlap,
+            cascadedShadowMap->getCascadedShadowMapSamplerBuffer()->getBindingInfo(),
+            fallbackCamera->getNearPlane(),
+            fallbackCamera->getFarPlane(),
+            bEnableShadows,
+            bEnableContactShadows,
+            lightCullingPipeline->getClusteredLightingData(),
+        };
+        deferredResolvePipeline->draw(cmd, deferredResolveDrawInfo);
+    })
+    .use(normalHandle, RenderGraphAccess::SampledCompute)
+    .use(albedoHandle, RenderGraphAccess::SampledCompute)
+    .use(pbrHandle, RenderGraphAccess::SampledCompute)
+    .use(depthHandle, RenderGraphAccess::SampledCompute)
+    .use(velocityHandle, RenderGraphAccess::SampledCompute)
+    .use(drawImageHandle, RenderGraphAccess::StorageWriteCompute)
+    // Samples the ambient occlusion and contact shadow images owned by their pipelines
+    .dependsOn("GTAO")
+    .dependsOn("Contact Shadows");
+
+    renderGraph->addPass("Transparent Composite", [this](VkCommandBuffer cmd) {
+        if (!bDrawTransparents) { return; }
+
+        const renderer::TransparentCompositeDrawInfo compositeDrawInfo{
+            renderContext->viewportExtent,
+            drawImage->imageView
+        };
+        transparentPipeline->drawComposite(cmd, compositeDrawInfo);
+    })
+    .use(drawImageHandle, RenderGraphAccess::ColorAttachment);
+
+    renderGraph->addPass("Temporal Antialiasing", [this](VkCommandBuffer cmd) {
+        const renderer::TemporalAntialiasingDrawInfo taaDrawInfo{
+            taaSettings.blendValue,
+            taaSettings.bEnabled ? 0 : 1,
+            taaHistoryIndex,
+            renderContext->viewportExtent,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
+        temporalAntialiasingPipeline->draw(cmd, taaDrawInfo);
+    })
+    .use(drawImageHandle, RenderGraphAccess::SampledCompute)
+    .use(taaHistoryGraphImage, RenderGraphAccess::SampledCompute)
+    .use(depthHandle, RenderGraphAccess::SampledCompute)
+    .use(velocityHandle, RenderGraphAccess::SampledCompute)
+    .use(taaResolveGraphImage, RenderGraphAccess::StorageWriteCompute);
+
+    renderGraph->addPass("Post Process", [this](VkCommandBuffer cmd) {
+        const renderer::PostProcessDrawInfo postProcessDrawInfo{
+            postProcessData,
+            taaHistoryIndex,
+            bSwapchainStorage ? static_cast<int32_t>(frameRenderContext.swapchainImageIndex) : 0,
+            bSwapchainStorage ? VkExtent2D{swapchainExtent.width, swapchainExtent.height} : renderContext->viewportExtent,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
         };
 
-        VkImageViewCreateInfo imageViewCreateInfo = renderer::vk_helpers::imageviewCreateInfo(DRAW_FORMAT, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
-        finalImageBuffer = resourceManager->createResource<renderer::RenderTarget>(imageCreateInfo, allocInfo, imageViewCreateInfo,
-                                                                                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    }
+        postProcessPipeline->draw(cmd, postProcessDrawInfo);
+    })
+    .use(taaResolveGraphImage, RenderGraphAccess::SampledCompute)
+    .use(postProcessOutput, RenderGraphAccess::StorageWriteCompute);
 
 #if WILL_ENGINE_DEBUG_DRAW
-    // Debug Output (Gizmos, Debug Draws, etc. Output here before combined w/ final image. Goes around normal pass stuff. Expects inputs to be jittered because to test against depth buffer, fragments need to be jittered cause depth buffer is jittered)
-    VkImageUsageFlags usageFlags{};
-    usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
-    usageFlags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-    const VkImageCreateInfo imageCreateInfo = renderer::vk_helpers::imageCreateInfo(DEBUG_FORMAT, usageFlags, extents);
-    constexpr VmaAllocationCreateInfo allocInfo = {
-        .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-    };
-    VkImageViewCreateInfo imageViewCreateInfo = renderer::vk_helpers::imageviewCreateInfo(DEBUG_FORMAT, VK_NULL_HANDLE, VK_IMAGE_ASPECT_COLOR_BIT);
-    debugTarget = resourceManager->createResource<renderer::RenderTarget>(imageCreateInfo, allocInfo, imageViewCreateInfo,
-                                                                          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    // Ensure all real rendering happens before this step, as debug draws do write to the depth buffer.
+    // This should ALWAYS be the final step before copying to swapchain
+    renderGraph->addPass("Debug Renderer", [this](VkCommandBuffer cmd) {
+        if (!bDrawDebugRendering) { return; }
+
+        const renderer::DebugRendererDrawInfo debugRendererDrawInfo{
+            true,
+            frameRenderContext.currentFrameOverlap,
+            renderContext->viewportExtent,
+            debugTarget->imageView,
+            depthImageView->imageView,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
 
+        debugRenderer->draw(cmd, debugRendererDrawInfo);
+    })
+    .use(debugHandle, RenderGraphAccess::ColorAttachment)
+    .use(depthHandle, RenderGraphAccess::DepthStencilAttachment);
+
+    renderGraph->addPass("Highlight Stencil", [this](VkCommandBuffer cmd) {
+        if (!bDrawDebugRendering) { return; }
+
+        if (auto cc = dynamic_cast<IComponentContainer*>(selectedItem)) {
+            std::vector<renderer::IRenderable*> meshRenderers = cc->getComponentsImplementing<renderer::IRenderable>();
+            if (!meshRenderers.empty()) {
+                const renderer::DebugHighlighterDrawInfo highlightDrawInfo{
+                    meshRenderers,
+                    renderContext->viewportExtent,
+                    depthStencilImage->imageView,
+                    frameRenderContext.sceneDataBinding,
+                    frameRenderContext.sceneDataBufferOffset,
+                };
+                frameRenderContext.bHighlightStencilDrawn = debugHighlighter->drawHighlightStencil(cmd, highlightDrawInfo);
+            }
+        }
+    })
+    .use(depthHandle, RenderGraphAccess::DepthStencilAttachment);
+
+    renderGraph->addPass("Highlight Outline", [this](VkCommandBuffer cmd) {
+        if (!frameRenderContext.bHighlightStencilDrawn) { return; }
+
+        const renderer::DebugHighlighterDrawInfo highlightDrawInfo{
+            {},
+            renderContext->viewportExtent,
+            depthStencilImage->imageView,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
+        debugHighlighter->drawHighlightProcessing(cmd, highlightDrawInfo);
+    })
+    .use(depthHandle, RenderGraphAccess::StorageReadCompute)
+    .use(debugHandle, RenderGraphAccess::StorageReadWriteCompute);
+
+    // Composite all draws in the debug image into `finalImageBuffer`, or the swapchain if post process wrote it directly
+    renderGraph->addPass("Debug Composite", [this](VkCommandBuffer cmd) {
+        if (!bDrawDebugRendering) { return; }
+
+        const renderer::DebugCompositePipelineDrawInfo drawInfo{
+            bSwapchainStorage ? VkExtent2D{swapchainExtent.width, swapchainExtent.height} : renderContext->viewportExtent,
+            bSwapchainStorage ? static_cast<int32_t>(frameRenderContext.swapchainImageIndex) : 0,
+            frameRenderContext.sceneDataBinding,
+            frameRenderContext.sceneDataBufferOffset,
+        };
+        debugPipeline->draw(cmd, drawInfo);
+    })
+    .use(debugHandle, RenderGraphAccess::SampledCompute)
+    .use(postProcessOutput, RenderGraphAccess::StorageReadWriteCompute);
 #endif
+
+    if (!bSwapchainStorage) {
+        renderGraph->addPass("Copy To Swapchain", [this](VkCommandBuffer cmd) {
+            // Upscales the rendered region of the final image
+            renderer::vk_helpers::copyImageToImage(cmd, finalImageBuffer->image, swapchainImages[frameRenderContext.swapchainImageIndex],
+                                                   renderContext->viewportExtent, swapchainExtent);
+        })
+        .use(finalImageHandle, RenderGraphAccess::TransferSrc)
+        .use(swapchainGraphImage, RenderGraphAccess::TransferDst);
+    }
+
+    if (imguiWrapper) {
+        renderGraph->addPass("Imgui", [this](VkCommandBuffer cmd) {
+            imguiWrapper->drawImgui(cmd, swapchainImageViews[frameRenderContext.swapchainImageIndex], swapchainExtent);
+        })
+        .use(swapchainGraphImage, RenderGraphAccess::ColorAttachment);
+    }
+
+    if (!renderGraph->compile(bAliasRenderTargets)) {
+        fmt::print("Warning: Failed to compile the render graph\n");
+    }
+
+    drawImage = renderGraph->getImage(drawImageHandle);
+    depthStencilImage = renderGraph->getImage(depthHandle);
+    normalRenderTarget = renderGraph->getImage(normalHandle);
+    albedoRenderTarget = renderGraph->getImage(albedoHandle);
+    pbrRenderTarget = renderGraph->getImage(pbrHandle);
+    velocityRenderTarget = renderGraph->getImage(velocityHandle);
+    finalImageBuffer = renderGraph->getImage(finalImageHandle);
+#if WILL_ENGINE_DEBUG_DRAW
+    debugTarget = renderGraph->getImage(debugHandle);
+#endif
+
+    const renderer::RenderGraphStatistics& statistics = renderGraph->getStatistics();
+    fmt::print("Render Graph: {} passes ({} culled), {} barriers, {} transient images in {} allocations ({:.1f} MB, {:.1f} MB without aliasing)\n",
+               statistics.passCount, statistics.culledPassCount, statistics.barrierCount, statistics.transientImageCount,
+               statistics.transientAllocationCount, statistics.transientAllocatedMemory / (1024.0 * 1024.0),
+               statistics.transientImageMemory / (1024.0 * 1024.0));
 }
 
 void Engine::setCsmSettings(const renderer::CascadedShadowMapSettings& settings)
@@ -1379,11 +1735,41 @@ void Engine::setCsmSettings(const renderer::CascadedShadowMapSettings& settings)
     }
 }
 
+void Engine::setAoSettings(const renderer::GTAOSettings& settings)
+{
+    const bool bResolutionChanged = settings.resolution != gtaoSettings.resolution;
+    gtaoSettings = settings;
+    if (ambientOcclusionPipeline && bResolutionChanged) {
+        // AO images are reallocated, previous frames may still be using them
+        vkDeviceWaitIdle(context->device);
+        ambientOcclusionPipeline->setResolution(gtaoSettings.resolution);
+    }
+}
+
+void Engine::setPhysicsSettings(const physics::PhysicsSettings& settings)
+{
+    physicsSettings = settings;
+    if (physics) {
+        physics->setPhysicsSettings(physicsSettings);
+        physicsSettings = physics->getPhysicsSettings();
+    }
+}
+
+void Engine::setTerrainStreamingSettings(const terrain::TerrainStreamingSettings& settings)
+{
+    terrainStreamingSettings = settings;
+    if (terrainManager) {
+        terrainManager->setStreamingSettings(terrainStreamingSettings);
+        terrainStreamingSettings = terrainManager->getStreamingSettings();
+    }
+}
+
 void Engine::hotReloadShaders() const
 {
     vkDeviceWaitIdle(context->device);
     cascadedShadowMap->reloadShaders();
     visibilityPassPipeline->reloadShaders();
+    lightCullingPipeline->reloadShaders();
     environmentPipeline->reloadShaders();
     terrainPipeline->reloadShaders();
     deferredMrtPipeline->reloadShaders();
@@ -1397,29 +1783,26 @@ void Engine::hotReloadShaders() const
 
 void Engine::handleResize(const renderer::ResolutionChangedEvent& event)
 {
-    resourceManager->destroyResource(std::move(drawImage));
-    resourceManager->destroyResource(std::move(depthStencilImage));
-    resourceManager->destroyResource(std::move(depthImageView));
-    resourceManager->destroyResource(std::move(stencilImageView));
-    resourceManager->destroyResource(std::move(normalRenderTarget));
-    resourceManager->destroyResource(std::move(albedoRenderTarget));
-    resourceManager->destroyResource(std::move(pbrRenderTarget));
-    resourceManager->destroyResource(std::move(velocityRenderTarget));
-    resourceManager->destroyResource(std::move(taaResolveTarget));
-    resourceManager->destroyResource(std::move(historyBuffer));
-    resourceManager->destroyResource(std::move(finalImageBuffer));
-#if WILL_ENGINE_DEBUG_DRAW
-    resourceManager->destroyResource(std::move(debugTarget));
-#endif
-
+    destroyDrawResources();
     createDrawResources({event.newExtent.width, event.newExtent.height, 1});
 }
 
+void Engine::recreateRenderGraph()
+{
+    vkDeviceWaitIdle(context->device);
+    destroyDrawResources();
+    createDrawResources({renderContext->renderExtent.width, renderContext->renderExtent.height, 1});
+    setupDescriptorBuffers();
+}
+
 void Engine::setupDescriptorBuffers() const
 {
-    ambientOcclusionPipeline->setupDepthPrefilterDescriptorBuffer(depthImageView->imageView);
-    ambientOcclusionPipeline->setupAmbientOcclusionDescriptorBuffer(normalRenderTarget->imageView);
-    ambientOcclusionPipeline->setupSpatialFilteringDescriptorBuffer();
+    const renderer::GTAODescriptor gtaoDescriptor{
+        depthImageView->imageView,
+        normalRenderTarget->imageView,
+        velocityRenderTarget->imageView,
+    };
+    ambientOcclusionPipeline->setupDescriptorBuffers(gtaoDescriptor);
     contactShadowsPipeline->setupDescriptorBuffer(depthImageView->imageView);
 
     const renderer::DeferredResolveDescriptor deferredResolveDescriptor{
@@ -1437,24 +1820,28 @@ void Engine::setupDescriptorBuffers() const
 
     const renderer::TemporalAntialiasingDescriptor temporalAntialiasingDescriptor{
         drawImage->imageView,
-        historyBuffer->imageView,
         depthImageView->imageView,
         velocityRenderTarget->imageView,
-        taaResolveTarget->imageView,
+        {taaHistoryBuffers[0]->imageView, taaHistoryBuffers[1]->imageView},
         resourceManager->getDefaultSamplerLinear()
-
     };
     temporalAntialiasingPipeline->setupDescriptorBuffer(temporalAntialiasingDescriptor);
 
+    // One set per swapchain image when writing the swapchain directly
+    const std::span<const VkImageView> finalImageViews = bSwapchainStorage
+                                                             ? std::span<const VkImageView>{swapchainImageViews}
+                                                             : std::span<const VkImageView>{&finalImageBuffer->imageView, 1};
+
     const renderer::PostProcessDescriptor postProcessDescriptor{
-        taaResolveTarget->imageView,
-        finalImageBuffer->imageView,
-        resourceManager->getDefaultSamplerLinear()
+        {taaHistoryBuffers[0]->imageView, taaHistoryBuffers[1]->imageView},
+        finalImageViews,
+        resourceManager->getDefaultSamplerLinear(),
+        bSwapchainStorage,
     };
     postProcessPipeline->setupDescriptorBuffer(postProcessDescriptor);
 
 #if WILL_ENGINE_DEBUG_DRAW
-    debugPipeline->setupDescriptorBuffer(debugTarget->imageView, finalImageBuffer->imageView);
+    debugPipeline->setupDescriptorBuffer(debugTarget->imageView, finalImageViews, bSwapchainStorage);
     debugHighlighter->setupDescriptorBuffer(stencilImageView->imageView, debugTarget->imageView);
 #endif
 }
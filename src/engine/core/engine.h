@@ -5,6 +5,9 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
+#include <array>
+#include <functional>
+
 #include <vulkan/vulkan_core.h>
 #include <glm/glm.hpp>
 
@@ -13,16 +16,21 @@
 #include "camera/free_camera.h"
 #include "scene/serializer.h"
 #include "engine/core/profiler/profiler.h"
+#include "engine/renderer/dynamic_resolution.h"
+#include "engine/renderer/gpu_profiler.h"
 #include "engine/renderer/imgui_wrapper.h"
 #include "engine/renderer/renderer_constants.h"
 #include "engine/renderer/assets/asset_manager.h"
 #include "engine/renderer/lighting/directional_light.h"
+#include "engine/renderer/lighting/local_light.h"
 #include "engine/renderer/pipelines/post/post_process/post_process_pipeline_types.h"
 #include "engine/renderer/pipelines/geometry/transparent_pipeline/transparent_pipeline.h"
+#include "engine/renderer/pipelines/post/temporal_antialiasing/temporal_antialiasing_pipeline.h"
 #include "engine/renderer/pipelines/post/temporal_antialiasing/temporal_antialiasing_pipeline_types.h"
 #include "engine/renderer/pipelines/shadows/cascaded_shadow_map/shadow_types.h"
 #include "engine/renderer/pipelines/shadows/contact_shadow/contact_shadows_pipeline.h"
 #include "engine/renderer/pipelines/shadows/ground_truth_ambient_occlusion/ambient_occlusion_types.h"
+#include "engine/renderer/render_graph/render_graph_types.h"
 #include "engine/renderer/resources/descriptor_set_layout.h"
 #include "engine/renderer/resources/pipeline.h"
 #include "engine/renderer/resources/pipeline_layout.h"
@@ -31,6 +39,8 @@
 #include "engine/renderer/resources/render_target.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_sampler.h"
 #include "engine/renderer/resources/resources_fwd.h"
+#include "engine/physics/physics_types.h"
+#include "engine/renderer/terrain/terrain_types.h"
 #include "events/event_dispatcher.h"
 
 #if WILL_ENGINE_DEBUG_DRAW
@@ -55,6 +65,8 @@ class DeferredMrtPipeline;
 class TerrainPipeline;
 class EnvironmentPipeline;
 class VisibilityPassPipeline;
+class LightCullingPipeline;
+class RenderGraph;
 }
 
 namespace will_engine::physics
@@ -64,9 +76,13 @@ class Physics;
 
 namespace will_engine
 {
+class CameraPath;
+class ILocalLightSource;
+
 namespace terrain
 {
     class TerrainManager;
+    class TerrainGenerator;
 }
 
 
@@ -79,7 +95,7 @@ public:
     static Engine* get() { return instance; }
 
 public:
-    void init();
+    void init(const HeadlessSettings& headless = {});
 
     void initRenderer();
 
@@ -89,6 +105,24 @@ public:
 
     void run();
 
+    /**
+     * Renders \code HeadlessSettings::frameCount\endcode frames at a fixed timestep, optionally along a camera path, and reports the frame timings
+     * @return false if the results could not be written
+     */
+    bool runHeadless();
+
+    /**
+     * Called every headless frame after the game and debug updates, before rendering. \code frame\endcode counts the warmup frames too
+     */
+    using HeadlessFrameCallback = std::function<void(uint32_t frame)>;
+
+    /**
+     * The measured part of \code runHeadless\endcode, doesn't print or write anything. \code cameraPath\endcode may be empty
+     */
+    HeadlessResult runHeadlessFrames(const CameraPath& cameraPath, const HeadlessFrameCallback& onFrame = {});
+
+    static void printHeadlessResult(const HeadlessResult& result);
+
     void updatePhysics(float deltaTime) const;
 
     void updateGame(float deltaTime);
@@ -129,17 +163,24 @@ public:
 public:
     renderer::AssetManager* getAssetManager() const { return assetManager; }
     renderer::ResourceManager* getResourceManager() const { return resourceManager; }
+    terrain::TerrainGenerator* getTerrainGenerator() const { return terrainGenerator; }
 
     void addToActiveTerrain(ITerrain* terrain);
 
     void removeFromActiveTerrain(ITerrain* terrain);
 
+    void addToActiveLights(ILocalLightSource* light);
+
+    void removeFromActiveLights(ILocalLightSource* light);
+
 private:
     SDL_Window* window{nullptr};
 
     renderer::RenderContext* renderContext;
     renderer::VulkanContext* context{nullptr};
     renderer::ImmediateSubmitter* immediate{nullptr};
+    renderer::DynamicResolution* dynamicResolution{nullptr};
+    renderer::GpuProfiler* gpuProfiler{nullptr};
     renderer::ResourceManager* resourceManager{nullptr};
     renderer::AssetManager* assetManager{nullptr};
     physics::Physics* physics{nullptr};
@@ -147,7 +188,7 @@ private:
     renderer::DebugRenderer* debugRenderer{nullptr};
     renderer::DebugHighlighter* debugHighlighter{nullptr};
     renderer::DebugCompositePipeline* debugPipeline{nullptr};
-    renderer::RenderTargetPtr debugTarget{};
+    renderer::RenderTarget* debugTarget{nullptr};
 #endif
     // Might be used in imgui which can be active outside of debug build
     IHierarchical* selectedItem{nullptr};
@@ -155,6 +196,7 @@ private:
     renderer::Environment* environmentMap{nullptr};
 
     terrain::TerrainManager* terrainManager{nullptr};
+    terrain::TerrainGenerator* terrainGenerator{nullptr};
     ImguiWrapper* imguiWrapper = nullptr;
 
     StartupProfiler startupProfiler{};
@@ -169,9 +211,38 @@ private: // Rendering
 
     bool bStopRendering{false};
     bool bWindowChanged{false};
+    /**
+     * Set by \code waitForFrameSlot\endcode so \code render\endcode doesn't wait again
+     */
+    bool bFrameSlotReady{false};
+    /**
+     * Wait semaphores of the frame's final submission, kept so submitting doesn't allocate
+     */
+    std::vector<VkSemaphoreSubmitInfo> submitWaitInfos;
+
+    /**
+     * Blocks until the current frame slot is free and no more than \code FramePacingSettings::framesInFlight\endcode frames are in flight
+     */
+    void waitForFrameSlot();
 
     void createDrawResources(VkExtent3D extents);
 
+    void destroyDrawResources();
+
+    /**
+     * Declares every pass of the frame and compiles the graph, which creates the transient render targets
+     */
+    void createRenderGraph(VkExtent3D extents);
+
+    renderer::RenderGraph* renderGraph{nullptr};
+    renderer::RenderGraphImageHandle swapchainGraphImage{renderer::INVALID_RENDER_GRAPH_IMAGE};
+    renderer::RenderGraphImageHandle taaResolveGraphImage{renderer::INVALID_RENDER_GRAPH_IMAGE};
+    renderer::RenderGraphImageHandle taaHistoryGraphImage{renderer::INVALID_RENDER_GRAPH_IMAGE};
+    /**
+     * Per frame state read by the render graph's passes
+     */
+    FrameRenderContext frameRenderContext{};
+
     EventDispatcher<int32_t> testDispatcher;
 
 private: // Engine Settings
@@ -183,6 +254,10 @@ private: // Engine Settings
     renderer::GTAOSettings gtaoSettings{};
     renderer::CascadedShadowMapSettings csmSettings{};
     temporal_antialiasing_pipeline::TemporalAntialiasingSettings taaSettings{};
+    physics::PhysicsSettings physicsSettings{};
+    terrain::TerrainStreamingSettings terrainStreamingSettings{};
+    terrain::TerrainTessellationSettings terrainTessellationSettings{};
+    FramePacingSettings framePacingSettings{};
 
 public:
 #if WILL_ENGINE_DEBUG
@@ -193,7 +268,7 @@ public:
     void setEngineSettings(const EngineSettings& settings) { engineSettings = settings; }
 
     renderer::GTAOSettings getAoSettings() const { return gtaoSettings; }
-    void setAoSettings(const renderer::GTAOSettings& settings) { gtaoSettings = settings; }
+    void setAoSettings(const renderer::GTAOSettings& settings);
 
     renderer::ContactShadowSettings getSssSettings() const { return sssSettings; }
     void setSssSettings(const renderer::ContactShadowSettings& settings) { sssSettings = settings; }
@@ -205,6 +280,28 @@ public:
     temporal_antialiasing_pipeline::TemporalAntialiasingSettings getTaaSettings() const { return taaSettings; }
     void setTaaSettings(const temporal_antialiasing_pipeline::TemporalAntialiasingSettings& settings) { taaSettings = settings; }
 
+    physics::PhysicsSettings getPhysicsSettings() const { return physicsSettings; }
+
+    void setPhysicsSettings(const physics::PhysicsSettings& settings);
+
+    terrain::TerrainStreamingSettings getTerrainStreamingSettings() const { return terrainStreamingSettings; }
+
+    void setTerrainStreamingSettings(const terrain::TerrainStreamingSettings& settings);
+
+    terrain::TerrainTessellationSettings getTerrainTessellationSettings() const { return terrainTessellationSettings; }
+    void setTerrainTessellationSettings(const terrain::TerrainTessellationSettings& settings) { terrainTessellationSettings = settings; }
+
+    renderer::DynamicResolutionSettings getDynamicResolutionSettings() const { return dynamicResolution->settings; }
+    void setDynamicResolutionSettings(const renderer::DynamicResolutionSettings& settings) { dynamicResolution->settings = settings; }
+
+    FramePacingSettings getFramePacingSettings() const { return framePacingSettings; }
+
+    void setFramePacingSettings(const FramePacingSettings& settings);
+
+    const Profiler& getProfiler() const { return profiler; }
+
+    const renderer::GpuProfiler* getGpuProfiler() const { return gpuProfiler; }
+
 private: // Debug
     int32_t deferredDebug{0};
     bool bEnablePhysics{true};
@@ -214,6 +311,19 @@ private: // Debug
     bool bDrawDebugRendering{true};
     bool bDebugPhysics{true};
     bool bFreezeVisibilitySceneData{false};
+    /**
+     * Disable to inspect/save render targets after the frame, otherwise later passes may have overwritten them
+     */
+    bool bAliasRenderTargets{true};
+    /**
+     * Runs GTAO and contact shadows on the compute queue alongside the shadow maps, if the device has a separate compute queue
+     */
+    bool bAsyncCompute{true};
+
+    /**
+     * Recreates the render graph and its render targets, e.g. after changing \code bAliasRenderTargets\endcode or \code bAsyncCompute\endcode
+     */
+    void recreateRenderGraph();
 
     void hotReloadShaders() const;
 
@@ -250,6 +360,11 @@ private: // Scene Data
     };
     std::vector<std::unique_ptr<game::Map> > activeMaps;
     std::unordered_set<ITerrain*> activeTerrains;
+    std::unordered_set<ILocalLightSource*> activeLights;
+    /**
+     * Lights gathered for the current frame, kept to avoid reallocating every frame
+     */
+    std::vector<LocalLightData> frameLocalLights;
 
 
     std::vector<IHierarchical*> hierarchalBeginQueue{};
@@ -258,6 +373,7 @@ private: // Scene Data
 
 private: // Pipelines
     renderer::VisibilityPassPipeline* visibilityPassPipeline{nullptr};
+    renderer::LightCullingPipeline* lightCullingPipeline{nullptr};
 
     renderer::EnvironmentPipeline* environmentPipeline{nullptr};
     renderer::TerrainPipeline* terrainPipeline{nullptr};
@@ -274,39 +390,40 @@ private: // Pipelines
     renderer::PostProcessPipeline* postProcessPipeline{nullptr};
 
 private: // Draw Resources
+    // Transient render targets are owned by the render graph and may share memory, their contents are only valid while the graph uses them
 
-    renderer::RenderTargetPtr drawImage{nullptr};
-    renderer::RenderTargetPtr depthStencilImage{nullptr};
+    renderer::RenderTarget* drawImage{nullptr};
+    renderer::RenderTarget* depthStencilImage{nullptr};
     renderer::ImageViewPtr depthImageView{nullptr};
     renderer::ImageViewPtr stencilImageView{nullptr};
 
     /**
      * 10,10,10 View Normals - 2 unused
      */
-    renderer::RenderTargetPtr normalRenderTarget{nullptr};
+    renderer::RenderTarget* normalRenderTarget{nullptr};
     /**
      * 16,16,16 RGB Albedo (HDR) - 16 indicates if the image should be shaded
      */
-    renderer::RenderTargetPtr albedoRenderTarget{nullptr};
+    renderer::RenderTarget* albedoRenderTarget{nullptr};
     /**
      * 8 Metallic, 8 Roughness, 8 Unused, 8 Is Transparent
      */
-    renderer::RenderTargetPtr pbrRenderTarget{nullptr};
+    renderer::RenderTarget* pbrRenderTarget{nullptr};
     /**
      * 16 X and 16 Y
      */
-    renderer::RenderTargetPtr velocityRenderTarget{nullptr};
+    renderer::RenderTarget* velocityRenderTarget{nullptr};
     /**
-    * The results of the TAA pass will be outputted into this buffer
-    */
-    renderer::RenderTargetPtr taaResolveTarget{nullptr};
-
+     * TAA resolves into one and reads the previous frame's resolve from the other, their roles swap every frame.
+     * Persist across frames so they aren't part of the render graph's transient memory
+     */
+    std::array<renderer::RenderTargetPtr, renderer::TAA_HISTORY_BUFFER_COUNT> taaHistoryBuffers{};
     /**
-     * A copy of the previous TAA Resolve Buffer
+     * History buffer TAA resolves into this frame
      */
-    renderer::RenderTargetPtr historyBuffer{nullptr};
+    int32_t taaHistoryIndex{0};
 
-    renderer::RenderTargetPtr finalImageBuffer{nullptr};
+    renderer::RenderTarget* finalImageBuffer{nullptr};
 
 private: // Swapchain
     VkSwapchainKHR swapchain{};
@@ -314,9 +431,31 @@ private: // Swapchain
     std::vector<VkImage> swapchainImages{};
     std::vector<VkImageView> swapchainImageViews{};
     VkExtent3D swapchainExtent{};
+    std::vector<VkPresentModeKHR> supportedPresentModes{};
+    /**
+     * The present mode changed and the swapchain is recreated at the start of the next frame
+     */
+    bool bSwapchainOutdated{false};
+    /**
+     * The swapchain has storage usage, so the post process and debug composite write it directly instead of copying the final image into it
+     */
+    bool bSwapchainStorage{false};
 
     void createSwapchain(uint32_t width, uint32_t height);
 
+    /**
+     * Stands in for the swapchain in headless mode, as its only image
+     */
+    void createHeadlessTarget(uint32_t width, uint32_t height);
+
+    HeadlessSettings headlessSettings{};
+    renderer::RenderTargetPtr headlessTarget{};
+
+    /**
+     * Device must be idle
+     */
+    void recreateSwapchain();
+
 public:
     game::Map* createMap(const std::filesystem::path& path);
 
@@ -4,11 +4,31 @@
 
 #ifndef ENGINE_TYPES_H
 #define ENGINE_TYPES_H
+#include <array>
 #include <filesystem>
+#include <string>
+#include <vector>
 #include <vulkan/vulkan_core.h>
 
+#include "engine/core/profiler/memory_tracker.h"
+#include "engine/util/profiling_utils.h"
+
 namespace will_engine
 {
+/**
+ * Ids of the engine's \code Profiler\endcode timers, they are added in this order
+ */
+enum EngineTimer : uint32_t
+{
+    ENGINE_TIMER_PHYSICS,
+    ENGINE_TIMER_GAME,
+    ENGINE_TIMER_RENDER,
+    ENGINE_TIMER_TOTAL,
+    ENGINE_TIMER_FRAME_PACING_WAIT,
+    ENGINE_TIMER_INPUT_TO_PRESENT,
+    ENGINE_TIMER_COUNT
+};
+
 struct FrameData
 {
     VkCommandPool _commandPool;
@@ -17,6 +37,15 @@ struct FrameData
     VkFence _renderFence;
 };
 
+struct FrameRenderContext
+{
+    int32_t currentFrameOverlap{0};
+    uint32_t swapchainImageIndex{0};
+    VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
+    VkDeviceSize sceneDataBufferOffset{0};
+    bool bHighlightStencilDrawn{false};
+};
+
 struct EditorSettings
 {
     bool bSaveSettingsOnExit{true};
@@ -27,6 +56,89 @@ struct EngineSettings
 {
     std::filesystem::path defaultMapToLoad{};
 };
+
+/**
+ * Renders into an offscreen image without a window, surface or swapchain, then exits with the frame timings
+ */
+struct HeadlessSettings
+{
+    bool bEnabled{false};
+    VkExtent2D extent{1920, 1080};
+    uint32_t frameCount{1000};
+    /**
+     * Frames rendered before timing starts, e.g. while pipelines are created and streaming settles
+     */
+    uint32_t warmupFrames{60};
+    /**
+     * Optional, see \code CameraPath::load\endcode. The path is stretched over the timed frames
+     */
+    std::filesystem::path cameraPath{};
+    /**
+     * Optional, the results are always printed
+     */
+    std::filesystem::path outputPath{};
+    /**
+     * Optional, a \code TraceProfiler\endcode capture of the timed frames
+     */
+    std::filesystem::path tracePath{};
+    /**
+     * Off for generated scenes (see \code benchmark::StressScene\endcode), which shouldn't be mixed with the default map's content
+     */
+    bool bLoadDefaultMap{true};
+};
+
+struct HeadlessStageTiming
+{
+    std::string name;
+    TimingStatistics ms{};
+};
+
+struct HeadlessResult
+{
+    uint32_t frameCount{0};
+    double totalMs{0.0};
+    /**
+     * Wall clock time of each frame, including waiting on the GPU
+     */
+    TimingStatistics cpuFrameMs{};
+    /**
+     * Empty if the graphics queue doesn't support timestamps
+     */
+    TimingStatistics gpuFrameMs{};
+    /**
+     * Parts of the CPU frame, in the order they run
+     */
+    std::vector<HeadlessStageTiming> cpuStages{};
+    /**
+     * One per GPU profiler scope (render graph pass), in the order they were first recorded
+     */
+    std::vector<HeadlessStageTiming> gpuStages{};
+    /**
+     * Heap allocations (all tags) made during each timed frame, see \code profiling::MemoryTracker\endcode
+     */
+    TimingStatistics allocationsPerFrame{};
+    /**
+     * Per \code profiling::MemoryTag\endcode at the end of the run. Peaks only cover the timed frames
+     */
+    std::array<profiling::MemoryTagStatistics, static_cast<size_t>(profiling::MemoryTag::Count)> memory{};
+    profiling::MemoryTagStatistics memoryTotal{};
+};
+
+struct FramePacingSettings
+{
+    /**
+     * Frames the CPU may record ahead of the GPU, 1 to \code FRAME_OVERLAP\endcode. Fewer frames trade throughput for latency
+     */
+    int32_t framesInFlight{2};
+    /**
+     * Falls back to FIFO if the surface doesn't support it
+     */
+    VkPresentModeKHR presentMode{VK_PRESENT_MODE_FIFO_KHR};
+    /**
+     * Wait for the GPU before sampling input rather than after, so the frame is recorded with the freshest input
+     */
+    bool bLowLatency{false};
+};
 }
 
 
@@ -12,6 +12,8 @@
 #include <unordered_map>
 #include <type_traits>
 
+#include "engine/core/profiler/memory_tracker.h"
+
 namespace will_engine::game
 {
 template<typename T>
@@ -24,7 +26,10 @@ template<typename BaseType>
 class ObjectFactory
 {
 protected:
-    ObjectFactory() = default;
+    /**
+     * @param memoryTag objects are created (constructed) under this tag
+     */
+    explicit ObjectFactory(const profiling::MemoryTag memoryTag = profiling::MemoryTag::Untagged) : memoryTag(memoryTag) {}
 
 public:
     using Creator = std::function<std::unique_ptr<BaseType>(const std::string& name)>;
@@ -46,12 +51,14 @@ public:
     {
         static_assert(std::is_base_of_v<BaseType, T>, "T must inherit from BaseType");
 
-        allCreators[T::getStaticType()] = [](const std::string& name) {
+        allCreators[T::getStaticType()] = [tag = memoryTag](const std::string& name) {
+            const profiling::MemoryTagScope tagScope{tag};
             return std::make_unique<T>(name);
         };
 
         if (canManuallyCreate) {
-            canManuallyCreateCreators[T::getStaticType()] = [](const std::string& name) {
+            canManuallyCreateCreators[T::getStaticType()] = [tag = memoryTag](const std::string& name) {
+                const profiling::MemoryTagScope tagScope{tag};
                 return std::make_unique<T>(name);
             };
         }
@@ -79,6 +86,7 @@ public:
     }
 
 private:
+    profiling::MemoryTag memoryTag;
     std::unordered_map<std::string_view, Creator> allCreators;
     std::unordered_map<std::string_view, Creator> canManuallyCreateCreators;
 };
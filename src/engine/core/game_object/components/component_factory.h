@@ -7,7 +7,9 @@
 
 #include "mesh_renderer_component.h"
 #include "name_printing_component.h"
+#include "point_light_component.h"
 #include "rigid_body_component.h"
+#include "spot_light_component.h"
 #include "terrain_component.h"
 #include "engine/core/factory/object_factory.h"
 #include "engine/core/game_object/components/component.h"
@@ -29,7 +31,12 @@ public:
         registerType<RigidBodyComponent>(RigidBodyComponent::CAN_BE_CREATED_MANUALLY);
         registerType<MeshRendererComponent>(MeshRendererComponent::CAN_BE_CREATED_MANUALLY);
         registerType<TerrainComponent>(TerrainComponent::CAN_BE_CREATED_MANUALLY);
+        registerType<PointLightComponent>(PointLightComponent::CAN_BE_CREATED_MANUALLY);
+        registerType<SpotLightComponent>(SpotLightComponent::CAN_BE_CREATED_MANUALLY);
     }
+
+private:
+    ComponentFactory() : ObjectFactory(profiling::MemoryTag::Components) {}
 };
 }
 #endif //COMPONENT_FACTORY_H
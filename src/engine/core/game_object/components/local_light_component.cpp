@@ -0,0 +1,99 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#include "local_light_component.h"
+
+#include <fmt/format.h>
+
+#include "imgui.h"
+#include "engine/core/engine.h"
+#include "engine/core/game_object/transformable.h"
+
+namespace will_engine::game
+{
+LocalLightComponent::LocalLightComponent(const std::string& name)
+    : Component(name)
+{}
+
+LocalLightComponent::~LocalLightComponent()
+{
+    if (Engine* engine = Engine::get()) {
+        engine->removeFromActiveLights(this);
+    }
+}
+
+void LocalLightComponent::setOwner(IComponentContainer* owner)
+{
+    Component::setOwner(owner);
+
+    transformableOwner = dynamic_cast<ITransformable*>(owner);
+    if (!transformableOwner) {
+        fmt::print("Attempted to attach a light to an IComponentContainer that does not implement ITransformable. This component will not have an effect.\n");
+        return;
+    }
+
+    if (Engine* engine = Engine::get()) {
+        engine->addToActiveLights(this);
+    }
+}
+
+void LocalLightComponent::beginDestroy()
+{
+    Component::beginDestroy();
+
+    transformableOwner = nullptr;
+    if (Engine* engine = Engine::get()) {
+        engine->removeFromActiveLights(this);
+    }
+}
+
+bool LocalLightComponent::getLocalLightData(LocalLightData& outLight)
+{
+    if (!transformableOwner || !bIsEnabled || intensity <= 0.0f || range <= 0.0f) {
+        return false;
+    }
+
+    const Transform& transform = transformableOwner->getGlobalTransform();
+    outLight.position = transform.getPosition();
+    outLight.direction = glm::normalize(transform.getRotation() * glm::vec3(0.0f, 0.0f, -1.0f));
+    outLight.color = color;
+    outLight.intensity = intensity;
+    outLight.range = range;
+    fillLightData(outLight);
+    return true;
+}
+
+void LocalLightComponent::serialize(ordered_json& j)
+{
+    Component::serialize(j);
+
+    j["color"] = {color.x, color.y, color.z};
+    j["intensity"] = intensity;
+    j["range"] = range;
+}
+
+void LocalLightComponent::deserialize(ordered_json& j)
+{
+    Component::deserialize(j);
+
+    if (j.contains("color") && j["color"].is_array() && j["color"].size() == 3) {
+        color = {j["color"][0].get<float>(), j["color"][1].get<float>(), j["color"][2].get<float>()};
+    }
+    if (j.contains("intensity")) {
+        intensity = j["intensity"].get<float>();
+    }
+    if (j.contains("range")) {
+        range = j["range"].get<float>();
+    }
+}
+
+void LocalLightComponent::updateRenderImgui()
+{
+    Component::updateRenderImgui();
+
+    ImGui::ColorEdit3("Color", &color.x);
+    ImGui::DragFloat("Intensity", &intensity, 0.1f, 0.0f, 1000.0f);
+    ImGui::DragFloat("Range", &range, 0.1f, 0.01f, 500.0f);
+}
+}
@@ -0,0 +1,61 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef LOCAL_LIGHT_COMPONENT_H
+#define LOCAL_LIGHT_COMPONENT_H
+
+#include <glm/glm.hpp>
+
+#include "engine/core/game_object/local_light_source.h"
+#include "engine/core/game_object/components/component.h"
+
+namespace will_engine
+{
+class ITransformable;
+}
+
+namespace will_engine::game
+{
+/**
+ * Shared base of point and spot lights. Lights register themselves with the engine once attached to an \code ITransformable\endcode
+ * and are culled into clusters every frame, so they can move freely.
+ */
+class LocalLightComponent : public Component, public ILocalLightSource
+{
+public:
+    explicit LocalLightComponent(const std::string& name = "");
+
+    ~LocalLightComponent() override;
+
+    void setOwner(IComponentContainer* owner) override;
+
+    void beginDestroy() override;
+
+public: // ILocalLightSource
+    bool getLocalLightData(LocalLightData& outLight) override;
+
+public: // Serialization
+    void serialize(ordered_json& j) override;
+
+    void deserialize(ordered_json& j) override;
+
+public: // Editor Tools
+    void updateRenderImgui() override;
+
+protected:
+    /**
+     * Type specific fields, position and the shared properties are already filled in
+     */
+    virtual void fillLightData(LocalLightData& outLight) const = 0;
+
+protected:
+    ITransformable* transformableOwner{nullptr};
+
+    glm::vec3 color{1.0f};
+    float intensity{10.0f};
+    float range{10.0f};
+};
+}
+
+#endif //LOCAL_LIGHT_COMPONENT_H
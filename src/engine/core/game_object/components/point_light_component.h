@@ -0,0 +1,37 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef POINT_LIGHT_COMPONENT_H
+#define POINT_LIGHT_COMPONENT_H
+
+#include "local_light_component.h"
+
+namespace will_engine::game
+{
+class PointLightComponent final : public LocalLightComponent
+{
+public:
+    explicit PointLightComponent(const std::string& name = "")
+        : LocalLightComponent(name) {}
+
+protected:
+    void fillLightData(LocalLightData& outLight) const override
+    {
+        outLight.type = LocalLightType::Point;
+    }
+
+public:
+    static constexpr auto TYPE = "PointLightComponent";
+    static constexpr bool CAN_BE_CREATED_MANUALLY = true;
+
+    static std::string_view getStaticType()
+    {
+        return TYPE;
+    }
+
+    std::string_view getComponentType() override { return TYPE; }
+};
+}
+
+#endif //POINT_LIGHT_COMPONENT_H
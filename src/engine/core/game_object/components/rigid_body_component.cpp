@@ -15,60 +15,10 @@
 #include "engine/physics/physics.h"
 #include "engine/physics/physics_constants.h"
 #include "engine/physics/physics_filters.h"
+#include "engine/physics/physics_serialization.h"
 #include "engine/physics/physics_utils.h"
 
 
-namespace will_engine::physics
-{
-using ordered_json = nlohmann::ordered_json;
-
-inline void to_json(ordered_json& j, const PhysicsProperties& p)
-{
-    j = {
-        {"isActive", p.isActive},
-        {"motionType", p.motionType},
-        {"layer", p.layer},
-        {"shapeType", p.shapeType},
-        {
-            "offset", {
-                {"x", p.offset.x},
-                {"y", p.offset.y},
-                {"z", p.offset.z}
-            }
-        },
-        {
-            "shapeParams", {
-                {"x", p.shapeParams.x},
-                {"y", p.shapeParams.y},
-                {"z", p.shapeParams.z}
-            }
-        }
-    };
-}
-
-inline void from_json(const ordered_json& j, PhysicsProperties& props)
-{
-    props.isActive = j["isActive"].get<bool>();
-    props.motionType = j["motionType"].get<uint8_t>();
-    props.layer = (j["layer"].get<uint16_t>());
-    props.shapeType = j["shapeType"].get<JPH::EShapeSubType>();
-    if (j.contains("shapeParams")) {
-        props.shapeParams = glm::vec3(
-            j["shapeParams"]["x"].get<float>(),
-            j["shapeParams"]["y"].get<float>(),
-            j["shapeParams"]["z"].get<float>()
-        );
-    }
-    if (j.contains("offset")) {
-        props.offset = glm::vec3(
-            j["offset"]["x"].get<float>(),
-            j["offset"]["y"].get<float>(),
-            j["offset"]["z"].get<float>()
-        );
-    }
-}
-}
-
 namespace will_engine::game
 {
 RigidBodyComponent::RigidBodyComponent(const std::string& name)
@@ -121,6 +71,17 @@ void RigidBodyComponent::setTransform(const glm::vec3& position, const glm::quat
     }
 }
 
+void RigidBodyComponent::dirty()
+{
+    if (bIsPhysicsDirty) { return; }
+    bIsPhysicsDirty = true;
+
+    if (!hasRigidBody()) { return; }
+    if (physics::Physics* physics = physics::Physics::get()) {
+        physics->markTransformDirty(bodyId);
+    }
+}
+
 glm::vec3 RigidBodyComponent::getGlobalPosition()
 {
     if (!transformableOwner) {
@@ -53,7 +53,7 @@ public:
 public: // IPhysicsBody
     void setTransform(const glm::vec3& position, const glm::quat& rotation) override;
 
-    void dirty() override { bIsPhysicsDirty = true; }
+    void dirty() override;
 
     void undirty() override { bIsPhysicsDirty = false; }
 
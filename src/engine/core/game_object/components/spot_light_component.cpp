@@ -0,0 +1,47 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#include "spot_light_component.h"
+
+#include "imgui.h"
+
+namespace will_engine::game
+{
+void SpotLightComponent::serialize(ordered_json& j)
+{
+    LocalLightComponent::serialize(j);
+
+    j["innerConeAngle"] = innerConeAngle;
+    j["outerConeAngle"] = outerConeAngle;
+}
+
+void SpotLightComponent::deserialize(ordered_json& j)
+{
+    LocalLightComponent::deserialize(j);
+
+    if (j.contains("innerConeAngle")) {
+        innerConeAngle = j["innerConeAngle"].get<float>();
+    }
+    if (j.contains("outerConeAngle")) {
+        outerConeAngle = j["outerConeAngle"].get<float>();
+    }
+}
+
+void SpotLightComponent::updateRenderImgui()
+{
+    LocalLightComponent::updateRenderImgui();
+
+    ImGui::SliderFloat("Inner Cone Angle", &innerConeAngle, 0.0f, outerConeAngle);
+    ImGui::SliderFloat("Outer Cone Angle", &outerConeAngle, 1.0f, 89.0f);
+}
+
+void SpotLightComponent::fillLightData(LocalLightData& outLight) const
+{
+    const float outer = glm::clamp(outerConeAngle, 1.0f, 89.0f);
+    const float inner = glm::clamp(innerConeAngle, 0.0f, outer);
+    outLight.type = LocalLightType::Spot;
+    outLight.spotCosOuter = glm::cos(glm::radians(outer));
+    outLight.spotCosInner = glm::cos(glm::radians(inner));
+}
+}
@@ -0,0 +1,52 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef SPOT_LIGHT_COMPONENT_H
+#define SPOT_LIGHT_COMPONENT_H
+
+#include "local_light_component.h"
+
+namespace will_engine::game
+{
+/**
+ * Shines along the owner's forward (-Z) axis
+ */
+class SpotLightComponent final : public LocalLightComponent
+{
+public:
+    explicit SpotLightComponent(const std::string& name = "")
+        : LocalLightComponent(name) {}
+
+public: // Serialization
+    void serialize(ordered_json& j) override;
+
+    void deserialize(ordered_json& j) override;
+
+public: // Editor Tools
+    void updateRenderImgui() override;
+
+protected:
+    void fillLightData(LocalLightData& outLight) const override;
+
+private:
+    /**
+     * Half angles in degrees. Intensity fades out between the inner and outer cone
+     */
+    float innerConeAngle{20.0f};
+    float outerConeAngle{30.0f};
+
+public:
+    static constexpr auto TYPE = "SpotLightComponent";
+    static constexpr bool CAN_BE_CREATED_MANUALLY = true;
+
+    static std::string_view getStaticType()
+    {
+        return TYPE;
+    }
+
+    std::string_view getComponentType() override { return TYPE; }
+};
+}
+
+#endif //SPOT_LIGHT_COMPONENT_H
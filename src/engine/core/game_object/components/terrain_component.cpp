@@ -6,6 +6,7 @@
 
 #include "imgui.h"
 #include "engine/core/engine.h"
+#include "engine/renderer/terrain/terrain_generator.h"
 
 namespace will_engine::game
 {
@@ -94,10 +95,7 @@ void TerrainComponent::deserialize(ordered_json& j)
 
 void TerrainComponent::generateTerrain()
 {
-    std::vector<float> heightMapData =
-            HeightmapUtil::generateFromNoise(NOISE_MAP_DIMENSIONS, NOISE_MAP_DIMENSIONS, seed, terrainGenerationProperties);
-    terrainChunk = std::make_unique<terrain::TerrainChunk>(*Engine::get()->getResourceManager(), heightMapData, NOISE_MAP_DIMENSIONS,
-                                                           NOISE_MAP_DIMENSIONS, terrainConfig);
+    createTerrainChunk();
     if (Engine* engine = Engine::get()) {
         engine->addToActiveTerrain(this);
     }
@@ -107,10 +105,7 @@ void TerrainComponent::generateTerrain()
 void TerrainComponent::generateTerrain(terrain::TerrainProperties terrainProperties,
                                                                 std::array<uint32_t, terrain::MAX_TERRAIN_TEXTURE_COUNT> textureIds)
 {
-    std::vector<float> heightMapData =
-            HeightmapUtil::generateFromNoise(NOISE_MAP_DIMENSIONS, NOISE_MAP_DIMENSIONS, seed, terrainGenerationProperties);
-    terrainChunk = std::make_unique<terrain::TerrainChunk>(*Engine::get()->getResourceManager(), heightMapData, NOISE_MAP_DIMENSIONS,
-                                                           NOISE_MAP_DIMENSIONS, terrainConfig);
+    createTerrainChunk();
     if (Engine* engine = Engine::get()) {
         engine->addToActiveTerrain(this);
     }
@@ -118,6 +113,16 @@ void TerrainComponent::generateTerrain(terrain::TerrainProperties terrainPropert
     bIsGenerated = true;
 }
 
+void TerrainComponent::createTerrainChunk()
+{
+    const Engine* engine = Engine::get();
+    // Heights are read back for the physics height field
+    terrain::TerrainGpuMeshData meshData = engine->getTerrainGenerator()->generate(NOISE_MAP_DIMENSIONS, NOISE_MAP_DIMENSIONS, seed,
+                                                                                   terrainGenerationProperties, terrainConfig, true);
+    terrainChunk = std::make_unique<terrain::TerrainChunk>(*engine->getResourceManager(), std::move(meshData),
+                                                           terrain::TerrainChunk::getCenteredPlacement(NOISE_MAP_DIMENSIONS, NOISE_MAP_DIMENSIONS));
+}
+
 void TerrainComponent::destroyTerrain()
 {
     terrainChunk.reset();
@@ -126,6 +131,10 @@ void TerrainComponent::destroyTerrain()
 
 std::vector<float> TerrainComponent::getHeightMapData() const
 {
+    // Includes any sculpting done since generation
+    if (terrainChunk && !terrainChunk->getHeights().empty()) {
+        return terrainChunk->getHeights();
+    }
     return HeightmapUtil::generateFromNoise(NOISE_MAP_DIMENSIONS, NOISE_MAP_DIMENSIONS, seed, terrainGenerationProperties);
 }
 
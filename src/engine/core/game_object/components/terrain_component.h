@@ -61,6 +61,12 @@ public:
 
     std::string_view getComponentType() override { return TYPE; }
 
+private:
+    /**
+     * Generates the height map and normals with compute shaders (\code TerrainGenerator\endcode)
+     */
+    void createTerrainChunk();
+
 private:
     std::unique_ptr<terrain::TerrainChunk> terrainChunk;
 
@@ -24,6 +24,9 @@ public:
     {
         registerType<GameObject>(GameObject::CAN_BE_CREATED_MANUALLY);
     }
+
+private:
+    GameObjectFactory() : ObjectFactory(profiling::MemoryTag::GameObjects) {}
 };
 }
 
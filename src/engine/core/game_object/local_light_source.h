@@ -0,0 +1,25 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef LOCAL_LIGHT_SOURCE_H
+#define LOCAL_LIGHT_SOURCE_H
+
+#include "engine/renderer/lighting/local_light.h"
+
+namespace will_engine
+{
+class ILocalLightSource
+{
+public:
+    virtual ~ILocalLightSource() = default;
+
+    /**
+     * @param outLight world space light
+     * @return false if the light should not be drawn this frame
+     */
+    virtual bool getLocalLightData(LocalLightData& outLight) = 0;
+};
+}
+
+#endif //LOCAL_LIGHT_SOURCE_H
@@ -0,0 +1,269 @@
+//
+// Created by William on 2025-07-15.
+//
+
+#include "memory_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace will_engine::profiling
+{
+namespace
+{
+// Padded so threads allocating under different tags don't contend on one cache line
+struct alignas(64) MemoryTagCounters
+{
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> freeCount{0};
+    std::atomic<uint64_t> liveBytes{0};
+    std::atomic<uint64_t> peakLiveBytes{0};
+    std::atomic<uint64_t> frameAllocationCount{0};
+    std::atomic<uint64_t> frameAllocatedBytes{0};
+    std::atomic<uint64_t> lastFrameAllocationCount{0};
+    std::atomic<uint64_t> lastFrameAllocatedBytes{0};
+    std::atomic<uint64_t> peakFrameAllocationCount{0};
+};
+
+constexpr size_t TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+// Constant initialized, operator new can run before any dynamic initialization
+constinit std::array<MemoryTagCounters, TAG_COUNT> tagCounters{};
+// Totals are summed from the tags when read, a shared total counter would be written by every allocation on every thread.
+// Only the peaks need their own state, they are updated in markFrame
+constinit std::atomic<uint64_t> totalPeakLiveBytes{0};
+constinit std::atomic<uint64_t> totalPeakFrameAllocationCount{0};
+
+constinit thread_local MemoryTag currentTag{MemoryTag::Untagged};
+
+void updateMax(std::atomic<uint64_t>& target, const uint64_t value)
+{
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void addAllocation(MemoryTagCounters& counters, const uint64_t size)
+{
+    counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    const uint64_t liveBytes = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    updateMax(counters.peakLiveBytes, liveBytes);
+}
+
+void addFree(MemoryTagCounters& counters, const uint64_t size)
+{
+    counters.freeCount.fetch_add(1, std::memory_order_relaxed);
+    counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void endFrame(MemoryTagCounters& counters)
+{
+    const uint64_t frameAllocations = counters.frameAllocationCount.exchange(0, std::memory_order_relaxed);
+    counters.lastFrameAllocationCount.store(frameAllocations, std::memory_order_relaxed);
+    counters.lastFrameAllocatedBytes.store(counters.frameAllocatedBytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    updateMax(counters.peakFrameAllocationCount, frameAllocations);
+}
+
+void resetCounterPeaks(MemoryTagCounters& counters)
+{
+    counters.peakLiveBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    counters.peakFrameAllocationCount.store(0, std::memory_order_relaxed);
+}
+
+MemoryTagStatistics toStatistics(const MemoryTagCounters& counters)
+{
+    MemoryTagStatistics statistics{};
+    statistics.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+    const uint64_t freeCount = counters.freeCount.load(std::memory_order_relaxed);
+    statistics.liveAllocationCount = statistics.allocationCount > freeCount ? statistics.allocationCount - freeCount : 0;
+    statistics.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    statistics.peakLiveBytes = counters.peakLiveBytes.load(std::memory_order_relaxed);
+    statistics.frameAllocationCount = counters.lastFrameAllocationCount.load(std::memory_order_relaxed);
+    statistics.frameAllocatedBytes = counters.lastFrameAllocatedBytes.load(std::memory_order_relaxed);
+    statistics.peakFrameAllocationCount = counters.peakFrameAllocationCount.load(std::memory_order_relaxed);
+    return statistics;
+}
+}
+
+MemoryTag MemoryTracker::setCurrentTag(const MemoryTag tag)
+{
+    const MemoryTag previousTag = currentTag;
+    currentTag = tag;
+    return previousTag;
+}
+
+MemoryTag MemoryTracker::getCurrentTag()
+{
+    return currentTag;
+}
+
+void MemoryTracker::markFrame()
+{
+    for (MemoryTagCounters& counters : tagCounters) {
+        endFrame(counters);
+    }
+
+    const MemoryTagStatistics total = getTotalStatistics();
+    updateMax(totalPeakLiveBytes, total.liveBytes);
+    updateMax(totalPeakFrameAllocationCount, total.frameAllocationCount);
+}
+
+void MemoryTracker::resetPeaks()
+{
+    uint64_t liveBytes = 0;
+    for (MemoryTagCounters& counters : tagCounters) {
+        resetCounterPeaks(counters);
+        liveBytes += counters.liveBytes.load(std::memory_order_relaxed);
+    }
+    totalPeakLiveBytes.store(liveBytes, std::memory_order_relaxed);
+    totalPeakFrameAllocationCount.store(0, std::memory_order_relaxed);
+}
+
+MemoryTagStatistics MemoryTracker::getStatistics(const MemoryTag tag)
+{
+    if (tag >= MemoryTag::Count) {
+        return {};
+    }
+    return toStatistics(tagCounters[static_cast<size_t>(tag)]);
+}
+
+MemoryTagStatistics MemoryTracker::getTotalStatistics()
+{
+    MemoryTagStatistics total{};
+    for (const MemoryTagCounters& counters : tagCounters) {
+        const MemoryTagStatistics statistics = toStatistics(counters);
+        total.allocationCount += statistics.allocationCount;
+        total.liveAllocationCount += statistics.liveAllocationCount;
+        total.liveBytes += statistics.liveBytes;
+        total.frameAllocationCount += statistics.frameAllocationCount;
+        total.frameAllocatedBytes += statistics.frameAllocatedBytes;
+    }
+    total.peakLiveBytes = std::max(totalPeakLiveBytes.load(std::memory_order_relaxed), total.liveBytes);
+    total.peakFrameAllocationCount = std::max(totalPeakFrameAllocationCount.load(std::memory_order_relaxed), total.frameAllocationCount);
+    return total;
+}
+
+void MemoryTracker::recordAllocation(const MemoryTag tag, const uint64_t size)
+{
+    addAllocation(tagCounters[static_cast<size_t>(tag)], size);
+}
+
+void MemoryTracker::recordFree(const MemoryTag tag, const uint64_t size)
+{
+    addFree(tagCounters[static_cast<size_t>(tag)], size);
+}
+}
+
+#if WILL_ENGINE_MEMORY_TRACKING
+namespace
+{
+using will_engine::profiling::MemoryTag;
+using will_engine::profiling::MemoryTracker;
+
+/**
+ * Sits right before the pointer handed out
+ */
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AllocationHeader
+{
+    uint64_t size;
+    /**
+     * From the start of the malloc'd block to the pointer handed out
+     */
+    uint32_t offset;
+    MemoryTag tag;
+};
+
+void* trackedAllocate(const std::size_t size, std::size_t alignment) noexcept
+{
+    alignment = alignment > alignof(AllocationHeader) ? alignment : alignof(AllocationHeader);
+    // malloc already returns blocks aligned for the header, only over-aligned types need padding
+    const std::size_t padding = alignment > alignof(AllocationHeader) ? alignment - 1 : 0;
+    void* block = std::malloc(sizeof(AllocationHeader) + padding + size);
+    if (!block) {
+        return nullptr;
+    }
+
+    const uintptr_t blockAddress = reinterpret_cast<uintptr_t>(block);
+    const uintptr_t address = (blockAddress + sizeof(AllocationHeader) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+    const MemoryTag tag = MemoryTracker::getCurrentTag();
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(address) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(address - blockAddress);
+    header->tag = tag;
+
+    MemoryTracker::recordAllocation(tag, size);
+    return reinterpret_cast<void*>(address);
+}
+
+void* trackedAllocateOrThrow(const std::size_t size, const std::size_t alignment)
+{
+    // Same as the standard operator new, the new handler gets a chance to free memory before giving up
+    while (true) {
+        if (void* pointer = trackedAllocate(size, alignment)) {
+            return pointer;
+        }
+
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* trackedAllocateNoThrow(const std::size_t size, const std::size_t alignment) noexcept
+{
+    try {
+        return trackedAllocateOrThrow(size, alignment);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void trackedFree(void* pointer) noexcept
+{
+    if (!pointer) {
+        return;
+    }
+
+    const AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+    MemoryTracker::recordFree(header->tag, header->size);
+    std::free(static_cast<char*>(pointer) - header->offset);
+}
+}
+
+// Replaces every global operator new/delete of the executable. Sized and aligned deletes ignore their extra arguments, the header has both
+void* operator new(const std::size_t size) { return trackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](const std::size_t size) { return trackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(const std::size_t size, const std::align_val_t alignment) { return trackedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](const std::size_t size, const std::align_val_t alignment) { return trackedAllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { return trackedAllocateNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept { return trackedAllocateNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return trackedAllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return trackedAllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+#endif
@@ -0,0 +1,125 @@
+//
+// Created by William on 2025-07-15.
+//
+
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace will_engine::profiling
+{
+/**
+ * Subsystem an allocation is attributed to, set for the current thread with \code WILL_MEMORY_TAG\endcode.
+ * Allocations are freed against the tag they were made with, wherever they are freed.
+ */
+enum class MemoryTag : uint8_t
+{
+    Untagged,
+    GameObjects,
+    Components,
+    Assets,
+    Serialization,
+    Debug,
+    Physics,
+    Terrain,
+    Renderer,
+    Count
+};
+
+inline constexpr std::array<const char*, static_cast<size_t>(MemoryTag::Count)> MEMORY_TAG_NAMES{
+    "Untagged", "Game Objects", "Components", "Assets", "Serialization", "Debug", "Physics", "Terrain", "Renderer"
+};
+
+struct MemoryTagStatistics
+{
+    /**
+     * Since startup
+     */
+    uint64_t allocationCount{0};
+    uint64_t liveAllocationCount{0};
+    uint64_t liveBytes{0};
+    /**
+     * Highest \code liveBytes\endcode since startup or \code MemoryTracker::resetPeaks\endcode
+     */
+    uint64_t peakLiveBytes{0};
+    /**
+     * During the last frame (between the last two \code MemoryTracker::markFrame\endcode)
+     */
+    uint64_t frameAllocationCount{0};
+    uint64_t frameAllocatedBytes{0};
+    /**
+     * Highest \code frameAllocationCount\endcode since startup or \code MemoryTracker::resetPeaks\endcode
+     */
+    uint64_t peakFrameAllocationCount{0};
+};
+
+/**
+ * Counts every allocation made through global operator new, per \code MemoryTag\endcode. Each allocation carries a small header
+ * holding its size and tag, so frees are attributed correctly.
+ * \n Only active with \code WILL_ENGINE_MEMORY_TRACKING\endcode, otherwise the global allocator is left alone and all statistics are 0.
+ * Allocations made directly with malloc (e.g. by Jolt or SDL) are not seen.
+ */
+class MemoryTracker
+{
+public:
+    static constexpr bool isEnabled() { return WILL_ENGINE_MEMORY_TRACKING; }
+
+    /**
+     * @return the previous tag of this thread
+     */
+    static MemoryTag setCurrentTag(MemoryTag tag);
+
+    static MemoryTag getCurrentTag();
+
+    /**
+     * Ends the current frame's allocation counters, call once per frame
+     */
+    static void markFrame();
+
+    static void resetPeaks();
+
+    static MemoryTagStatistics getStatistics(MemoryTag tag);
+
+    /**
+     * All tags combined, summed when called. The peaks are peaks of the total, not the sum of each tag's peak.
+     * The total's peak live bytes is only sampled once per \code markFrame\endcode, so spikes within a frame are missed
+     */
+    static MemoryTagStatistics getTotalStatistics();
+
+    static void recordAllocation(MemoryTag tag, uint64_t size);
+
+    static void recordFree(MemoryTag tag, uint64_t size);
+};
+
+class MemoryTagScope
+{
+public:
+    explicit MemoryTagScope(const MemoryTag tag) : previousTag(MemoryTracker::setCurrentTag(tag)) {}
+
+    ~MemoryTagScope() { MemoryTracker::setCurrentTag(previousTag); }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag previousTag;
+};
+}
+
+#if WILL_ENGINE_MEMORY_TRACKING
+#define WILL_MEMORY_TAG_CONCAT_IMPL(a, b) a##b
+#define WILL_MEMORY_TAG_CONCAT(a, b) WILL_MEMORY_TAG_CONCAT_IMPL(a, b)
+/**
+ * Attributes allocations on this thread to \code MemoryTag::tag\endcode for the rest of the enclosing scope
+ */
+#define WILL_MEMORY_TAG(tag) \
+    const will_engine::profiling::MemoryTagScope WILL_MEMORY_TAG_CONCAT(willMemoryTag, __LINE__){will_engine::profiling::MemoryTag::tag}
+#else
+#define WILL_MEMORY_TAG(tag) (void)0
+#endif
+
+#endif //MEMORY_TRACKER_H
@@ -4,7 +4,8 @@
 
 #ifndef PROFILER_H
 #define PROFILER_H
-#include <map>
+#include <string>
+#include <vector>
 
 #include "engine/util/profiling_utils.h"
 
@@ -35,35 +36,61 @@ private:
     std::vector<will_engine::StartupProfilerEntry> entries;
 };
 
+using TimerId = uint32_t;
+
+/**
+ * Averaged CPU timers shown in the profiler UI. Timers are addressed by the id returned from \code addTimer\endcode, so beginning and ending
+ * one is an index, not a string lookup. See \code will_engine::profiling::TraceProfiler\endcode for per-frame timelines.
+ */
 class Profiler
 {
 public:
-    void addTimer(const std::string& name)
+    struct Timer
+    {
+        std::string name;
+        ProfilingData data;
+    };
+
+    /**
+     * Ids are handed out in order, starting at 0
+     */
+    TimerId addTimer(std::string name)
     {
-        if (!timers.contains(name)) {
-            timers.emplace(std::move(name), ProfilingData{});
+        timers.push_back({std::move(name), ProfilingData{}});
+        return static_cast<TimerId>(timers.size() - 1);
+    }
+
+    void beginTimer(const TimerId id)
+    {
+        if (id < timers.size()) {
+            timers[id].data.begin();
         }
     }
 
-    void beginTimer(const std::string& name)
+    void endTimer(const TimerId id)
     {
-        if (const auto it = timers.find(name); it != timers.end()) {
-            it->second.begin();
+        if (id < timers.size()) {
+            timers[id].data.end();
         }
     }
 
-    void endTimer(const std::string& name)
+    void cancelTimer(const TimerId id)
     {
-        if (const auto it = timers.find(name); it != timers.end()) {
-            it->second.end();
+        if (id < timers.size()) {
+            timers[id].data.cancel();
         }
     }
 
-    [[nodiscard]] const auto& getTimers() const { return timers; }
+    /**
+     * In the order they were added
+     */
+    [[nodiscard]] const std::vector<Timer>& getTimers() const { return timers; }
+
+    [[nodiscard]] const ProfilingData* getTimer(const TimerId id) const { return id < timers.size() ? &timers[id].data : nullptr; }
 
 
 private:
-    std::map<std::string, ProfilingData> timers;
+    std::vector<Timer> timers;
 };
 
 
@@ -0,0 +1,127 @@
+//
+// Created by William on 2025-07-14.
+//
+
+#include "trace_profiler.h"
+
+#include <mutex>
+#include <thread>
+
+#include <fmt/format.h>
+
+namespace will_engine::profiling
+{
+namespace
+{
+/**
+ * Guards the buffer list, the last capture and capture state changes
+ */
+std::mutex registryMutex;
+/**
+ * Buffers are never freed so threads that exit early (e.g. task workers) keep their events until the capture ends
+ */
+std::vector<std::unique_ptr<ThreadTraceBuffer> > threadBuffers;
+std::vector<TraceThread> lastCapture;
+
+thread_local ThreadTraceBuffer* localBuffer{nullptr};
+}
+
+ThreadTraceBuffer::~ThreadTraceBuffer()
+{
+    delete[] events.load(std::memory_order_relaxed);
+}
+
+void ThreadTraceBuffer::push(const TraceEventType type, const SourceLocation* location)
+{
+    // Both sides are sequentially consistent, so either this sees the storage was taken or releaseEvents sees the write in progress
+    bWriting.store(true, std::memory_order_seq_cst);
+    if (TraceEvent* storage = events.load(std::memory_order_seq_cst)) {
+        if (count < CAPACITY) {
+            storage[count++] = {TraceProfiler::now(), location, type};
+        }
+        else {
+            droppedCount++;
+        }
+    }
+    bWriting.store(false, std::memory_order_release);
+}
+
+void ThreadTraceBuffer::allocateEvents()
+{
+    count = 0;
+    droppedCount = 0;
+    delete[] events.exchange(new TraceEvent[CAPACITY], std::memory_order_seq_cst);
+}
+
+std::unique_ptr<TraceEvent[]> ThreadTraceBuffer::releaseEvents()
+{
+    TraceEvent* storage = events.exchange(nullptr, std::memory_order_seq_cst);
+    while (bWriting.load(std::memory_order_seq_cst)) {
+        std::this_thread::yield();
+    }
+    return std::unique_ptr<TraceEvent[]>(storage);
+}
+
+void TraceProfiler::beginCapture()
+{
+    std::lock_guard lock(registryMutex);
+    lastCapture.clear();
+    for (const std::unique_ptr<ThreadTraceBuffer>& buffer : threadBuffers) {
+        // A capture that is still running is discarded
+        buffer->releaseEvents();
+        buffer->allocateEvents();
+    }
+    bCapturing.store(true, std::memory_order_release);
+}
+
+void TraceProfiler::endCapture()
+{
+    std::lock_guard lock(registryMutex);
+    bCapturing.store(false, std::memory_order_release);
+
+    lastCapture.clear();
+    lastCapture.reserve(threadBuffers.size());
+    for (const std::unique_ptr<ThreadTraceBuffer>& buffer : threadBuffers) {
+        const std::unique_ptr<TraceEvent[]> events = buffer->releaseEvents();
+
+        TraceThread& thread = lastCapture.emplace_back();
+        thread.threadIndex = buffer->threadIndex;
+        const char* name = buffer->threadName.load(std::memory_order_relaxed);
+        thread.name = name ? name : fmt::format("Thread {}", buffer->threadIndex);
+
+        if (events) {
+            thread.events.assign(events.get(), events.get() + buffer->count);
+            thread.droppedCount = buffer->droppedCount;
+        }
+    }
+}
+
+std::vector<TraceThread> TraceProfiler::collect()
+{
+    std::lock_guard lock(registryMutex);
+    return lastCapture;
+}
+
+void TraceProfiler::setThreadName(const char* name)
+{
+    getThreadBuffer().threadName.store(name, std::memory_order_relaxed);
+}
+
+void TraceProfiler::recordUnchecked(const TraceEventType type, const SourceLocation* location)
+{
+    getThreadBuffer().push(type, location);
+}
+
+ThreadTraceBuffer& TraceProfiler::getThreadBuffer()
+{
+    if (!localBuffer) {
+        std::lock_guard lock(registryMutex);
+        localBuffer = threadBuffers.emplace_back(std::make_unique<ThreadTraceBuffer>(static_cast<uint32_t>(threadBuffers.size()))).get();
+        // Threads that start mid capture join it
+        if (bCapturing.load(std::memory_order_relaxed)) {
+            localBuffer->allocateEvents();
+        }
+    }
+    return *localBuffer;
+}
+}
@@ -0,0 +1,207 @@
+//
+// Created by William on 2025-07-14.
+//
+
+#ifndef TRACE_PROFILER_H
+#define TRACE_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace will_engine::profiling
+{
+/**
+ * Identifies a zone. One is created as a \code static constexpr\endcode per \code WILL_PROFILE_ZONE\endcode, its address is the zone's id
+ * so recording never touches a string.
+ */
+struct SourceLocation
+{
+    const char* name;
+    const char* file;
+    uint32_t line;
+};
+
+enum class TraceEventType : uint8_t
+{
+    ZoneBegin,
+    ZoneEnd,
+    /**
+     * \code location\endcode is null
+     */
+    FrameMark,
+};
+
+struct TraceEvent
+{
+    /**
+     * Nanoseconds, steady clock
+     */
+    uint64_t timestamp;
+    const SourceLocation* location;
+    TraceEventType type;
+};
+
+/**
+ * Events of one thread. Only the owning thread writes. Event storage only exists while a capture is running, it is allocated by
+ * \code TraceProfiler::beginCapture\endcode and taken back by \code TraceProfiler::endCapture\endcode.
+ */
+class ThreadTraceBuffer
+{
+public:
+    static constexpr uint32_t CAPACITY = 1 << 16;
+
+    explicit ThreadTraceBuffer(const uint32_t threadIndex) : threadIndex(threadIndex) {}
+
+    ~ThreadTraceBuffer();
+
+    ThreadTraceBuffer(const ThreadTraceBuffer&) = delete;
+
+    ThreadTraceBuffer& operator=(const ThreadTraceBuffer&) = delete;
+
+    /**
+     * Dropped if there is no capture storage
+     */
+    void push(TraceEventType type, const SourceLocation* location);
+
+    /**
+     * Gives the buffer empty storage for a new capture
+     */
+    void allocateEvents();
+
+    /**
+     * Takes the storage away, waiting for a push in progress on the owning thread to finish
+     * @return the events recorded since \code allocateEvents\endcode (\code count\endcode of them), null if there was no storage
+     */
+    std::unique_ptr<TraceEvent[]> releaseEvents();
+
+    const uint32_t threadIndex;
+    std::atomic<const char*> threadName{nullptr};
+    /**
+     * Only touched while the buffer has storage, by the owning thread
+     */
+    uint32_t count{0};
+    /**
+     * Events that didn't fit, the capture is cut short rather than overwriting older events
+     */
+    uint32_t droppedCount{0};
+
+private:
+    std::atomic<TraceEvent*> events{nullptr};
+    /**
+     * Set by the owning thread around a push so \code releaseEvents\endcode doesn't free storage that is being written
+     */
+    std::atomic<bool> bWriting{false};
+};
+
+struct TraceThread
+{
+    uint32_t threadIndex{0};
+    std::string name;
+    std::vector<TraceEvent> events;
+    uint32_t droppedCount{0};
+};
+
+/**
+ * Records nested zones and frame markers into per-thread buffers while a capture is running, to be exported as a timeline
+ * (see \code Serializer::serializeTraceCapture\endcode).
+ * \n When not capturing a zone costs one relaxed atomic load, with \code WILL_ENGINE_PROFILING\endcode off the macros compile to nothing.
+ * Unlike \code Profiler\endcode nothing is averaged, so single frame spikes and work on other threads stay visible.
+ * \n Event storage is only allocated for the length of a capture, its events are copied out when it ends.
+ */
+class TraceProfiler
+{
+public:
+    /**
+     * Discards the previous capture
+     */
+    static void beginCapture();
+
+    /**
+     * Copies out the recorded events and frees every thread's event storage
+     */
+    static void endCapture();
+
+    [[nodiscard]] static bool isCapturing() { return bCapturing.load(std::memory_order_relaxed); }
+
+    /**
+     * Copies the events of the last ended capture
+     */
+    static std::vector<TraceThread> collect();
+
+    static void markFrame() { record(TraceEventType::FrameMark, nullptr); }
+
+    /**
+     * @param name must outlive the profiler, e.g. a string literal
+     */
+    static void setThreadName(const char* name);
+
+    static void record(const TraceEventType type, const SourceLocation* location)
+    {
+        if (!isCapturing()) { return; }
+        recordUnchecked(type, location);
+    }
+
+    /**
+     * Skips the capture check, used by zones that already checked when they began. Events after the capture ended are dropped
+     */
+    static void recordUnchecked(TraceEventType type, const SourceLocation* location);
+
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    static ThreadTraceBuffer& getThreadBuffer();
+
+    static inline std::atomic<bool> bCapturing{false};
+};
+
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const SourceLocation* location) : location(location), bActive(TraceProfiler::isCapturing())
+    {
+        if (bActive) {
+            TraceProfiler::recordUnchecked(TraceEventType::ZoneBegin, location);
+        }
+    }
+
+    ~ProfileZone()
+    {
+        if (bActive) {
+            TraceProfiler::recordUnchecked(TraceEventType::ZoneEnd, location);
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const SourceLocation* location;
+    bool bActive;
+};
+}
+
+#if WILL_ENGINE_PROFILING
+#define WILL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define WILL_PROFILE_CONCAT(a, b) WILL_PROFILE_CONCAT_IMPL(a, b)
+/**
+ * Profiles the rest of the enclosing scope. \code name\endcode must be a string literal
+ */
+#define WILL_PROFILE_ZONE(name) \
+    static constexpr will_engine::profiling::SourceLocation WILL_PROFILE_CONCAT(willProfileLocation, __LINE__){name, __FILE__, __LINE__}; \
+    const will_engine::profiling::ProfileZone WILL_PROFILE_CONCAT(willProfileZone, __LINE__){&WILL_PROFILE_CONCAT(willProfileLocation, __LINE__)}
+#define WILL_PROFILE_FRAME() will_engine::profiling::TraceProfiler::markFrame()
+#define WILL_PROFILE_THREAD(name) will_engine::profiling::TraceProfiler::setThreadName(name)
+#else
+#define WILL_PROFILE_ZONE(name) (void)0
+#define WILL_PROFILE_FRAME() (void)0
+#define WILL_PROFILE_THREAD(name) (void)0
+#endif
+
+#endif //TRACE_PROFILER_H
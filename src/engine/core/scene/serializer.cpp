@@ -153,6 +153,7 @@ std::unique_ptr<IHierarchical> Serializer::deserializeGameObject(const ordered_j
 
 bool Serializer::serializeMap(IHierarchical* map, ordered_json& rootJ, const std::filesystem::path& filepath)
 {
+    WILL_MEMORY_TAG(Serialization);
     if (map == nullptr) {
         fmt::print("Warning: map is null\n");
         return false;
@@ -189,6 +190,7 @@ bool Serializer::serializeMap(IHierarchical* map, ordered_json& rootJ, const std
 
 bool Serializer::deserializeMap(IHierarchical* root, ordered_json& rootJ)
 {
+    WILL_MEMORY_TAG(Serialization);
     if (rootJ.contains("gameObjects")) {
         for (auto child : rootJ["gameObjects"]["children"]) {
             std::unique_ptr<IHierarchical> childObject = deserializeGameObject(child);
@@ -395,6 +397,7 @@ std::optional<TextureInfo> Serializer::loadWillTexture(const std::filesystem::pa
 
 bool Serializer::serializeEngineSettings(Engine* engine, EngineSettingsTypeFlag engineSettings)
 {
+    WILL_MEMORY_TAG(Serialization);
 #if WILL_ENGINE_DEBUG
     if (engine == nullptr) {
         fmt::print("Warning: engine is null\n");
@@ -488,6 +491,8 @@ bool Serializer::serializeEngineSettings(Engine* engine, EngineSettingsTypeFlag
 
         renderer::GTAOSettings settings = engine->getAoSettings();
         aoSettings["enabled"] = settings.bEnabled;
+        aoSettings["resolution"] = static_cast<int32_t>(settings.resolution);
+        aoSettings["temporal_accumulation"] = settings.bTemporalAccumulation;
 
         aoSettings["properties"]["effect_radius"] = settings.pushConstants.effectRadius;
         aoSettings["properties"]["effect_falloff_range"] = settings.pushConstants.effectFalloffRange;
@@ -499,6 +504,7 @@ bool Serializer::serializeEngineSettings(Engine* engine, EngineSettingsTypeFlag
         aoSettings["properties"]["depth_mip_sampling_offset"] = settings.pushConstants.depthMipSamplingOffset;
         aoSettings["properties"]["slice_count"] = settings.pushConstants.sliceCount;
         aoSettings["properties"]["steps_per_slice_count"] = settings.pushConstants.stepsPerSliceCount;
+        aoSettings["properties"]["temporal_blend"] = settings.pushConstants.temporalBlend;
 
         rootJ["aoSettings"] = aoSettings;
     }
@@ -567,6 +573,75 @@ bool Serializer::serializeEngineSettings(Engine* engine, EngineSettingsTypeFlag
         rootJ["taaSettings"] = taaSettings;
     }
 
+    if (hasFlag(engineSettings, EngineSettingsTypeFlag::PHYSICS_SETTINGS)) {
+        ordered_json physicsSettings;
+
+        physics::PhysicsSettings settings = engine->getPhysicsSettings();
+        physicsSettings["properties"]["stepRate"] = settings.stepRate;
+        physicsSettings["properties"]["collisionSteps"] = settings.collisionSteps;
+        physicsSettings["properties"]["maxSubsteps"] = settings.maxSubsteps;
+        physicsSettings["properties"]["interpolate"] = settings.bInterpolate;
+
+        rootJ["physicsSettings"] = physicsSettings;
+    }
+
+    if (hasFlag(engineSettings, EngineSettingsTypeFlag::TERRAIN_STREAMING_SETTINGS)) {
+        ordered_json terrainStreamingSettings;
+
+        terrain::TerrainStreamingSettings settings = engine->getTerrainStreamingSettings();
+        terrainStreamingSettings["enabled"] = settings.bEnabled;
+
+        terrainStreamingSettings["properties"]["tileSize"] = settings.tileSize;
+        terrainStreamingSettings["properties"]["tileResolution"] = settings.tileResolution;
+        terrainStreamingSettings["properties"]["maxDepth"] = settings.maxDepth;
+        terrainStreamingSettings["properties"]["lodDistanceFactor"] = settings.lodDistanceFactor;
+        terrainStreamingSettings["properties"]["viewDistance"] = settings.viewDistance;
+        terrainStreamingSettings["properties"]["memoryBudgetMb"] = settings.memoryBudgetMb;
+        terrainStreamingSettings["properties"]["maxUploadsPerFrame"] = settings.maxUploadsPerFrame;
+        terrainStreamingSettings["properties"]["seed"] = settings.seed;
+
+        rootJ["terrainStreamingSettings"] = terrainStreamingSettings;
+    }
+
+    if (hasFlag(engineSettings, EngineSettingsTypeFlag::TERRAIN_TESSELLATION_SETTINGS)) {
+        ordered_json terrainTessellationSettings;
+
+        terrain::TerrainTessellationSettings settings = engine->getTerrainTessellationSettings();
+        terrainTessellationSettings["properties"]["targetEdgeLength"] = settings.targetEdgeLength;
+        terrainTessellationSettings["properties"]["maxTessLevel"] = settings.maxTessLevel;
+        terrainTessellationSettings["properties"]["shadowTargetEdgeLength"] = settings.shadowTargetEdgeLength;
+        terrainTessellationSettings["properties"]["shadowMaxTessLevel"] = settings.shadowMaxTessLevel;
+        terrainTessellationSettings["properties"]["cullPatches"] = settings.bCullPatches;
+
+        rootJ["terrainTessellationSettings"] = terrainTessellationSettings;
+    }
+
+    if (hasFlag(engineSettings, EngineSettingsTypeFlag::DYNAMIC_RESOLUTION_SETTINGS)) {
+        ordered_json dynamicResolutionSettings;
+
+        renderer::DynamicResolutionSettings settings = engine->getDynamicResolutionSettings();
+        dynamicResolutionSettings["enabled"] = settings.bEnabled;
+
+        dynamicResolutionSettings["properties"]["targetFrameTimeMs"] = settings.targetFrameTimeMs;
+        dynamicResolutionSettings["properties"]["minScale"] = settings.minScale;
+        dynamicResolutionSettings["properties"]["maxScale"] = settings.maxScale;
+        dynamicResolutionSettings["properties"]["maxScaleStep"] = settings.maxScaleStep;
+        dynamicResolutionSettings["properties"]["tolerance"] = settings.tolerance;
+
+        rootJ["dynamicResolutionSettings"] = dynamicResolutionSettings;
+    }
+
+    if (hasFlag(engineSettings, EngineSettingsTypeFlag::FRAME_PACING_SETTINGS)) {
+        ordered_json framePacingSettings;
+
+        FramePacingSettings settings = engine->getFramePacingSettings();
+        framePacingSettings["properties"]["framesInFlight"] = settings.framesInFlight;
+        framePacingSettings["properties"]["presentMode"] = static_cast<int32_t>(settings.presentMode);
+        framePacingSettings["properties"]["lowLatency"] = settings.bLowLatency;
+
+        rootJ["framePacingSettings"] = framePacingSettings;
+    }
+
 
     std::ofstream outFile(filepath);
     if (!outFile.is_open()) {
@@ -586,6 +661,7 @@ bool Serializer::serializeEngineSettings(Engine* engine, EngineSettingsTypeFlag
 
 bool Serializer::deserializeEngineSettings(Engine* engine, EngineSettingsTypeFlag engineSettings)
 {
+    WILL_MEMORY_TAG(Serialization);
     if (engine == nullptr) {
         fmt::print("Warning: engine is null\n");
         return false;
@@ -728,6 +804,21 @@ bool Serializer::deserializeEngineSettings(Engine* engine, EngineSettingsTypeFla
                     settings.bEnabled = aoSettings["enabled"].get<bool>();
                 }
 
+                if (aoSettings.contains("resolution")) {
+                    const int32_t resolution = aoSettings["resolution"].get<int32_t>();
+                    if (resolution == static_cast<int32_t>(renderer::GTAOResolution::Half) ||
+                        resolution == static_cast<int32_t>(renderer::GTAOResolution::Quarter)) {
+                        settings.resolution = static_cast<renderer::GTAOResolution>(resolution);
+                    }
+                    else {
+                        settings.resolution = renderer::GTAOResolution::Full;
+                    }
+                }
+
+                if (aoSettings.contains("temporal_accumulation")) {
+                    settings.bTemporalAccumulation = aoSettings["temporal_accumulation"].get<bool>();
+                }
+
                 if (aoSettings.contains("properties")) {
                     ordered_json aoProperties = aoSettings["properties"];
 
@@ -770,6 +861,10 @@ bool Serializer::deserializeEngineSettings(Engine* engine, EngineSettingsTypeFla
                     if (aoProperties.contains("steps_per_slice_count")) {
                         settings.pushConstants.stepsPerSliceCount = aoProperties["steps_per_slice_count"].get<float>();
                     }
+
+                    if (aoProperties.contains("temporal_blend")) {
+                        settings.pushConstants.temporalBlend = aoProperties["temporal_blend"].get<float>();
+                    }
                 }
 
 
@@ -918,6 +1013,179 @@ bool Serializer::deserializeEngineSettings(Engine* engine, EngineSettingsTypeFla
             }
         }
 
+        if (hasFlag(engineSettings, EngineSettingsTypeFlag::PHYSICS_SETTINGS)) {
+            if (rootJ.contains("physicsSettings")) {
+                ordered_json physicsSettings = rootJ["physicsSettings"];
+                physics::PhysicsSettings settings = engine->getPhysicsSettings();
+
+                if (physicsSettings.contains("properties")) {
+                    auto properties = physicsSettings["properties"];
+
+                    if (properties.contains("stepRate")) {
+                        settings.stepRate = properties["stepRate"].get<float>();
+                    }
+
+                    if (properties.contains("collisionSteps")) {
+                        settings.collisionSteps = properties["collisionSteps"].get<int32_t>();
+                    }
+
+                    if (properties.contains("maxSubsteps")) {
+                        settings.maxSubsteps = properties["maxSubsteps"].get<int32_t>();
+                    }
+
+                    if (properties.contains("interpolate")) {
+                        settings.bInterpolate = properties["interpolate"].get<bool>();
+                    }
+                }
+
+                engine->setPhysicsSettings(settings);
+            }
+        }
+
+        if (hasFlag(engineSettings, EngineSettingsTypeFlag::TERRAIN_STREAMING_SETTINGS)) {
+            if (rootJ.contains("terrainStreamingSettings")) {
+                ordered_json terrainStreamingSettings = rootJ["terrainStreamingSettings"];
+                terrain::TerrainStreamingSettings settings = engine->getTerrainStreamingSettings();
+
+                if (terrainStreamingSettings.contains("enabled")) {
+                    settings.bEnabled = terrainStreamingSettings["enabled"].get<bool>();
+                }
+
+                if (terrainStreamingSettings.contains("properties")) {
+                    auto properties = terrainStreamingSettings["properties"];
+
+                    if (properties.contains("tileSize")) {
+                        settings.tileSize = properties["tileSize"].get<float>();
+                    }
+
+                    if (properties.contains("tileResolution")) {
+                        settings.tileResolution = properties["tileResolution"].get<int32_t>();
+                    }
+
+                    if (properties.contains("maxDepth")) {
+                        settings.maxDepth = properties["maxDepth"].get<int32_t>();
+                    }
+
+                    if (properties.contains("lodDistanceFactor")) {
+                        settings.lodDistanceFactor = properties["lodDistanceFactor"].get<float>();
+                    }
+
+                    if (properties.contains("viewDistance")) {
+                        settings.viewDistance = properties["viewDistance"].get<float>();
+                    }
+
+                    if (properties.contains("memoryBudgetMb")) {
+                        settings.memoryBudgetMb = properties["memoryBudgetMb"].get<int32_t>();
+                    }
+
+                    if (properties.contains("maxUploadsPerFrame")) {
+                        settings.maxUploadsPerFrame = properties["maxUploadsPerFrame"].get<int32_t>();
+                    }
+
+                    if (properties.contains("seed")) {
+                        settings.seed = properties["seed"].get<uint32_t>();
+                    }
+                }
+
+                engine->setTerrainStreamingSettings(settings);
+            }
+        }
+
+        if (hasFlag(engineSettings, EngineSettingsTypeFlag::TERRAIN_TESSELLATION_SETTINGS)) {
+            if (rootJ.contains("terrainTessellationSettings")) {
+                ordered_json terrainTessellationSettings = rootJ["terrainTessellationSettings"];
+                terrain::TerrainTessellationSettings settings = engine->getTerrainTessellationSettings();
+
+                if (terrainTessellationSettings.contains("properties")) {
+                    auto properties = terrainTessellationSettings["properties"];
+
+                    if (properties.contains("targetEdgeLength")) {
+                        settings.targetEdgeLength = properties["targetEdgeLength"].get<float>();
+                    }
+
+                    if (properties.contains("maxTessLevel")) {
+                        settings.maxTessLevel = properties["maxTessLevel"].get<float>();
+                    }
+
+                    if (properties.contains("shadowTargetEdgeLength")) {
+                        settings.shadowTargetEdgeLength = properties["shadowTargetEdgeLength"].get<float>();
+                    }
+
+                    if (properties.contains("shadowMaxTessLevel")) {
+                        settings.shadowMaxTessLevel = properties["shadowMaxTessLevel"].get<float>();
+                    }
+
+                    if (properties.contains("cullPatches")) {
+                        settings.bCullPatches = properties["cullPatches"].get<bool>();
+                    }
+                }
+
+                engine->setTerrainTessellationSettings(settings);
+            }
+        }
+
+        if (hasFlag(engineSettings, EngineSettingsTypeFlag::DYNAMIC_RESOLUTION_SETTINGS)) {
+            if (rootJ.contains("dynamicResolutionSettings")) {
+                ordered_json dynamicResolutionSettings = rootJ["dynamicResolutionSettings"];
+                renderer::DynamicResolutionSettings settings = engine->getDynamicResolutionSettings();
+
+                if (dynamicResolutionSettings.contains("enabled")) {
+                    settings.bEnabled = dynamicResolutionSettings["enabled"].get<bool>();
+                }
+
+                if (dynamicResolutionSettings.contains("properties")) {
+                    auto properties = dynamicResolutionSettings["properties"];
+
+                    if (properties.contains("targetFrameTimeMs")) {
+                        settings.targetFrameTimeMs = properties["targetFrameTimeMs"].get<float>();
+                    }
+
+                    if (properties.contains("minScale")) {
+                        settings.minScale = properties["minScale"].get<float>();
+                    }
+
+                    if (properties.contains("maxScale")) {
+                        settings.maxScale = properties["maxScale"].get<float>();
+                    }
+
+                    if (properties.contains("maxScaleStep")) {
+                        settings.maxScaleStep = properties["maxScaleStep"].get<float>();
+                    }
+
+                    if (properties.contains("tolerance")) {
+                        settings.tolerance = properties["tolerance"].get<float>();
+                    }
+                }
+
+                engine->setDynamicResolutionSettings(settings);
+            }
+        }
+
+        if (hasFlag(engineSettings, EngineSettingsTypeFlag::FRAME_PACING_SETTINGS)) {
+            if (rootJ.contains("framePacingSettings")) {
+                ordered_json framePacingSettings = rootJ["framePacingSettings"];
+                FramePacingSettings settings = engine->getFramePacingSettings();
+
+                if (framePacingSettings.contains("properties")) {
+                    auto properties = framePacingSettings["properties"];
+
+                    if (properties.contains("framesInFlight")) {
+                        settings.framesInFlight = properties["framesInFlight"].get<int32_t>();
+                    }
+
+                    if (properties.contains("presentMode")) {
+                        settings.presentMode = static_cast<VkPresentModeKHR>(properties["presentMode"].get<int32_t>());
+                    }
+
+                    if (properties.contains("lowLatency")) {
+                        settings.bLowLatency = properties["lowLatency"].get<bool>();
+                    }
+                }
+
+                engine->setFramePacingSettings(settings);
+            }
+        }
+
         return true;
     } catch
     (const std::exception&
@@ -927,4 +1195,232 @@ bool Serializer::deserializeEngineSettings(Engine* engine, EngineSettingsTypeFla
         return false;
     }
 }
+
+static ordered_json memoryStatisticsToJson(const profiling::MemoryTagStatistics& statistics)
+{
+    ordered_json statisticsJ;
+    statisticsJ["allocations"] = statistics.allocationCount;
+    statisticsJ["liveAllocations"] = statistics.liveAllocationCount;
+    statisticsJ["liveBytes"] = statistics.liveBytes;
+    statisticsJ["peakLiveBytes"] = statistics.peakLiveBytes;
+    statisticsJ["frameAllocations"] = statistics.frameAllocationCount;
+    statisticsJ["frameAllocatedBytes"] = statistics.frameAllocatedBytes;
+    statisticsJ["peakFrameAllocations"] = statistics.peakFrameAllocationCount;
+    return statisticsJ;
+}
+
+static ordered_json memoryReportToJson(const profiling::MemoryTagStatistics& total,
+                                       const std::array<profiling::MemoryTagStatistics, static_cast<size_t>(profiling::MemoryTag::Count)>& tags)
+{
+    ordered_json memoryJ;
+    memoryJ["total"] = memoryStatisticsToJson(total);
+    memoryJ["tags"] = ordered_json::object();
+    for (size_t tag = 0; tag < tags.size(); ++tag) {
+        memoryJ["tags"][profiling::MEMORY_TAG_NAMES[tag]] = memoryStatisticsToJson(tags[tag]);
+    }
+    return memoryJ;
+}
+
+bool Serializer::serializeProfilerCapture(Engine* engine, const std::filesystem::path& filepath)
+{
+    WILL_MEMORY_TAG(Serialization);
+    if (engine == nullptr) {
+        fmt::print("Warning: engine is null\n");
+        return false;
+    }
+
+    ordered_json rootJ;
+    rootJ["version"] = EngineVersion::current();
+
+    ordered_json cpuTimers = ordered_json::array();
+    for (const Profiler::Timer& timer : engine->getProfiler().getTimers()) {
+        ordered_json timerJ;
+        timerJ["name"] = timer.name;
+        timerJ["timeMs"] = timer.data.getAverageTime();
+        cpuTimers.push_back(timerJ);
+    }
+    rootJ["cpuTimers"] = cpuTimers;
+
+    if (const renderer::GpuProfiler* gpuProfiler = engine->getGpuProfiler(); gpuProfiler && gpuProfiler->isSupported()) {
+        ordered_json gpuScopes = ordered_json::array();
+        for (const renderer::GpuProfilerScope& scope : gpuProfiler->getScopes()) {
+            ordered_json scopeJ;
+            scopeJ["name"] = scope.name;
+            scopeJ["timeMs"] = scope.time.getAverageTime();
+            if (gpuProfiler->bPipelineStatistics) {
+                ordered_json statisticsJ;
+                statisticsJ["inputAssemblyPrimitives"] = scope.statistics.inputAssemblyPrimitives;
+                statisticsJ["vertexShaderInvocations"] = scope.statistics.vertexShaderInvocations;
+                statisticsJ["clippingPrimitives"] = scope.statistics.clippingPrimitives;
+                statisticsJ["fragmentShaderInvocations"] = scope.statistics.fragmentShaderInvocations;
+                statisticsJ["computeShaderInvocations"] = scope.statistics.computeShaderInvocations;
+                scopeJ["pipelineStatistics"] = statisticsJ;
+            }
+            gpuScopes.push_back(scopeJ);
+        }
+        rootJ["gpuFrameTimeMs"] = gpuProfiler->getLastFrameTime();
+        rootJ["gpuScopes"] = gpuScopes;
+    }
+
+    if (profiling::MemoryTracker::isEnabled()) {
+        std::array<profiling::MemoryTagStatistics, static_cast<size_t>(profiling::MemoryTag::Count)> tags{};
+        for (size_t tag = 0; tag < tags.size(); ++tag) {
+            tags[tag] = profiling::MemoryTracker::getStatistics(static_cast<profiling::MemoryTag>(tag));
+        }
+        rootJ["memory"] = memoryReportToJson(profiling::MemoryTracker::getTotalStatistics(), tags);
+    }
+
+    std::ofstream outFile(filepath);
+    if (!outFile.is_open()) {
+        fmt::print("Warning: Could not open profiler capture file for writing\n");
+        return false;
+    }
+
+    outFile << rootJ.dump(4);
+    return true;
+}
+
+static ordered_json timingStatisticsToJson(const TimingStatistics& statistics)
+{
+    ordered_json statisticsJ;
+    statisticsJ["mean"] = statistics.mean;
+    statisticsJ["p50"] = statistics.p50;
+    statisticsJ["p90"] = statistics.p90;
+    statisticsJ["p99"] = statistics.p99;
+    statisticsJ["max"] = statistics.max;
+    return statisticsJ;
+}
+
+ordered_json Serializer::headlessResultToJson(const HeadlessSettings& settings, const HeadlessResult& result)
+{
+    ordered_json rootJ;
+    rootJ["version"] = EngineVersion::current();
+    rootJ["width"] = settings.extent.width;
+    rootJ["height"] = settings.extent.height;
+    rootJ["frames"] = result.frameCount;
+    rootJ["warmupFrames"] = settings.warmupFrames;
+    rootJ["cameraPath"] = settings.cameraPath.string();
+    rootJ["totalMs"] = result.totalMs;
+    rootJ["cpuFrameMs"] = timingStatisticsToJson(result.cpuFrameMs);
+    rootJ["gpuFrameMs"] = timingStatisticsToJson(result.gpuFrameMs);
+
+    rootJ["cpuStagesMs"] = ordered_json::object();
+    for (const HeadlessStageTiming& stage : result.cpuStages) {
+        rootJ["cpuStagesMs"][stage.name] = timingStatisticsToJson(stage.ms);
+    }
+    rootJ["gpuStagesMs"] = ordered_json::object();
+    for (const HeadlessStageTiming& stage : result.gpuStages) {
+        rootJ["gpuStagesMs"][stage.name] = timingStatisticsToJson(stage.ms);
+    }
+
+    if (profiling::MemoryTracker::isEnabled()) {
+        rootJ["allocationsPerFrame"] = timingStatisticsToJson(result.allocationsPerFrame);
+        rootJ["memory"] = memoryReportToJson(result.memoryTotal, result.memory);
+    }
+
+    return rootJ;
+}
+
+bool Serializer::serializeHeadlessResult(const HeadlessSettings& settings, const HeadlessResult& result, const std::filesystem::path& filepath)
+{
+    WILL_MEMORY_TAG(Serialization);
+    const ordered_json rootJ = headlessResultToJson(settings, result);
+
+    std::ofstream outFile(filepath);
+    if (!outFile.is_open()) {
+        fmt::print("Warning: Could not open headless result file for writing\n");
+        return false;
+    }
+
+    outFile << rootJ.dump(4);
+    return true;
+}
+
+bool Serializer::serializeTraceCapture(const std::vector<profiling::TraceThread>& threads, const std::vector<StartupProfilerEntry>& startupEntries,
+                                       const std::filesystem::path& filepath)
+{
+    WILL_MEMORY_TAG(Serialization);
+    constexpr int32_t capturePid = 1;
+    constexpr int32_t startupPid = 2;
+
+    uint64_t baseTimestamp = UINT64_MAX;
+    for (const profiling::TraceThread& thread : threads) {
+        if (!thread.events.empty()) {
+            baseTimestamp = std::min(baseTimestamp, thread.events.front().timestamp);
+        }
+    }
+    const auto toMicroseconds = [baseTimestamp](const uint64_t timestamp) {
+        return static_cast<double>(timestamp - baseTimestamp) / 1000.0;
+    };
+
+    ordered_json eventsJ = ordered_json::array();
+    eventsJ.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", capturePid}, {"args", {{"name", ENGINE_NAME}}}});
+
+    uint32_t frameIndex{0};
+    uint64_t droppedCount{0};
+    for (const profiling::TraceThread& thread : threads) {
+        droppedCount += thread.droppedCount;
+        if (thread.events.empty()) {
+            continue;
+        }
+
+        const uint32_t tid = thread.threadIndex;
+        eventsJ.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", capturePid}, {"tid", tid}, {"args", {{"name", thread.name}}}});
+
+        // Zones that were already open when the capture began only have their end recorded
+        std::vector<const profiling::SourceLocation*> openZones;
+        for (const profiling::TraceEvent& event : thread.events) {
+            const double ts = toMicroseconds(event.timestamp);
+            switch (event.type) {
+                case profiling::TraceEventType::ZoneBegin:
+                    openZones.push_back(event.location);
+                    eventsJ.push_back({{"name", event.location->name}, {"cat", "cpu"}, {"ph", "B"}, {"ts", ts}, {"pid", capturePid}, {"tid", tid},
+                                       {"args", {{"file", event.location->file}, {"line", event.location->line}}}});
+                    break;
+                case profiling::TraceEventType::ZoneEnd:
+                    if (openZones.empty()) {
+                        break;
+                    }
+                    openZones.pop_back();
+                    eventsJ.push_back({{"ph", "E"}, {"ts", ts}, {"pid", capturePid}, {"tid", tid}});
+                    break;
+                case profiling::TraceEventType::FrameMark:
+                    eventsJ.push_back({{"name", fmt::format("Frame {}", frameIndex++)}, {"ph", "i"}, {"s", "g"}, {"ts", ts}, {"pid", capturePid}, {"tid", tid}});
+                    break;
+            }
+        }
+
+        // And zones still open when it ended are closed at the thread's last event
+        const double lastTs = toMicroseconds(thread.events.back().timestamp);
+        for (size_t i = 0; i < openZones.size(); ++i) {
+            eventsJ.push_back({{"ph", "E"}, {"ts", lastTs}, {"pid", capturePid}, {"tid", tid}});
+        }
+    }
+
+    if (!startupEntries.empty()) {
+        eventsJ.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", startupPid}, {"args", {{"name", "Startup"}}}});
+        // Each entry marks the end of a step, which starts where the previous one ended
+        const auto startupBase = startupEntries.front().time;
+        for (size_t i = 1; i < startupEntries.size(); ++i) {
+            const double ts = std::chrono::duration<double, std::micro>(startupEntries[i - 1].time - startupBase).count();
+            const double duration = std::chrono::duration<double, std::micro>(startupEntries[i].time - startupEntries[i - 1].time).count();
+            eventsJ.push_back({{"name", startupEntries[i].name}, {"cat", "startup"}, {"ph", "X"}, {"ts", ts}, {"dur", duration}, {"pid", startupPid}, {"tid", 0}});
+        }
+    }
+
+    ordered_json rootJ;
+    rootJ["traceEvents"] = eventsJ;
+    rootJ["displayTimeUnit"] = "ms";
+    rootJ["otherData"]["version"] = EngineVersion::current();
+    rootJ["otherData"]["droppedEvents"] = droppedCount;
+
+    std::ofstream outFile(filepath);
+    if (!outFile.is_open()) {
+        fmt::print("Warning: Could not open trace capture file for writing\n");
+        return false;
+    }
+
+    outFile << rootJ.dump();
+    return true;
+}
 } // will_engine
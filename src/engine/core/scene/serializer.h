@@ -10,7 +10,10 @@
 
 #include "map.h"
 #include "serializer_types.h"
+#include "engine/core/engine_types.h"
 #include "engine/core/transform.h"
+#include "engine/core/profiler/profiler.h"
+#include "engine/core/profiler/trace_profiler.h"
 #include "engine/core/game_object/game_object.h"
 #include "engine/core/game_object/components/component.h"
 #include "engine/core/game_object/components/component_factory.h"
@@ -219,6 +222,11 @@ enum class EngineSettingsTypeFlag : uint32_t
     CASCADED_SHADOW_MAP_SETTINGS = 1 << 8,
     TEMPORAL_ANTIALIASING_SETTINGS = 1 << 9,
     POSTPROCESS_SETTINGS = 1 << 10,
+    PHYSICS_SETTINGS = 1 << 11,
+    TERRAIN_STREAMING_SETTINGS = 1 << 12,
+    TERRAIN_TESSELLATION_SETTINGS = 1 << 13,
+    DYNAMIC_RESOLUTION_SETTINGS = 1 << 14,
+    FRAME_PACING_SETTINGS = 1 << 15,
     ALL_SETTINGS = 0xFFFFFFFF
 };
 
@@ -274,6 +282,29 @@ public: // Engine Settings
 
     static bool deserializeEngineSettings(Engine* engine, EngineSettingsTypeFlag engineSettings);
 
+public: // Profiling
+    /**
+     * Writes the current CPU timers and GPU scopes (averages in milliseconds) to a json file
+     */
+    static bool serializeProfilerCapture(Engine* engine, const std::filesystem::path& filepath);
+
+    /**
+     * Frame and per-stage timings of a headless run, in milliseconds
+     */
+    static ordered_json headlessResultToJson(const HeadlessSettings& settings, const HeadlessResult& result);
+
+    /**
+     * Writes \code headlessResultToJson\endcode to a json file
+     */
+    static bool serializeHeadlessResult(const HeadlessSettings& settings, const HeadlessResult& result, const std::filesystem::path& filepath);
+
+    /**
+     * Writes a \code TraceProfiler\endcode capture in the Chrome trace event format, open it in Perfetto or chrome://tracing.
+     * Startup entries are written as their own process, they are from long before the capture.
+     */
+    static bool serializeTraceCapture(const std::vector<profiling::TraceThread>& threads, const std::vector<StartupProfilerEntry>& startupEntries,
+                                      const std::filesystem::path& filepath);
+
 public: //
     static uint32_t computePathHash(const std::filesystem::path& path)
     {
@@ -7,10 +7,12 @@
 #include <ranges>
 #include <thread>
 #include <fmt/format.h>
+#include <glm/gtc/quaternion.hpp>
 
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
+#include "Jolt/Physics/Body/BodyLockMulti.h"
 #include "Jolt/Physics/Collision/Shape/BoxShape.h"
 #include "Jolt/Physics/Collision/Shape/CapsuleShape.h"
 #include "Jolt/Physics/Collision/Shape/CylinderShape.h"
@@ -18,8 +20,11 @@
 
 #include "physics_constants.h"
 #include "physics_filters.h"
+#include "physics_listeners.h"
 #include "physics_utils.h"
 #include "physics_body.h"
+#include "engine/core/profiler/memory_tracker.h"
+#include "engine/core/profiler/trace_profiler.h"
 
 
 namespace will_engine::physics
@@ -63,9 +68,8 @@ Physics::Physics()
 
     // A body activation listener gets notified when bodies activate and go to sleep
     // Note that this is called from a job so whatever you do here needs to be thread safe.
-    // Registering one is entirely optional.
-    //MyBodyActivationListener body_activation_listener;
-    //physics_system.SetBodyActivationListener(&body_activation_listener);
+    bodyActivationListener = new BodyActivationListenerImpl();
+    physicsSystem->SetBodyActivationListener(bodyActivationListener);
 
     // A contact listener gets notified when bodies (are about to) collide, and when they separate again.
     // Note that this is called from a job so whatever you do here needs to be thread safe.
@@ -120,6 +124,11 @@ void Physics::cleanup()
         physicsSystem = nullptr;
     }
 
+    if (bodyActivationListener) {
+        delete bodyActivationListener;
+        bodyActivationListener = nullptr;
+    }
+
     if (tempAllocator) {
         delete tempAllocator;
         tempAllocator = nullptr;
@@ -153,13 +162,36 @@ void Physics::cleanup()
 
 void Physics::update(const float deltaTime)
 {
-    constexpr int collisionSteps = 10;
-
+    WILL_MEMORY_TAG(Physics);
+    WILL_PROFILE_ZONE("Physics Update");
     syncGameData();
 
-    physicsSystem->Update(deltaTime, collisionSteps, tempAllocator, jobSystem);
+    const float fixedTimestep = physicsSettings.getFixedTimestep();
+    timeAccumulator += deltaTime;
+
+    const int32_t stepCount = glm::min(static_cast<int32_t>(timeAccumulator / fixedTimestep), physicsSettings.maxSubsteps);
+    for (int32_t i = 0; i < stepCount; ++i) {
+        WILL_PROFILE_ZONE("Physics Step");
+        physicsSystem->Update(fixedTimestep, physicsSettings.collisionSteps, tempAllocator, jobSystem);
+        storeStepState();
+        timeAccumulator -= fixedTimestep;
+    }
+
+    // Spiral of death, drop the simulation time that could not be caught up on this frame
+    if (timeAccumulator >= fixedTimestep) {
+        timeAccumulator = glm::mod(timeAccumulator, fixedTimestep);
+    }
+
+    interpolationAlpha = physicsSettings.bInterpolate ? timeAccumulator / fixedTimestep : 1.0f;
+    updateGameData(interpolationAlpha);
+}
 
-    updateGameData();
+void Physics::setPhysicsSettings(const PhysicsSettings& settings)
+{
+    physicsSettings = settings;
+    physicsSettings.stepRate = glm::max(physicsSettings.stepRate, 1.0f);
+    physicsSettings.collisionSteps = glm::max(physicsSettings.collisionSteps, 1);
+    physicsSettings.maxSubsteps = glm::max(physicsSettings.maxSubsteps, 1);
 }
 
 JPH::BodyInterface& Physics::getBodyInterface() const
@@ -201,27 +233,109 @@ void Physics::removeRigidBodies(const std::vector<IPhysicsBody*>& objects)
 
 void Physics::syncGameData()
 {
-    JPH::BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
-    for (auto val : physicsObjects | std::views::values) {
-        if (!val.physicsBody->isTransformDirty()) { continue; }
+    if (dirtyBodyQueue.empty()) { return; }
+
+    syncBodyIds.clear();
+    for (const JPH::BodyID bodyId : dirtyBodyQueue) {
+        const auto it = physicsObjects.find(bodyId);
+        if (it == physicsObjects.end()) { continue; }
+        // Duplicates and bodies already written back are no longer dirty
+        if (!it->second.physicsBody->isTransformDirty()) { continue; }
+
+        it->second.physicsBody->undirty();
+        syncBodyIds.push_back(bodyId);
+    }
+    dirtyBodyQueue.clear();
+
+    if (syncBodyIds.empty()) { return; }
+
+    const JPH::BodyLockMultiWrite lock(physicsSystem->GetBodyLockInterface(), syncBodyIds.data(), static_cast<int32_t>(syncBodyIds.size()));
+    // Bodies are already locked above, the no-lock interface avoids re-locking for every body
+    JPH::BodyInterface& bodyInterface = physicsSystem->GetBodyInterfaceNoLock();
+    for (int32_t i = 0; i < static_cast<int32_t>(syncBodyIds.size()); ++i) {
+        if (lock.GetBody(i) == nullptr) { continue; }
+
+        PhysicsObject& physicsObject = physicsObjects.at(syncBodyIds[i]);
+        const glm::vec3 position = physicsObject.physicsBody->getGlobalPosition();
+        const glm::quat rotation = physicsObject.physicsBody->getGlobalRotation();
+
+        bodyInterface.SetPositionAndRotation(syncBodyIds[i], PhysicsUtils::toJolt(position), PhysicsUtils::toJolt(rotation), JPH::EActivation::Activate);
+
+        // Teleported by the game, don't interpolate from the old transform
+        physicsObject.previousPosition = physicsObject.currentPosition = position;
+        physicsObject.previousRotation = physicsObject.currentRotation = rotation;
+    }
+}
+
+void Physics::storeStepState()
+{
+    physicsSystem->GetActiveBodies(JPH::EBodyType::RigidBody, activeBodyIds);
+
+    const size_t firstDeactivated = deactivatedBodyIds.size();
+    bodyActivationListener->consumeDeactivatedBodies(deactivatedBodyIds);
 
-        glm::vec3 position = val.physicsBody->getGlobalPosition();
-        glm::quat rotation = val.physicsBody->getGlobalRotation();
+    {
+        const JPH::BodyLockMultiRead lock(physicsSystem->GetBodyLockInterface(), activeBodyIds.data(), static_cast<int32_t>(activeBodyIds.size()));
+        for (int32_t i = 0; i < static_cast<int32_t>(activeBodyIds.size()); ++i) {
+            const JPH::Body* body = lock.GetBody(i);
+            if (body == nullptr) { continue; }
+
+            const auto it = physicsObjects.find(activeBodyIds[i]);
+            if (it == physicsObjects.end()) { continue; }
+
+            PhysicsObject& physicsObject = it->second;
+            physicsObject.previousPosition = physicsObject.currentPosition;
+            physicsObject.previousRotation = physicsObject.currentRotation;
+            physicsObject.currentPosition = PhysicsUtils::toGLM(body->GetPosition());
+            physicsObject.currentRotation = PhysicsUtils::toGLM(body->GetRotation());
+        }
+    }
 
-        bodyInterface.SetPosition(val.bodyId, PhysicsUtils::toJolt(position), JPH::EActivation::Activate);
-        bodyInterface.SetRotation(val.bodyId, PhysicsUtils::toJolt(rotation), JPH::EActivation::Activate);
-        val.physicsBody->undirty();
+    // Sleeping bodies snap to their rest transform, they will not be written back again until they wake up
+    for (size_t i = firstDeactivated; i < deactivatedBodyIds.size(); ++i) {
+        const auto it = physicsObjects.find(deactivatedBodyIds[i]);
+        if (it == physicsObjects.end()) { continue; }
+
+        PhysicsObject& physicsObject = it->second;
+        JPH::RVec3 position;
+        JPH::Quat rotation;
+        getBodyInterface().GetPositionAndRotation(deactivatedBodyIds[i], position, rotation);
+        physicsObject.previousPosition = physicsObject.currentPosition = PhysicsUtils::toGLM(position);
+        physicsObject.previousRotation = physicsObject.currentRotation = PhysicsUtils::toGLM(rotation);
     }
 }
 
-void Physics::updateGameData() const
+void Physics::updateGameData(const float alpha)
 {
-    const JPH::BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
-    for (auto physicsObject : physicsObjects) {
-        const JPH::Vec3 position = bodyInterface.GetPosition(physicsObject.first);
-        const JPH::Quat rotation = bodyInterface.GetRotation(physicsObject.first);
-        physicsObject.second.physicsBody->setTransform(PhysicsUtils::toGLM(position), PhysicsUtils::toGLM(rotation));
+    const auto writeBack = [this, alpha](const JPH::BodyID bodyId) {
+        const auto it = physicsObjects.find(bodyId);
+        if (it == physicsObjects.end()) { return; }
+
+        const PhysicsObject& physicsObject = it->second;
+        const glm::vec3 position = glm::mix(physicsObject.previousPosition, physicsObject.currentPosition, alpha);
+        const glm::quat rotation = glm::slerp(physicsObject.previousRotation, physicsObject.currentRotation, alpha);
+        // Interpolated transforms must not be pushed back into the simulation. Bodies of children the write back moves are still queued
+        writeBackBodyId = bodyId;
+        physicsObject.physicsBody->setTransform(position, rotation);
+        physicsObject.physicsBody->undirty();
+        writeBackBodyId = JPH::BodyID();
+    };
+
+    for (const JPH::BodyID bodyId : activeBodyIds) {
+        writeBack(bodyId);
     }
+
+    for (const JPH::BodyID bodyId : deactivatedBodyIds) {
+        writeBack(bodyId);
+    }
+    deactivatedBodyIds.clear();
+}
+
+void Physics::markTransformDirty(const JPH::BodyID bodyId)
+{
+    if (bodyId.GetIndex() == JPH::BodyID::cMaxBodyIndex) { return; }
+    if (bodyId == writeBackBodyId) { return; }
+    dirtyBodyQueue.push_back(bodyId);
 }
 
 PhysicsObject* Physics::getPhysicsObject(const JPH::BodyID bodyId)
@@ -291,10 +405,14 @@ JPH::BodyID Physics::setupRigidbody(IPhysicsBody* physicsBody, const JPH::EShape
     physicsObject.physicsBody = physicsBody;
     physicsObject.bodyId = physicsSystem->GetBodyInterface().CreateAndAddBody(settings, JPH::EActivation::Activate);
     physicsObject.shape = shape;
+    physicsObject.previousPosition = physicsObject.currentPosition = physicsBody->getGlobalPosition();
+    physicsObject.previousRotation = physicsObject.currentRotation = physicsBody->getGlobalRotation();
 
     physicsObjects.insert({physicsObject.bodyId, physicsObject});
 
     physicsBody->setPhysicsBodyId(physicsObject.bodyId);
+    // Body was just created from the current game transform
+    physicsBody->undirty();
     return physicsObject.bodyId;
 }
 
@@ -328,13 +446,70 @@ JPH::BodyID Physics::setupRigidbody(IPhysicsBody* physicsBody, JPH::HeightFieldS
     physicsObject.physicsBody = physicsBody;
     physicsObject.bodyId = physicsSystem->GetBodyInterface().CreateAndAddBody(settings, JPH::EActivation::Activate);
     physicsObject.shape = terrainShape;
+    physicsObject.previousPosition = physicsObject.currentPosition = physicsBody->getGlobalPosition();
+    physicsObject.previousRotation = physicsObject.currentRotation = physicsBody->getGlobalRotation();
 
     physicsObjects.insert({physicsObject.bodyId, physicsObject});
 
     physicsBody->setPhysicsBodyId(physicsObject.bodyId);
+    // Body was just created from the current game transform
+    physicsBody->undirty();
     return physicsObject.bodyId;
 }
 
+bool Physics::setHeightFieldHeights(const IPhysicsBody* physicsBody, const float* heights, const uint32_t width, const uint32_t height, const uint32_t x,
+                                    const uint32_t z, const uint32_t sizeX, const uint32_t sizeZ)
+{
+    const JPH::BodyID bodyId = physicsBody->getPhysicsBodyId();
+    const auto it = physicsObjects.find(bodyId);
+    if (it == physicsObjects.end() || !it->second.shape || it->second.shape->GetSubType() != JPH::EShapeSubType::HeightField) {
+        fmt::print("Warning: Failed to set height field heights (body is not a height field)\n");
+        return false;
+    }
+    if (sizeX == 0 || sizeZ == 0) { return true; }
+
+    // The shape is only referenced by this body, editing it in place is what Jolt intends (see HeightFieldShape::SetHeights)
+    auto* heightField = const_cast<JPH::HeightFieldShape*>(static_cast<const JPH::HeightFieldShape*>(it->second.shape.GetPtr()));
+
+    // Jolt only edits whole blocks, except for the last block which ends at the (padded) sample count
+    const uint32_t blockSize = heightField->GetBlockSize();
+    const uint32_t sampleCount = heightField->GetSampleCount();
+    const uint32_t minX = x / blockSize * blockSize;
+    const uint32_t minZ = z / blockSize * blockSize;
+    const uint32_t maxX = std::min((x + sizeX + blockSize - 1) / blockSize * blockSize, sampleCount);
+    const uint32_t maxZ = std::min((z + sizeZ + blockSize - 1) / blockSize * blockSize, sampleCount);
+    if (minX >= maxX || minZ >= maxZ) { return true; }
+
+    // Jolt pads the grid up to a multiple of the block size by repeating the last sample, do the same for the padding
+    const uint32_t alignedWidth = maxX - minX;
+    const uint32_t alignedHeight = maxZ - minZ;
+    std::vector<float> alignedHeights(static_cast<size_t>(alignedWidth) * alignedHeight);
+    for (uint32_t row = 0; row < alignedHeight; ++row) {
+        const uint32_t sourceZ = std::min(minZ + row, height - 1);
+        for (uint32_t column = 0; column < alignedWidth; ++column) {
+            const uint32_t sourceX = std::min(minX + column, width - 1);
+            alignedHeights[static_cast<size_t>(row) * alignedWidth + column] = heights[static_cast<size_t>(sourceZ) * width + sourceX];
+        }
+    }
+
+    const JPH::Vec3 previousCenterOfMass = heightField->GetCenterOfMass();
+    heightField->SetHeights(minX, minZ, alignedWidth, alignedHeight, alignedHeights.data(), alignedWidth, *tempAllocator);
+
+    JPH::BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
+    bodyInterface.NotifyShapeChanged(bodyId, previousCenterOfMass, false, JPH::EActivation::DontActivate);
+
+    // Bodies resting on the edited area may be asleep and would otherwise float or sink until something wakes them
+    JPH::AABox changedBounds;
+    changedBounds.Encapsulate(heightField->GetPosition(minX, minZ));
+    changedBounds.Encapsulate(heightField->GetPosition(maxX - 1, maxZ - 1));
+    const JPH::AABox localBounds = heightField->GetLocalBounds();
+    changedBounds.mMin.SetY(localBounds.mMin.GetY());
+    changedBounds.mMax.SetY(localBounds.mMax.GetY());
+    bodyInterface.ActivateBodiesInAABox(changedBounds.Transformed(bodyInterface.GetCenterOfMassTransform(bodyId)), {}, {});
+
+    return true;
+}
+
 void Physics::releaseRigidbody(IPhysicsBody* physicsBody)
 {
     const auto bodyId = physicsBody->getPhysicsBodyId();
@@ -428,6 +603,34 @@ void Physics::drawDebug()
 #endif
 }
 
+void Physics::parallelFor(const uint32_t count, const uint32_t minBatchSize, const std::function<void(uint32_t begin, uint32_t end)>& function) const
+{
+    if (count == 0) { return; }
+
+    // A few batches per thread keeps threads busy when query costs are uneven
+    const uint32_t maxBatches = static_cast<uint32_t>(jobSystem->GetMaxConcurrency()) * 4;
+    const uint32_t batchSize = std::max(std::max(minBatchSize, 1u), (count + maxBatches - 1) / maxBatches);
+    const uint32_t batchCount = (count + batchSize - 1) / batchSize;
+
+    if (batchCount <= 1) {
+        function(0, count);
+        return;
+    }
+
+    JPH::JobSystem::Barrier* barrier = jobSystem->CreateBarrier();
+    for (uint32_t batch = 0; batch < batchCount; ++batch) {
+        const uint32_t begin = batch * batchSize;
+        const uint32_t end = std::min(begin + batchSize, count);
+        JPH::JobHandle handle = jobSystem->CreateJob("PhysicsParallelFor", JPH::Color::sGreen, [&function, begin, end] {
+            WILL_PROFILE_ZONE("Physics Parallel For Batch");
+            function(begin, end);
+        });
+        barrier->AddJob(handle);
+    }
+    jobSystem->WaitForJobs(barrier);
+    jobSystem->DestroyBarrier(barrier);
+}
+
 PhysicsProperties Physics::serializeProperties(const IPhysicsBody* physicsBody) const
 {
     if (physicsBody == nullptr || physicsBody->getPhysicsBodyId().GetIndex() == JPH::BodyID::cMaxBodyIndex) {
@@ -5,6 +5,8 @@
 #ifndef PHYSICS_H
 #define PHYSICS_H
 
+#include <functional>
+
 #include <Jolt/Jolt.h>
 #include <Jolt/Core/HashCombine.h>
 #include <Jolt/Core/StaticArray.h>
@@ -31,7 +33,6 @@ class CapsuleShape;
 class SphereShape;
 class BoxShape;
 class ContactListener;
-class BodyActivationListener;
 class BroadPhaseLayerInterface;
 class ObjectVsBroadPhaseLayerFilter;
 class ObjectLayerPairFilter;
@@ -39,6 +40,8 @@ class ObjectLayerPairFilter;
 
 namespace will_engine::physics
 {
+class BodyActivationListenerImpl;
+
 class Physics
 {
 public:
@@ -66,9 +69,22 @@ public:
 
     void removeRigidBodies(const std::vector<IPhysicsBody*>& objects);
 
+    /**
+     * Pushes the transforms of all bodies in the dirty queue into the simulation under a single body lock
+     */
     void syncGameData();
 
-    void updateGameData() const;
+    /**
+     * Writes body transforms of active (and just deactivated) bodies back to their game objects, interpolated between the previous and current fixed step
+     * @param alpha fraction of a fixed step that has elapsed since the most recent step
+     */
+    void updateGameData(float alpha);
+
+    /**
+     * Queues a body to have its game transform pushed into the simulation on the next update
+     * @param bodyId
+     */
+    void markTransformDirty(JPH::BodyID bodyId);
 
     bool doesPhysicsBodyExists(const JPH::BodyID bodyId) const { return physicsObjects.contains(bodyId); }
 
@@ -81,6 +97,23 @@ public:
     JPH::BodyID setupRigidbody(IPhysicsBody* physicsBody, JPH::HeightFieldShapeSettings& heightFieldShapeSettings, JPH::EMotionType motion,
                                JPH::ObjectLayer layer);
 
+    /**
+     * Replaces a rectangle of a height field body's samples in place, without recreating the shape. Used by terrain sculpting.
+     * \n The rectangle is grown to the shape's block size, so \code heights\endcode must hold the whole \code width * height\endcode grid the shape was created from.
+     * Heights outside the shape's \code mMinHeightValue/mMaxHeightValue\endcode range are clamped by Jolt.
+     * @param physicsBody
+     * @param heights row-major \code width * height\endcode grid, (x, z) is \code heights[z * width + x]\endcode
+     * @param width
+     * @param height
+     * @param x first column of the changed rectangle
+     * @param z first row of the changed rectangle
+     * @param sizeX
+     * @param sizeZ
+     * @return false if the body is not a height field
+     */
+    bool setHeightFieldHeights(const IPhysicsBody* physicsBody, const float* heights, uint32_t width, uint32_t height, uint32_t x, uint32_t z,
+                               uint32_t sizeX, uint32_t sizeZ);
+
     void releaseRigidbody(IPhysicsBody* physicsBody);
 
     void setPositionAndRotation(JPH::BodyID bodyId, glm::vec3 position, glm::quat rotation, bool activate = true) const;
@@ -103,6 +136,25 @@ public:
 
     void drawDebug();
 
+    [[nodiscard]] PhysicsSettings getPhysicsSettings() const { return physicsSettings; }
+
+    void setPhysicsSettings(const PhysicsSettings& settings);
+
+    /**
+     * Fraction of a fixed step the simulation is currently behind the game. Used to interpolate transforms.
+     */
+    [[nodiscard]] float getInterpolationAlpha() const { return interpolationAlpha; }
+
+    /**
+     * Splits \code [0, count)\endcode into batches of at least \code minBatchSize\endcode and runs them on the physics job system. Blocks until all batches are complete,
+     * the calling thread helps execute them. Small workloads run inline on the calling thread.
+     * \n Must not be called while the physics system is updating.
+     * @param count
+     * @param minBatchSize
+     * @param function called with the \code [begin, end)\endcode range of each batch
+     */
+    void parallelFor(uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t begin, uint32_t end)>& function) const;
+
 public: // Serialization
     PhysicsProperties serializeProperties(const IPhysicsBody* physicsBody) const;
 
@@ -121,10 +173,37 @@ private:
 
     // Optional listeners
     JPH::ContactListener* contactListener = nullptr;
-    JPH::BodyActivationListener* bodyActivationListener = nullptr;
+    BodyActivationListenerImpl* bodyActivationListener = nullptr;
 
     std::unordered_map<JPH::BodyID, PhysicsObject> physicsObjects;
 
+    /**
+     * Bodies whose game transform changed since the last sync. May contain duplicates or removed bodies.
+     */
+    std::vector<JPH::BodyID> dirtyBodyQueue;
+    /**
+     * Body whose transform \code updateGameData\endcode is currently writing back, it is not queued as dirty
+     */
+    JPH::BodyID writeBackBodyId{};
+    std::vector<JPH::BodyID> syncBodyIds;
+    /**
+     * Bodies active after the most recent fixed step, only these are written back to the game
+     */
+    JPH::BodyIDVector activeBodyIds;
+    /**
+     * Bodies that went to sleep since the last write back, written back once at rest
+     */
+    std::vector<JPH::BodyID> deactivatedBodyIds;
+
+    PhysicsSettings physicsSettings{};
+    float timeAccumulator{0.0f};
+    float interpolationAlpha{0.0f};
+
+    /**
+     * Shifts the current transform of every body that moved in the last step into the previous transform and reads the new current transform
+     */
+    void storeStepState();
+
 public: // Shapes
     JPH::ShapeRefC getUnitCubeShape() const { return unitCubeShape; }
     JPH::ShapeRefC getUnitSphereShape() const { return unitSphereShape; }
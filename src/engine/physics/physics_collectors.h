@@ -0,0 +1,65 @@
+//
+// Created by William on 2025-06-28.
+//
+
+#ifndef PHYSICS_COLLECTORS_H
+#define PHYSICS_COLLECTORS_H
+
+#include <span>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollector.h>
+
+namespace will_engine::physics
+{
+/**
+ * Collects the body IDs of a query into a caller provided buffer. Never allocates, stops the query early once the buffer is full.
+ * \n Works with both broad phase (\code CollideShapeBodyCollector\endcode) and narrow phase (\code CollideShapeCollector\endcode) queries.
+ * @tparam CollectorType
+ */
+template<class CollectorType>
+class BodyBufferCollector final : public CollectorType
+{
+public:
+    using ResultType = typename CollectorType::ResultType;
+
+    explicit BodyBufferCollector(const std::span<JPH::BodyID> outBodies) : outBodies(outBodies) {}
+
+    void Reset() override
+    {
+        CollectorType::Reset();
+        count = 0;
+    }
+
+    void AddHit(const ResultType& inResult) override
+    {
+        if (count >= outBodies.size()) { return; }
+
+        const JPH::BodyID bodyId = getBodyId(inResult);
+        // Narrow phase reports hits body by body, skip repeated hits against the same body (compound shapes, triangles)
+        if (count > 0 && outBodies[count - 1] == bodyId) { return; }
+
+        outBodies[count++] = bodyId;
+        if (count == outBodies.size()) {
+            CollectorType::ForceEarlyOut();
+        }
+    }
+
+    [[nodiscard]] size_t getCount() const { return count; }
+
+private:
+    static JPH::BodyID getBodyId(const JPH::BodyID& bodyId) { return bodyId; }
+
+    static JPH::BodyID getBodyId(const JPH::CollideShapeResult& result) { return result.mBodyID2; }
+
+    std::span<JPH::BodyID> outBodies;
+    size_t count{0};
+};
+
+using BroadPhaseBodyCollector = BodyBufferCollector<JPH::CollideShapeBodyCollector>;
+using NarrowPhaseBodyCollector = BodyBufferCollector<JPH::CollideShapeCollector>;
+}
+
+#endif //PHYSICS_COLLECTORS_H
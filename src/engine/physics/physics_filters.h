@@ -102,6 +102,52 @@ public:
         return inLayer != Layers::PLAYER;
     }
 };
+
+constexpr uint32_t layerMask(const JPH::ObjectLayer layer)
+{
+    return 1u << layer;
+}
+
+/**
+ * Only accepts object layers contained in the mask. Build the mask with \code layerMask(Layers::X) | layerMask(Layers::Y)\endcode
+ */
+class ObjectLayerMaskFilter final : public JPH::ObjectLayerFilter
+{
+public:
+    explicit ObjectLayerMaskFilter(const uint32_t mask) : mask(mask) {}
+
+    [[nodiscard]] bool ShouldCollide(const JPH::ObjectLayer inLayer) const override
+    {
+        return (mask & layerMask(inLayer)) != 0;
+    }
+
+private:
+    uint32_t mask;
+};
+
+/**
+ * Only accepts broad phase layers that contain at least one object layer in the mask. Pair with \code ObjectLayerMaskFilter\endcode to skip entire broad phase trees.
+ */
+class BroadPhaseLayerMaskFilter final : public JPH::BroadPhaseLayerFilter
+{
+public:
+    BroadPhaseLayerMaskFilter(const JPH::BroadPhaseLayerInterface& broadPhaseLayerInterface, const uint32_t mask)
+    {
+        for (JPH::ObjectLayer layer = 0; layer < Layers::NUM_LAYERS; ++layer) {
+            if ((mask & layerMask(layer)) != 0) {
+                broadPhaseMask |= 1u << static_cast<JPH::BroadPhaseLayer::Type>(broadPhaseLayerInterface.GetBroadPhaseLayer(layer));
+            }
+        }
+    }
+
+    [[nodiscard]] bool ShouldCollide(const JPH::BroadPhaseLayer inLayer) const override
+    {
+        return (broadPhaseMask & 1u << static_cast<JPH::BroadPhaseLayer::Type>(inLayer)) != 0;
+    }
+
+private:
+    uint32_t broadPhaseMask{0};
+};
 }
 
 #endif //PHYSICS_FILTERS_H
@@ -0,0 +1,21 @@
+//
+// Created by William on 2025-06-27.
+//
+
+#include "physics_listeners.h"
+
+namespace will_engine::physics
+{
+void BodyActivationListenerImpl::OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData)
+{
+    std::lock_guard lock(deactivatedMutex);
+    deactivatedBodies.push_back(inBodyID);
+}
+
+void BodyActivationListenerImpl::consumeDeactivatedBodies(std::vector<JPH::BodyID>& outBodyIds)
+{
+    std::lock_guard lock(deactivatedMutex);
+    outBodyIds.insert(outBodyIds.end(), deactivatedBodies.begin(), deactivatedBodies.end());
+    deactivatedBodies.clear();
+}
+}
@@ -0,0 +1,40 @@
+//
+// Created by William on 2025-06-27.
+//
+
+#ifndef PHYSICS_LISTENERS_H
+#define PHYSICS_LISTENERS_H
+
+#include <mutex>
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyActivationListener.h>
+#include <Jolt/Physics/Body/BodyID.h>
+
+namespace will_engine::physics
+{
+/**
+ * Records bodies that went to sleep during a physics step so their final rest transform can be written back once.
+ * \n Jolt calls this from job threads, everything here must be thread safe.
+ */
+class BodyActivationListenerImpl final : public JPH::BodyActivationListener
+{
+public:
+    void OnBodyActivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override {}
+
+    void OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override;
+
+    /**
+     * Appends all bodies deactivated since the last call to \code outBodyIds\endcode and clears the internal list
+     * @param outBodyIds
+     */
+    void consumeDeactivatedBodies(std::vector<JPH::BodyID>& outBodyIds);
+
+private:
+    std::mutex deactivatedMutex;
+    std::vector<JPH::BodyID> deactivatedBodies;
+};
+}
+
+#endif //PHYSICS_LISTENERS_H
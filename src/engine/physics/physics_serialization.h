@@ -0,0 +1,63 @@
+//
+// Created by William on 2025-06-28.
+//
+
+#ifndef PHYSICS_SERIALIZATION_H
+#define PHYSICS_SERIALIZATION_H
+
+#include <json/json.hpp>
+
+#include "physics_types.h"
+
+namespace will_engine::physics
+{
+using ordered_json = nlohmann::ordered_json;
+
+inline void to_json(ordered_json& j, const PhysicsProperties& p)
+{
+    j = {
+        {"isActive", p.isActive},
+        {"motionType", p.motionType},
+        {"layer", p.layer},
+        {"shapeType", p.shapeType},
+        {
+            "offset", {
+                {"x", p.offset.x},
+                {"y", p.offset.y},
+                {"z", p.offset.z}
+            }
+        },
+        {
+            "shapeParams", {
+                {"x", p.shapeParams.x},
+                {"y", p.shapeParams.y},
+                {"z", p.shapeParams.z}
+            }
+        }
+    };
+}
+
+inline void from_json(const ordered_json& j, PhysicsProperties& props)
+{
+    props.isActive = j["isActive"].get<bool>();
+    props.motionType = j["motionType"].get<uint8_t>();
+    props.layer = (j["layer"].get<uint16_t>());
+    props.shapeType = j["shapeType"].get<JPH::EShapeSubType>();
+    if (j.contains("shapeParams")) {
+        props.shapeParams = glm::vec3(
+            j["shapeParams"]["x"].get<float>(),
+            j["shapeParams"]["y"].get<float>(),
+            j["shapeParams"]["z"].get<float>()
+        );
+    }
+    if (j.contains("offset")) {
+        props.offset = glm::vec3(
+            j["offset"]["x"].get<float>(),
+            j["offset"]["y"].get<float>(),
+            j["offset"]["z"].get<float>()
+        );
+    }
+}
+}
+
+#endif //PHYSICS_SERIALIZATION_H
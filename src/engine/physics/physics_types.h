@@ -6,6 +6,7 @@
 #define PHYSICS_TYPES_H
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <Jolt/Jolt.h>
 #include <Jolt/Physics/Body/BodyID.h>
 #include <Jolt/Physics/Body/MotionType.h>
@@ -39,11 +40,97 @@ struct RaycastHit
     }
 };
 
+struct DistanceHit
+{
+    bool hasHit = false;
+    float distance = 0.0f;
+    glm::vec3 pointOnBody{0.0f};
+    JPH::BodyID bodyId;
+    JPH::SubShapeID subShapeID;
+
+    bool operator!() const
+    {
+        return !hasHit;
+    }
+
+    explicit operator bool() const
+    {
+        return hasHit;
+    }
+};
+
+struct RaycastQuery
+{
+    glm::vec3 start{0.0f};
+    glm::vec3 end{0.0f};
+};
+
+struct SphereCastQuery
+{
+    glm::vec3 start{0.0f};
+    glm::vec3 end{0.0f};
+    float radius{0.5f};
+};
+
+struct BoxCastQuery
+{
+    glm::vec3 start{0.0f};
+    glm::vec3 end{0.0f};
+    glm::vec3 halfExtents{0.5f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+struct OverlapSphereQuery
+{
+    glm::vec3 center{0.0f};
+    float radius{0.5f};
+};
+
+struct OverlapBoxQuery
+{
+    glm::vec3 center{0.0f};
+    glm::vec3 halfExtents{0.5f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
 struct PhysicsObject
 {
     IPhysicsBody* physicsBody;
     JPH::BodyID bodyId;
     JPH::ShapeRefC shape = nullptr;
+
+    /**
+     * Body transform before the most recent fixed step, used to interpolate the game transform between steps
+     */
+    glm::vec3 previousPosition{0.0f};
+    glm::quat previousRotation{1.0f, 0.0f, 0.0f, 0.0f};
+    /**
+     * Body transform after the most recent fixed step
+     */
+    glm::vec3 currentPosition{0.0f};
+    glm::quat currentRotation{1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+struct PhysicsSettings
+{
+    /**
+     * Number of fixed simulation steps per second
+     */
+    float stepRate{60.0f};
+    /**
+     * Collision steps performed by Jolt within a single fixed step
+     */
+    int32_t collisionSteps{1};
+    /**
+     * Upper bound of fixed steps taken in a single frame. Simulation time beyond this is dropped to avoid a spiral of death
+     */
+    int32_t maxSubsteps{4};
+    /**
+     * Interpolate game transforms between the previous and current fixed step
+     */
+    bool bInterpolate{true};
+
+    [[nodiscard]] float getFixedTimestep() const { return 1.0f / stepRate; }
 };
 
 struct PhysicsProperties
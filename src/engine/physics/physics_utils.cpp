@@ -4,7 +4,79 @@
 
 #include "physics_utils.h"
 
+#include <fmt/format.h>
+
+#include <Jolt/Geometry/AABox.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+
+#include "physics_collectors.h"
+
+namespace will_engine::physics
+{
+static RaycastHit castShape(const JPH::Shape& shape, const glm::vec3& start, const glm::vec3& end, const glm::quat& rotation, const JPH::BroadPhaseLayerFilter& broadLayerFilter,
+                            const JPH::ObjectLayerFilter& objectLayerFilter, const JPH::BodyFilter& bodyFilter)
+{
+    RaycastHit result;
+
+    const JPH::RMat44 startTransform = JPH::RMat44::sRotationTranslation(PhysicsUtils::toJolt(rotation), PhysicsUtils::toJolt(start));
+    const JPH::RShapeCast shapeCast = JPH::RShapeCast::sFromWorldTransform(&shape, JPH::Vec3::sReplicate(1.0f), startTransform, PhysicsUtils::toJolt(end - start));
+
+    JPH::ShapeCastSettings settings;
+    settings.mReturnDeepestPoint = true;
+
+    JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+    Physics::get()->getPhysicsSystem().GetNarrowPhaseQuery().CastShape(shapeCast, settings, JPH::RVec3::sZero(), collector, broadLayerFilter, objectLayerFilter, bodyFilter);
+
+    if (collector.HadHit()) {
+        const JPH::ShapeCastResult& hit = collector.mHit;
+        result.hasHit = true;
+        result.fraction = hit.mFraction;
+        result.distance = glm::distance(start, end) * hit.mFraction;
+        result.hitPosition = PhysicsUtils::toGLM(hit.mContactPointOn2);
+        result.hitBodyID = hit.mBodyID2;
+        result.subShapeID = hit.mSubShapeID2;
+        // Penetration axis points from the cast shape into the hit body
+        if (hit.mPenetrationAxis.LengthSq() > 0.0f) {
+            result.hitNormal = PhysicsUtils::toGLM(-hit.mPenetrationAxis.Normalized());
+        }
+    }
+
+    return result;
+}
+
+static size_t overlapShape(const JPH::Shape& shape, const glm::vec3& center, const glm::quat& rotation, const std::span<JPH::BodyID> outBodies,
+                           const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter, const JPH::BodyFilter& bodyFilter)
+{
+    const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation(PhysicsUtils::toJolt(rotation), PhysicsUtils::toJolt(center));
+
+    JPH::CollideShapeSettings settings;
+    settings.mCollectFacesMode = JPH::ECollectFacesMode::NoFaces;
+
+    NarrowPhaseBodyCollector collector{outBodies};
+    Physics::get()->getPhysicsSystem().GetNarrowPhaseQuery().CollideShape(&shape, JPH::Vec3::sReplicate(1.0f), transform * JPH::Mat44::sTranslation(shape.GetCenterOfMass()),
+                                                                         settings, JPH::RVec3::sZero(), collector, broadLayerFilter, objectLayerFilter, bodyFilter);
+    return collector.getCount();
+}
+
+/**
+ * Queries are cheap individually, batching them keeps job overhead small relative to the work
+ */
+static constexpr uint32_t QUERY_BATCH_SIZE = 32;
+
+static bool validateBatch(const char* name, const size_t queryCount, const size_t outputCount)
+{
+    if (!Physics::get()) { return false; }
+    if (outputCount < queryCount) {
+        fmt::print("Warning: {} output buffer too small ({} < {}), batch was not executed\n", name, outputCount, queryCount);
+        return false;
+    }
+    return true;
+}
+}
 
 glm::vec3 will_engine::physics::PhysicsUtils::toGLM(const JPH::Vec3& vec)
 {
@@ -222,6 +294,194 @@ JPH::ObjectLayer will_engine::physics::PhysicsUtils::getObjectLayer(const JPH::B
 
 
 
+will_engine::physics::RaycastHit will_engine::physics::PhysicsUtils::sphereCast(const glm::vec3& start, const glm::vec3& end, const float radius,
+                                                                                const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                                                const JPH::BodyFilter& bodyFilter)
+{
+    if (!Physics::get()) return {};
+    if (radius <= 0.0f) { return raycast(start, end, broadLayerFilter, objectLayerFilter, bodyFilter); }
+
+    // Query shapes live on the stack, embedded so the ref counting does not try to free them
+    JPH::SphereShape sphere{radius};
+    sphere.SetEmbedded();
+
+    return castShape(sphere, start, end, glm::identity<glm::quat>(), broadLayerFilter, objectLayerFilter, bodyFilter);
+}
+
+will_engine::physics::RaycastHit will_engine::physics::PhysicsUtils::boxCast(const glm::vec3& start, const glm::vec3& end, const glm::vec3& halfExtents, const glm::quat& rotation,
+                                                                             const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                                             const JPH::BodyFilter& bodyFilter)
+{
+    if (!Physics::get()) return {};
+
+    const glm::vec3 extents = glm::max(halfExtents, glm::vec3(0.001f));
+    JPH::BoxShape box{toJolt(extents), glm::min(JPH::cDefaultConvexRadius, glm::min(extents.x, glm::min(extents.y, extents.z)))};
+    box.SetEmbedded();
+
+    return castShape(box, start, end, rotation, broadLayerFilter, objectLayerFilter, bodyFilter);
+}
+
+size_t will_engine::physics::PhysicsUtils::overlapSphere(const glm::vec3& center, const float radius, const std::span<JPH::BodyID> outBodies,
+                                                         const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                         const JPH::BodyFilter& bodyFilter)
+{
+    if (!Physics::get()) return 0;
+    if (outBodies.empty() || radius <= 0.0f) { return 0; }
+
+    JPH::SphereShape sphere{radius};
+    sphere.SetEmbedded();
+
+    return overlapShape(sphere, center, glm::identity<glm::quat>(), outBodies, broadLayerFilter, objectLayerFilter, bodyFilter);
+}
+
+size_t will_engine::physics::PhysicsUtils::overlapBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::quat& rotation, const std::span<JPH::BodyID> outBodies,
+                                                      const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                      const JPH::BodyFilter& bodyFilter)
+{
+    if (!Physics::get()) return 0;
+    if (outBodies.empty()) { return 0; }
+
+    const glm::vec3 extents = glm::max(halfExtents, glm::vec3(0.001f));
+    JPH::BoxShape box{toJolt(extents), glm::min(JPH::cDefaultConvexRadius, glm::min(extents.x, glm::min(extents.y, extents.z)))};
+    box.SetEmbedded();
+
+    return overlapShape(box, center, rotation, outBodies, broadLayerFilter, objectLayerFilter, bodyFilter);
+}
+
+size_t will_engine::physics::PhysicsUtils::overlapSphereBroad(const glm::vec3& center, const float radius, const std::span<JPH::BodyID> outBodies,
+                                                              const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter)
+{
+    if (!Physics::get()) return 0;
+    if (outBodies.empty()) { return 0; }
+
+    BroadPhaseBodyCollector collector{outBodies};
+    Physics::get()->getPhysicsSystem().GetBroadPhaseQuery().CollideSphere(toJolt(center), radius, collector, broadLayerFilter, objectLayerFilter);
+    return collector.getCount();
+}
+
+size_t will_engine::physics::PhysicsUtils::overlapBoxBroad(const glm::vec3& center, const glm::vec3& halfExtents, const std::span<JPH::BodyID> outBodies,
+                                                           const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter)
+{
+    if (!Physics::get()) return 0;
+    if (outBodies.empty()) { return 0; }
+
+    const JPH::AABox box{toJolt(center - halfExtents), toJolt(center + halfExtents)};
+    BroadPhaseBodyCollector collector{outBodies};
+    Physics::get()->getPhysicsSystem().GetBroadPhaseQuery().CollideAABox(box, collector, broadLayerFilter, objectLayerFilter);
+    return collector.getCount();
+}
+
+will_engine::physics::DistanceHit will_engine::physics::PhysicsUtils::getClosestBody(const glm::vec3& point, const float maxDistance,
+                                                                                     const JPH::BroadPhaseLayerFilter& broadLayerFilter,
+                                                                                     const JPH::ObjectLayerFilter& objectLayerFilter, const JPH::BodyFilter& bodyFilter)
+{
+    DistanceHit result;
+    if (!Physics::get()) return result;
+
+    // Collide a tiny probe sphere and let the max separation distance pick up bodies that are not touching it.
+    // Closest hit collector keeps the deepest penetration, which is the nearest surface.
+    constexpr float probeRadius = 0.001f;
+    JPH::SphereShape probe{probeRadius};
+    probe.SetEmbedded();
+
+    JPH::CollideShapeSettings settings;
+    settings.mMaxSeparationDistance = glm::max(maxDistance - probeRadius, 0.0f);
+    settings.mCollectFacesMode = JPH::ECollectFacesMode::NoFaces;
+
+    JPH::ClosestHitCollisionCollector<JPH::CollideShapeCollector> collector;
+    Physics::get()->getPhysicsSystem().GetNarrowPhaseQuery().CollideShape(&probe, JPH::Vec3::sReplicate(1.0f), JPH::RMat44::sTranslation(toJolt(point)), settings,
+                                                                         JPH::RVec3::sZero(), collector, broadLayerFilter, objectLayerFilter, bodyFilter);
+
+    if (collector.HadHit()) {
+        const JPH::CollideShapeResult& hit = collector.mHit;
+        result.hasHit = true;
+        result.distance = glm::max(probeRadius - hit.mPenetrationDepth, 0.0f);
+        result.pointOnBody = toGLM(hit.mContactPointOn2);
+        result.bodyId = hit.mBodyID2;
+        result.subShapeID = hit.mSubShapeID2;
+    }
+
+    return result;
+}
+
+bool will_engine::physics::PhysicsUtils::raycastBatch(const std::span<const RaycastQuery> queries, const std::span<RaycastHit> outHits,
+                                                     const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                     const JPH::BodyFilter& bodyFilter)
+{
+    if (!validateBatch("raycastBatch", queries.size(), outHits.size())) { return false; }
+
+    Physics::get()->parallelFor(static_cast<uint32_t>(queries.size()), QUERY_BATCH_SIZE, [&](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            outHits[i] = raycast(queries[i].start, queries[i].end, broadLayerFilter, objectLayerFilter, bodyFilter);
+        }
+    });
+    return true;
+}
+
+bool will_engine::physics::PhysicsUtils::sphereCastBatch(const std::span<const SphereCastQuery> queries, const std::span<RaycastHit> outHits,
+                                                        const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                        const JPH::BodyFilter& bodyFilter)
+{
+    if (!validateBatch("sphereCastBatch", queries.size(), outHits.size())) { return false; }
+
+    Physics::get()->parallelFor(static_cast<uint32_t>(queries.size()), QUERY_BATCH_SIZE, [&](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            outHits[i] = sphereCast(queries[i].start, queries[i].end, queries[i].radius, broadLayerFilter, objectLayerFilter, bodyFilter);
+        }
+    });
+    return true;
+}
+
+bool will_engine::physics::PhysicsUtils::boxCastBatch(const std::span<const BoxCastQuery> queries, const std::span<RaycastHit> outHits,
+                                                     const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                     const JPH::BodyFilter& bodyFilter)
+{
+    if (!validateBatch("boxCastBatch", queries.size(), outHits.size())) { return false; }
+
+    Physics::get()->parallelFor(static_cast<uint32_t>(queries.size()), QUERY_BATCH_SIZE, [&](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const BoxCastQuery& query = queries[i];
+            outHits[i] = boxCast(query.start, query.end, query.halfExtents, query.rotation, broadLayerFilter, objectLayerFilter, bodyFilter);
+        }
+    });
+    return true;
+}
+
+bool will_engine::physics::PhysicsUtils::overlapSphereBatch(const std::span<const OverlapSphereQuery> queries, const uint32_t maxBodiesPerQuery,
+                                                           const std::span<JPH::BodyID> outBodies, const std::span<uint32_t> outCounts,
+                                                           const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                           const JPH::BodyFilter& bodyFilter)
+{
+    if (!validateBatch("overlapSphereBatch", queries.size(), outCounts.size())) { return false; }
+    if (!validateBatch("overlapSphereBatch", queries.size() * maxBodiesPerQuery, outBodies.size())) { return false; }
+
+    Physics::get()->parallelFor(static_cast<uint32_t>(queries.size()), QUERY_BATCH_SIZE, [&](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const std::span<JPH::BodyID> queryBodies = outBodies.subspan(static_cast<size_t>(i) * maxBodiesPerQuery, maxBodiesPerQuery);
+            outCounts[i] = static_cast<uint32_t>(overlapSphere(queries[i].center, queries[i].radius, queryBodies, broadLayerFilter, objectLayerFilter, bodyFilter));
+        }
+    });
+    return true;
+}
+
+bool will_engine::physics::PhysicsUtils::overlapBoxBatch(const std::span<const OverlapBoxQuery> queries, const uint32_t maxBodiesPerQuery,
+                                                        const std::span<JPH::BodyID> outBodies, const std::span<uint32_t> outCounts,
+                                                        const JPH::BroadPhaseLayerFilter& broadLayerFilter, const JPH::ObjectLayerFilter& objectLayerFilter,
+                                                        const JPH::BodyFilter& bodyFilter)
+{
+    if (!validateBatch("overlapBoxBatch", queries.size(), outCounts.size())) { return false; }
+    if (!validateBatch("overlapBoxBatch", queries.size() * maxBodiesPerQuery, outBodies.size())) { return false; }
+
+    Physics::get()->parallelFor(static_cast<uint32_t>(queries.size()), QUERY_BATCH_SIZE, [&](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const OverlapBoxQuery& query = queries[i];
+            const std::span<JPH::BodyID> queryBodies = outBodies.subspan(static_cast<size_t>(i) * maxBodiesPerQuery, maxBodiesPerQuery);
+            outCounts[i] = static_cast<uint32_t>(overlapBox(query.center, query.halfExtents, query.rotation, queryBodies, broadLayerFilter, objectLayerFilter, bodyFilter));
+        }
+    });
+    return true;
+}
+
 JPH::EShapeSubType will_engine::physics::PhysicsUtils::getObjectShapeSubtype(JPH::BodyID bodyId)
 {
     if (!Physics::get()) return JPH::EShapeSubType::Empty;
@@ -8,6 +8,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <span>
+
 #include "physics_types.h"
 #include "Jolt/Physics/Collision/CastResult.h"
 #include "Jolt/Physics/Collision/RayCast.h"
@@ -103,18 +105,141 @@ public:
 
     static JPH::EShapeSubType getObjectShapeSubtype(JPH::BodyID bodyId);
 
-    //inline RaycastHit sphereCast(const glm::vec3& start, const glm::vec3& end, float radius);
-    //inline RaycastHit boxCast(const glm::vec3& start, const glm::vec3& end, const glm::vec3& halfExtents);
-    // inline std::vector<JPH::BodyID> overlapSphere(const glm::vec3& center, float radius);
-    // inline std::vector<JPH::BodyID> overlapBox(const glm::vec3& center, const glm::vec3& halfExtents);
+    /**
+     * Sweeps a sphere from \code start\endcode to \code end\endcode and finds the closest hit.
+     * \n Bodies already overlapping the sphere at \code start\endcode are reported with a fraction of 0.
+     * @param start
+     * @param end
+     * @param radius
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return
+     */
+    static RaycastHit sphereCast(const glm::vec3& start, const glm::vec3& end, float radius, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                                 const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Sweeps an oriented box from \code start\endcode to \code end\endcode and finds the closest hit.
+     * \n Bodies already overlapping the box at \code start\endcode are reported with a fraction of 0.
+     * @param start
+     * @param end
+     * @param halfExtents
+     * @param rotation
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return
+     */
+    static RaycastHit boxCast(const glm::vec3& start, const glm::vec3& end, const glm::vec3& halfExtents, const glm::quat& rotation = glm::identity<glm::quat>(),
+                              const JPH::BroadPhaseLayerFilter& broadLayerFilter = {}, const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Finds all bodies whose shapes overlap the sphere. Results are written to \code outBodies\endcode, the query stops once it is full.
+     * \n Does not allocate.
+     * @param center
+     * @param radius
+     * @param outBodies
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return the number of bodies written to \code outBodies\endcode
+     */
+    static size_t overlapSphere(const glm::vec3& center, float radius, std::span<JPH::BodyID> outBodies, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                                const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Finds all bodies whose shapes overlap the oriented box. Results are written to \code outBodies\endcode, the query stops once it is full.
+     * \n Does not allocate.
+     * @param center
+     * @param halfExtents
+     * @param rotation
+     * @param outBodies
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return the number of bodies written to \code outBodies\endcode
+     */
+    static size_t overlapBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::quat& rotation, std::span<JPH::BodyID> outBodies,
+                             const JPH::BroadPhaseLayerFilter& broadLayerFilter = {}, const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Broad phase only, finds all bodies whose bounding boxes overlap the sphere. Cheaper but less precise than \code overlapSphere\endcode.
+     * @return the number of bodies written to \code outBodies\endcode
+     */
+    static size_t overlapSphereBroad(const glm::vec3& center, float radius, std::span<JPH::BodyID> outBodies, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                                     const JPH::ObjectLayerFilter& objectLayerFilter = {});
+
+    /**
+     * Broad phase only, finds all bodies whose bounding boxes overlap the axis aligned box. Cheaper but less precise than \code overlapBox\endcode.
+     * @return the number of bodies written to \code outBodies\endcode
+     */
+    static size_t overlapBoxBroad(const glm::vec3& center, const glm::vec3& halfExtents, std::span<JPH::BodyID> outBodies, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                                  const JPH::ObjectLayerFilter& objectLayerFilter = {});
+
+    /**
+     * Finds the body surface closest to \code point\endcode within \code maxDistance\endcode.
+     * \n If the point is inside a body, that body is returned with a distance of 0.
+     * @param point
+     * @param maxDistance
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return
+     */
+    static DistanceHit getClosestBody(const glm::vec3& point, float maxDistance, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                                      const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Executes a batch of raycasts across the physics job system. \code outHits[i]\endcode receives the closest hit of \code queries[i]\endcode.
+     * \n Filters are shared by every query in the batch and must be safe to call from multiple threads.
+     * @param queries
+     * @param outHits must be at least as large as \code queries\endcode
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return false if the batch was not executed
+     */
+    static bool raycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastHit> outHits, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                             const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Batched \code sphereCast\endcode, see \code raycastBatch\endcode.
+     */
+    static bool sphereCastBatch(std::span<const SphereCastQuery> queries, std::span<RaycastHit> outHits, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                                const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Batched \code boxCast\endcode, see \code raycastBatch\endcode.
+     */
+    static bool boxCastBatch(std::span<const BoxCastQuery> queries, std::span<RaycastHit> outHits, const JPH::BroadPhaseLayerFilter& broadLayerFilter = {},
+                             const JPH::ObjectLayerFilter& objectLayerFilter = {}, const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Executes a batch of sphere overlaps across the physics job system.
+     * \n Query \code i\endcode writes up to \code maxBodiesPerQuery\endcode bodies to \code outBodies[i * maxBodiesPerQuery]\endcode and its count to \code outCounts[i]\endcode.
+     * @param queries
+     * @param maxBodiesPerQuery
+     * @param outBodies must hold at least \code queries.size() * maxBodiesPerQuery\endcode ids
+     * @param outCounts must be at least as large as \code queries\endcode
+     * @param broadLayerFilter
+     * @param objectLayerFilter
+     * @param bodyFilter
+     * @return false if the batch was not executed
+     */
+    static bool overlapSphereBatch(std::span<const OverlapSphereQuery> queries, uint32_t maxBodiesPerQuery, std::span<JPH::BodyID> outBodies, std::span<uint32_t> outCounts,
+                                   const JPH::BroadPhaseLayerFilter& broadLayerFilter = {}, const JPH::ObjectLayerFilter& objectLayerFilter = {},
+                                   const JPH::BodyFilter& bodyFilter = {});
+
+    /**
+     * Batched \code overlapBox\endcode, see \code overlapSphereBatch\endcode.
+     */
+    static bool overlapBoxBatch(std::span<const OverlapBoxQuery> queries, uint32_t maxBodiesPerQuery, std::span<JPH::BodyID> outBodies, std::span<uint32_t> outCounts,
+                                const JPH::BroadPhaseLayerFilter& broadLayerFilter = {}, const JPH::ObjectLayerFilter& objectLayerFilter = {},
+                                const JPH::BodyFilter& bodyFilter = {});
+
     // inline bool isPointInShape(const glm::vec3& point, JPH::BodyID bodyId);
     // inline std::vector<JPH::BodyID> getBodiesTouchingPoint(const glm::vec3& point);
-    // struct DistanceHit {
-    //     float distance;
-    //     glm::vec3 pointOnBody;
-    //     JPH::BodyID. bodyId;
-    // };
-    // inline DistanceHit getClosestBody(const glm::vec3& point);
 };
 };
 
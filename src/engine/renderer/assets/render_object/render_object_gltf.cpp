@@ -13,6 +13,7 @@
 #include "engine/renderer/vulkan_context.h"
 #include "render_object_constants.h"
 #include "engine/core/game_object/game_object_factory.h"
+#include "engine/core/profiler/memory_tracker.h"
 #include "engine/renderer/vk_helpers.h"
 #include "engine/renderer/resources/buffer.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_sampler.h"
@@ -282,6 +283,7 @@ std::vector<Primitive> RenderObjectGltf::getPrimitives(const int32_t meshIndex)
 bool RenderObjectGltf::parseGltf(const std::filesystem::path& gltfFilepath, std::vector<MaterialProperties>& materials, std::vector<VertexPosition>& vertexPositions,
                                  std::vector<VertexProperty>& vertexProperties, std::vector<uint32_t>& indices, std::vector<Primitive>& primitives)
 {
+    WILL_MEMORY_TAG(Assets);
     auto start = std::chrono::system_clock::now();
 
     fastgltf::Parser parser{
@@ -561,6 +563,7 @@ bool RenderObjectGltf::parseGltf(const std::filesystem::path& gltfFilepath, std:
 
 void RenderObjectGltf::load()
 {
+    WILL_MEMORY_TAG(Assets);
     if (bIsLoaded) {
         fmt::print("Render Object attempted to load when it is already loaded");
         return;
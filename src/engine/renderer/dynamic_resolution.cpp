@@ -0,0 +1,49 @@
+//
+// Created by William on 2025-07-08.
+//
+
+#include "dynamic_resolution.h"
+
+#include <glm/glm.hpp>
+
+#include "gpu_profiler.h"
+
+namespace will_engine::renderer
+{
+float DynamicResolution::beginFrame()
+{
+    if (gpuProfiler.getFrameDurationSampleCount() != lastFrameDurationSampleCount) {
+        lastFrameDurationSampleCount = gpuProfiler.getFrameDurationSampleCount();
+        updateScale(gpuProfiler.getLastFrameDuration());
+    }
+
+    return settings.bEnabled ? scale : 1.0f;
+}
+
+bool DynamicResolution::isSupported() const
+{
+    return gpuProfiler.isSupported();
+}
+
+void DynamicResolution::updateScale(const float gpuFrameTimeMs)
+{
+    // React quickly to spikes, recover slowly
+    const float smoothing = gpuFrameTimeMs > smoothedGpuFrameTimeMs ? 0.5f : 0.1f;
+    smoothedGpuFrameTimeMs = smoothedGpuFrameTimeMs <= 0.0f ? gpuFrameTimeMs : glm::mix(smoothedGpuFrameTimeMs, gpuFrameTimeMs, smoothing);
+
+    if (!settings.bEnabled) {
+        scale = settings.maxScale;
+        return;
+    }
+
+    const float error = smoothedGpuFrameTimeMs / settings.targetFrameTimeMs;
+    if (glm::abs(error - 1.0f) <= settings.tolerance) {
+        return;
+    }
+
+    // GPU cost is roughly proportional to the pixel count, i.e. the square of the scale
+    const float desiredScale = scale * glm::sqrt(1.0f / glm::max(error, 0.01f));
+    const float step = glm::clamp(desiredScale - scale, -settings.maxScaleStep, settings.maxScaleStep);
+    scale = glm::clamp(scale + step, settings.minScale, settings.maxScale);
+}
+}
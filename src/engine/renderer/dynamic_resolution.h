@@ -0,0 +1,76 @@
+//
+// Created by William on 2025-07-08.
+//
+
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <cstdint>
+
+namespace will_engine::renderer
+{
+class GpuProfiler;
+
+struct DynamicResolutionSettings
+{
+    bool bEnabled{false};
+    /**
+     * GPU frame time the controller aims for, in milliseconds
+     */
+    float targetFrameTimeMs{16.0f};
+    float minScale{0.5f};
+    float maxScale{1.0f};
+    /**
+     * Largest change to the scale per frame, keeps single frame spikes from visibly pumping the resolution
+     */
+    float maxScaleStep{0.05f};
+    /**
+     * The scale is left alone while the GPU time is within this fraction of the target
+     */
+    float tolerance{0.05f};
+};
+
+/**
+ * Picks the fraction of the render targets rendered to each frame from the measured GPU frame time.
+ * Frame times come from the \code GpuProfiler\endcode's frame timestamps, which are read back without stalling.
+ */
+class DynamicResolution
+{
+public:
+    explicit DynamicResolution(const GpuProfiler& gpuProfiler) : gpuProfiler(gpuProfiler) {}
+
+    DynamicResolution(const DynamicResolution&) = delete;
+
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    /**
+     * Updates the scale if the GPU profiler read back a new frame time, call after \code GpuProfiler::beginFrame\endcode.
+     * @return the viewport scale to render this frame with
+     */
+    float beginFrame();
+
+    [[nodiscard]] float getScale() const { return scale; }
+
+    /**
+     * @return the last measured GPU frame time in milliseconds, smoothed over a few frames
+     */
+    [[nodiscard]] float getGpuFrameTimeMs() const { return smoothedGpuFrameTimeMs; }
+
+    [[nodiscard]] bool isSupported() const;
+
+public:
+    DynamicResolutionSettings settings{};
+
+private:
+    void updateScale(float gpuFrameTimeMs);
+
+private:
+    const GpuProfiler& gpuProfiler;
+    uint32_t lastFrameDurationSampleCount{0};
+
+    float smoothedGpuFrameTimeMs{0.0f};
+    float scale{1.0f};
+};
+}
+
+#endif //DYNAMIC_RESOLUTION_H
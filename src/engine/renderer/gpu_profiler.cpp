@@ -0,0 +1,260 @@
+//
+// Created by William on 2025-07-09.
+//
+
+#include "gpu_profiler.h"
+
+#include <cassert>
+
+#include <fmt/format.h>
+#include <volk/volk.h>
+
+#include "vk_helpers.h"
+#include "vulkan_context.h"
+
+namespace will_engine::renderer
+{
+static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+static constexpr uint32_t PIPELINE_STATISTICS_COUNT = 5;
+
+GpuProfiler::GpuProfiler(const VulkanContext& context) : context(context)
+{
+    uint32_t queueFamilyCount{0};
+    vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    const uint32_t validBits = queueFamilies[context.graphicsQueueFamily].timestampValidBits;
+    if (validBits == 0) {
+        fmt::print("Warning: Graphics queue does not support timestamps, GPU profiling and dynamic resolution are unavailable\n");
+        return;
+    }
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(context.physicalDevice, &properties);
+    timestampPeriod = properties.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo timestampPoolInfo{};
+    timestampPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    timestampPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    timestampPoolInfo.queryCount = TIMESTAMPS_PER_FRAME * FRAME_OVERLAP;
+    VK_CHECK(vkCreateQueryPool(context.device, &timestampPoolInfo, nullptr, &timestampPool));
+
+    if (context.bPipelineStatisticsQuery) {
+        VkQueryPoolCreateInfo statisticsPoolInfo{};
+        statisticsPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        statisticsPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statisticsPoolInfo.queryCount = MAX_SCOPES_PER_FRAME * FRAME_OVERLAP;
+        statisticsPoolInfo.pipelineStatistics = PIPELINE_STATISTICS;
+        VK_CHECK(vkCreateQueryPool(context.device, &statisticsPoolInfo, nullptr, &statisticsPool));
+    }
+
+    if (context.hasAsyncComputeQueue()) {
+        const uint32_t computeValidBits = queueFamilies[context.computeQueueFamily].timestampValidBits;
+        if (computeValidBits > 0) {
+            computeTimestampMask = computeValidBits >= 64 ? ~0ull : (1ull << computeValidBits) - 1;
+            VK_CHECK(vkCreateQueryPool(context.device, &timestampPoolInfo, nullptr, &computeTimestampPool));
+        }
+        else {
+            fmt::print("Warning: Compute queue does not support timestamps, async compute passes are not profiled\n");
+        }
+    }
+
+    timestampResults.resize(MAX_SCOPES_PER_FRAME * 2);
+    statisticsResults.resize(MAX_SCOPES_PER_FRAME * PIPELINE_STATISTICS_COUNT);
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    if (timestampPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(context.device, timestampPool, nullptr);
+    }
+    if (statisticsPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(context.device, statisticsPool, nullptr);
+    }
+    if (computeTimestampPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(context.device, computeTimestampPool, nullptr);
+    }
+}
+
+void GpuProfiler::beginFrame(VkCommandBuffer cmd, const int32_t frameOverlap)
+{
+    bFrameRecording = false;
+    if (timestampPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    currentFrameOverlap = frameOverlap;
+    FrameQueries& frame = frames[frameOverlap];
+
+    if (frame.bFrameTimestampsWritten) {
+        readFrameDuration(frameOverlap);
+    }
+
+    if (!frame.scopeIndices.empty() || !frame.computeScopeIndices.empty()) {
+        lastFrameTime = 0.0f;
+    }
+
+    const auto scopeCount = static_cast<uint32_t>(frame.scopeIndices.size());
+    if (scopeCount > 0) {
+        readTimestamps(timestampPool, timestampMask, frameOverlap, frame.scopeIndices);
+
+        if (frame.bPipelineStatistics) {
+            const VkResult statisticsResult = vkGetQueryPoolResults(context.device, statisticsPool, frameOverlap * MAX_SCOPES_PER_FRAME, scopeCount,
+                                                                    scopeCount * PIPELINE_STATISTICS_COUNT * sizeof(uint64_t), statisticsResults.data(),
+                                                                    PIPELINE_STATISTICS_COUNT * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (statisticsResult == VK_SUCCESS) {
+                for (uint32_t i = 0; i < scopeCount; ++i) {
+                    const uint64_t* values = &statisticsResults[i * PIPELINE_STATISTICS_COUNT];
+                    GpuPipelineStatistics& statistics = scopes[frame.scopeIndices[i]].statistics;
+                    // Results are in the order of the flag bits
+                    statistics.inputAssemblyPrimitives = values[0];
+                    statistics.vertexShaderInvocations = values[1];
+                    statistics.clippingPrimitives = values[2];
+                    statistics.fragmentShaderInvocations = values[3];
+                    statistics.computeShaderInvocations = values[4];
+                }
+            }
+        }
+    }
+
+    if (!frame.computeScopeIndices.empty()) {
+        readTimestamps(computeTimestampPool, computeTimestampMask, frameOverlap, frame.computeScopeIndices);
+    }
+
+    frame.scopeIndices.clear();
+    frame.computeScopeIndices.clear();
+    frame.bPipelineStatistics = bPipelineStatistics && statisticsPool != VK_NULL_HANDLE;
+    frame.bFrameTimestampsWritten = false;
+
+    // The compute pool is reset on the compute queue, in the frame's first async compute scope
+    const uint32_t firstQuery = frameOverlap * TIMESTAMPS_PER_FRAME;
+    vkCmdResetQueryPool(cmd, timestampPool, firstQuery, TIMESTAMPS_PER_FRAME);
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, timestampPool, firstQuery + MAX_SCOPES_PER_FRAME * 2);
+
+    if (!bEnabled) {
+        return;
+    }
+
+    if (frame.bPipelineStatistics) {
+        vkCmdResetQueryPool(cmd, statisticsPool, frameOverlap * MAX_SCOPES_PER_FRAME, MAX_SCOPES_PER_FRAME);
+    }
+    bFrameRecording = true;
+}
+
+void GpuProfiler::endFrame(VkCommandBuffer cmd)
+{
+    if (timestampPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, timestampPool, currentFrameOverlap * TIMESTAMPS_PER_FRAME + MAX_SCOPES_PER_FRAME * 2 + 1);
+    frames[currentFrameOverlap].bFrameTimestampsWritten = true;
+}
+
+void GpuProfiler::beginScope(VkCommandBuffer cmd, const std::string& name, const bool bAsyncCompute)
+{
+    if (!bFrameRecording) {
+        return;
+    }
+    if (bAsyncCompute && computeTimestampPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    FrameQueries& frame = frames[currentFrameOverlap];
+    assert(!bScopeOpen && "GPU profiler scopes can't be nested");
+    std::vector<uint32_t>& scopeIndices = bAsyncCompute ? frame.computeScopeIndices : frame.scopeIndices;
+    if (scopeIndices.size() >= MAX_SCOPES_PER_FRAME) {
+        return;
+    }
+
+    const uint32_t firstQuery = currentFrameOverlap * TIMESTAMPS_PER_FRAME;
+    if (bAsyncCompute && scopeIndices.empty()) {
+        vkCmdResetQueryPool(cmd, computeTimestampPool, firstQuery, MAX_SCOPES_PER_FRAME * 2);
+    }
+
+    const auto localIndex = static_cast<uint32_t>(scopeIndices.size());
+    scopeIndices.push_back(getScopeIndex(name));
+    bScopeOpen = true;
+    bOpenScopeAsyncCompute = bAsyncCompute;
+
+    // Written once all previous work completes, so each scope measures only its own work
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, bAsyncCompute ? computeTimestampPool : timestampPool, firstQuery + localIndex * 2);
+    if (!bAsyncCompute && frame.bPipelineStatistics) {
+        vkCmdBeginQuery(cmd, statisticsPool, currentFrameOverlap * MAX_SCOPES_PER_FRAME + localIndex, 0);
+    }
+}
+
+void GpuProfiler::endScope(VkCommandBuffer cmd)
+{
+    if (!bScopeOpen) {
+        return;
+    }
+
+    const FrameQueries& frame = frames[currentFrameOverlap];
+    if (bOpenScopeAsyncCompute) {
+        const auto localIndex = static_cast<uint32_t>(frame.computeScopeIndices.size() - 1);
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, computeTimestampPool, currentFrameOverlap * TIMESTAMPS_PER_FRAME + localIndex * 2 + 1);
+    }
+    else {
+        const auto localIndex = static_cast<uint32_t>(frame.scopeIndices.size() - 1);
+        if (frame.bPipelineStatistics) {
+            vkCmdEndQuery(cmd, statisticsPool, currentFrameOverlap * MAX_SCOPES_PER_FRAME + localIndex);
+        }
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, timestampPool, currentFrameOverlap * TIMESTAMPS_PER_FRAME + localIndex * 2 + 1);
+    }
+    bScopeOpen = false;
+}
+
+uint32_t GpuProfiler::getScopeIndex(const std::string& name)
+{
+    if (const auto it = scopeLookup.find(name); it != scopeLookup.end()) {
+        return it->second;
+    }
+
+    const auto scopeIndex = static_cast<uint32_t>(scopes.size());
+    scopes.push_back({name});
+    scopeLookup.emplace(name, scopeIndex);
+    return scopeIndex;
+}
+
+void GpuProfiler::readTimestamps(VkQueryPool pool, const uint64_t mask, const int32_t frameOverlap, const std::vector<uint32_t>& scopeIndices)
+{
+    const auto scopeCount = static_cast<uint32_t>(scopeIndices.size());
+    const VkResult result = vkGetQueryPoolResults(context.device, pool, frameOverlap * TIMESTAMPS_PER_FRAME, scopeCount * 2,
+                                                  scopeCount * 2 * sizeof(uint64_t), timestampResults.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < scopeCount; ++i) {
+        const uint64_t ticks = (timestampResults[i * 2 + 1] & mask) - (timestampResults[i * 2] & mask);
+        const float time = static_cast<float>(ticks) * timestampPeriod / 1000000.0f;
+        GpuProfilerScope& scope = scopes[scopeIndices[i]];
+        scope.time.addSample(time);
+        scope.lastTime = time;
+        scope.sampleCount++;
+        lastFrameTime += time;
+    }
+}
+
+void GpuProfiler::readFrameDuration(const int32_t frameOverlap)
+{
+    std::array<uint64_t, 2> timestamps{};
+    const VkResult result = vkGetQueryPoolResults(context.device, timestampPool, frameOverlap * TIMESTAMPS_PER_FRAME + MAX_SCOPES_PER_FRAME * 2, 2,
+                                                  sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    const uint64_t ticks = (timestamps[1] & timestampMask) - (timestamps[0] & timestampMask);
+    lastFrameDuration = static_cast<float>(ticks) * timestampPeriod / 1000000.0f;
+    frameDurationSampleCount++;
+}
+}
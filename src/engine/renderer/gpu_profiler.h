@@ -0,0 +1,172 @@
+//
+// Created by William on 2025-07-09.
+//
+
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "renderer_constants.h"
+#include "engine/util/profiling_utils.h"
+
+namespace will_engine::renderer
+{
+class VulkanContext;
+
+/**
+ * Counters from the last frame the scope was recorded in
+ */
+struct GpuPipelineStatistics
+{
+    uint64_t inputAssemblyPrimitives{0};
+    uint64_t vertexShaderInvocations{0};
+    uint64_t clippingPrimitives{0};
+    uint64_t fragmentShaderInvocations{0};
+    uint64_t computeShaderInvocations{0};
+};
+
+struct GpuProfilerScope
+{
+    std::string name;
+    ProfilingData time{};
+    /**
+     * Unsmoothed time of the last read back frame, in milliseconds
+     */
+    float lastTime{0.0f};
+    /**
+     * Number of frames read back, to tell a new \code lastTime\endcode apart from a stale one
+     */
+    uint32_t sampleCount{0};
+    GpuPipelineStatistics statistics{};
+};
+
+/**
+ * Measures GPU time (and optionally pipeline statistics) of named scopes in the frame's command buffers.
+ * Results are read back \code FRAME_OVERLAP\endcode frames later, when the frame slot is reused, so reading them never stalls.
+ * Scopes can't be nested. Scopes recorded on the async compute queue use their own query pool and only measure time.
+ * \n The duration of the whole frame is measured even while scope profiling is disabled, it drives the dynamic resolution.
+ */
+class GpuProfiler
+{
+public:
+    static constexpr uint32_t MAX_SCOPES_PER_FRAME = 64;
+    /**
+     * Two per scope plus the frame's start and end
+     */
+    static constexpr uint32_t TIMESTAMPS_PER_FRAME = (MAX_SCOPES_PER_FRAME + 1) * 2;
+
+    explicit GpuProfiler(const VulkanContext& context);
+
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /**
+     * Reads back the results of the last frame recorded in \code frameOverlap\endcode (its fence must have been waited on) and resets its queries.
+     * Writes the frame's start timestamp, should be the first command in the frame's command buffer.
+     */
+    void beginFrame(VkCommandBuffer cmd, int32_t frameOverlap);
+
+    /**
+     * Writes the frame's end timestamp, should be the last command in the frame's command buffer.
+     */
+    void endFrame(VkCommandBuffer cmd);
+
+    /**
+     * @param bAsyncCompute \code cmd\endcode is submitted to the async compute queue. Its queries are reset in the first such scope of the frame,
+     * so all async compute command buffers of a frame must be submitted in the order they were recorded
+     */
+    void beginScope(VkCommandBuffer cmd, const std::string& name, bool bAsyncCompute = false);
+
+    void endScope(VkCommandBuffer cmd);
+
+    /**
+     * @return all scopes seen so far, in the order they were first recorded
+     */
+    [[nodiscard]] const std::vector<GpuProfilerScope>& getScopes() const { return scopes; }
+
+    /**
+     * @return sum of the scopes measured in the last read back frame, in milliseconds
+     */
+    [[nodiscard]] float getLastFrameTime() const { return lastFrameTime; }
+
+    /**
+     * @return time from the start to the end of the last read back frame, including work outside of scopes, in milliseconds
+     */
+    [[nodiscard]] float getLastFrameDuration() const { return lastFrameDuration; }
+
+    /**
+     * Number of frame durations read back, to tell a new \code getLastFrameDuration\endcode apart from a stale one
+     */
+    [[nodiscard]] uint32_t getFrameDurationSampleCount() const { return frameDurationSampleCount; }
+
+    [[nodiscard]] bool isSupported() const { return timestampPool != VK_NULL_HANDLE; }
+
+    [[nodiscard]] bool isPipelineStatisticsSupported() const { return statisticsPool != VK_NULL_HANDLE; }
+
+public:
+    bool bEnabled{true};
+    bool bPipelineStatistics{false};
+
+private:
+    struct FrameQueries
+    {
+        /**
+         * Index into \code scopes\endcode of each scope recorded this frame
+         */
+        std::vector<uint32_t> scopeIndices;
+        std::vector<uint32_t> computeScopeIndices;
+        bool bPipelineStatistics{false};
+        bool bFrameTimestampsWritten{false};
+    };
+
+    uint32_t getScopeIndex(const std::string& name);
+
+    /**
+     * Adds a sample to each scope if all of their timestamps are available
+     */
+    void readTimestamps(VkQueryPool pool, uint64_t mask, int32_t frameOverlap, const std::vector<uint32_t>& scopeIndices);
+
+    void readFrameDuration(int32_t frameOverlap);
+
+    const VulkanContext& context;
+
+    VkQueryPool timestampPool{VK_NULL_HANDLE};
+    VkQueryPool statisticsPool{VK_NULL_HANDLE};
+    float timestampPeriod{1.0f};
+    uint64_t timestampMask{~0ull};
+    /**
+     * Only if the device has a separate compute queue that supports timestamps
+     */
+    VkQueryPool computeTimestampPool{VK_NULL_HANDLE};
+    uint64_t computeTimestampMask{~0ull};
+
+    std::array<FrameQueries, FRAME_OVERLAP> frames{};
+    int32_t currentFrameOverlap{0};
+    bool bScopeOpen{false};
+    bool bOpenScopeAsyncCompute{false};
+    bool bFrameRecording{false};
+
+    std::vector<GpuProfilerScope> scopes;
+    std::unordered_map<std::string, uint32_t> scopeLookup;
+    float lastFrameTime{0.0f};
+    float lastFrameDuration{0.0f};
+    uint32_t frameDurationSampleCount{0};
+
+    /**
+     * Scratch space so reading back results doesn't allocate
+     */
+    std::vector<uint64_t> timestampResults;
+    std::vector<uint64_t> statisticsResults;
+};
+}
+
+#endif //GPU_PROFILER_H
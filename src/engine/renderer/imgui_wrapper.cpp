@@ -21,6 +21,8 @@
 #include "engine/core/engine.h"
 #include "engine/core/time.h"
 #include "engine/core/camera/free_camera.h"
+#include "engine/core/profiler/memory_tracker.h"
+#include "engine/core/profiler/trace_profiler.h"
 #include "engine/core/game_object/game_object_factory.h"
 #include "engine/core/game_object/renderable.h"
 #include "engine/core/scene/serializer.h"
@@ -28,6 +30,9 @@
 #include "engine/util/file.h"
 #include "engine/util/math_utils.h"
 #include "pipelines/geometry/environment/environment_pipeline.h"
+#include "render_context.h"
+#include "render_graph/render_graph.h"
+#include "terrain/terrain_manager.h"
 
 namespace will_engine
 {
@@ -156,19 +161,105 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 ImGui::NextColumn();
                 ImGui::Separator();
 
-                for (const auto& [name, timer] : engine->profiler.getTimers()) {
-                    std::string_view nameView = name;
-                    if (!nameView.empty()) {
-                        nameView.remove_prefix(1);
-                    }
-
-                    ImGui::Text("%s", nameView.data());
+                for (const Profiler::Timer& timer : engine->profiler.getTimers()) {
+                    ImGui::Text("%s", timer.name.c_str());
                     ImGui::NextColumn();
-                    ImGui::Text("%.2f", timer.getAverageTime());
+                    ImGui::Text("%.2f", timer.data.getAverageTime());
                     ImGui::NextColumn();
                 }
 
                 ImGui::Columns(1);
+
+                renderer::GpuProfiler* gpuProfiler = engine->gpuProfiler;
+                ImGui::Separator();
+                if (!gpuProfiler->isSupported()) {
+                    ImGui::Text("GPU timestamps are not supported on this device");
+                }
+                else {
+                    ImGui::Checkbox("GPU Profiling", &gpuProfiler->bEnabled);
+                    ImGui::SameLine();
+                    ImGui::BeginDisabled(!gpuProfiler->isPipelineStatisticsSupported());
+                    ImGui::Checkbox("Pipeline Statistics", &gpuProfiler->bPipelineStatistics);
+                    ImGui::EndDisabled();
+
+                    const bool bShowStatistics = gpuProfiler->bPipelineStatistics;
+                    const int32_t columnCount = bShowStatistics ? 7 : 2;
+                    if (ImGui::BeginTable("GpuTimers", columnCount, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+                        ImGui::TableSetupColumn("GPU Pass");
+                        ImGui::TableSetupColumn("Time (ms)");
+                        if (bShowStatistics) {
+                            ImGui::TableSetupColumn("IA Prims");
+                            ImGui::TableSetupColumn("VS Invocations");
+                            ImGui::TableSetupColumn("Clip Prims");
+                            ImGui::TableSetupColumn("FS Invocations");
+                            ImGui::TableSetupColumn("CS Invocations");
+                        }
+                        ImGui::TableHeadersRow();
+
+                        for (const renderer::GpuProfilerScope& scope : gpuProfiler->getScopes()) {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%s", scope.name.c_str());
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f", scope.time.getAverageTime());
+                            if (bShowStatistics) {
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%llu", static_cast<unsigned long long>(scope.statistics.inputAssemblyPrimitives));
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%llu", static_cast<unsigned long long>(scope.statistics.vertexShaderInvocations));
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%llu", static_cast<unsigned long long>(scope.statistics.clippingPrimitives));
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%llu", static_cast<unsigned long long>(scope.statistics.fragmentShaderInvocations));
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%llu", static_cast<unsigned long long>(scope.statistics.computeShaderInvocations));
+                            }
+                        }
+                        ImGui::EndTable();
+                    }
+                    ImGui::Text("GPU Frame (sum of passes): %.3f ms", gpuProfiler->getLastFrameTime());
+                }
+
+                if (ImGui::Button("Save Profiler Capture")) {
+                    if (file::getOrCreateDirectory(file::profilingSavePath)) {
+                        const std::filesystem::path path = file::profilingSavePath / "profilerCapture.json";
+                        if (Serializer::serializeProfilerCapture(engine, path)) {
+                            fmt::print("Saved profiler capture to {}\n", path.string());
+                        }
+                    }
+                    else {
+                        fmt::print(" Failed to find/create profiling save path directory\n");
+                    }
+                }
+
+#if WILL_ENGINE_PROFILING
+                ImGui::SameLine();
+                if (!profiling::TraceProfiler::isCapturing()) {
+                    if (ImGui::Button("Start Trace Capture")) {
+                        profiling::TraceProfiler::beginCapture();
+                    }
+                }
+                else if (ImGui::Button("Stop And Save Trace Capture")) {
+                    profiling::TraceProfiler::endCapture();
+                    if (file::getOrCreateDirectory(file::profilingSavePath)) {
+                        const std::filesystem::path path = file::profilingSavePath / "traceCapture.json";
+                        const std::vector<profiling::TraceThread> threads = profiling::TraceProfiler::collect();
+                        size_t eventCount{0};
+                        uint32_t droppedCount{0};
+                        for (const profiling::TraceThread& thread : threads) {
+                            eventCount += thread.events.size();
+                            droppedCount += thread.droppedCount;
+                        }
+                        if (Serializer::serializeTraceCapture(threads, engine->startupProfiler.getEntries(), path)) {
+                            fmt::print("Saved trace capture ({} events, {} dropped) to {}\n", eventCount, droppedCount, path.string());
+                        }
+                    }
+                    else {
+                        fmt::print(" Failed to find/create profiling save path directory\n");
+                    }
+                }
+#endif
+
                 ImGui::EndTabItem();
             }
 
@@ -208,6 +299,55 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 ImGui::Columns(1);
                 ImGui::EndTabItem();
             }
+
+            if (ImGui::BeginTabItem("Memory")) {
+                if (!profiling::MemoryTracker::isEnabled()) {
+                    ImGui::Text("Memory tracking is disabled (WILL_ENGINE_MEMORY_TRACKING)");
+                }
+                else {
+                    if (ImGui::Button("Reset Peaks")) {
+                        profiling::MemoryTracker::resetPeaks();
+                    }
+
+                    // Last frame's allocations, high counts here are the usual cause of frame time spikes
+                    if (ImGui::BeginTable("MemoryTags", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+                        ImGui::TableSetupColumn("Tag");
+                        ImGui::TableSetupColumn("Live (KB)");
+                        ImGui::TableSetupColumn("Peak (KB)");
+                        ImGui::TableSetupColumn("Live Allocs");
+                        ImGui::TableSetupColumn("Allocs / Frame");
+                        ImGui::TableSetupColumn("KB / Frame");
+                        ImGui::TableSetupColumn("Peak Allocs / Frame");
+                        ImGui::TableHeadersRow();
+
+                        const auto drawRow = [](const char* name, const profiling::MemoryTagStatistics& memory) {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%s", name);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.1f", static_cast<double>(memory.liveBytes) / 1024.0);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.1f", static_cast<double>(memory.peakLiveBytes) / 1024.0);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%llu", static_cast<unsigned long long>(memory.liveAllocationCount));
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%llu", static_cast<unsigned long long>(memory.frameAllocationCount));
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.1f", static_cast<double>(memory.frameAllocatedBytes) / 1024.0);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%llu", static_cast<unsigned long long>(memory.peakFrameAllocationCount));
+                        };
+
+                        for (size_t tag = 0; tag < profiling::MEMORY_TAG_NAMES.size(); ++tag) {
+                            drawRow(profiling::MEMORY_TAG_NAMES[tag], profiling::MemoryTracker::getStatistics(static_cast<profiling::MemoryTag>(tag)));
+                        }
+                        drawRow("Total", profiling::MemoryTracker::getTotalStatistics());
+                        ImGui::EndTable();
+                    }
+                }
+
+                ImGui::EndTabItem();
+            }
         }
         ImGui::EndTabBar();
     }
@@ -394,6 +534,91 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 ImGui::EndTabItem();
             }
 
+            if (ImGui::BeginTabItem("Dynamic Resolution")) {
+                ImGui::SetNextItemWidth(-1.0f);
+                if (ImGui::Button("Save Dynamic Resolution Settings")) {
+                    Serializer::serializeEngineSettings(engine, EngineSettingsTypeFlag::DYNAMIC_RESOLUTION_SETTINGS);
+                }
+
+                renderer::DynamicResolution* dynamicResolution = engine->dynamicResolution;
+                if (!dynamicResolution->isSupported()) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Timestamps are not supported by the graphics queue");
+                }
+                renderer::DynamicResolutionSettings& settings = dynamicResolution->settings;
+                ImGui::Checkbox("Enable Dynamic Resolution", &settings.bEnabled);
+                ImGui::DragFloat("Target GPU Frame Time (ms)", &settings.targetFrameTimeMs, 0.1f, 1.0f, 100.0f);
+                ImGui::DragFloatRange2("Scale Range", &settings.minScale, &settings.maxScale, 0.01f, 0.25f, 1.0f);
+                ImGui::DragFloat("Max Scale Step", &settings.maxScaleStep, 0.005f, 0.005f, 0.25f);
+                ImGui::DragFloat("Tolerance", &settings.tolerance, 0.005f, 0.0f, 0.5f);
+
+                ImGui::Separator();
+                ImGui::Text("GPU Frame Time: %.2f ms", dynamicResolution->getGpuFrameTimeMs());
+                ImGui::Text("Viewport Scale: %.2f", engine->renderContext->viewportScale);
+                ImGui::Text("Viewport: %u x %u (Render Targets: %u x %u)", engine->renderContext->viewportExtent.width,
+                            engine->renderContext->viewportExtent.height, engine->renderContext->renderExtent.width,
+                            engine->renderContext->renderExtent.height);
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Frame Pacing")) {
+                ImGui::SetNextItemWidth(-1.0f);
+                if (ImGui::Button("Save Frame Pacing Settings")) {
+                    Serializer::serializeEngineSettings(engine, EngineSettingsTypeFlag::FRAME_PACING_SETTINGS);
+                }
+
+                FramePacingSettings settings = engine->getFramePacingSettings();
+                bool bChanged = ImGui::SliderInt("Frames In Flight", &settings.framesInFlight, 1, FRAME_OVERLAP);
+
+                if (ImGui::BeginCombo("Present Mode", string_VkPresentModeKHR(settings.presentMode))) {
+                    for (const VkPresentModeKHR presentMode : engine->supportedPresentModes) {
+                        const bool bSelected = presentMode == settings.presentMode;
+                        if (ImGui::Selectable(string_VkPresentModeKHR(presentMode), bSelected)) {
+                            settings.presentMode = presentMode;
+                            bChanged = true;
+                        }
+                        if (bSelected) {
+                            ImGui::SetItemDefaultFocus();
+                        }
+                    }
+                    ImGui::EndCombo();
+                }
+
+                bChanged |= ImGui::Checkbox("Low Latency", &settings.bLowLatency);
+                ImGui::SameLine();
+                ImGui::TextDisabled("(wait for the GPU before sampling input)");
+
+                if (bChanged) {
+                    engine->setFramePacingSettings(settings);
+                }
+
+                ImGui::Separator();
+                if (const ProfilingData* timer = engine->profiler.getTimer(ENGINE_TIMER_FRAME_PACING_WAIT)) {
+                    ImGui::Text("Frame Pacing Wait: %.2f ms", timer->getAverageTime());
+                }
+                // CPU time from sampling input to handing the frame to the presentation engine
+                if (const ProfilingData* timer = engine->profiler.getTimer(ENGINE_TIMER_INPUT_TO_PRESENT)) {
+                    ImGui::Text("Input To Present: %.2f ms", timer->getAverageTime());
+                }
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Terrain Tessellation")) {
+                ImGui::SetNextItemWidth(-1.0f);
+                if (ImGui::Button("Save Terrain Tessellation Settings")) {
+                    Serializer::serializeEngineSettings(engine, EngineSettingsTypeFlag::TERRAIN_TESSELLATION_SETTINGS);
+                }
+                terrain::TerrainTessellationSettings& tessellationSettings = engine->terrainTessellationSettings;
+                ImGui::DragFloat("Target Edge Length (px)", &tessellationSettings.targetEdgeLength, 0.5f, 1.0f, 128.0f);
+                ImGui::DragFloat("Max Tess Level", &tessellationSettings.maxTessLevel, 0.5f, 1.0f, 64.0f);
+                ImGui::DragFloat("Shadow Target Edge Length (texels)", &tessellationSettings.shadowTargetEdgeLength, 0.5f, 1.0f, 256.0f);
+                ImGui::DragFloat("Shadow Max Tess Level", &tessellationSettings.shadowMaxTessLevel, 0.5f, 1.0f, 64.0f);
+                ImGui::Checkbox("Cull Patches", &tessellationSettings.bCullPatches);
+
+                ImGui::EndTabItem();
+            }
+
             if (ImGui::BeginTabItem("Post-Processing")) {
                 static bool tonemapping = (engine->postProcessData & renderer::PostProcessType::Tonemapping) !=
                                           renderer::PostProcessType::None;
@@ -441,7 +666,39 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                     Serializer::serializeEngineSettings(engine, EngineSettingsTypeFlag::AMBIENT_OCCLUSION_SETTINGS);
                 }
 
+                const char* resolutionModes[] = {"Full", "Half", "Quarter"};
+                int resolutionMode = 0;
+                if (engine->gtaoSettings.resolution == renderer::GTAOResolution::Half) resolutionMode = 1;
+                else if (engine->gtaoSettings.resolution == renderer::GTAOResolution::Quarter) resolutionMode = 2;
+
+                if (ImGui::Combo("Resolution", &resolutionMode, resolutionModes, IM_ARRAYSIZE(resolutionModes))) {
+                    renderer::GTAOSettings settings = engine->getAoSettings();
+                    switch (resolutionMode) {
+                        case 1: settings.resolution = renderer::GTAOResolution::Half;
+                            break;
+                        case 2: settings.resolution = renderer::GTAOResolution::Quarter;
+                            break;
+                        default: settings.resolution = renderer::GTAOResolution::Full;
+                            break;
+                    }
+
+                    // Reduced resolution trades slices for temporal accumulation
+                    if (settings.resolution != renderer::GTAOResolution::Full) {
+                        settings.bTemporalAccumulation = true;
+                        settings.pushConstants.sliceCount = renderer::GTAO_REDUCED_RESOLUTION_SLICE_COUNT;
+                    }
+                    engine->setAoSettings(settings);
+                }
+                ImGui::SetItemTooltip("Reduced resolutions compute AO at a fraction of the render resolution and upsample it with a depth aware filter");
+                ImGui::Checkbox("Temporal Accumulation", &engine->gtaoSettings.bTemporalAccumulation);
+
                 renderer::GTAOPushConstants& gtao = engine->gtaoSettings.pushConstants;
+                ImGui::BeginDisabled(!engine->gtaoSettings.bTemporalAccumulation);
+                ImGui::SliderFloat("Temporal Blend", &gtao.temporalBlend, 0.02f, 1.0f);
+                ImGui::EndDisabled();
+
+                ImGui::Separator();
+
                 const char* qualityPresets[] = {"Low", "Medium", "High", "Ultra"};
                 int slicePreset = 0;
 
@@ -680,6 +937,65 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 ImGui::EndTabItem();
             }
 
+            if (ImGui::BeginTabItem("Physics")) {
+                ImGui::SetNextItemWidth(-1.0f);
+                if (ImGui::Button("Save Physics Settings")) {
+                    Serializer::serializeEngineSettings(engine, EngineSettingsTypeFlag::PHYSICS_SETTINGS);
+                }
+
+                physics::PhysicsSettings physicsSettings = engine->getPhysicsSettings();
+                bool physicsSettingsChanged = false;
+                physicsSettingsChanged |= ImGui::DragFloat("Step Rate (Hz)", &physicsSettings.stepRate, 1.0f, 10.0f, 240.0f);
+                physicsSettingsChanged |= ImGui::DragInt("Collision Steps", &physicsSettings.collisionSteps, 1, 1, 10);
+                physicsSettingsChanged |= ImGui::DragInt("Max Substeps", &physicsSettings.maxSubsteps, 1, 1, 16);
+                physicsSettingsChanged |= ImGui::Checkbox("Interpolate Transforms", &physicsSettings.bInterpolate);
+                if (physicsSettingsChanged) {
+                    engine->setPhysicsSettings(physicsSettings);
+                }
+
+                if (const physics::Physics* physics = physics::Physics::get()) {
+                    ImGui::Text("Interpolation Alpha: %.2f", physics->getInterpolationAlpha());
+                }
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Terrain Streaming")) {
+                ImGui::SetNextItemWidth(-1.0f);
+                if (ImGui::Button("Save Terrain Streaming Settings")) {
+                    Serializer::serializeEngineSettings(engine, EngineSettingsTypeFlag::TERRAIN_STREAMING_SETTINGS);
+                }
+
+                terrain::TerrainStreamingSettings streamingSettings = engine->getTerrainStreamingSettings();
+                bool streamingSettingsChanged = false;
+                streamingSettingsChanged |= ImGui::Checkbox("Enable Streaming", &streamingSettings.bEnabled);
+                streamingSettingsChanged |= ImGui::DragFloat("Tile Size", &streamingSettings.tileSize, 1.0f, 16.0f, 4096.0f);
+                streamingSettingsChanged |= ImGui::DragInt("Tile Resolution", &streamingSettings.tileResolution, 1, 17, 513);
+                streamingSettingsChanged |= ImGui::DragInt("Max Depth", &streamingSettings.maxDepth, 1, 0, 8);
+                streamingSettingsChanged |= ImGui::DragFloat("LOD Distance Factor", &streamingSettings.lodDistanceFactor, 0.05f, 1.0f, 8.0f);
+                streamingSettingsChanged |= ImGui::DragFloat("View Distance", &streamingSettings.viewDistance, 10.0f, 100.0f, 50000.0f);
+                streamingSettingsChanged |= ImGui::DragInt("Memory Budget (MB)", &streamingSettings.memoryBudgetMb, 1, 16, 4096);
+                streamingSettingsChanged |= ImGui::DragInt("Max Uploads Per Frame", &streamingSettings.maxUploadsPerFrame, 1, 1, 16);
+                int32_t seed = static_cast<int32_t>(streamingSettings.seed);
+                if (ImGui::InputInt("Seed", &seed)) {
+                    streamingSettings.seed = static_cast<uint32_t>(seed);
+                    streamingSettingsChanged = true;
+                }
+                if (streamingSettingsChanged) {
+                    engine->setTerrainStreamingSettings(streamingSettings);
+                }
+
+                if (terrain::TerrainManager* terrainManager = terrain::TerrainManager::get()) {
+                    ImGui::Separator();
+                    ImGui::Text("Resident Tiles: %zu", terrainManager->getResidentTileCount());
+                    ImGui::Text("Active Tiles: %zu", terrainManager->getActiveTileCount());
+                    ImGui::Text("Pending Tiles: %zu", terrainManager->getPendingTileCount());
+                    ImGui::Text("Memory: %.2f MB", static_cast<double>(terrainManager->getMemoryUsage()) / (1024.0 * 1024.0));
+                }
+
+                ImGui::EndTabItem();
+            }
+
             ImGui::EndTabBar();
         }
     }
@@ -699,12 +1015,35 @@ void ImguiWrapper::imguiInterface(Engine* engine)
 
                 ImGui::Text("Deferred Debug");
                 const char* deferredDebugOptions[]{
-                    "None", "Depth", "Velocity", "Albedo", "Normal", "PBR", "Shadows", "Cascade Level", "nDotL", "AO", "Contact Shadows"
+                    "None", "Depth", "Velocity", "Albedo", "Normal", "PBR", "Shadows", "Cascade Level", "nDotL", "AO", "Contact Shadows", "Light Clusters"
                 };
                 ImGui::Combo("Deferred Debug", &engine->deferredDebug, deferredDebugOptions, IM_ARRAYSIZE(deferredDebugOptions));
                 ImGui::Separator();
 
                 ImGui::Checkbox("Freeze Visibility Pass Scene Data", &engine->bFreezeVisibilitySceneData);
+                ImGui::Separator();
+
+                ImGui::Text("Render Graph");
+                if (engine->renderGraph) {
+                    const renderer::RenderGraphStatistics& statistics = engine->renderGraph->getStatistics();
+                    ImGui::Text("Passes: %u (%u culled)", statistics.passCount, statistics.culledPassCount);
+                    ImGui::Text("Barriers: %u", statistics.barrierCount);
+                    ImGui::Text("Transient Images: %u in %u allocations", statistics.transientImageCount, statistics.transientAllocationCount);
+                    ImGui::Text("Transient Memory: %.1f MB (%.1f MB without aliasing)", statistics.transientAllocatedMemory / (1024.0 * 1024.0),
+                                statistics.transientImageMemory / (1024.0 * 1024.0));
+                    ImGui::Text("Async Compute Passes: %u", statistics.asyncComputePassCount);
+                    ImGui::Text("Submissions: %u (%u queue ownership transfers)", statistics.submissionCount, statistics.queueOwnershipTransferCount);
+                }
+                if (ImGui::Checkbox("Alias Render Targets", &engine->bAliasRenderTargets)) {
+                    engine->recreateRenderGraph();
+                }
+                ImGui::SetItemTooltip("Aliased render targets share memory, disable to inspect them with \"Save Images\"");
+                ImGui::BeginDisabled(!engine->context->hasAsyncComputeQueue());
+                if (ImGui::Checkbox("Async Compute", &engine->bAsyncCompute)) {
+                    engine->recreateRenderGraph();
+                }
+                ImGui::EndDisabled();
+                ImGui::SetItemTooltip("Runs GTAO and contact shadows on a separate compute queue. Unavailable if the device has none.");
                 ImGui::EndTabItem();
             }
 
@@ -712,7 +1051,7 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 if (ImGui::Button("Save Draw Image")) {
                     if (file::getOrCreateDirectory(file::imagesSavePath)) {
                         const std::filesystem::path path = file::imagesSavePath / "drawImage.png";
-                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->drawImage.get(),
+                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->drawImage,
                                                         renderer::vk_helpers::ImageFormat::RGBA16F, path.string());
                     }
                     else {
@@ -730,8 +1069,8 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                             return (2.0f * zNear) / (zFar + zNear - d * (zFar - zNear));
                         };
 
-                        renderer::vk_helpers::saveImageR32F(*engine->resourceManager, *engine->immediate, engine->depthStencilImage.get(),
-                                                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT,
+                        renderer::vk_helpers::saveImageR32F(*engine->resourceManager, *engine->immediate, engine->depthStencilImage,
+                                                            engine->depthStencilImage->imageLayout, VK_IMAGE_ASPECT_DEPTH_BIT,
                                                             path.string().c_str(),
                                                             depthNormalize);
                     }
@@ -743,7 +1082,7 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 if (ImGui::Button("Save Normals")) {
                     if (file::getOrCreateDirectory(file::imagesSavePath)) {
                         const std::filesystem::path path = file::imagesSavePath / "normalRT.png";
-                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->normalRenderTarget.get(),
+                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->normalRenderTarget,
                                                         renderer::vk_helpers::ImageFormat::A2R10G10B10_UNORM, path.string());
                     }
                     else {
@@ -754,7 +1093,7 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 if (ImGui::Button("Save Albedo Render Target")) {
                     if (file::getOrCreateDirectory(file::imagesSavePath)) {
                         const std::filesystem::path path = file::imagesSavePath / "albedoRT.png";
-                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->albedoRenderTarget.get(),
+                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->albedoRenderTarget,
                                                         renderer::vk_helpers::ImageFormat::RGBA16F, path.string());
                     }
                     else {
@@ -765,7 +1104,7 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                 if (ImGui::Button("Save PBR Render Target")) {
                     if (file::getOrCreateDirectory(file::imagesSavePath)) {
                         std::filesystem::path path = file::imagesSavePath / "pbrRT.png";
-                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->pbrRenderTarget.get(),
+                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->pbrRenderTarget,
                                                         renderer::vk_helpers::ImageFormat::RGBA8_UNORM, path.string());
                     }
                     else {
@@ -773,16 +1112,19 @@ void ImguiWrapper::imguiInterface(Engine* engine)
                     }
                 }
 
+                // Post process writes the swapchain directly when it supports storage usage, there is no final image then
+                ImGui::BeginDisabled(engine->finalImageBuffer == nullptr);
                 if (ImGui::Button("Save Final Image")) {
                     if (file::getOrCreateDirectory(file::imagesSavePath)) {
                         std::filesystem::path path = file::imagesSavePath / "finalImage.png";
-                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->finalImageBuffer.get(),
+                        renderer::vk_helpers::saveImage(*engine->resourceManager, *engine->immediate, engine->finalImageBuffer,
                                                         renderer::vk_helpers::ImageFormat::RGBA16F, path.string());
                     }
                     else {
                         fmt::print(" Failed to find/create image save path directory");
                     }
                 }
+                ImGui::EndDisabled();
                 ImGui::EndTabItem();
             }
 
@@ -1436,6 +1778,31 @@ void ImguiWrapper::drawSceneGraph(Engine* engine)
                     ImGui::EndTabItem();
                 }
 
+                if (ImGui::BeginTabItem("Terrain Sculpting")) {
+                    terrain::TerrainChunk* terrainChunk = currentTerrainComponent ? currentTerrainComponent->getTerrainChunk() : nullptr;
+                    ImGui::BeginDisabled(!terrainChunk);
+
+                    const char* brushModes[] = {"Raise", "Lower", "Flatten", "Smooth"};
+                    int32_t brushMode = static_cast<int32_t>(terrainBrush.mode);
+                    if (ImGui::Combo("Brush Mode", &brushMode, brushModes, IM_ARRAYSIZE(brushModes))) {
+                        terrainBrush.mode = static_cast<terrain::TerrainBrushMode>(brushMode);
+                    }
+                    ImGui::DragFloat2("Brush Center (XZ)", &terrainBrush.center.x, 0.5f);
+                    ImGui::SliderFloat("Brush Radius", &terrainBrush.radius, 1.0f, 128.0f);
+                    ImGui::SliderFloat("Brush Strength", &terrainBrush.strength, 0.0f, 10.0f);
+                    if (terrainBrush.mode == terrain::TerrainBrushMode::Flatten) {
+                        ImGui::DragFloat("Target Height", &terrainBrush.targetHeight, 0.5f);
+                    }
+
+                    // Only the brush area is regenerated and uploaded, the rest of the terrain is untouched
+                    if (ImGui::Button("Apply Brush", ImVec2(-1, 0))) {
+                        terrainChunk->applyBrush(terrainBrush);
+                    }
+
+                    ImGui::EndDisabled();
+                    ImGui::EndTabItem();
+                }
+
                 if (ImGui::BeginTabItem("Terrain Config")) {
                     if (ImGui::CollapsingHeader("Terrain Properties", ImGuiTreeNodeFlags_DefaultOpen)) {
                         ImGui::SliderFloat("Rocks: Slope Threshold", &terrainProperties.slopeRockThreshold, 0.0f, 1.0f, "%.2f");
@@ -91,6 +91,7 @@ private:
 
     terrain::TerrainProperties terrainProperties{};
     std::array<uint32_t, terrain::MAX_TERRAIN_TEXTURE_COUNT> terrainTextures;
+    terrain::TerrainBrush terrainBrush{};
 
     VkDescriptorSet currentlySelectedTextureImguiId{VK_NULL_HANDLE};
 
@@ -0,0 +1,45 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef LOCAL_LIGHT_H
+#define LOCAL_LIGHT_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace will_engine
+{
+enum class LocalLightType : uint32_t
+{
+    Point = 0,
+    Spot = 1,
+};
+
+/**
+ * Point/spot light as read by the clustered lighting shaders (\code LocalLight\endcode in clustered_lighting.glsl).
+ * Positions and directions are in view space once uploaded.
+ */
+struct LocalLightData
+{
+    glm::vec3 position{0.0f};
+    /**
+     * Distance at which the light's contribution reaches 0
+     */
+    float range{10.0f};
+    glm::vec3 color{1.0f};
+    float intensity{1.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+    /**
+     * Cosine of the spot's outer half angle, unused by point lights
+     */
+    float spotCosOuter{0.0f};
+    float spotCosInner{0.0f};
+    LocalLightType type{LocalLightType::Point};
+    glm::vec2 pad{};
+};
+
+static_assert(sizeof(LocalLightData) == 64);
+}
+
+#endif //LOCAL_LIGHT_H
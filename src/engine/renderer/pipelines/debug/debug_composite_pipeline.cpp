@@ -38,42 +38,59 @@ DebugCompositePipeline::DebugCompositePipeline(ResourceManager& resourceManager)
 
     pipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
 
-    createPipeline();
+    createPipelines();
 
     descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, 1);
+    descriptorSetCount = 1;
 }
 
 DebugCompositePipeline::~DebugCompositePipeline()
 {
     resourceManager.destroyResource(std::move(pipeline));
+    resourceManager.destroyResource(std::move(swapchainPipeline));
     resourceManager.destroyResource(std::move(pipelineLayout));
     resourceManager.destroyResource(std::move(descriptorSetLayout));
     resourceManager.destroyResource(std::move(descriptorBuffer));
 }
 
-void DebugCompositePipeline::setupDescriptorBuffer(VkImageView debugTarget, VkImageView finalImageView)
+void DebugCompositePipeline::setupDescriptorBuffer(VkImageView debugTarget, const std::span<const VkImageView> finalImageViews,
+                                                   const bool bSwapchainOutput)
 {
-    std::vector<DescriptorImageData> descriptors;
-    descriptors.reserve(2);
+    this->bSwapchainOutput = bSwapchainOutput;
+    if (bSwapchainOutput && !swapchainPipeline) {
+        swapchainPipeline = createPipeline("shaders/debug/debug_composite_swapchain.comp");
+    }
+
+    const auto requiredSetCount = static_cast<int32_t>(finalImageViews.size());
+    if (requiredSetCount > descriptorSetCount) {
+        resourceManager.destroyResource(std::move(descriptorBuffer));
+        descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, requiredSetCount);
+        descriptorSetCount = requiredSetCount;
+    }
 
     VkDescriptorImageInfo inputImage{};
     inputImage.sampler = resourceManager.getDefaultSamplerNearest();
     inputImage.imageView = debugTarget;
     inputImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    VkDescriptorImageInfo outputImage{};
-    outputImage.imageView = finalImageView;
-    outputImage.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    for (int32_t i = 0; i < requiredSetCount; ++i) {
+        std::vector<DescriptorImageData> descriptors;
+        descriptors.reserve(2);
 
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, inputImage, false});
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, outputImage, false});
+        VkDescriptorImageInfo outputImage{};
+        outputImage.imageView = finalImageViews[i];
+        outputImage.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-    descriptorBuffer->setupData(descriptors, 0);
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, inputImage, false});
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, outputImage, false});
+
+        descriptorBuffer->setupData(descriptors, i);
+    }
 }
 
 void DebugCompositePipeline::draw(VkCommandBuffer cmd, const DebugCompositePipelineDrawInfo& drawInfo) const
 {
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, bSwapchainOutput ? swapchainPipeline->pipeline : pipeline->pipeline);
 
     const std::array bindingInfos{
         drawInfo.sceneDataBinding,
@@ -82,7 +99,7 @@ void DebugCompositePipeline::draw(VkCommandBuffer cmd, const DebugCompositePipel
     vkCmdBindDescriptorBuffersEXT(cmd, 2, bindingInfos.data());
 
     constexpr std::array indices{0u, 1u};
-    const std::array<VkDeviceSize, 2> offsets{drawInfo.sceneDataOffset, 0};
+    const std::array<VkDeviceSize, 2> offsets{drawInfo.sceneDataOffset, descriptorBuffer->getDescriptorBufferSize() * drawInfo.finalImageIndex};
     vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->layout, 0, 2, indices.data(), offsets.data());
 
     const auto x = static_cast<uint32_t>(std::ceil(drawInfo.extents.width / 16.0f));
@@ -90,10 +107,20 @@ void DebugCompositePipeline::draw(VkCommandBuffer cmd, const DebugCompositePipel
     vkCmdDispatch(cmd, x, y, 1);
 }
 
-void DebugCompositePipeline::createPipeline()
+void DebugCompositePipeline::createPipelines()
 {
     resourceManager.destroyResource(std::move(pipeline));
-    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/debug/debug_composite.comp");
+    pipeline = createPipeline("shaders/debug/debug_composite.comp");
+
+    if (swapchainPipeline) {
+        resourceManager.destroyResource(std::move(swapchainPipeline));
+        swapchainPipeline = createPipeline("shaders/debug/debug_composite_swapchain.comp");
+    }
+}
+
+PipelinePtr DebugCompositePipeline::createPipeline(const char* shaderPath) const
+{
+    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>(shaderPath);
 
     VkPipelineShaderStageCreateInfo stageInfo{};
     stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -109,6 +136,6 @@ void DebugCompositePipeline::createPipeline()
     pipelineInfo.stage = stageInfo;
     pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
 
-    pipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+    return resourceManager.createResource<Pipeline>(pipelineInfo);
 }
 }
@@ -5,6 +5,8 @@
 #ifndef DEBUG_PIPELINE_H
 #define DEBUG_PIPELINE_H
 
+#include <span>
+
 #include <vulkan/vulkan_core.h>
 
 #include "engine/renderer/renderer_constants.h"
@@ -17,6 +19,10 @@ class ResourceManager;
 struct DebugCompositePipelineDrawInfo
 {
     VkExtent2D extents{DEFAULT_RENDER_EXTENT_2D};
+    /**
+     * The swapchain image index when compositing into the swapchain
+     */
+    int32_t finalImageIndex{0};
     VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
     VkDeviceSize sceneDataOffset{0};
 };
@@ -27,22 +33,34 @@ public:
 
     ~DebugCompositePipeline();
 
-    void setupDescriptorBuffer(VkImageView debugTarget, VkImageView finalImageView);
+    /**
+     * @param finalImageViews the final image, or every swapchain image if \code bSwapchainOutput\endcode
+     * @param bSwapchainOutput the post process wrote the swapchain directly, composite into it instead of the final image
+     */
+    void setupDescriptorBuffer(VkImageView debugTarget, std::span<const VkImageView> finalImageViews, bool bSwapchainOutput);
 
     void draw(VkCommandBuffer cmd, const DebugCompositePipelineDrawInfo& drawInfo) const;
 
-    void reloadShaders() { createPipeline(); }
+    void reloadShaders() { createPipelines(); }
 
 private:
-    void createPipeline();
+    void createPipelines();
+
+    PipelinePtr createPipeline(const char* shaderPath) const;
 
 private:
     ResourceManager& resourceManager;
 
     PipelineLayoutPtr pipelineLayout{};
     PipelinePtr pipeline{};
+    /**
+     * Only created if the swapchain supports storage usage
+     */
+    PipelinePtr swapchainPipeline{};
+    bool bSwapchainOutput{false};
     DescriptorSetLayoutPtr descriptorSetLayout{};
     DescriptorBufferSamplerPtr descriptorBuffer{};
+    int32_t descriptorSetCount{0};
 };
 
 }
@@ -9,6 +9,7 @@
 #include <glm/ext/matrix_transform.hpp>
 #include <volk/volk.h>
 
+#include "engine/core/profiler/memory_tracker.h"
 #include "engine/renderer/resource_manager.h"
 #include "engine/renderer/vk_descriptors.h"
 #include "engine/renderer/vk_helpers.h"
@@ -111,6 +112,7 @@ DebugRenderer::~DebugRenderer()
 
 void DebugRenderer::drawLine(const glm::vec3& start, const glm::vec3& end, const glm::vec3& color)
 {
+    WILL_MEMORY_TAG(Debug);
     DebugRenderer* inst = get();
     if (!inst) { return; }
     inst->drawLineImpl(start, end, color);
@@ -118,6 +120,7 @@ void DebugRenderer::drawLine(const glm::vec3& start, const glm::vec3& end, const
 
 void DebugRenderer::drawTriangle(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3, const glm::vec3& color)
 {
+    WILL_MEMORY_TAG(Debug);
     DebugRenderer* inst = get();
     if (!inst) { return; }
     inst->drawTriangleImpl(v1, v2, v3, color);
@@ -125,6 +128,7 @@ void DebugRenderer::drawTriangle(const glm::vec3& v1, const glm::vec3& v2, const
 
 void DebugRenderer::drawSphere(const glm::vec3& center, float radius, const glm::vec3& color, DebugRendererCategory category)
 {
+    WILL_MEMORY_TAG(Debug);
     DebugRenderer* inst = get();
     if (!inst) { return; }
     inst->drawSphereImpl(center, radius, color, category);
@@ -132,6 +136,7 @@ void DebugRenderer::drawSphere(const glm::vec3& center, float radius, const glm:
 
 void DebugRenderer::drawBox(const glm::vec3& center, const glm::vec3& dimensions, const glm::vec3& color, DebugRendererCategory category)
 {
+    WILL_MEMORY_TAG(Debug);
     DebugRenderer* inst = get();
     if (!inst) { return; }
     inst->drawBoxImpl(center, dimensions, color, category);
@@ -139,6 +144,7 @@ void DebugRenderer::drawBox(const glm::vec3& center, const glm::vec3& dimensions
 
 void DebugRenderer::drawBoxMinMax(const glm::vec3& min, const glm::vec3& max, const glm::vec3& color, DebugRendererCategory category)
 {
+    WILL_MEMORY_TAG(Debug);
     DebugRenderer* inst = get();
     if (!inst) { return; }
     inst->drawBoxMinMaxImpl(min, max, color, category);
@@ -146,6 +152,7 @@ void DebugRenderer::drawBoxMinMax(const glm::vec3& min, const glm::vec3& max, co
 
 void DebugRenderer::draw(VkCommandBuffer cmd, const DebugRendererDrawInfo& drawInfo)
 {
+    WILL_MEMORY_TAG(Debug);
     VkDebugUtilsLabelEXT label = {};
     label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
     label.pLabelName = "Debug Renderer";
@@ -224,7 +231,8 @@ void DebugRenderer::draw(VkCommandBuffer cmd, const DebugRendererDrawInfo& drawI
     }
 
 
-    const VkRenderingAttachmentInfo imageAttachment = vk_helpers::attachmentInfo(drawInfo.debugTarget, nullptr,
+    constexpr VkClearValue colorClear = {.color = {0.0f, 0.0f, 0.0f, 0.0f}};
+    const VkRenderingAttachmentInfo imageAttachment = vk_helpers::attachmentInfo(drawInfo.debugTarget, drawInfo.bClearColor ? &colorClear : nullptr,
                                                                                  VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     const VkRenderingAttachmentInfo depthAttachment = vk_helpers::attachmentInfo(drawInfo.depthTarget, nullptr,
                                                                                  VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
@@ -87,6 +87,7 @@ struct DebugRendererInstance
 
 struct DebugRendererDrawInfo
 {
+    bool bClearColor{false};
     int32_t currentFrameOverlap{};
     VkExtent2D extents{DEFAULT_RENDER_EXTENT_2D};
     VkImageView debugTarget{VK_NULL_HANDLE};
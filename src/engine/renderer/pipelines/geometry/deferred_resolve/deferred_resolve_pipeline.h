@@ -8,6 +8,7 @@
 #include <volk/volk.h>
 
 #include "engine/renderer/renderer_constants.h"
+#include "engine/renderer/pipelines/lighting/light_culling/light_culling_pipeline_types.h"
 #include "engine/renderer/resources/resources_fwd.h"
 
 namespace will_engine::renderer
@@ -38,6 +39,7 @@ struct DeferredResolvePushConstants
     int32_t pcfLevel{5};
     float nearPlane{1000.0f};
     float farPlane{0.1f};
+    ClusteredLightingData clusteredLighting{};
 };
 
 struct DeferredResolveDrawInfo
@@ -56,6 +58,7 @@ struct DeferredResolveDrawInfo
     float farPlane{0.1f};
     bool bEnableShadowMap{true};
     bool bEnableContactShadows{true};
+    ClusteredLightingData clusteredLighting{};
 };
 
 class DeferredResolvePipeline
@@ -16,6 +16,10 @@ class ResourceManager;
 
 struct EnvironmentDrawInfo
 {
+    /**
+     * The environment is the first thing drawn into the G-Buffer, so it usually clears it
+     */
+    bool bClearColor{true};
     VkExtent2D renderExtents{DEFAULT_RENDER_EXTENT_2D};
     VkImageView normalTarget{VK_NULL_HANDLE};
     VkImageView albedoTarget{VK_NULL_HANDLE};
@@ -18,19 +18,22 @@
 
 namespace will_engine::renderer
 {
+static constexpr int32_t TERRAIN_PATCH_BOUNDS_GROUP_SIZE = 8;
+
 TerrainPipeline::TerrainPipeline(ResourceManager& resourceManager) : resourceManager(resourceManager)
 {
     std::array descriptorLayout{
         resourceManager.getSceneDataLayout(),
         resourceManager.getTerrainTexturesLayout(),
         resourceManager.getTerrainUniformLayout(),
+        resourceManager.getTerrainHeightmapLayout(),
     };
 
 
     VkPushConstantRange pushConstants = {};
     pushConstants.offset = 0;
     pushConstants.size = sizeof(TerrainPushConstants);
-    pushConstants.stageFlags = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    pushConstants.stageFlags = TERRAIN_PUSH_CONSTANT_STAGES;
 
     VkPipelineLayoutCreateInfo layoutInfo = vk_helpers::pipelineLayoutCreateInfo();
     layoutInfo.pNext = nullptr;
@@ -41,13 +44,77 @@ TerrainPipeline::TerrainPipeline(ResourceManager& resourceManager) : resourceMan
 
     pipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
 
+    // Patch bounds
+    {
+        VkDescriptorSetLayout heightmapLayout = resourceManager.getTerrainHeightmapLayout();
+
+        VkPushConstantRange boundsPushConstants = {};
+        boundsPushConstants.offset = 0;
+        boundsPushConstants.size = sizeof(TerrainPatchBoundsPushConstants);
+        boundsPushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkPipelineLayoutCreateInfo boundsLayoutInfo = vk_helpers::pipelineLayoutCreateInfo();
+        boundsLayoutInfo.pNext = nullptr;
+        boundsLayoutInfo.pSetLayouts = &heightmapLayout;
+        boundsLayoutInfo.setLayoutCount = 1;
+        boundsLayoutInfo.pPushConstantRanges = &boundsPushConstants;
+        boundsLayoutInfo.pushConstantRangeCount = 1;
+
+        patchBoundsPipelineLayout = resourceManager.createResource<PipelineLayout>(boundsLayoutInfo);
+    }
+
     createPipeline();
+    createPatchBoundsPipeline();
 }
 
 TerrainPipeline::~TerrainPipeline()
 {
     resourceManager.destroyResource(std::move(pipelineLayout));
     resourceManager.destroyResource(std::move(pipeline));
+    resourceManager.destroyResource(std::move(patchBoundsPipelineLayout));
+    resourceManager.destroyResource(std::move(patchBoundsPipeline));
+}
+
+void TerrainPipeline::updatePatchBounds(VkCommandBuffer cmd, const std::unordered_set<ITerrain*>& terrains) const
+{
+    bool bBound{false};
+    for (ITerrain* terrain : terrains) {
+        terrain::TerrainChunk* terrainChunk = terrain->getTerrainChunk();
+        if (!terrainChunk || !terrainChunk->arePatchBoundsDirty()) { continue; }
+
+        if (!bBound) {
+            VkDebugUtilsLabelEXT label = {};
+            label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+            label.pLabelName = "Terrain Patch Bounds";
+            vkCmdBeginDebugUtilsLabelEXT(cmd, &label);
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, patchBoundsPipeline->pipeline);
+            bBound = true;
+        }
+
+        // Previous frames' terrain draws may still be reading the old bounds
+        vk_helpers::bufferBarrier(cmd, terrainChunk->getPatchBoundsBuffer()->buffer, VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT, VK_ACCESS_2_NONE,
+                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
+
+        VkDescriptorBufferBindingInfoEXT heightmapBinding = terrainChunk->getHeightmapDescriptorBuffer()->getBindingInfo();
+        vkCmdBindDescriptorBuffersEXT(cmd, 1, &heightmapBinding);
+        constexpr uint32_t heightmapIndex{0};
+        vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, patchBoundsPipelineLayout->layout, 0, 1, &heightmapIndex, &ZERO_DEVICE_SIZE);
+
+        const glm::ivec2 patchCount = terrainChunk->getPatchCount();
+        const TerrainPatchBoundsPushConstants push{terrainChunk->getPatchBoundsAddress(), patchCount};
+        vkCmdPushConstants(cmd, patchBoundsPipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(TerrainPatchBoundsPushConstants), &push);
+        vkCmdDispatch(cmd, (patchCount.x + TERRAIN_PATCH_BOUNDS_GROUP_SIZE - 1) / TERRAIN_PATCH_BOUNDS_GROUP_SIZE,
+                      (patchCount.y + TERRAIN_PATCH_BOUNDS_GROUP_SIZE - 1) / TERRAIN_PATCH_BOUNDS_GROUP_SIZE, 1);
+
+        vk_helpers::bufferBarrier(cmd, terrainChunk->getPatchBoundsBuffer()->buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+        terrainChunk->clearPatchBoundsDirty();
+    }
+
+    if (bBound) {
+        vkCmdEndDebugUtilsLabelEXT(cmd);
+    }
 }
 
 void TerrainPipeline::draw(VkCommandBuffer cmd, const TerrainDrawInfo& drawInfo) const
@@ -109,10 +176,10 @@ void TerrainPipeline::draw(VkCommandBuffer cmd, const TerrainDrawInfo& drawInfo)
     scissor.extent.height = drawInfo.renderExtents.height;
     vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-    TerrainPushConstants push{4.0f};
-    vkCmdPushConstants(cmd, pipelineLayout->layout, VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, 0, sizeof(TerrainPushConstants), &push);
-
-    constexpr VkDeviceSize zeroOffset{0};
+    TerrainPushConstants push{};
+    push.targetEdgeLength = drawInfo.tessellationSettings.targetEdgeLength;
+    push.maxTessLevel = drawInfo.tessellationSettings.maxTessLevel;
+    push.bCullPatches = drawInfo.tessellationSettings.bCullPatches ? 1 : 0;
 
     for (ITerrain* terrain : drawInfo.terrains) {
         terrain::TerrainChunk* terrainChunk = terrain->getTerrainChunk();
@@ -122,23 +189,33 @@ void TerrainPipeline::draw(VkCommandBuffer cmd, const TerrainDrawInfo& drawInfo)
             drawInfo.sceneDataBinding,
             terrainChunk->getTextureDescriptorBuffer()->getBindingInfo(),
             terrainChunk->getUniformDescriptorBuffer()->getBindingInfo(),
+            terrainChunk->getHeightmapDescriptorBuffer()->getBindingInfo(),
         };
 
         vkCmdBindDescriptorBuffersEXT(cmd, descriptorBufferBindingInfo.size(), descriptorBufferBindingInfo.data());
 
-        std::array<uint32_t, 3> indices{0, 1, 2};
+        std::array<uint32_t, 4> indices{0, 1, 2, 3};
         std::array offsets{
             drawInfo.sceneDataOffset,
             ZERO_DEVICE_SIZE,
-            drawInfo.currentFrameOverlap * terrainChunk->getUniformDescriptorBuffer()->getDescriptorBufferSize()
+            drawInfo.currentFrameOverlap * terrainChunk->getUniformDescriptorBuffer()->getDescriptorBufferSize(),
+            ZERO_DEVICE_SIZE,
         };
 
-        vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout->layout, 0, 3, indices.data(), offsets.data());
+        vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout->layout, 0, 4, indices.data(), offsets.data());
+
+        const terrain::TerrainConfig& terrainConfig = terrainChunk->getTerrainConfig();
+        const terrain::TerrainChunkPlacement& placement = terrainChunk->getPlacement();
+        push.baseColor = terrainConfig.baseColor;
+        push.origin = placement.origin;
+        push.uvScale = terrainConfig.uvScale;
+        push.uvOffset = terrainConfig.uvOffset;
+        push.sampleSpacing = placement.sampleSpacing;
+        push.skirtDepth = placement.skirtDepth;
+        push.patchBoundsBuffer = terrainChunk->getPatchBoundsAddress();
+        vkCmdPushConstants(cmd, pipelineLayout->layout, TERRAIN_PUSH_CONSTANT_STAGES, 0, sizeof(TerrainPushConstants), &push);
 
-        VkBuffer vertexBuffer = terrainChunk->getVertexBuffer();
-        vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &zeroOffset);
-        vkCmdBindIndexBuffer(cmd, terrainChunk->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(cmd, terrainChunk->getIndexCount(), 1, 0, 0, 0);
+        vkCmdDraw(cmd, terrainChunk->getPatchVertexCount(), 1, 0, 0);
     }
 
     vkCmdEndRendering(cmd);
@@ -154,50 +231,8 @@ void TerrainPipeline::createPipeline()
     ShaderModulePtr teseShader = resourceManager.createResource<ShaderModule>("shaders/terrain/terrain.tese");
     ShaderModulePtr fragShader = resourceManager.createResource<ShaderModule>("shaders/terrain/terrain.frag");
 
+    // No vertex input, positions are pulled from the chunk's height map
     RenderPipelineBuilder renderPipelineBuilder;
-    const std::vector<VkVertexInputBindingDescription> vertexBindings{
-        {
-            .binding = 0,
-            .stride = sizeof(terrain::TerrainVertex),
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-        }
-    };
-
-    const std::vector<VkVertexInputAttributeDescription> vertexAttributes{
-        {
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(terrain::TerrainVertex, position),
-        },
-        {
-            .location = 1,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(terrain::TerrainVertex, normal),
-        },
-        {
-            .location = 2,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = offsetof(terrain::TerrainVertex, uv),
-        },
-        {
-            .location = 3,
-            .binding = 0,
-            .format = VK_FORMAT_R32_SINT,
-            .offset = offsetof(terrain::TerrainVertex, materialIndex),
-        },
-        {
-            .location = 4,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
-            .offset = offsetof(terrain::TerrainVertex, color),
-        }
-    };
-
-    renderPipelineBuilder.setupVertexInput(vertexBindings, vertexAttributes);
-
     renderPipelineBuilder.setShaders(vertShader->shader, tescShader->shader, teseShader->shader, fragShader->shader);
     renderPipelineBuilder.setupInputAssembly(VK_PRIMITIVE_TOPOLOGY_PATCH_LIST, false);
     renderPipelineBuilder.setupRasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_CLOCKWISE);
@@ -211,4 +246,25 @@ void TerrainPipeline::createPipeline()
     VkGraphicsPipelineCreateInfo pipelineCreateInfo = renderPipelineBuilder.generatePipelineCreateInfo();
     pipeline = resourceManager.createResource<Pipeline>(pipelineCreateInfo);
 }
+
+void TerrainPipeline::createPatchBoundsPipeline()
+{
+    resourceManager.destroyResource(std::move(patchBoundsPipeline));
+    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/terrain/terrain_patch_bounds.comp");
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.pNext = nullptr;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = shader->shader;
+    stageInfo.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = nullptr;
+    pipelineInfo.layout = patchBoundsPipelineLayout->layout;
+    pipelineInfo.stage = stageInfo;
+
+    patchBoundsPipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+}
 }
@@ -11,6 +11,7 @@
 
 #include "engine/renderer/renderer_constants.h"
 #include "engine/renderer/resources/resources_fwd.h"
+#include "engine/renderer/terrain/terrain_types.h"
 
 namespace will_engine
 {
@@ -21,9 +22,26 @@ namespace will_engine::renderer
 {
 class ResourceManager;
 
+static inline constexpr VkShaderStageFlags TERRAIN_PUSH_CONSTANT_STAGES{VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT};
+
 struct TerrainPushConstants
 {
-    float tessLevel;
+    glm::vec4 baseColor;
+    glm::vec2 origin;
+    glm::vec2 uvScale;
+    glm::vec2 uvOffset;
+    float sampleSpacing;
+    float targetEdgeLength;
+    float maxTessLevel;
+    int32_t bCullPatches;
+    float skirtDepth;
+    VkDeviceAddress patchBoundsBuffer;
+};
+
+struct TerrainPatchBoundsPushConstants
+{
+    VkDeviceAddress patchBoundsBuffer;
+    glm::ivec2 patchCount;
 };
 
 struct TerrainDrawInfo
@@ -39,6 +57,7 @@ struct TerrainDrawInfo
     VkImageView depthTarget{VK_NULL_HANDLE};
     VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
     VkDeviceSize sceneDataOffset{0};
+    terrain::TerrainTessellationSettings tessellationSettings{};
 };
 
 class TerrainPipeline
@@ -48,22 +67,36 @@ public:
 
     ~TerrainPipeline();
 
+    /**
+     * Recomputes the patch bounds of chunks that were created or edited since they were last computed. Must be recorded after the chunks'
+     * \code update\endcode and before any terrain is drawn (including shadows).
+     * @param cmd
+     * @param terrains
+     */
+    void updatePatchBounds(VkCommandBuffer cmd, const std::unordered_set<ITerrain*>& terrains) const;
+
     void draw(VkCommandBuffer cmd, const TerrainDrawInfo& drawInfo) const;
 
     void reloadShaders()
     {
         createPipeline();
+        createPatchBoundsPipeline();
     }
 
 private:
     void createPipeline();
 
+    void createPatchBoundsPipeline();
+
 private:
     ResourceManager& resourceManager;
 
     PipelineLayoutPtr pipelineLayout{};
     PipelinePtr pipeline{};
 
+    PipelineLayoutPtr patchBoundsPipelineLayout{};
+    PipelinePtr patchBoundsPipeline{};
+
     DescriptorSetLayoutPtr descriptorSetLayout{};
     DescriptorBufferSamplerPtr descriptorBuffer;
 };
@@ -152,6 +152,7 @@ void TransparentPipeline::drawAccumulate(VkCommandBuffer cmd, const TransparentA
 
     TransparentPushConstants pushConstants = {};
     pushConstants.bEnabled = drawInfo.enabled;
+    pushConstants.clusteredLighting = drawInfo.clusteredLighting;
 
     vkCmdPushConstants(cmd, accumulationPipelineLayout->layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(TransparentPushConstants), &pushConstants);
 
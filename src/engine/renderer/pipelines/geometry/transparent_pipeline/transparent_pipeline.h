@@ -10,6 +10,7 @@
 
 #include "engine/core/events/event_dispatcher.h"
 #include "engine/renderer/render_context.h"
+#include "engine/renderer/pipelines/lighting/light_culling/light_culling_pipeline_types.h"
 #include "engine/renderer/resources/resources_fwd.h"
 
 namespace will_engine::renderer
@@ -23,6 +24,8 @@ struct TransparentPushConstants
     int32_t bEnabled{true};
     int32_t bDisableShadows{false};
     int32_t bDisableContactShadows{false};
+    int32_t pad{0};
+    ClusteredLightingData clusteredLighting{};
 };
 
 struct TransparentAccumulateDrawInfo
@@ -39,6 +42,7 @@ struct TransparentAccumulateDrawInfo
     VkDescriptorBufferBindingInfoEXT cascadeUniformBinding{};
     VkDeviceSize cascadeUniformOffset{0};
     VkDescriptorBufferBindingInfoEXT cascadeSamplerBinding{};
+    ClusteredLightingData clusteredLighting{};
 };
 
 struct TransparentCompositeDrawInfo
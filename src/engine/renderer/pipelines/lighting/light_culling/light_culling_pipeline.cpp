@@ -0,0 +1,144 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#include "light_culling_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+
+#include "engine/renderer/resource_manager.h"
+#include "engine/renderer/vk_helpers.h"
+#include "engine/renderer/resources/buffer.h"
+#include "engine/renderer/resources/pipeline.h"
+#include "engine/renderer/resources/pipeline_layout.h"
+#include "engine/renderer/resources/shader_module.h"
+
+namespace will_engine::renderer
+{
+LightCullingPipeline::LightCullingPipeline(ResourceManager& resourceManager)
+    : resourceManager(resourceManager)
+{
+    VkDescriptorSetLayout layouts[1];
+    layouts[0] = resourceManager.getSceneDataLayout();
+
+    VkPushConstantRange pushConstantRange;
+    pushConstantRange.size = sizeof(LightCullingPushConstants);
+    pushConstantRange.offset = 0;
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = layouts;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    layoutInfo.pushConstantRangeCount = 1;
+    pipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
+
+    createPipeline();
+
+    // Lights are rewritten by the CPU every frame, cluster lists by the GPU. One of each per frame in flight
+    for (int32_t i{0}; i < FRAME_OVERLAP; i++) {
+        lightBuffers[i] = resourceManager.createResource<Buffer>(BufferType::HostSequential, sizeof(LocalLightData) * MAX_LOCAL_LIGHTS);
+        clusterBuffers[i] = resourceManager.createResource<Buffer>(BufferType::Device,
+                                                                   sizeof(uint32_t) * CLUSTER_COUNT * (MAX_LIGHTS_PER_CLUSTER + 1));
+    }
+}
+
+LightCullingPipeline::~LightCullingPipeline()
+{
+    resourceManager.destroyResource(std::move(pipeline));
+    resourceManager.destroyResource(std::move(pipelineLayout));
+    for (BufferPtr& lightBuffer : lightBuffers) {
+        resourceManager.destroyResource(std::move(lightBuffer));
+    }
+    for (BufferPtr& clusterBuffer : clusterBuffers) {
+        resourceManager.destroyResource(std::move(clusterBuffer));
+    }
+}
+
+void LightCullingPipeline::draw(VkCommandBuffer cmd, const LightCullingDrawInfo& drawInfo)
+{
+    const int32_t frame = drawInfo.currentFrameOverlap;
+    const auto lightCount = static_cast<uint32_t>(std::min<size_t>(drawInfo.lights.size(), MAX_LOCAL_LIGHTS));
+    // Only when the count changes, not every frame
+    if (drawInfo.lights.size() > MAX_LOCAL_LIGHTS && drawInfo.lights.size() != lastWarnedLightCount) {
+        fmt::print("Warning: {} local lights exceeds the maximum of {}, the rest will not be drawn\n", drawInfo.lights.size(), MAX_LOCAL_LIGHTS);
+    }
+    lastWarnedLightCount = drawInfo.lights.size() > MAX_LOCAL_LIGHTS ? drawInfo.lights.size() : 0;
+
+    // Reverse-z cameras pass their planes swapped
+    const float nearPlane = std::min(drawInfo.nearPlane, drawInfo.farPlane);
+    const float farPlane = std::max(drawInfo.nearPlane, drawInfo.farPlane);
+    const float logDepthRange = std::log(farPlane / nearPlane);
+
+    clusteredLightingData.lightBuffer = resourceManager.getBufferAddress(*lightBuffers[frame]);
+    clusteredLightingData.clusterBuffer = resourceManager.getBufferAddress(*clusterBuffers[frame]);
+    clusteredLightingData.gridSize = glm::ivec4(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, lightCount);
+    clusteredLightingData.depthSliceScale = static_cast<float>(CLUSTER_GRID_Z) / logDepthRange;
+    clusteredLightingData.depthSliceBias = -static_cast<float>(CLUSTER_GRID_Z) * std::log(nearPlane) / logDepthRange;
+    clusteredLightingData.nearPlane = nearPlane;
+    clusteredLightingData.farPlane = farPlane;
+
+    // Nothing to cull, passes skip local lights when the count is 0
+    if (lightCount == 0) { return; }
+
+    // View space on upload so neither culling nor shading has to transform every light
+    auto* pLights = static_cast<LocalLightData*>(lightBuffers[frame]->info.pMappedData);
+    const glm::mat3 viewRotation{drawInfo.viewMatrix};
+    for (uint32_t i = 0; i < lightCount; ++i) {
+        LocalLightData light = drawInfo.lights[i];
+        light.position = glm::vec3(drawInfo.viewMatrix * glm::vec4(light.position, 1.0f));
+        light.direction = glm::normalize(viewRotation * light.direction);
+        pLights[i] = light;
+    }
+
+    VkDebugUtilsLabelEXT label = {};
+    label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    label.pLabelName = "Light Culling";
+    vkCmdBeginDebugUtilsLabelEXT(cmd, &label);
+
+    // Previous frame using this buffer has finished (frame fence), only ordering against earlier commands in this submission is needed
+    vk_helpers::bufferBarrier(cmd, clusterBuffers[frame]->buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                              VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
+
+    const LightCullingPushConstants pushConstants{clusteredLightingData};
+    vkCmdPushConstants(cmd, pipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(LightCullingPushConstants), &pushConstants);
+
+    vkCmdBindDescriptorBuffersEXT(cmd, 1, &drawInfo.sceneDataBinding);
+    constexpr uint32_t index{0};
+    vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->layout, 0, 1, &index, &drawInfo.sceneDataOffset);
+
+    vkCmdDispatch(cmd, (CLUSTER_COUNT + LIGHT_CULLING_WORKGROUP_SIZE - 1) / LIGHT_CULLING_WORKGROUP_SIZE, 1, 1);
+
+    vk_helpers::bufferBarrier(cmd, clusterBuffers[frame]->buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                              VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+
+    vkCmdEndDebugUtilsLabelEXT(cmd);
+}
+
+void LightCullingPipeline::createPipeline()
+{
+    resourceManager.destroyResource(std::move(pipeline));
+    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/lighting/light_culling.comp");
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.pNext = nullptr;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = shader->shader;
+    stageInfo.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = nullptr;
+    pipelineInfo.layout = pipelineLayout->layout;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+    pipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+}
+}
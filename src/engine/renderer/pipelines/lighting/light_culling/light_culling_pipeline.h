@@ -0,0 +1,63 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef LIGHT_CULLING_PIPELINE_H
+#define LIGHT_CULLING_PIPELINE_H
+
+#include <array>
+#include <vulkan/vulkan_core.h>
+
+#include "light_culling_pipeline_types.h"
+#include "engine/renderer/renderer_constants.h"
+#include "engine/renderer/resources/resources_fwd.h"
+
+namespace will_engine::renderer
+{
+class ResourceManager;
+
+/**
+ * Clustered light culling. Assigns every point/spot light to the froxels its bounds overlap, so shading only loops over the lights of its own cluster.
+ */
+class LightCullingPipeline
+{
+public:
+    explicit LightCullingPipeline(ResourceManager& resourceManager);
+
+    ~LightCullingPipeline();
+
+    /**
+     * Uploads this frame's lights and builds the per-cluster light lists. Scene data for the frame must already be up to date.
+     * The lists are ready for compute and fragment shaders once this returns.
+     */
+    void draw(VkCommandBuffer cmd, const LightCullingDrawInfo& drawInfo);
+
+    /**
+     * Cluster lookup for the frame last passed to \code draw\endcode
+     */
+    [[nodiscard]] const ClusteredLightingData& getClusteredLightingData() const { return clusteredLightingData; }
+
+    void reloadShaders() { createPipeline(); }
+
+private:
+    void createPipeline();
+
+private:
+    ResourceManager& resourceManager;
+
+    PipelineLayoutPtr pipelineLayout{};
+    PipelinePtr pipeline{};
+
+    std::array<BufferPtr, FRAME_OVERLAP> lightBuffers{};
+    std::array<BufferPtr, FRAME_OVERLAP> clusterBuffers{};
+
+    ClusteredLightingData clusteredLightingData{};
+
+    /**
+     * Light count the over-limit warning was last printed for, 0 while under the limit
+     */
+    size_t lastWarnedLightCount{0};
+};
+}
+
+#endif //LIGHT_CULLING_PIPELINE_H
@@ -0,0 +1,73 @@
+//
+// Created by William on 2025-07-04.
+//
+
+#ifndef LIGHT_CULLING_PIPELINE_TYPES_H
+#define LIGHT_CULLING_PIPELINE_TYPES_H
+
+#include <span>
+#include <glm/glm.hpp>
+#include <volk/volk.h>
+
+#include "engine/renderer/lighting/local_light.h"
+
+namespace will_engine::renderer
+{
+/**
+ * Froxel grid, x/y split the screen into tiles and z splits view depth exponentially
+ */
+static constexpr uint32_t CLUSTER_GRID_X{16};
+static constexpr uint32_t CLUSTER_GRID_Y{9};
+static constexpr uint32_t CLUSTER_GRID_Z{24};
+static constexpr uint32_t CLUSTER_COUNT{CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z};
+static constexpr uint32_t MAX_LOCAL_LIGHTS{1024};
+/**
+ * Must match MAX_LIGHTS_PER_CLUSTER in clustered_lighting.glsl. Lights past this limit are dropped from the cluster
+ */
+static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER{128};
+static constexpr uint32_t LIGHT_CULLING_WORKGROUP_SIZE{64};
+
+/**
+ * Everything a pass needs to shade with the culled local lights, embedded in its push constants (\code ClusteredLighting\endcode in clustered_lighting.glsl)
+ */
+struct ClusteredLightingData
+{
+    VkDeviceAddress lightBuffer{0};
+    /**
+     * Per cluster, a light count followed by \code MAX_LIGHTS_PER_CLUSTER\endcode light indices
+     */
+    VkDeviceAddress clusterBuffer{0};
+    /**
+     * xyz cluster counts, w light count. Passes skip local lights entirely if w is 0
+     */
+    glm::ivec4 gridSize{CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, 0};
+    /**
+     * Depth slice of a view depth is \code log(depth) * depthSliceScale + depthSliceBias\endcode
+     */
+    float depthSliceScale{0.0f};
+    float depthSliceBias{0.0f};
+    float nearPlane{0.1f};
+    float farPlane{1000.0f};
+};
+
+struct LightCullingPushConstants
+{
+    ClusteredLightingData clusteredLighting;
+};
+
+struct LightCullingDrawInfo
+{
+    int32_t currentFrameOverlap{0};
+    /**
+     * World space, converted to view space when uploaded
+     */
+    std::span<const LocalLightData> lights{};
+    glm::mat4 viewMatrix{1.0f};
+    float nearPlane{0.1f};
+    float farPlane{1000.0f};
+    VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
+    VkDeviceSize sceneDataOffset{0};
+};
+}
+
+#endif //LIGHT_CULLING_PIPELINE_TYPES_H
@@ -10,20 +10,27 @@
 #include "engine/renderer/renderer_constants.h"
 #include "engine/renderer/resource_manager.h"
 #include "engine/renderer/vk_descriptors.h"
-#include "engine/renderer/resources/pipeline.h"
 #include "engine/renderer/resources/pipeline_layout.h"
-#include "engine/renderer/resources/shader_module.h"
+#include "engine/renderer/resources/pipeline_permutations.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_sampler.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_types.h"
 
 namespace will_engine::renderer
 {
+static void specialize(const uint32_t permutation, SpecializationConstants& constants)
+{
+    const auto flags = static_cast<PostProcessType>(permutation);
+    constants.add(0, (flags & PostProcessType::Tonemapping) != PostProcessType::None);
+    constants.add(1, (flags & PostProcessType::Sharpening) != PostProcessType::None);
+    constants.add(2, (flags & PostProcessType::FXAA) != PostProcessType::None);
+}
+
 PostProcessPipeline::PostProcessPipeline(ResourceManager& resourceManager)
     : resourceManager(resourceManager)
 {
     DescriptorLayoutBuilder layoutBuilder{2};
     layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // taa resolve image
-    layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE); // post process result
+    layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE); // post process result, the final image or a swapchain image
     VkDescriptorSetLayoutCreateInfo layoutCreateInfo = layoutBuilder.build(
         VK_SHADER_STAGE_COMPUTE_BIT,
         VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
@@ -31,11 +38,6 @@ PostProcessPipeline::PostProcessPipeline(ResourceManager& resourceManager)
 
     descriptorSetLayout = resourceManager.createResource<DescriptorSetLayout>(layoutCreateInfo);
 
-    VkPushConstantRange pushConstants{};
-    pushConstants.offset = 0;
-    pushConstants.size = sizeof(PostProcessPushConstants);
-    pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-
     const std::array setLayouts{
         resourceManager.getSceneDataLayout(),
         descriptorSetLayout->layout,
@@ -47,19 +49,21 @@ PostProcessPipeline::PostProcessPipeline(ResourceManager& resourceManager)
     layoutInfo.pNext = nullptr;
     layoutInfo.pSetLayouts = setLayouts.data();
     layoutInfo.setLayoutCount = setLayouts.size();
-    layoutInfo.pPushConstantRanges = &pushConstants;
-    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = nullptr;
+    layoutInfo.pushConstantRangeCount = 0;
 
     pipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
 
-    createPipeline();
+    pipelines = std::make_unique<ComputePipelinePermutations>(resourceManager, "shaders/postProcess.comp", pipelineLayout->layout, specialize);
 
-    descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, 1);
+    descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, POST_PROCESS_INPUT_COUNT);
+    descriptorSetCount = POST_PROCESS_INPUT_COUNT;
 }
 
 PostProcessPipeline::~PostProcessPipeline()
 {
-    resourceManager.destroyResource(std::move(pipeline));
+    pipelines.reset();
+    swapchainPipelines.reset();
     resourceManager.destroyResource(std::move(pipelineLayout));
     resourceManager.destroyResource(std::move(descriptorSetLayout));
     resourceManager.destroyResource(std::move(descriptorBuffer));
@@ -67,21 +71,39 @@ PostProcessPipeline::~PostProcessPipeline()
 
 void PostProcessPipeline::setupDescriptorBuffer(const PostProcessDescriptor& bufferInfo)
 {
-    VkDescriptorImageInfo inputImage{};
-    inputImage.sampler = bufferInfo.sampler;
-    inputImage.imageView = bufferInfo.inputImage;
-    inputImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    VkDescriptorImageInfo outputImage{};
-    outputImage.imageView = bufferInfo.outputImage;
-    outputImage.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-
-    std::array<DescriptorImageData, 2> descriptors{
-        DescriptorImageData{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, inputImage, false},
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, outputImage, false},
-    };
+    bSwapchainOutput = bufferInfo.bSwapchainOutput;
+    if (bSwapchainOutput && !swapchainPipelines) {
+        swapchainPipelines = std::make_unique<ComputePipelinePermutations>(resourceManager, "shaders/postProcessSwapchain.comp",
+                                                                           pipelineLayout->layout, specialize);
+    }
+
+    // The swapchain image count is only known once the swapchain is created, and may change when it is recreated
+    const int32_t requiredSetCount = static_cast<int32_t>(bufferInfo.outputImages.size()) * POST_PROCESS_INPUT_COUNT;
+    if (requiredSetCount > descriptorSetCount) {
+        resourceManager.destroyResource(std::move(descriptorBuffer));
+        descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, requiredSetCount);
+        descriptorSetCount = requiredSetCount;
+    }
 
-    descriptorBuffer->setupData(descriptors, 0);
+    for (int32_t output = 0; output < static_cast<int32_t>(bufferInfo.outputImages.size()); ++output) {
+        VkDescriptorImageInfo outputImage{};
+        outputImage.imageView = bufferInfo.outputImages[output];
+        outputImage.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        for (int32_t i = 0; i < POST_PROCESS_INPUT_COUNT; ++i) {
+            VkDescriptorImageInfo inputImage{};
+            inputImage.sampler = bufferInfo.sampler;
+            inputImage.imageView = bufferInfo.inputImages[i];
+            inputImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+            std::array<DescriptorImageData, 2> descriptors{
+                DescriptorImageData{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, inputImage, false},
+                {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, outputImage, false},
+            };
+
+            descriptorBuffer->setupData(descriptors, output * POST_PROCESS_INPUT_COUNT + i);
+        }
+    }
 }
 
 void PostProcessPipeline::draw(VkCommandBuffer cmd, PostProcessDrawInfo drawInfo) const
@@ -96,12 +118,11 @@ void PostProcessPipeline::draw(VkCommandBuffer cmd, PostProcessDrawInfo drawInfo
     label.pLabelName = "Post Process Pass";
     vkCmdBeginDebugUtilsLabelEXT(cmd, &label);
 
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
-
-    PostProcessPushConstants push{};
-    push.postProcessFlags = static_cast<uint32_t>(drawInfo.postProcessFlags);
-
-    vkCmdPushConstants(cmd, pipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PostProcessPushConstants), &push);
+    // Unused bits are masked off so ALL and the exact flag set share a variant
+    constexpr PostProcessType usedFlags = PostProcessType::Tonemapping | PostProcessType::Sharpening | PostProcessType::FXAA;
+    const auto permutation = static_cast<uint32_t>(drawInfo.postProcessFlags & usedFlags);
+    ComputePipelinePermutations& activePipelines = bSwapchainOutput ? *swapchainPipelines : *pipelines;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, activePipelines.get(permutation));
 
     const std::array bindingInfos{
         drawInfo.sceneDataBinding,
@@ -110,7 +131,8 @@ void PostProcessPipeline::draw(VkCommandBuffer cmd, PostProcessDrawInfo drawInfo
     vkCmdBindDescriptorBuffersEXT(cmd, 2, bindingInfos.data());
 
     constexpr std::array<uint32_t, 2> indices{0, 1};
-    const std::array<VkDeviceSize, 2> offsets{drawInfo.sceneDataOffset, 0};
+    const int32_t setIndex = drawInfo.outputIndex * POST_PROCESS_INPUT_COUNT + drawInfo.inputIndex;
+    const std::array<VkDeviceSize, 2> offsets{drawInfo.sceneDataOffset, descriptorBuffer->getDescriptorBufferSize() * setIndex};
     vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->layout, 0, 2, indices.data(), offsets.data());
 
     const auto x = static_cast<uint32_t>(std::ceil(drawInfo.extents.width / 16.0f));
@@ -120,25 +142,11 @@ void PostProcessPipeline::draw(VkCommandBuffer cmd, PostProcessDrawInfo drawInfo
     vkCmdEndDebugUtilsLabelEXT(cmd);
 }
 
-void PostProcessPipeline::createPipeline()
+void PostProcessPipeline::reloadShaders()
 {
-    resourceManager.destroyResource(std::move(pipeline));
-    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/postProcess.comp");
-
-    VkPipelineShaderStageCreateInfo stageInfo{};
-    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stageInfo.pNext = nullptr;
-    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    stageInfo.module = shader->shader;
-    stageInfo.pName = "main";
-
-    VkComputePipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    pipelineInfo.pNext = nullptr;
-    pipelineInfo.layout = pipelineLayout->layout;
-    pipelineInfo.stage = stageInfo;
-    pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
-
-    pipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+    pipelines->reset();
+    if (swapchainPipelines) {
+        swapchainPipelines->reset();
+    }
 }
 }
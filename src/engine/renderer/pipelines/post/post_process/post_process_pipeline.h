@@ -5,7 +5,10 @@
 #ifndef POST_PROCESS_PIPELINE_H
 #define POST_PROCESS_PIPELINE_H
 
-#include <glm/glm.hpp>
+#include <array>
+#include <memory>
+#include <span>
+
 #include <vulkan/vulkan_core.h>
 
 #include "post_process_pipeline_types.h"
@@ -15,23 +18,35 @@
 namespace will_engine::renderer
 {
 class ResourceManager;
+class ComputePipelinePermutations;
+
+static constexpr int32_t POST_PROCESS_INPUT_COUNT = 2;
 
 struct PostProcessDescriptor
 {
-    VkImageView inputImage;
-    VkImageView outputImage;
+    /**
+     * Inputs the pass alternates between, e.g. ping-ponged TAA history buffers
+     */
+    std::array<VkImageView, POST_PROCESS_INPUT_COUNT> inputImages;
+    /**
+     * The final image, or every swapchain image if \code bSwapchainOutput\endcode
+     */
+    std::span<const VkImageView> outputImages;
     VkSampler sampler;
-};
-
-struct PostProcessPushConstants
-{
-    uint32_t postProcessFlags;
-    glm::vec3 padding;
+    /**
+     * Write the swapchain directly, which has to be \code VK_FORMAT_R8G8B8A8_UNORM\endcode and created with storage usage
+     */
+    bool bSwapchainOutput{false};
 };
 
 struct PostProcessDrawInfo
 {
     PostProcessType postProcessFlags{PostProcessType::ALL};
+    int32_t inputIndex{0};
+    /**
+     * Index into \code PostProcessDescriptor::outputImages\endcode, the swapchain image index when writing to the swapchain
+     */
+    int32_t outputIndex{0};
     VkExtent2D extents{DEFAULT_RENDER_EXTENT_2D};
     VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
     VkDeviceSize sceneDataOffset{0};
@@ -48,18 +63,27 @@ public:
 
     void draw(VkCommandBuffer cmd, PostProcessDrawInfo drawInfo) const;
 
-    void reloadShaders() { createPipeline(); }
-
-private:
-    void createPipeline();
+    void reloadShaders();
 
 private:
     ResourceManager& resourceManager;
 
     PipelineLayoutPtr pipelineLayout{};
-    PipelinePtr pipeline{};
+    /**
+     * One variant per combination of the \code PostProcessType\endcode flags
+     */
+    std::unique_ptr<ComputePipelinePermutations> pipelines{};
+    /**
+     * Same permutations, stretching the render target over the swapchain. Only created if the swapchain supports storage usage
+     */
+    std::unique_ptr<ComputePipelinePermutations> swapchainPipelines{};
+    bool bSwapchainOutput{false};
     DescriptorSetLayoutPtr descriptorSetLayout{};
     DescriptorBufferSamplerPtr descriptorBuffer{};
+    /**
+     * One set per input and output combination
+     */
+    int32_t descriptorSetCount{0};
 };
 }
 
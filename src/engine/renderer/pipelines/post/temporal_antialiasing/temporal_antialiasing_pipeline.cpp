@@ -52,7 +52,8 @@ TemporalAntialiasingPipeline::TemporalAntialiasingPipeline(ResourceManager& reso
 
     createPipeline();
 
-    descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, 1);
+    // One set per history buffer that can be resolved into
+    descriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(descriptorSetLayout->layout, TAA_HISTORY_BUFFER_COUNT);
 }
 
 TemporalAntialiasingPipeline::~TemporalAntialiasingPipeline()
@@ -74,11 +75,6 @@ void TemporalAntialiasingPipeline::setupDescriptorBuffer(
     drawImage.imageView = descriptor.drawImage;
     drawImage.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    VkDescriptorImageInfo history{};
-    history.sampler = descriptor.sampler;
-    history.imageView = descriptor.historyBuffer;
-    history.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
     VkDescriptorImageInfo depth{};
     depth.sampler = descriptor.sampler;
     depth.imageView = descriptor.depthBuffer;
@@ -89,18 +85,25 @@ void TemporalAntialiasingPipeline::setupDescriptorBuffer(
     velocity.imageView = descriptor.velocityBuffer;
     velocity.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    VkDescriptorImageInfo output{};
-    output.imageView = descriptor.outputTarget;
-    output.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    for (int32_t i = 0; i < TAA_HISTORY_BUFFER_COUNT; ++i) {
+        VkDescriptorImageInfo history{};
+        history.sampler = descriptor.sampler;
+        history.imageView = descriptor.historyBuffers[(i + 1) % TAA_HISTORY_BUFFER_COUNT];
+        history.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
+        VkDescriptorImageInfo output{};
+        output.imageView = descriptor.historyBuffers[i];
+        output.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, drawImage, false});
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, history, false});
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, depth, false});
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, velocity, false});
-    descriptors.push_back({VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, output, false});
+        descriptors.clear();
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, drawImage, false});
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, history, false});
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, depth, false});
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, velocity, false});
+        descriptors.push_back({VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, output, false});
 
-    descriptorBuffer->setupData(descriptors, 0);
+        descriptorBuffer->setupData(descriptors, i);
+    }
 }
 
 void TemporalAntialiasingPipeline::draw(VkCommandBuffer cmd, const TemporalAntialiasingDrawInfo& drawInfo) const
@@ -130,7 +133,7 @@ void TemporalAntialiasingPipeline::draw(VkCommandBuffer cmd, const TemporalAntia
 
 
     constexpr std::array<uint32_t, 2> indices{0, 1};
-    const std::array offsets{drawInfo.sceneDataOffset, ZERO_DEVICE_SIZE};
+    const std::array offsets{drawInfo.sceneDataOffset, descriptorBuffer->getDescriptorBufferSize() * drawInfo.historyIndex};
 
     vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->layout, 0, 2, indices.data(), offsets.data());
 
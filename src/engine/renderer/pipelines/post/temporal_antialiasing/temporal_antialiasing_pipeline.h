@@ -5,6 +5,8 @@
 #ifndef TEMPORAL_ANTIALIASING_PIPELINE_H
 #define TEMPORAL_ANTIALIASING_PIPELINE_H
 
+#include <array>
+
 #include <vulkan/vulkan_core.h>
 
 #include "engine/renderer/renderer_constants.h"
@@ -21,13 +23,17 @@ struct TemporalAntialiasingPushConstants
     int32_t taaDebug{0};
 };
 
+static constexpr int32_t TAA_HISTORY_BUFFER_COUNT = 2;
+
 struct TemporalAntialiasingDescriptor
 {
     VkImageView drawImage{VK_NULL_HANDLE};
-    VkImageView historyBuffer{VK_NULL_HANDLE};
     VkImageView depthBuffer{VK_NULL_HANDLE};
     VkImageView velocityBuffer{VK_NULL_HANDLE};
-    VkImageView outputTarget{VK_NULL_HANDLE};
+    /**
+     * Each frame resolves into one history buffer and reads the previous frame's resolve from the other
+     */
+    std::array<VkImageView, TAA_HISTORY_BUFFER_COUNT> historyBuffers{};
     VkSampler sampler{VK_NULL_HANDLE};
 };
 
@@ -35,6 +41,10 @@ struct TemporalAntialiasingDrawInfo
 {
     float blendValue{};
     int32_t debugMode{};
+    /**
+     * History buffer resolved into this frame
+     */
+    int32_t historyIndex{0};
     VkExtent2D extents{DEFAULT_RENDER_EXTENT_2D};
     VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
     VkDeviceSize sceneDataOffset{0};
@@ -36,7 +36,8 @@ CascadedShadowMap::CascadedShadowMap(ResourceManager& resourceManager)
         DescriptorLayoutBuilder layoutBuilder{1};
         layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
         VkDescriptorSetLayoutCreateInfo layoutCreateInfo = layoutBuilder.build(
-            static_cast<VkShaderStageFlagBits>(VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT),
+            static_cast<VkShaderStageFlagBits>(VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT |
+                                               VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT),
             VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
         );
         cascadedShadowMapUniformLayout = resourceManager.createResource<DescriptorSetLayout>(layoutCreateInfo);
@@ -111,17 +112,18 @@ CascadedShadowMap::CascadedShadowMap(ResourceManager& resourceManager)
     createRenderObjectPipeline();
     //
     {
-        VkDescriptorSetLayout layouts[1];
+        VkDescriptorSetLayout layouts[2];
         layouts[0] = cascadedShadowMapUniformLayout->layout;
+        layouts[1] = resourceManager.getTerrainHeightmapLayout();
 
         VkPushConstantRange pushConstantRange;
-        pushConstantRange.size = sizeof(CascadedShadowMapGenerationPushConstants);
+        pushConstantRange.size = sizeof(TerrainShadowPushConstants);
         pushConstantRange.offset = 0;
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        pushConstantRange.stageFlags = TERRAIN_SHADOW_PUSH_CONSTANT_STAGES;
 
         VkPipelineLayoutCreateInfo layoutInfo = vk_helpers::pipelineLayoutCreateInfo();
         layoutInfo.pNext = nullptr;
-        layoutInfo.setLayoutCount = 1;
+        layoutInfo.setLayoutCount = 2;
         layoutInfo.pSetLayouts = layouts;
         layoutInfo.pPushConstantRanges = &pushConstantRange;
         layoutInfo.pushConstantRangeCount = 1;
@@ -248,11 +250,12 @@ void CascadedShadowMap::draw(VkCommandBuffer cmd, CascadedShadowMapDrawInfo draw
 
             vkCmdSetDepthBias(cmd, cascadeBias.constant, 0.0f, cascadeBias.slope);
 
-            CascadedShadowMapGenerationPushConstants pushConstants{};
+            TerrainShadowPushConstants pushConstants{};
             pushConstants.cascadeIndex = cascadeShadowMapData.cascadeLevel;
-            pushConstants.tessLevel = 1;
-            vkCmdPushConstants(cmd, terrainPipelineLayout->layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, 0,
-                               sizeof(CascadedShadowMapGenerationPushConstants), &pushConstants);
+            pushConstants.targetEdgeLength = drawInfo.tessellationSettings.shadowTargetEdgeLength;
+            pushConstants.maxTessLevel = drawInfo.tessellationSettings.shadowMaxTessLevel;
+            pushConstants.cascadeResolution = static_cast<float>(cascadeExtents.width);
+            pushConstants.bCullPatches = drawInfo.tessellationSettings.bCullPatches ? 1 : 0;
 
             //  Viewport
             VkViewport viewport = {};
@@ -271,28 +274,34 @@ void CascadedShadowMap::draw(VkCommandBuffer cmd, CascadedShadowMapDrawInfo draw
             scissor.extent.height = cascadeExtents.height;
             vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-            constexpr VkDeviceSize zeroOffset{0};
-
             for (ITerrain* terrain : drawInfo.terrains) {
                 terrain::TerrainChunk* terrainChunk = terrain->getTerrainChunk();
                 if (!terrainChunk) { continue; }
 
-                VkDescriptorBufferBindingInfoEXT descriptorBufferBindingInfo[1];
-                constexpr uint32_t shadowDataIndex{0};
-                descriptorBufferBindingInfo[0] = cascadedShadowMapDescriptorBufferUniform->getBindingInfo();
+                std::array descriptorBufferBindingInfo{
+                    cascadedShadowMapDescriptorBufferUniform->getBindingInfo(),
+                    terrainChunk->getHeightmapDescriptorBuffer()->getBindingInfo(),
+                };
 
-                vkCmdBindDescriptorBuffersEXT(cmd, 1, descriptorBufferBindingInfo);
+                vkCmdBindDescriptorBuffersEXT(cmd, descriptorBufferBindingInfo.size(), descriptorBufferBindingInfo.data());
 
-                const VkDeviceSize shadowDataOffset{
-                    cascadedShadowMapDescriptorBufferUniform->getDescriptorBufferSize() * drawInfo.currentFrameOverlap
+                std::array<uint32_t, 2> indices{0, 1};
+                std::array offsets{
+                    cascadedShadowMapDescriptorBufferUniform->getDescriptorBufferSize() * drawInfo.currentFrameOverlap,
+                    ZERO_DEVICE_SIZE,
                 };
-                vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, terrainPipelineLayout->layout, 0, 1, &shadowDataIndex,
-                                                   &shadowDataOffset);
+                vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, terrainPipelineLayout->layout, 0, 2, indices.data(),
+                                                   offsets.data());
 
-                VkBuffer vertexBuffer = terrainChunk->getVertexBuffer();
-                vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &zeroOffset);
-                vkCmdBindIndexBuffer(cmd, terrainChunk->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
-                vkCmdDrawIndexed(cmd, terrainChunk->getIndexCount(), 1, 0, 0, 0);
+                const terrain::TerrainChunkPlacement& placement = terrainChunk->getPlacement();
+                pushConstants.origin = placement.origin;
+                pushConstants.sampleSpacing = placement.sampleSpacing;
+                pushConstants.skirtDepth = placement.skirtDepth;
+                pushConstants.patchBoundsBuffer = terrainChunk->getPatchBoundsAddress();
+                vkCmdPushConstants(cmd, terrainPipelineLayout->layout, TERRAIN_SHADOW_PUSH_CONSTANT_STAGES, 0, sizeof(TerrainShadowPushConstants),
+                                   &pushConstants);
+
+                vkCmdDraw(cmd, terrainChunk->getPatchVertexCount(), 1, 0, 0);
             }
 
             vkCmdEndRendering(cmd);
@@ -496,26 +505,8 @@ void CascadedShadowMap::createTerrainPipeline()
     ShaderModulePtr fragShader = resourceManager.createResource<ShaderModule>("shaders/shadows/shadow_pass.frag");
 
 
+    // No vertex input, positions are pulled from the chunk's height map
     RenderPipelineBuilder pipelineBuilder;
-    const std::vector<VkVertexInputBindingDescription> vertexBindings{
-        {
-            .binding = 0,
-            .stride = sizeof(terrain::TerrainVertex),
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-        }
-    };
-
-    const std::vector<VkVertexInputAttributeDescription> vertexAttributes{
-        {
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(terrain::TerrainVertex, position),
-        }
-    };
-
-    pipelineBuilder.setupVertexInput(vertexBindings, vertexAttributes);
-
     pipelineBuilder.setShaders(vertShader->shader, tescShader->shader, teseShader->shader, fragShader->shader);
     pipelineBuilder.setupInputAssembly(VK_PRIMITIVE_TOPOLOGY_PATCH_LIST, false);
     pipelineBuilder.setupRasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_CLOCKWISE);
@@ -12,6 +12,7 @@
 
 #include "engine/renderer/lighting/directional_light.h"
 #include "engine/renderer/resources/resources_fwd.h"
+#include "engine/renderer/terrain/terrain_types.h"
 
 namespace will_engine
 {
@@ -24,6 +25,9 @@ class RenderObject;
 
 static inline constexpr uint32_t SHADOW_CASCADE_COUNT{4};
 static inline constexpr VkFormat CASCADE_DEPTH_FORMAT{VK_FORMAT_D32_SFLOAT};
+static inline constexpr VkShaderStageFlags TERRAIN_SHADOW_PUSH_CONSTANT_STAGES{
+    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT
+};
 
 struct CascadeBias
 {
@@ -88,7 +92,19 @@ struct CascadeShadowMapData
 struct CascadedShadowMapGenerationPushConstants
 {
     int32_t cascadeIndex{};
-    int32_t tessLevel{};
+};
+
+struct TerrainShadowPushConstants
+{
+    glm::vec2 origin{};
+    float sampleSpacing{};
+    int32_t cascadeIndex{};
+    float targetEdgeLength{};
+    float maxTessLevel{};
+    float cascadeResolution{};
+    int32_t bCullPatches{};
+    float skirtDepth{};
+    VkDeviceAddress patchBoundsBuffer{};
 };
 
 struct CascadeShadowData
@@ -107,6 +123,7 @@ struct CascadedShadowMapDrawInfo
     int32_t currentFrameOverlap{};
     const std::vector<RenderObject*>& renderObjects;
     std::unordered_set<ITerrain*>& terrains;
+    terrain::TerrainTessellationSettings tessellationSettings{};
 };
 }
 #endif //SHADOW_TYPES_H
@@ -11,9 +11,8 @@
 #include "engine/renderer/vk_helpers.h"
 #include "engine/renderer/lighting/directional_light.h"
 #include "engine/renderer/resources/image.h"
-#include "engine/renderer/resources/pipeline.h"
 #include "engine/renderer/resources/pipeline_layout.h"
-#include "engine/renderer/resources/shader_module.h"
+#include "engine/renderer/resources/pipeline_permutations.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_sampler.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_types.h"
 
@@ -51,7 +50,11 @@ ContactShadowsPipeline::ContactShadowsPipeline(ResourceManager& resourceManager,
     layoutInfo.pushConstantRangeCount = 1;
 
     pipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
-    createPipeline();
+    pipelines = std::make_unique<ComputePipelinePermutations>(
+        resourceManager, "shaders/shadows/contact_shadow_pass.comp", pipelineLayout->layout,
+        [](const uint32_t permutation, SpecializationConstants& constants) {
+            constants.add(0, permutation != 0); // DEBUG_OUTPUT
+        });
 
     VkSamplerCreateInfo samplerInfo = {.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
     samplerInfo.magFilter = VK_FILTER_NEAREST;
@@ -79,7 +82,7 @@ ContactShadowsPipeline::ContactShadowsPipeline(ResourceManager& resourceManager,
 
 ContactShadowsPipeline::~ContactShadowsPipeline()
 {
-    resourceManager.destroyResource(std::move(pipeline));
+    pipelines.reset();
     resourceManager.destroyResource(std::move(pipelineLayout));
     resourceManager.destroyResource(std::move(descriptorSetLayout));
 
@@ -118,18 +121,21 @@ void ContactShadowsPipeline::setupDescriptorBuffer(const VkImageView& depthImage
 
 void ContactShadowsPipeline::draw(VkCommandBuffer cmd, const ContactShadowsDrawInfo& drawInfo)
 {
-    vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    const bool bDebugOutput = drawInfo.push.debugMode != 0;
+    if (bDebugOutput) {
+        vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
     vk_helpers::clearColorImage(cmd, VK_IMAGE_ASPECT_COLOR_BIT, contactShadowImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
 
     if (!drawInfo.bIsEnabled) {
         return;
     }
 
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines->get(bDebugOutput ? 1 : 0));
 
     ContactShadowsPushConstants push{drawInfo.push};
 
-    const DispatchList dispatchList = buildDispatchList(drawInfo.camera, drawInfo.light);
+    const DispatchList dispatchList = buildDispatchList(drawInfo.camera, drawInfo.light, {drawInfo.renderExtent.width, drawInfo.renderExtent.height});
 
     push.lightCoordinate = glm::vec4(dispatchList.LightCoordinate_Shader[0], dispatchList.LightCoordinate_Shader[1],
                                      dispatchList.LightCoordinate_Shader[2], dispatchList.LightCoordinate_Shader[3]);
@@ -153,26 +159,9 @@ void ContactShadowsPipeline::draw(VkCommandBuffer cmd, const ContactShadowsDrawI
     }
 }
 
-void ContactShadowsPipeline::createPipeline()
+void ContactShadowsPipeline::reloadShaders() const
 {
-    resourceManager.destroyResource(std::move(pipeline));
-    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/shadows/contact_shadow_pass.comp");
-
-    VkPipelineShaderStageCreateInfo stageInfo{};
-    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stageInfo.pNext = nullptr;
-    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    stageInfo.module = shader->shader;
-    stageInfo.pName = "main";
-
-    VkComputePipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    pipelineInfo.pNext = nullptr;
-    pipelineInfo.layout = pipelineLayout->layout;
-    pipelineInfo.stage = stageInfo;
-    pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
-
-    pipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+    pipelines->reset();
 }
 
 void ContactShadowsPipeline::createIntermediateRenderTargets(VkExtent2D extents)
@@ -183,6 +172,8 @@ void ContactShadowsPipeline::createIntermediateRenderTargets(VkExtent2D extents)
     usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
     VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(contactShadowFormat, usage, {extents.width, extents.height, 1});
+    // Written on the async compute queue, sampled by the deferred resolve on the graphics queue
+    resourceManager.setAsyncComputeSharing(imgInfo);
     contactShadowImage = resourceManager.createResource<Image>(imgInfo);
 
     usage = {};
@@ -192,6 +183,8 @@ void ContactShadowsPipeline::createIntermediateRenderTargets(VkExtent2D extents)
     usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
     imgInfo = vk_helpers::imageCreateInfo(debugFormat, usage, {extents.width, extents.height, 1});
+    // Also written on the async compute queue, the debug view reads it on the graphics queue
+    resourceManager.setAsyncComputeSharing(imgInfo);
     debugImage = resourceManager.createResource<Image>(imgInfo);
 }
 
@@ -201,10 +194,9 @@ void ContactShadowsPipeline::handleResize(const ResolutionChangedEvent& event)
     resourceManager.destroyResource(std::move(debugImage));
 
     createIntermediateRenderTargets(event.newExtent);
-    cachedRenderExtents = {event.newExtent.width, event.newExtent.height};
 }
 
-DispatchList ContactShadowsPipeline::buildDispatchList(const Camera* camera, const DirectionalLight& mainLight) const
+DispatchList ContactShadowsPipeline::buildDispatchList(const Camera* camera, const DirectionalLight& mainLight, const glm::vec2 renderExtents) const
 {
     DispatchList result = {};
 
@@ -219,8 +211,8 @@ DispatchList ContactShadowsPipeline::buildDispatchList(const Camera* camera, con
     else if (xy_light_w < 0 && xy_light_w > -FP_limit) xy_light_w = -FP_limit;
 
     // Need precise XY pixel coordinates of the light
-    result.LightCoordinate_Shader[0] = ((lightProjection[0] / xy_light_w) * +0.5f + 0.5f) * cachedRenderExtents.x;
-    result.LightCoordinate_Shader[1] = ((lightProjection[1] / xy_light_w) * -0.5f + 0.5f) * cachedRenderExtents.y;
+    result.LightCoordinate_Shader[0] = ((lightProjection[0] / xy_light_w) * +0.5f + 0.5f) * renderExtents.x;
+    result.LightCoordinate_Shader[1] = ((lightProjection[1] / xy_light_w) * -0.5f + 0.5f) * renderExtents.y;
     result.LightCoordinate_Shader[2] = lightProjection[3] == 0 ? 0 : (lightProjection[2] / lightProjection[3]);
     result.LightCoordinate_Shader[3] = lightProjection[3] > 0 ? 1 : -1;
 
@@ -232,8 +224,8 @@ DispatchList ContactShadowsPipeline::buildDispatchList(const Camera* camera, con
     const int32_t biased_bounds[4] =
     {
         0 - light_xy[0],
-        -static_cast<int32_t>(cachedRenderExtents.y - light_xy[1]),
-        static_cast<int32_t>(cachedRenderExtents.x - light_xy[0]),
+        -static_cast<int32_t>(renderExtents.y - light_xy[1]),
+        static_cast<int32_t>(renderExtents.x - light_xy[0]),
         -(0 - light_xy[1]),
     };
 
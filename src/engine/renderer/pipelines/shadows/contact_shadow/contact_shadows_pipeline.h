@@ -5,6 +5,8 @@
 #ifndef CONTACT_SHADOWS_H
 #define CONTACT_SHADOWS_H
 
+#include <memory>
+
 #include <vulkan/vulkan_core.h>
 
 #include "contact_shadows_pipeline_types.h"
@@ -22,6 +24,7 @@ struct DirectionalLight;
 namespace will_engine::renderer
 {
 class ResourceManager;
+class ComputePipelinePermutations;
 
 class ContactShadowsPipeline {
 public:
@@ -33,29 +36,19 @@ public:
 
     void draw(VkCommandBuffer cmd, const ContactShadowsDrawInfo& drawInfo);
 
-    void reloadShaders()
-    {
-        createPipeline();
-    }
+    void reloadShaders() const;
 
     VkImageView getContactShadowRenderTarget() const { return contactShadowImage->imageView; }
 
 private:
-    void createPipeline();
-
     void createIntermediateRenderTargets(VkExtent2D extents);
 
     void handleResize(const ResolutionChangedEvent& event);
 
     EventDispatcher<ResolutionChangedEvent>::Handle resolutionChangedHandle;
 
-    /**
-     * Used to calculate dispatch lists
-     */
-    glm::vec2 cachedRenderExtents{DEFAULT_RENDER_EXTENT_2D.width, DEFAULT_RENDER_EXTENT_2D.height};
-
 private:
-    DispatchList buildDispatchList(const Camera* camera, const DirectionalLight& mainLight) const;
+    DispatchList buildDispatchList(const Camera* camera, const DirectionalLight& mainLight, glm::vec2 renderExtents) const;
 
     static int32_t bend_min(const int32_t a, const int32_t b) { return a > b ? b : a; }
     static int32_t bend_max(const int32_t a, const int32_t b) { return a > b ? a : b; }
@@ -63,7 +56,10 @@ private:
 private:
     DescriptorSetLayoutPtr descriptorSetLayout{};
     PipelineLayoutPtr pipelineLayout{};
-    PipelinePtr pipeline{};
+    /**
+     * Permutation 1 writes \code debugImage\endcode, permutation 0 strips it
+     */
+    std::unique_ptr<ComputePipelinePermutations> pipelines{};
 
     SamplerPtr depthSampler{};
 
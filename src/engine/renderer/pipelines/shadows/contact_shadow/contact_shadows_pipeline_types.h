@@ -9,6 +9,7 @@
 #include <volk/volk.h>
 
 #include "engine/core/camera/camera.h"
+#include "engine/renderer/renderer_constants.h"
 #include "engine/renderer/lighting/directional_light.h"
 
 namespace will_engine::renderer
@@ -55,6 +56,10 @@ struct ContactShadowsPushConstants
 
 struct ContactShadowsDrawInfo
 {
+    /**
+     * Region of the depth buffer that was rendered to this frame, the light's screen position is computed against it
+     */
+    VkExtent2D renderExtent{DEFAULT_RENDER_EXTENT_2D};
     Camera* camera;
     DirectionalLight light;
     bool bIsEnabled{true};
@@ -30,6 +30,18 @@ static constexpr float XE_GTAO_STEPS_PER_SLICE_COUNT_ULTRA = 3.0f;
 #define DEFAULT_GTAO_STEPS_PER_SLICE_COUNT XE_GTAO_STEPS_PER_SLICE_COUNT_ULTRA
 #endif
 
+/**
+ * Slice count used by the reduced resolution quality modes, temporal accumulation makes up for the missing slices over a few frames
+ */
+static constexpr float GTAO_REDUCED_RESOLUTION_SLICE_COUNT = XE_GTAO_SLICE_COUNT_MEDIUM;
+
+enum class GTAOResolution : int32_t
+{
+    Full = 1,
+    Half = 2,
+    Quarter = 4,
+};
+
 
 struct GTAOPushConstants
 {
@@ -40,6 +52,12 @@ struct GTAOPushConstants
 
     glm::vec2 ndcToViewMul_x_PixelSize{};
 
+    /**
+     * Converts uvs of the (possibly reduced resolution) AO images to uvs of the full resolution render targets
+     */
+    glm::vec2 aoUvToTextureUv{1.0f};
+    glm::vec2 aoTexelSize{};
+
     float depthLinearizeMult{0.0f};
     float depthLinearizeAdd{0.0f};
 
@@ -58,7 +76,20 @@ struct GTAOPushConstants
     float sliceCount{DEFAULT_GTAO_SLICE_COUNT};
     float stepsPerSliceCount{DEFAULT_GTAO_STEPS_PER_SLICE_COUNT};
 
-    int32_t debug{4};
+    /**
+     * 0 uses the production variants, any other mode switches to the variants that write the debug image
+     */
+    int32_t debug{0};
+
+    /**
+     * Each AO texel covers resolutionDivisor x resolutionDivisor pixels
+     */
+    int32_t resolutionDivisor{1};
+    /**
+     * Weight of the current frame when accumulating AO temporally
+     */
+    float temporalBlend{0.1f};
+    int32_t bHistoryValid{0};
 };
 
 struct GTAODrawInfo
@@ -67,6 +98,7 @@ struct GTAODrawInfo
     Camera* camera{nullptr};
     bool bEnabled{true};
     GTAOPushConstants& push;
+    bool bTemporalAccumulation{false};
     int32_t currentFrame{};
     VkDescriptorBufferBindingInfoEXT sceneDataBinding{};
     VkDeviceSize sceneDataOffset{0};
@@ -75,6 +107,11 @@ struct GTAODrawInfo
 struct GTAOSettings
 {
     bool bEnabled{true};
+    GTAOResolution resolution{GTAOResolution::Full};
+    /**
+     * Accumulates AO over frames with the velocity buffer, required for the reduced resolution modes to stay stable
+     */
+    bool bTemporalAccumulation{false};
     GTAOPushConstants pushConstants{};
 };
 
@@ -15,12 +15,28 @@
 #include "engine/renderer/resources/image_view.h"
 #include "engine/renderer/resources/pipeline.h"
 #include "engine/renderer/resources/pipeline_layout.h"
+#include "engine/renderer/resources/pipeline_permutations.h"
 #include "engine/renderer/resources/shader_module.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_sampler.h"
 #include "engine/renderer/resources/descriptor_buffer/descriptor_buffer_types.h"
 
 namespace will_engine::renderer
 {
+/**
+ * Bit 0 of every GTAO permutation key selects the variant that writes \code debugImage\endcode
+ */
+static constexpr uint32_t GTAO_DEBUG_OUTPUT_PERMUTATION = 1;
+
+/**
+ * The main pass also bakes its quality tier into the key, slice count in bits 8-15 and steps per slice in bits 16-23
+ */
+static uint32_t getAmbientOcclusionPermutation(const GTAOPushConstants& push, const uint32_t debugPermutation)
+{
+    const auto sliceCount = static_cast<uint32_t>(glm::clamp(glm::round(push.sliceCount), 1.0f, 255.0f));
+    const auto stepsPerSlice = static_cast<uint32_t>(glm::clamp(glm::round(push.stepsPerSliceCount), 1.0f, 255.0f));
+    return debugPermutation | sliceCount << 8 | stepsPerSlice << 16;
+}
+
 GroundTruthAmbientOcclusionPipeline::GroundTruthAmbientOcclusionPipeline(ResourceManager& resourceManager, RenderContext& renderContext)
 : resourceManager(resourceManager)
 {
@@ -58,7 +74,11 @@ GroundTruthAmbientOcclusionPipeline::GroundTruthAmbientOcclusionPipeline(Resourc
         layoutInfo.pushConstantRangeCount = 1;
 
         depthPrefilterPipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
-        createDepthPrefilterPipeline();
+        depthPrefilterPipelines = std::make_unique<ComputePipelinePermutations>(
+            resourceManager, "shaders/ambient_occlusion/ground_truth/gtao_depth_prefilter.comp", depthPrefilterPipelineLayout->layout,
+            [](const uint32_t permutation, SpecializationConstants& constants) {
+                constants.add(0, (permutation & GTAO_DEBUG_OUTPUT_PERMUTATION) != 0);
+            });
 
         depthPrefilterDescriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(depthPrefilterSetLayout->layout, 1);
 
@@ -113,7 +133,13 @@ GroundTruthAmbientOcclusionPipeline::GroundTruthAmbientOcclusionPipeline(Resourc
         layoutInfo.pushConstantRangeCount = 1;
 
         ambientOcclusionPipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
-        createAmbientOcclusionPipeline();
+        ambientOcclusionPipelines = std::make_unique<ComputePipelinePermutations>(
+            resourceManager, "shaders/ambient_occlusion/ground_truth/gtao_main_pass.comp", ambientOcclusionPipelineLayout->layout,
+            [](const uint32_t permutation, SpecializationConstants& constants) {
+                constants.add(0, (permutation & GTAO_DEBUG_OUTPUT_PERMUTATION) != 0);
+                constants.add(1, static_cast<float>(permutation >> 8 & 0xFF)); // SLICE_COUNT
+                constants.add(2, static_cast<float>(permutation >> 16 & 0xFF)); // STEPS_PER_SLICE
+            });
 
         ambientOcclusionDescriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(ambientOcclusionSetLayout->layout, 1);
 
@@ -188,9 +214,91 @@ GroundTruthAmbientOcclusionPipeline::GroundTruthAmbientOcclusionPipeline(Resourc
         layoutInfo.pushConstantRangeCount = 1;
 
         spatialFilteringPipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
-        createSpatialFilteringPipeline();
+        spatialFilteringPipelines = std::make_unique<ComputePipelinePermutations>(
+            resourceManager, "shaders/ambient_occlusion/ground_truth/gtao_spatial_filter.comp", spatialFilteringPipelineLayout->layout,
+            [](const uint32_t permutation, SpecializationConstants& constants) {
+                constants.add(0, (permutation & GTAO_DEBUG_OUTPUT_PERMUTATION) != 0);
+            });
+
+        spatialFilteringDescriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(spatialFilteringSetLayout->layout, 2);
+    }
+
+    // Temporal Accumulation
+    {
+        DescriptorLayoutBuilder layoutBuilder{4};
+        layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // denoised ao
+        layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // ao history
+        layoutBuilder.addBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // MRT velocity buffer
+        layoutBuilder.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE); // accumulated ao
+        VkDescriptorSetLayoutCreateInfo layoutCreateInfo = layoutBuilder.build(
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+        );
+
+        temporalAccumulationSetLayout = resourceManager.createResource<DescriptorSetLayout>(layoutCreateInfo);
+
+        VkPushConstantRange pushConstants{};
+        pushConstants.offset = 0;
+        pushConstants.size = sizeof(GTAOPushConstants);
+        pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        std::array setLayouts{
+            resourceManager.getSceneDataLayout(),
+            temporalAccumulationSetLayout->layout,
+        };
+
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = nullptr;
+        layoutInfo.pSetLayouts = setLayouts.data();
+        layoutInfo.setLayoutCount = setLayouts.size();
+        layoutInfo.pPushConstantRanges = &pushConstants;
+        layoutInfo.pushConstantRangeCount = 1;
+
+        temporalAccumulationPipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
+        createTemporalAccumulationPipeline();
+
+        temporalAccumulationDescriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(temporalAccumulationSetLayout->layout, 2);
+    }
+
+    // Bilateral Upsample
+    {
+        DescriptorLayoutBuilder layoutBuilder{4};
+        layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // reduced resolution ao
+        layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // pre-filtered depth
+        layoutBuilder.addBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // MRT depth buffer
+        layoutBuilder.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE); // full resolution ao
+        VkDescriptorSetLayoutCreateInfo layoutCreateInfo = layoutBuilder.build(
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+        );
+
+        upsampleSetLayout = resourceManager.createResource<DescriptorSetLayout>(layoutCreateInfo);
+
+        VkPushConstantRange pushConstants{};
+        pushConstants.offset = 0;
+        pushConstants.size = sizeof(GTAOPushConstants);
+        pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        std::array setLayouts{
+            resourceManager.getSceneDataLayout(),
+            upsampleSetLayout->layout,
+        };
+
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = nullptr;
+        layoutInfo.pSetLayouts = setLayouts.data();
+        layoutInfo.setLayoutCount = setLayouts.size();
+        layoutInfo.pPushConstantRanges = &pushConstants;
+        layoutInfo.pushConstantRangeCount = 1;
+
+        upsamplePipelineLayout = resourceManager.createResource<PipelineLayout>(layoutInfo);
+        createUpsamplePipeline();
 
-        spatialFilteringDescriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(spatialFilteringSetLayout->layout, 1);
+        upsampleDescriptorBuffer = resourceManager.createResource<DescriptorBufferSampler>(upsampleSetLayout->layout, 3);
     }
 
     createIntermediateRenderTargets(renderContext.renderExtent);
@@ -201,46 +309,76 @@ GroundTruthAmbientOcclusionPipeline::GroundTruthAmbientOcclusionPipeline(Resourc
 
 GroundTruthAmbientOcclusionPipeline::~GroundTruthAmbientOcclusionPipeline()
 {
-    // Debug Resources
-    resourceManager.destroyResource(std::move(debugImage));
+    destroyIntermediateRenderTargets();
 
     // Depth Prefilter Resources
     resourceManager.destroyResource(std::move(depthPrefilterSetLayout));
+    depthPrefilterPipelines.reset();
     resourceManager.destroyResource(std::move(depthPrefilterPipelineLayout));
-    resourceManager.destroyResource(std::move(depthPrefilterPipeline));
 
-    for (int32_t i = 0; i < DEPTH_PREFILTER_MIP_COUNT; ++i) {
-        resourceManager.destroyResource(std::move(depthPrefilterImageViews[i]));
-    }
-
-    resourceManager.destroyResource(std::move(depthPrefilterImage));
     resourceManager.destroyResource(std::move(depthSampler));
 
     resourceManager.destroyResource(std::move(depthPrefilterDescriptorBuffer));
 
     // AO Resources
     resourceManager.destroyResource(std::move(ambientOcclusionSetLayout));
+    ambientOcclusionPipelines.reset();
     resourceManager.destroyResource(std::move(ambientOcclusionPipelineLayout));
-    resourceManager.destroyResource(std::move(ambientOcclusionPipeline));
 
     resourceManager.destroyResource(std::move(depthPrefilterSampler));
     resourceManager.destroyResource(std::move(normalsSampler));
-    resourceManager.destroyResource(std::move(ambientOcclusionImage));
-    resourceManager.destroyResource(std::move(edgeDataImage));
 
     resourceManager.destroyResource(std::move(ambientOcclusionDescriptorBuffer));
 
     // Spatial Filtering Resources
     resourceManager.destroyResource(std::move(spatialFilteringSetLayout));
+    spatialFilteringPipelines.reset();
     resourceManager.destroyResource(std::move(spatialFilteringPipelineLayout));
-    resourceManager.destroyResource(std::move(spatialFilteringPipeline));
-
-    resourceManager.destroyResource(std::move(denoisedFinalAOImage));
 
     resourceManager.destroyResource(std::move(spatialFilteringDescriptorBuffer));
+
+    // Temporal Accumulation Resources
+    resourceManager.destroyResource(std::move(temporalAccumulationSetLayout));
+    resourceManager.destroyResource(std::move(temporalAccumulationPipelineLayout));
+    resourceManager.destroyResource(std::move(temporalAccumulationPipeline));
+
+    resourceManager.destroyResource(std::move(temporalAccumulationDescriptorBuffer));
+
+    // Bilateral Upsample Resources
+    resourceManager.destroyResource(std::move(upsampleSetLayout));
+    resourceManager.destroyResource(std::move(upsamplePipelineLayout));
+    resourceManager.destroyResource(std::move(upsamplePipeline));
+
+    resourceManager.destroyResource(std::move(upsampleDescriptorBuffer));
+}
+
+void GroundTruthAmbientOcclusionPipeline::setupDescriptorBuffers(const GTAODescriptor& descriptor)
+{
+    this->descriptor = descriptor;
+    setupDepthPrefilterDescriptorBuffer();
+    setupAmbientOcclusionDescriptorBuffer();
+    setupSpatialFilteringDescriptorBuffer();
+    setupTemporalAccumulationDescriptorBuffer();
+    setupUpsampleDescriptorBuffer();
 }
 
-void GroundTruthAmbientOcclusionPipeline::setupDepthPrefilterDescriptorBuffer(const VkImageView& depthImageView)
+void GroundTruthAmbientOcclusionPipeline::setResolution(const GTAOResolution newResolution)
+{
+    if (resolution == newResolution) {
+        return;
+    }
+
+    resolution = newResolution;
+    destroyReducedResolutionRenderTargets();
+    createReducedResolutionRenderTargets();
+
+    // Not set up yet during initialization
+    if (descriptor.depthImageView != VK_NULL_HANDLE) {
+        setupDescriptorBuffers(descriptor);
+    }
+}
+
+void GroundTruthAmbientOcclusionPipeline::setupDepthPrefilterDescriptorBuffer()
 {
     std::vector<DescriptorImageData> imageDescriptors{};
     imageDescriptors.reserve(1 + DEPTH_PREFILTER_MIP_COUNT + 1);
@@ -248,7 +386,7 @@ void GroundTruthAmbientOcclusionPipeline::setupDepthPrefilterDescriptorBuffer(co
     imageDescriptors.push_back(
         {
             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            {depthSampler->sampler, depthImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+            {depthSampler->sampler, descriptor.depthImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
             false
         }
     );
@@ -271,7 +409,7 @@ void GroundTruthAmbientOcclusionPipeline::setupDepthPrefilterDescriptorBuffer(co
     depthPrefilterDescriptorBuffer->setupData(imageDescriptors, 0);
 }
 
-void GroundTruthAmbientOcclusionPipeline::setupAmbientOcclusionDescriptorBuffer(const VkImageView& normalsImageView)
+void GroundTruthAmbientOcclusionPipeline::setupAmbientOcclusionDescriptorBuffer()
 {
     std::vector<DescriptorImageData> imageDescriptors{};
     imageDescriptors.reserve(4);
@@ -285,7 +423,7 @@ void GroundTruthAmbientOcclusionPipeline::setupAmbientOcclusionDescriptorBuffer(
     imageDescriptors.push_back(
         {
             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            {normalsSampler->sampler, normalsImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+            {normalsSampler->sampler, descriptor.normalsImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
             false
         });
     imageDescriptors.push_back(
@@ -311,33 +449,105 @@ void GroundTruthAmbientOcclusionPipeline::setupAmbientOcclusionDescriptorBuffer(
 
 void GroundTruthAmbientOcclusionPipeline::setupSpatialFilteringDescriptorBuffer()
 {
-    std::vector<DescriptorImageData> imageDescriptors{};
-    imageDescriptors.reserve(5);
+    const std::array outputImages{denoisedFinalAOImage->imageView, denoisedAOImage->imageView};
+    for (int32_t i = 0; i < static_cast<int32_t>(outputImages.size()); ++i) {
+        std::vector<DescriptorImageData> imageDescriptors{};
+        imageDescriptors.reserve(4);
+
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, ambientOcclusionImage->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, edgeDataImage->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back({
+            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            {VK_NULL_HANDLE, outputImages[i], VK_IMAGE_LAYOUT_GENERAL},
+            false
+        });
+        imageDescriptors.push_back({
+            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            {VK_NULL_HANDLE, debugImage->imageView, VK_IMAGE_LAYOUT_GENERAL},
+            false
+        });
 
-    imageDescriptors.push_back(
-        {
-            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            {depthSampler->sampler, ambientOcclusionImage->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        spatialFilteringDescriptorBuffer->setupData(imageDescriptors, i);
+    }
+}
+
+void GroundTruthAmbientOcclusionPipeline::setupTemporalAccumulationDescriptorBuffer()
+{
+    for (int32_t i = 0; i < static_cast<int32_t>(historyImages.size()); ++i) {
+        std::vector<DescriptorImageData> imageDescriptors{};
+        imageDescriptors.reserve(4);
+
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, denoisedAOImage->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {resourceManager.getDefaultSamplerLinear(), historyImages[1 - i]->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, descriptor.velocityImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back({
+            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            {VK_NULL_HANDLE, historyImages[i]->imageView, VK_IMAGE_LAYOUT_GENERAL},
             false
         });
-    imageDescriptors.push_back(
-        {
-            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            {depthSampler->sampler, edgeDataImage->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+
+        temporalAccumulationDescriptorBuffer->setupData(imageDescriptors, i);
+    }
+}
+
+void GroundTruthAmbientOcclusionPipeline::setupUpsampleDescriptorBuffer()
+{
+    const std::array sourceImages{historyImages[0]->imageView, historyImages[1]->imageView, denoisedAOImage->imageView};
+    for (int32_t i = 0; i < static_cast<int32_t>(sourceImages.size()); ++i) {
+        std::vector<DescriptorImageData> imageDescriptors{};
+        imageDescriptors.reserve(4);
+
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, sourceImages[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, depthPrefilterImageViews[0]->imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back(
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                {depthSampler->sampler, descriptor.depthImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                false
+            });
+        imageDescriptors.push_back({
+            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            {VK_NULL_HANDLE, denoisedFinalAOImage->imageView, VK_IMAGE_LAYOUT_GENERAL},
             false
         });
-    imageDescriptors.push_back({
-        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        {VK_NULL_HANDLE, denoisedFinalAOImage->imageView, VK_IMAGE_LAYOUT_GENERAL},
-        false
-    });
-    imageDescriptors.push_back({
-        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        {VK_NULL_HANDLE, debugImage->imageView, VK_IMAGE_LAYOUT_GENERAL},
-        false
-    });
 
-    spatialFilteringDescriptorBuffer->setupData(imageDescriptors, 0);
+        upsampleDescriptorBuffer->setupData(imageDescriptors, i);
+    }
 }
 
 void GroundTruthAmbientOcclusionPipeline::draw(VkCommandBuffer cmd, const GTAODrawInfo& drawInfo)
@@ -359,25 +569,45 @@ void GroundTruthAmbientOcclusionPipeline::draw(VkCommandBuffer cmd, const GTAODr
     drawInfo.push.cameraTanHalfFOV = {tanHalfFOVX, tanHalfFOVY};
     drawInfo.push.ndcToViewMul = {drawInfo.push.cameraTanHalfFOV.x * 2.0f, drawInfo.push.cameraTanHalfFOV.y * -2.0f};
     drawInfo.push.ndcToViewAdd = {drawInfo.push.cameraTanHalfFOV.x * -1.0f, drawInfo.push.cameraTanHalfFOV.y * 1.0f};
-    const glm::vec2 texelSize = {1.0f / drawInfo.renderExtent.width, 1.0f / drawInfo.renderExtent.height};
+
+    const int32_t divisor = static_cast<int32_t>(resolution);
+    // Size of one AO texel on screen
+    const glm::vec2 texelSize = {static_cast<float>(divisor) / drawInfo.renderExtent.width, static_cast<float>(divisor) / drawInfo.renderExtent.height};
     drawInfo.push.ndcToViewMul_x_PixelSize = {drawInfo.push.ndcToViewMul.x * texelSize.x, drawInfo.push.ndcToViewMul.y * texelSize.y};
+    drawInfo.push.aoTexelSize = {1.0f / aoExtent.width, 1.0f / aoExtent.height};
+    drawInfo.push.aoUvToTextureUv = {
+        static_cast<float>(aoExtent.width * divisor) / renderExtent.width,
+        static_cast<float>(aoExtent.height * divisor) / renderExtent.height
+    };
+    drawInfo.push.resolutionDivisor = divisor;
+    drawInfo.push.bHistoryValid = bHistoryValid;
 
     drawInfo.push.noiseIndex = GTAO_DENOISE_PASSES > 0 ? drawInfo.currentFrame % 64 : 0;
 
-    vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    const uint32_t aoWidth = (drawInfo.renderExtent.width + divisor - 1) / divisor;
+    const uint32_t aoHeight = (drawInfo.renderExtent.height + divisor - 1) / divisor;
+    // Full resolution without accumulation is the only mode that filters straight into the final image
+    const bool bFilterToFinalImage = resolution == GTAOResolution::Full && !drawInfo.bTemporalAccumulation;
+
+    // Debug image writes are compiled out unless a debug mode is selected
+    const bool bDebugOutput = drawInfo.push.debug > 0;
+    const uint32_t debugPermutation = bDebugOutput ? GTAO_DEBUG_OUTPUT_PERMUTATION : 0;
+    if (bDebugOutput) {
+        vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
 
     vk_helpers::clearColorImage(cmd, VK_IMAGE_ASPECT_COLOR_BIT, depthPrefilterImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
 
     if (!drawInfo.bEnabled) {
         vk_helpers::clearColorImage(cmd, VK_IMAGE_ASPECT_COLOR_BIT, denoisedFinalAOImage->image, VK_IMAGE_LAYOUT_UNDEFINED,
                                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, {1.0f, 1.0f, 1.0f, 1.0f});
-        vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                 VK_IMAGE_ASPECT_COLOR_BIT);
+        bHistoryValid = false;
+        vkCmdEndDebugUtilsLabelEXT(cmd);
         return;
     }
     // Depth Prefilter
     {
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, depthPrefilterPipeline->pipeline);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, depthPrefilterPipelines->get(debugPermutation));
         vkCmdPushConstants(cmd, depthPrefilterPipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GTAOPushConstants), &drawInfo.push);
 
         VkDescriptorBufferBindingInfoEXT bindingInfos[2] = {};
@@ -392,8 +622,8 @@ void GroundTruthAmbientOcclusionPipeline::draw(VkCommandBuffer cmd, const GTAODr
                                            offsets.data());
 
         // shader only operates on 8,8 work groups, mip 0 will operate on 2x2 texels, so its 16x16 as expected
-        const auto x = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.width / 16.0f));
-        const auto y = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.height / 16.0f));
+        const auto x = static_cast<uint32_t>(std::ceil(aoWidth / 16.0f));
+        const auto y = static_cast<uint32_t>(std::ceil(aoHeight / 16.0f));
         vkCmdDispatch(cmd, x, y, 1);
     }
 
@@ -402,7 +632,8 @@ void GroundTruthAmbientOcclusionPipeline::draw(VkCommandBuffer cmd, const GTAODr
     vk_helpers::imageBarrier(cmd, ambientOcclusionImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
     // Ambient Occlusion
     {
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, ambientOcclusionPipeline->pipeline);
+        const uint32_t permutation = getAmbientOcclusionPermutation(drawInfo.push, debugPermutation);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, ambientOcclusionPipelines->get(permutation));
         vkCmdPushConstants(cmd, ambientOcclusionPipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GTAOPushConstants), &drawInfo.push);
 
         VkDescriptorBufferBindingInfoEXT bindingInfos[2] = {};
@@ -416,19 +647,19 @@ void GroundTruthAmbientOcclusionPipeline::draw(VkCommandBuffer cmd, const GTAODr
         vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, depthPrefilterPipelineLayout->layout, 0, 2, indices.data(),
                                            offsets.data());
 
-        const auto x = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.width / 16.0f));
-        const auto y = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.height / 16.0f));
+        const auto x = static_cast<uint32_t>(std::ceil(aoWidth / 16.0f));
+        const auto y = static_cast<uint32_t>(std::ceil(aoHeight / 16.0f));
         vkCmdDispatch(cmd, x, y, 1);
     }
 
 
+    VkImage spatialFilterTarget = bFilterToFinalImage ? denoisedFinalAOImage->image : denoisedAOImage->image;
     vk_helpers::imageBarrier(cmd, ambientOcclusionImage->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                              VK_IMAGE_ASPECT_COLOR_BIT);
-    vk_helpers::imageBarrier(cmd, denoisedFinalAOImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
-                             VK_IMAGE_ASPECT_COLOR_BIT);
+    vk_helpers::imageBarrier(cmd, spatialFilterTarget, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
     // Spatial Filtering
     {
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, spatialFilteringPipeline->pipeline);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, spatialFilteringPipelines->get(debugPermutation));
         vkCmdPushConstants(cmd, spatialFilteringPipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GTAOPushConstants), &drawInfo.push);
 
         VkDescriptorBufferBindingInfoEXT bindingInfos[2] = {};
@@ -437,60 +668,106 @@ void GroundTruthAmbientOcclusionPipeline::draw(VkCommandBuffer cmd, const GTAODr
         vkCmdBindDescriptorBuffersEXT(cmd, 2, bindingInfos);
 
         constexpr std::array<uint32_t, 2> indices{0, 1};
-        const std::array offsets{drawInfo.sceneDataOffset, ZERO_DEVICE_SIZE};
+        const VkDeviceSize spatialFilteringOffset = spatialFilteringDescriptorBuffer->getDescriptorBufferSize() * (bFilterToFinalImage ? 0 : 1);
+        const std::array offsets{drawInfo.sceneDataOffset, spatialFilteringOffset};
 
         vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, spatialFilteringPipelineLayout->layout, 0, 2, indices.data(),
                                            offsets.data());
 
         // each dispatch operates on 2x1 pixels
-        const auto x = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.width / (16.0f * 2.0f)));
-        const auto y = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.height / 16.0f));
+        const auto x = static_cast<uint32_t>(std::ceil(aoWidth / (16.0f * 2.0f)));
+        const auto y = static_cast<uint32_t>(std::ceil(aoHeight / 16.0f));
         vkCmdDispatch(cmd, x, y, 1);
     }
 
-    vk_helpers::imageBarrier(cmd, denoisedFinalAOImage->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                             VK_IMAGE_ASPECT_COLOR_BIT);
+    vk_helpers::imageBarrier(cmd, spatialFilterTarget, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
 
+    // Temporal Accumulation
+    if (drawInfo.bTemporalAccumulation) {
+        if (!bHistoryValid) {
+            // Not read by the shader, but has to be in the layout the descriptor expects
+            vk_helpers::imageBarrier(cmd, historyImages[1 - historyIndex]->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                     VK_IMAGE_ASPECT_COLOR_BIT);
+        }
+        vk_helpers::imageBarrier(cmd, historyImages[historyIndex]->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                                 VK_IMAGE_ASPECT_COLOR_BIT);
 
-    vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                             VK_IMAGE_ASPECT_COLOR_BIT);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, temporalAccumulationPipeline->pipeline);
+        vkCmdPushConstants(cmd, temporalAccumulationPipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GTAOPushConstants),
+                           &drawInfo.push);
 
-    vkCmdEndDebugUtilsLabelEXT(cmd);
-}
+        VkDescriptorBufferBindingInfoEXT bindingInfos[2] = {};
+        bindingInfos[0] = drawInfo.sceneDataBinding;
+        bindingInfos[1] = temporalAccumulationDescriptorBuffer->getBindingInfo();
+        vkCmdBindDescriptorBuffersEXT(cmd, 2, bindingInfos);
 
-void GroundTruthAmbientOcclusionPipeline::reloadShaders()
-{
-    createDepthPrefilterPipeline();
-    createAmbientOcclusionPipeline();
-    createSpatialFilteringPipeline();
-}
+        constexpr std::array<uint32_t, 2> indices{0, 1};
+        const std::array offsets{drawInfo.sceneDataOffset, temporalAccumulationDescriptorBuffer->getDescriptorBufferSize() * historyIndex};
 
-void GroundTruthAmbientOcclusionPipeline::createDepthPrefilterPipeline()
-{
-    resourceManager.destroyResource(std::move(depthPrefilterPipeline));
-    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/ambient_occlusion/ground_truth/gtao_depth_prefilter.comp");
+        vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, temporalAccumulationPipelineLayout->layout, 0, 2, indices.data(),
+                                           offsets.data());
 
-    VkPipelineShaderStageCreateInfo stageInfo{};
-    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stageInfo.pNext = nullptr;
-    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    stageInfo.module = shader->shader;
-    stageInfo.pName = "main";
+        const auto x = static_cast<uint32_t>(std::ceil(aoWidth / 16.0f));
+        const auto y = static_cast<uint32_t>(std::ceil(aoHeight / 16.0f));
+        vkCmdDispatch(cmd, x, y, 1);
 
-    VkComputePipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    pipelineInfo.pNext = nullptr;
-    pipelineInfo.layout = depthPrefilterPipelineLayout->layout;
-    pipelineInfo.stage = stageInfo;
-    pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        vk_helpers::imageBarrier(cmd, historyImages[historyIndex]->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    // Bilateral Upsample
+    if (!bFilterToFinalImage) {
+        vk_helpers::imageBarrier(cmd, denoisedFinalAOImage->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT);
 
-    depthPrefilterPipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, upsamplePipeline->pipeline);
+        vkCmdPushConstants(cmd, upsamplePipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GTAOPushConstants), &drawInfo.push);
+
+        VkDescriptorBufferBindingInfoEXT bindingInfos[2] = {};
+        bindingInfos[0] = drawInfo.sceneDataBinding;
+        bindingInfos[1] = upsampleDescriptorBuffer->getBindingInfo();
+        vkCmdBindDescriptorBuffersEXT(cmd, 2, bindingInfos);
+
+        constexpr std::array<uint32_t, 2> indices{0, 1};
+        const int32_t sourceIndex = drawInfo.bTemporalAccumulation ? historyIndex : 2;
+        const std::array offsets{drawInfo.sceneDataOffset, upsampleDescriptorBuffer->getDescriptorBufferSize() * sourceIndex};
+
+        vkCmdSetDescriptorBufferOffsetsEXT(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, upsamplePipelineLayout->layout, 0, 2, indices.data(),
+                                           offsets.data());
+
+        const auto x = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.width / 16.0f));
+        const auto y = static_cast<uint32_t>(std::ceil(drawInfo.renderExtent.height / 16.0f));
+        vkCmdDispatch(cmd, x, y, 1);
+
+        vk_helpers::imageBarrier(cmd, denoisedFinalAOImage->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    if (drawInfo.bTemporalAccumulation) {
+        historyIndex = 1 - historyIndex;
+    }
+    bHistoryValid = drawInfo.bTemporalAccumulation;
+
+    if (bDebugOutput) {
+        vk_helpers::imageBarrier(cmd, debugImage->image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    vkCmdEndDebugUtilsLabelEXT(cmd);
 }
 
-void GroundTruthAmbientOcclusionPipeline::createAmbientOcclusionPipeline()
+void GroundTruthAmbientOcclusionPipeline::reloadShaders()
 {
-    resourceManager.destroyResource(std::move(ambientOcclusionPipeline));
-    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/ambient_occlusion/ground_truth/gtao_main_pass.comp");
+    depthPrefilterPipelines->reset();
+    ambientOcclusionPipelines->reset();
+    spatialFilteringPipelines->reset();
+    createTemporalAccumulationPipeline();
+    createUpsamplePipeline();
+}
+
+void GroundTruthAmbientOcclusionPipeline::createTemporalAccumulationPipeline()
+{
+    resourceManager.destroyResource(std::move(temporalAccumulationPipeline));
+    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/ambient_occlusion/ground_truth/gtao_temporal_accumulation.comp");
 
     VkPipelineShaderStageCreateInfo stageInfo{};
     stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -502,17 +779,17 @@ void GroundTruthAmbientOcclusionPipeline::createAmbientOcclusionPipeline()
     VkComputePipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipelineInfo.pNext = nullptr;
-    pipelineInfo.layout = ambientOcclusionPipelineLayout->layout;
+    pipelineInfo.layout = temporalAccumulationPipelineLayout->layout;
     pipelineInfo.stage = stageInfo;
     pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
 
-    ambientOcclusionPipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+    temporalAccumulationPipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
 }
 
-void GroundTruthAmbientOcclusionPipeline::createSpatialFilteringPipeline()
+void GroundTruthAmbientOcclusionPipeline::createUpsamplePipeline()
 {
-    resourceManager.destroyResource(std::move(spatialFilteringPipeline));
-    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/ambient_occlusion/ground_truth/gtao_spatial_filter.comp");
+    resourceManager.destroyResource(std::move(upsamplePipeline));
+    ShaderModulePtr shader = resourceManager.createResource<ShaderModule>("shaders/ambient_occlusion/ground_truth/gtao_upsample.comp");
 
     VkPipelineShaderStageCreateInfo stageInfo{};
     stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -524,15 +801,17 @@ void GroundTruthAmbientOcclusionPipeline::createSpatialFilteringPipeline()
     VkComputePipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipelineInfo.pNext = nullptr;
-    pipelineInfo.layout = spatialFilteringPipelineLayout->layout;
+    pipelineInfo.layout = upsamplePipelineLayout->layout;
     pipelineInfo.stage = stageInfo;
     pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
 
-    spatialFilteringPipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+    upsamplePipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
 }
 
 void GroundTruthAmbientOcclusionPipeline::createIntermediateRenderTargets(VkExtent2D extents)
 {
+    renderExtent = extents;
+
     // Debug
     {
         VkImageUsageFlags usage{};
@@ -542,9 +821,33 @@ void GroundTruthAmbientOcclusionPipeline::createIntermediateRenderTargets(VkExte
         usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
         VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(debugFormat, usage, {extents.width, extents.height, 1});
+        // Also written on the async compute queue, the debug view reads it on the graphics queue
+        resourceManager.setAsyncComputeSharing(imgInfo);
         debugImage = resourceManager.createResource<Image>(imgInfo);
     }
 
+    // Final AO
+    {
+        VkImageUsageFlags usage{};
+        usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(ambientOcclusionFormat, usage, {extents.width, extents.height, 1});
+        // Written on the async compute queue, sampled by the deferred resolve on the graphics queue
+        resourceManager.setAsyncComputeSharing(imgInfo);
+        denoisedFinalAOImage = resourceManager.createResource<Image>(imgInfo);
+    }
+
+    createReducedResolutionRenderTargets();
+}
+
+void GroundTruthAmbientOcclusionPipeline::createReducedResolutionRenderTargets()
+{
+    const auto divisor = static_cast<uint32_t>(resolution);
+    aoExtent = {(renderExtent.width + divisor - 1) / divisor, (renderExtent.height + divisor - 1) / divisor};
+    bHistoryValid = false;
+
     // Depth pre-filter
     {
         VkImageUsageFlags usage{};
@@ -552,7 +855,7 @@ void GroundTruthAmbientOcclusionPipeline::createIntermediateRenderTargets(VkExte
         usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
         usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(depthPrefilterFormat, usage, {extents.width, extents.height, 1});
+        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(depthPrefilterFormat, usage, {aoExtent.width, aoExtent.height, 1});
         // 5 mips, suggested by Intel's implementation
         // https://github.com/GameTechDev/XeGTAO
         imgInfo.mipLevels = DEPTH_PREFILTER_MIP_COUNT;
@@ -571,33 +874,42 @@ void GroundTruthAmbientOcclusionPipeline::createIntermediateRenderTargets(VkExte
         usage |= VK_IMAGE_USAGE_STORAGE_BIT;
         usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
 
-        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(ambientOcclusionFormat, usage, {extents.width, extents.height, 1});
+        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(ambientOcclusionFormat, usage, {aoExtent.width, aoExtent.height, 1});
         ambientOcclusionImage = resourceManager.createResource<Image>(imgInfo);
 
         usage = {};
         usage |= VK_IMAGE_USAGE_STORAGE_BIT;
         usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
 
-        imgInfo = vk_helpers::imageCreateInfo(edgeDataFormat, usage, {extents.width, extents.height, 1});
+        imgInfo = vk_helpers::imageCreateInfo(edgeDataFormat, usage, {aoExtent.width, aoExtent.height, 1});
         edgeDataImage = resourceManager.createResource<Image>(imgInfo);
     }
 
-    // Spatial Filtering
+    // Spatial Filtering and Temporal Accumulation
     {
         VkImageUsageFlags usage{};
         usage |= VK_IMAGE_USAGE_STORAGE_BIT;
         usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
-        usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(ambientOcclusionFormat, usage, {extents.width, extents.height, 1});
-        denoisedFinalAOImage = resourceManager.createResource<Image>(imgInfo);
+        VkImageCreateInfo imgInfo = vk_helpers::imageCreateInfo(ambientOcclusionFormat, usage, {aoExtent.width, aoExtent.height, 1});
+        // History outlives a switch between the graphics and async compute queue, the denoised AO is read on the graphics queue
+        resourceManager.setAsyncComputeSharing(imgInfo);
+        denoisedAOImage = resourceManager.createResource<Image>(imgInfo);
+        for (ImageResourcePtr& historyImage : historyImages) {
+            historyImage = resourceManager.createResource<Image>(imgInfo);
+        }
     }
 }
 
-void GroundTruthAmbientOcclusionPipeline::handleResize(const ResolutionChangedEvent& event)
+void GroundTruthAmbientOcclusionPipeline::destroyIntermediateRenderTargets()
 {
     resourceManager.destroyResource(std::move(debugImage));
+    resourceManager.destroyResource(std::move(denoisedFinalAOImage));
+    destroyReducedResolutionRenderTargets();
+}
 
+void GroundTruthAmbientOcclusionPipeline::destroyReducedResolutionRenderTargets()
+{
     for (int32_t i = 0; i < DEPTH_PREFILTER_MIP_COUNT; ++i) {
         resourceManager.destroyResource(std::move(depthPrefilterImageViews[i]));
     }
@@ -605,8 +917,15 @@ void GroundTruthAmbientOcclusionPipeline::handleResize(const ResolutionChangedEv
     resourceManager.destroyResource(std::move(depthPrefilterImage));
     resourceManager.destroyResource(std::move(ambientOcclusionImage));
     resourceManager.destroyResource(std::move(edgeDataImage));
-    resourceManager.destroyResource(std::move(denoisedFinalAOImage));
+    resourceManager.destroyResource(std::move(denoisedAOImage));
+    for (ImageResourcePtr& historyImage : historyImages) {
+        resourceManager.destroyResource(std::move(historyImage));
+    }
+}
 
+void GroundTruthAmbientOcclusionPipeline::handleResize(const ResolutionChangedEvent& event)
+{
+    destroyIntermediateRenderTargets();
     createIntermediateRenderTargets(event.newExtent);
 }
 }
@@ -6,6 +6,7 @@
 #define GROUND_TRUTH_AMBIENT_OCCLUSION_H
 
 #include <array>
+#include <memory>
 
 #include "ambient_occlusion_types.h"
 #include "engine/renderer/render_context.h"
@@ -16,7 +17,19 @@
 namespace will_engine::renderer
 {
 class ResourceManager;
+class ComputePipelinePermutations;
 
+struct GTAODescriptor
+{
+    VkImageView depthImageView{VK_NULL_HANDLE};
+    VkImageView normalsImageView{VK_NULL_HANDLE};
+    VkImageView velocityImageView{VK_NULL_HANDLE};
+};
+
+/**
+ * XeGTAO. At reduced resolutions every pass up to the spatial filter runs on the smaller AO images, the result is
+ * optionally accumulated temporally and then upsampled to \code renderExtent\endcode with a depth aware bilateral filter.
+ */
 class GroundTruthAmbientOcclusionPipeline
 {
 public:
@@ -24,11 +37,12 @@ public:
 
     ~GroundTruthAmbientOcclusionPipeline();
 
-    void setupDepthPrefilterDescriptorBuffer(const VkImageView& depthImageView);
-
-    void setupAmbientOcclusionDescriptorBuffer(const VkImageView& normalsImageView);
+    void setupDescriptorBuffers(const GTAODescriptor& descriptor);
 
-    void setupSpatialFilteringDescriptorBuffer();
+    /**
+     * Reallocates the reduced resolution images and rewrites the descriptor buffers, the GPU must not be using this pipeline.
+     */
+    void setResolution(GTAOResolution newResolution);
 
     void draw(VkCommandBuffer cmd, const GTAODrawInfo& drawInfo);
 
@@ -37,22 +51,47 @@ public:
     VkImageView getAmbientOcclusionRenderTarget() const { return denoisedFinalAOImage->imageView; }
 
 private:
-    void createDepthPrefilterPipeline();
+    void setupDepthPrefilterDescriptorBuffer();
+
+    void setupAmbientOcclusionDescriptorBuffer();
+
+    void setupSpatialFilteringDescriptorBuffer();
 
-    void createAmbientOcclusionPipeline();
+    void setupTemporalAccumulationDescriptorBuffer();
 
-    void createSpatialFilteringPipeline();
+    void setupUpsampleDescriptorBuffer();
+
+    void createTemporalAccumulationPipeline();
+
+    void createUpsamplePipeline();
 
     void createIntermediateRenderTargets(VkExtent2D extents);
 
+    /**
+     * Images sized by \code resolution\endcode, recreated when it changes
+     */
+    void createReducedResolutionRenderTargets();
+
+    void destroyIntermediateRenderTargets();
+
+    void destroyReducedResolutionRenderTargets();
+
     void handleResize(const ResolutionChangedEvent& event);
 
     EventDispatcher<ResolutionChangedEvent>::Handle resolutionChangedHandle;
 
+    GTAODescriptor descriptor{};
+    GTAOResolution resolution{GTAOResolution::Full};
+    VkExtent2D renderExtent{};
+    /**
+     * Allocated size of the images the AO is computed at
+     */
+    VkExtent2D aoExtent{};
+
 private: // Depth Pre-filter
     DescriptorSetLayoutPtr depthPrefilterSetLayout{};
     PipelineLayoutPtr depthPrefilterPipelineLayout{};
-    PipelinePtr depthPrefilterPipeline{};
+    std::unique_ptr<ComputePipelinePermutations> depthPrefilterPipelines{};
 
     SamplerPtr depthSampler{};
 
@@ -66,7 +105,7 @@ private: // Depth Pre-filter
 private: // Ambient Occlusion
     DescriptorSetLayoutPtr ambientOcclusionSetLayout{};
     PipelineLayoutPtr ambientOcclusionPipelineLayout{};
-    PipelinePtr ambientOcclusionPipeline{};
+    std::unique_ptr<ComputePipelinePermutations> ambientOcclusionPipelines{};
 
     SamplerPtr depthPrefilterSampler{};
     SamplerPtr normalsSampler{};
@@ -83,12 +122,49 @@ private: // Ambient Occlusion
 private: // Spatial Filtering
     DescriptorSetLayoutPtr spatialFilteringSetLayout{};
     PipelineLayoutPtr spatialFilteringPipelineLayout{};
-    PipelinePtr spatialFilteringPipeline{};
+    std::unique_ptr<ComputePipelinePermutations> spatialFilteringPipelines{};
 
+    /**
+     * Full resolution result, always sampled by the deferred resolve
+     */
     ImageResourcePtr denoisedFinalAOImage{};
-
+    /**
+     * Spatial filter output when it is accumulated or upsampled afterward
+     */
+    ImageResourcePtr denoisedAOImage{};
+
+    /**
+     * 0 writes directly to the final image, 1 writes to \code denoisedAOImage\endcode
+     */
     DescriptorBufferSamplerPtr spatialFilteringDescriptorBuffer;
 
+private: // Temporal Accumulation
+    DescriptorSetLayoutPtr temporalAccumulationSetLayout{};
+    PipelineLayoutPtr temporalAccumulationPipelineLayout{};
+    PipelinePtr temporalAccumulationPipeline{};
+
+    /**
+     * Ping-ponged, the history written one frame is read the next
+     */
+    std::array<ImageResourcePtr, 2> historyImages{};
+    int32_t historyIndex{0};
+    bool bHistoryValid{false};
+
+    /**
+     * Index i writes to \code historyImages[i]\endcode
+     */
+    DescriptorBufferSamplerPtr temporalAccumulationDescriptorBuffer;
+
+private: // Bilateral Upsample
+    DescriptorSetLayoutPtr upsampleSetLayout{};
+    PipelineLayoutPtr upsamplePipelineLayout{};
+    PipelinePtr upsamplePipeline{};
+
+    /**
+     * Index i upsamples \code historyImages[i]\endcode, index 2 upsamples \code denoisedAOImage\endcode
+     */
+    DescriptorBufferSamplerPtr upsampleDescriptorBuffer;
+
 private: // Debug
     VkFormat debugFormat{VK_FORMAT_R8G8B8A8_UNORM};
     ImageResourcePtr debugImage{};
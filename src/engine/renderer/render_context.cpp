@@ -21,6 +21,15 @@ RenderContext::RenderContext(const VkExtent2D windowExtent, float renderScale)
     applyPendingChanges();
 }
 
+void RenderContext::setViewportScale(const float scale)
+{
+    viewportScale = glm::clamp(scale, 0.1f, 1.0f);
+    viewportExtent = {
+        glm::max(static_cast<uint32_t>(renderExtent.width * viewportScale), 1u),
+        glm::max(static_cast<uint32_t>(renderExtent.height * viewportScale), 1u)
+    };
+}
+
 bool RenderContext::hasPendingChanges() const
 {
     return pending.hasPendingChanges();
@@ -49,6 +58,8 @@ bool RenderContext::applyPendingChanges()
         static_cast<uint32_t>(windowExtent.height * renderScale)
     };
 
+    setViewportScale(viewportScale);
+
     pending.clear();
 
 
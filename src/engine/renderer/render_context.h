@@ -53,10 +53,16 @@ public:
 public:
     VkExtent2D windowExtent{1920, 1080};
     VkExtent2D renderExtent{1920, 1080};
+    /**
+     * Region of the render targets rendered to this frame. Render targets are allocated at `renderExtent`,
+     * dynamic resolution renders to a smaller region without reallocating them.
+     */
+    VkExtent2D viewportExtent{1920, 1080};
 
     PendingChanges pending{};
 
     float renderScale = 1.0f;
+    float viewportScale = 1.0f;
     /**
      * So we don't have to check if > 0 in advance frame
      */
@@ -77,6 +83,11 @@ public:
         pending.renderScaleChangePending = true;
     }
 
+    /**
+     * Unlike the render scale, takes effect immediately and does not recreate render targets.
+     */
+    void setViewportScale(float scale);
+
     bool hasPendingChanges() const;
 
     bool applyPendingChanges();
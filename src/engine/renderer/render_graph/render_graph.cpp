@@ -0,0 +1,909 @@
+//
+// Created by William on 2025-07-06.
+//
+
+#include "render_graph.h"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <volk/volk.h>
+
+#include "engine/core/profiler/trace_profiler.h"
+#include "engine/renderer/gpu_profiler.h"
+#include "engine/renderer/resource_manager.h"
+#include "engine/renderer/vk_helpers.h"
+#include "engine/renderer/vulkan_context.h"
+#include "engine/renderer/resources/memory_allocation.h"
+#include "engine/renderer/resources/render_target.h"
+
+namespace will_engine::renderer
+{
+/**
+ * Marks barriers of persistent imported images, the old layout is read from the image when recording
+ */
+static constexpr VkImageLayout CURRENT_IMAGE_LAYOUT = VK_IMAGE_LAYOUT_MAX_ENUM;
+
+static constexpr VkAccessFlags2 WRITE_ACCESS_MASK = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+                                                    | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                                    | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+                                                    | VK_ACCESS_2_SHADER_WRITE_BIT
+                                                    | VK_ACCESS_2_TRANSFER_WRITE_BIT
+                                                    | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+/**
+ * Stages a barrier recorded on the compute queue may use
+ */
+static constexpr VkPipelineStageFlags2 COMPUTE_QUEUE_STAGE_MASK = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+                                                                  | VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT
+                                                                  | VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+static RenderGraphAccessInfo getAccessInfo(const RenderGraphAccess access)
+{
+    switch (access) {
+        case RenderGraphAccess::ColorAttachment:
+            return {
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true, true
+            };
+        case RenderGraphAccess::DepthStencilAttachment:
+            return {
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true, true
+            };
+        case RenderGraphAccess::DepthStencilAttachmentRead:
+            return {
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true, false
+            };
+        case RenderGraphAccess::SampledFragment:
+            return {
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false
+            };
+        case RenderGraphAccess::SampledCompute:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false
+            };
+        case RenderGraphAccess::StorageReadCompute:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, true, false
+            };
+        case RenderGraphAccess::StorageWriteCompute:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, false, true
+            };
+        case RenderGraphAccess::StorageReadWriteCompute:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, true, true
+            };
+        case RenderGraphAccess::TransferSrc:
+            return {
+                VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, true, false
+            };
+        case RenderGraphAccess::TransferDst:
+            return {
+                VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, false, true
+            };
+    }
+    return {};
+}
+
+static VkImageMemoryBarrier2 createBarrier(const VkPipelineStageFlags2 srcStages, const VkAccessFlags2 srcAccess, const VkPipelineStageFlags2 dstStages,
+                                           const VkAccessFlags2 dstAccess, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+                                           const VkImageAspectFlags aspect)
+{
+    VkImageMemoryBarrier2 barrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    barrier.srcStageMask = srcStages;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStages;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange = {
+        .aspectMask = aspect,
+        .baseMipLevel = 0,
+        .levelCount = VK_REMAINING_MIP_LEVELS,
+        .baseArrayLayer = 0,
+        .layerCount = VK_REMAINING_ARRAY_LAYERS,
+    };
+    return barrier;
+}
+
+static void sanitizeComputeQueueBarrier(VkImageMemoryBarrier2& barrier)
+{
+    // Earlier graphics work is ordered by the semaphore the compute submission waits on, which also makes its writes visible
+    if ((barrier.srcStageMask & ~COMPUTE_QUEUE_STAGE_MASK) != 0) {
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+    }
+}
+
+RenderGraphPass::RenderGraphPass(std::string name, std::function<void(VkCommandBuffer)>&& execute)
+    : name(std::move(name)), execute(std::move(execute))
+{}
+
+RenderGraphPass& RenderGraphPass::use(const RenderGraphImageHandle image, const RenderGraphAccess access)
+{
+    uses.push_back({image, access});
+    return *this;
+}
+
+RenderGraphPass& RenderGraphPass::setSideEffects()
+{
+    bSideEffects = true;
+    return *this;
+}
+
+RenderGraphPass& RenderGraphPass::setAsyncCompute()
+{
+    bAsyncCompute = true;
+    return *this;
+}
+
+RenderGraphPass& RenderGraphPass::dependsOn(const std::string& passName)
+{
+    dependencyNames.push_back(passName);
+    return *this;
+}
+
+RenderGraph::RenderGraph(ResourceManager& resourceManager) : resourceManager(resourceManager)
+{}
+
+RenderGraph::~RenderGraph()
+{
+    // The graph is only destroyed while the device is idle
+    for (QueueData& queue : queues) {
+        for (const VkCommandPool pool : queue.commandPools) {
+            if (pool != VK_NULL_HANDLE) {
+                vkDestroyCommandPool(resourceManager.getDevice(), pool, nullptr);
+            }
+        }
+        if (queue.timeline != VK_NULL_HANDLE) {
+            vkDestroySemaphore(resourceManager.getDevice(), queue.timeline, nullptr);
+        }
+    }
+
+    for (GraphImage& image : images) {
+        resourceManager.destroyResource(std::move(image.transientImage));
+    }
+    for (MemoryBlock& block : memoryBlocks) {
+        resourceManager.destroyResource(std::move(block.allocation));
+    }
+}
+
+void RenderGraph::enableAsyncCompute(const VulkanContext& context)
+{
+    if (bCompiled) {
+        fmt::print("Warning: Async compute has to be enabled before the render graph is compiled\n");
+        return;
+    }
+    if (!context.hasAsyncComputeQueue() || bAsyncComputeEnabled) {
+        return;
+    }
+
+    queues[static_cast<size_t>(RenderGraphQueue::Graphics)].queue = context.graphicsQueue;
+    queues[static_cast<size_t>(RenderGraphQueue::Graphics)].family = context.graphicsQueueFamily;
+    queues[static_cast<size_t>(RenderGraphQueue::AsyncCompute)].queue = context.computeQueue;
+    queues[static_cast<size_t>(RenderGraphQueue::AsyncCompute)].family = context.computeQueueFamily;
+
+    for (QueueData& queue : queues) {
+        VkSemaphoreTypeCreateInfo typeInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+        VkSemaphoreCreateInfo semaphoreInfo = vk_helpers::semaphoreCreateInfo();
+        semaphoreInfo.pNext = &typeInfo;
+        VK_CHECK(vkCreateSemaphore(resourceManager.getDevice(), &semaphoreInfo, nullptr, &queue.timeline));
+    }
+
+    bAsyncComputeEnabled = true;
+}
+
+RenderGraphImageHandle RenderGraph::createImage(const std::string& name, const RenderGraphImageDescription& description)
+{
+    GraphImage& image = images.emplace_back();
+    image.name = name;
+    image.description = description;
+    image.aspect = description.aspect;
+    image.bTransient = true;
+    return static_cast<RenderGraphImageHandle>(images.size() - 1);
+}
+
+RenderGraphImageHandle RenderGraph::importImage(const std::string& name, ImageResource* image, const VkImageAspectFlags aspect)
+{
+    GraphImage& graphImage = images.emplace_back();
+    graphImage.name = name;
+    graphImage.aspect = aspect;
+    graphImage.importedImage = image;
+    return static_cast<RenderGraphImageHandle>(images.size() - 1);
+}
+
+RenderGraphImageHandle RenderGraph::importImage(const std::string& name, const VkImageAspectFlags aspect, const VkImageLayout finalLayout)
+{
+    GraphImage& graphImage = images.emplace_back();
+    graphImage.name = name;
+    graphImage.aspect = aspect;
+    graphImage.finalLayout = finalLayout;
+    return static_cast<RenderGraphImageHandle>(images.size() - 1);
+}
+
+void RenderGraph::markOutput(const RenderGraphImageHandle image)
+{
+    images[image].bOutput = true;
+}
+
+RenderGraphPass& RenderGraph::addPass(const std::string& name, std::function<void(VkCommandBuffer)>&& execute)
+{
+    return passes.emplace_back(name, std::move(execute));
+}
+
+bool RenderGraph::compile(const bool bAliasTransientImages)
+{
+    if (bCompiled) {
+        fmt::print("Warning: Render graph has already been compiled\n");
+        return false;
+    }
+
+    for (const RenderGraphPass& pass : passes) {
+        for (const RenderGraphImageUse& use : pass.uses) {
+            if (use.image >= images.size()) {
+                fmt::print("Warning: Render graph pass {} uses an image that doesn't exist\n", pass.name);
+                return false;
+            }
+        }
+    }
+
+    if (!resolveDependencies()) {
+        return false;
+    }
+
+    cullPasses();
+    assignQueues();
+    computeLifetimes();
+    if (!allocateTransientImages(bAliasTransientImages)) {
+        return false;
+    }
+    buildBarriers();
+    buildSegments();
+    createCommandBuffers();
+
+    bCompiled = true;
+    return true;
+}
+
+bool RenderGraph::resolveDependencies()
+{
+    for (int32_t passIndex = 0; passIndex < static_cast<int32_t>(passes.size()); ++passIndex) {
+        RenderGraphPass& pass = passes[passIndex];
+        for (const std::string& dependencyName : pass.dependencyNames) {
+            const auto it = std::find_if(passes.begin(), passes.begin() + passIndex, [&dependencyName](const RenderGraphPass& other) {
+                return other.name == dependencyName;
+            });
+            if (it == passes.begin() + passIndex) {
+                fmt::print("Warning: Render graph pass {} depends on {}, which isn't added before it\n", pass.name, dependencyName);
+                return false;
+            }
+            pass.dependencies.push_back(static_cast<int32_t>(it - passes.begin()));
+        }
+    }
+    return true;
+}
+
+void RenderGraph::cullPasses()
+{
+    // Walk backwards from the outputs. A pass survives if something later still needs what it writes.
+    std::vector<bool> bNeeded(images.size(), false);
+    for (size_t i = 0; i < images.size(); ++i) {
+        bNeeded[i] = images[i].bOutput;
+    }
+
+    statistics.passCount = static_cast<uint32_t>(passes.size());
+    statistics.culledPassCount = 0;
+    for (auto it = passes.rbegin(); it != passes.rend(); ++it) {
+        RenderGraphPass& pass = *it;
+        bool bAlive = pass.bSideEffects;
+        for (const RenderGraphImageUse& use : pass.uses) {
+            if (getAccessInfo(use.access).bWrite && bNeeded[use.image]) {
+                bAlive = true;
+            }
+        }
+
+        pass.bCulled = !bAlive;
+        if (!bAlive) {
+            statistics.culledPassCount++;
+            continue;
+        }
+
+        // Fully overwritten images don't need anything written before this pass
+        for (const RenderGraphImageUse& use : pass.uses) {
+            const RenderGraphAccessInfo info = getAccessInfo(use.access);
+            if (info.bWrite && !info.bRead) {
+                bNeeded[use.image] = false;
+            }
+        }
+        for (const RenderGraphImageUse& use : pass.uses) {
+            if (getAccessInfo(use.access).bRead) {
+                bNeeded[use.image] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::assignQueues()
+{
+    statistics.asyncComputePassCount = 0;
+    for (RenderGraphPass& pass : passes) {
+        pass.queue = RenderGraphQueue::Graphics;
+        if (pass.bCulled || !pass.bAsyncCompute || !bAsyncComputeEnabled) { continue; }
+
+        bool bSupported = true;
+        for (const RenderGraphImageUse& use : pass.uses) {
+            const GraphImage& image = images[use.image];
+            // Imported images are used across frames and by code outside the graph, which all expects them on the graphics queue
+            if (!image.bTransient) {
+                fmt::print("Warning: Render graph pass {} uses imported image {} and runs on the graphics queue\n", pass.name, image.name);
+                bSupported = false;
+            }
+            if ((getAccessInfo(use.access).stageMask & ~COMPUTE_QUEUE_STAGE_MASK) != 0) {
+                fmt::print("Warning: Render graph pass {} uses {} outside of compute and runs on the graphics queue\n", pass.name, image.name);
+                bSupported = false;
+            }
+        }
+        if (!bSupported) { continue; }
+
+        pass.queue = RenderGraphQueue::AsyncCompute;
+        for (const RenderGraphImageUse& use : pass.uses) {
+            images[use.image].bAsyncComputeUse = true;
+        }
+        statistics.asyncComputePassCount++;
+    }
+}
+
+void RenderGraph::computeLifetimes()
+{
+    for (int32_t passIndex = 0; passIndex < static_cast<int32_t>(passes.size()); ++passIndex) {
+        const RenderGraphPass& pass = passes[passIndex];
+        if (pass.bCulled) { continue; }
+
+        for (const RenderGraphImageUse& use : pass.uses) {
+            GraphImage& image = images[use.image];
+            if (image.firstPass < 0) {
+                image.firstPass = passIndex;
+                if (image.bTransient && !getAccessInfo(use.access).bWrite) {
+                    fmt::print("Warning: Render graph image {} is read by {} before it is written\n", image.name, pass.name);
+                }
+            }
+            image.lastPass = passIndex;
+        }
+    }
+}
+
+bool RenderGraph::allocateTransientImages(const bool bAliasTransientImages)
+{
+    std::vector<RenderGraphImageHandle> transientImages;
+    for (RenderGraphImageHandle i = 0; i < images.size(); ++i) {
+        GraphImage& image = images[i];
+        if (!image.bTransient || image.firstPass < 0) { continue; }
+
+        const VkImageCreateInfo createInfo = vk_helpers::imageCreateInfo(image.description.format, image.description.usage, image.description.extent);
+        const VkDeviceImageMemoryRequirements requirementsInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+            .pNext = nullptr,
+            .pCreateInfo = &createInfo,
+        };
+        VkMemoryRequirements2 requirements{.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+        vkGetDeviceImageMemoryRequirements(resourceManager.getDevice(), &requirementsInfo, &requirements);
+        image.memoryRequirements = requirements.memoryRequirements;
+
+        transientImages.push_back(i);
+    }
+
+    // Largest first, so smaller images fill in the blocks the large ones created
+    std::ranges::sort(transientImages, [this](const RenderGraphImageHandle a, const RenderGraphImageHandle b) {
+        return images[a].memoryRequirements.size > images[b].memoryRequirements.size;
+    });
+
+    statistics.transientImageCount = static_cast<uint32_t>(transientImages.size());
+    statistics.transientImageMemory = 0;
+    for (const RenderGraphImageHandle handle : transientImages) {
+        GraphImage& image = images[handle];
+        statistics.transientImageMemory += image.memoryRequirements.size;
+
+        // Aliasing barriers between queues would need their own semaphores
+        int32_t blockIndex = -1;
+        if (bAliasTransientImages && !image.bAsyncComputeUse) {
+            for (int32_t i = 0; i < static_cast<int32_t>(memoryBlocks.size()); ++i) {
+                const MemoryBlock& block = memoryBlocks[i];
+                if ((block.requirements.memoryTypeBits & image.memoryRequirements.memoryTypeBits) == 0) { continue; }
+
+                const bool bOverlaps = std::ranges::any_of(block.images, [this, &image](const RenderGraphImageHandle other) {
+                    return images[other].bAsyncComputeUse || (image.firstPass <= images[other].lastPass && images[other].firstPass <= image.lastPass);
+                });
+                if (!bOverlaps) {
+                    blockIndex = i;
+                    break;
+                }
+            }
+        }
+
+        if (blockIndex < 0) {
+            memoryBlocks.emplace_back().requirements = image.memoryRequirements;
+            blockIndex = static_cast<int32_t>(memoryBlocks.size() - 1);
+        }
+
+        MemoryBlock& block = memoryBlocks[blockIndex];
+        block.requirements.size = std::max(block.requirements.size, image.memoryRequirements.size);
+        block.requirements.alignment = std::max(block.requirements.alignment, image.memoryRequirements.alignment);
+        block.requirements.memoryTypeBits &= image.memoryRequirements.memoryTypeBits;
+        block.images.push_back(handle);
+        image.memoryBlock = blockIndex;
+    }
+
+    constexpr VmaAllocationCreateInfo allocInfo{
+        .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+    };
+
+    statistics.transientAllocationCount = static_cast<uint32_t>(memoryBlocks.size());
+    statistics.transientAllocatedMemory = 0;
+    for (MemoryBlock& block : memoryBlocks) {
+        block.allocation = resourceManager.createResource<MemoryAllocation>(block.requirements, allocInfo);
+        if (block.allocation->allocation == VK_NULL_HANDLE) {
+            fmt::print("Warning: Failed to allocate render graph transient memory\n");
+            return false;
+        }
+        statistics.transientAllocatedMemory += block.requirements.size;
+
+        for (const RenderGraphImageHandle handle : block.images) {
+            GraphImage& image = images[handle];
+            const VkImageCreateInfo createInfo = vk_helpers::imageCreateInfo(image.description.format, image.description.usage,
+                                                                             image.description.extent);
+            VkImageViewCreateInfo viewInfo = vk_helpers::imageviewCreateInfo(image.description.format, VK_NULL_HANDLE, image.aspect);
+            image.transientImage = resourceManager.createResource<RenderTarget>(createInfo, viewInfo, block.allocation->allocation, 0);
+        }
+    }
+
+    return true;
+}
+
+void RenderGraph::buildBarriers()
+{
+    std::vector<ImageState> states(images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        if (images[i].importedImage) {
+            // Last frame's (or anyone else's) accesses are unknown
+            states[i].layout = CURRENT_IMAGE_LAYOUT;
+            states[i].writeStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            states[i].writeAccess = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        }
+    }
+
+    // Aliased images have to wait on whichever image last used their memory. The first image of each block waits on the last one
+    // from the previous frame, which is only known once every pass has been visited.
+    struct BlockState
+    {
+        VkPipelineStageFlags2 stages{VK_PIPELINE_STAGE_2_NONE};
+        VkAccessFlags2 writeAccess{VK_ACCESS_2_NONE};
+        bool bUsed{false};
+    };
+    std::vector<BlockState> blockStates(memoryBlocks.size());
+    std::vector<std::pair<int32_t, size_t> > wrappingBarriers;
+    std::vector<int32_t> lastPasses(images.size(), -1);
+
+    for (RenderGraphPass& pass : passes) {
+        pass.barriers.clear();
+        pass.barrierImages.clear();
+        pass.releaseBarriers.clear();
+        pass.releaseBarrierImages.clear();
+    }
+
+    statistics.barrierCount = 0;
+    statistics.queueOwnershipTransferCount = 0;
+    for (int32_t passIndex = 0; passIndex < static_cast<int32_t>(passes.size()); ++passIndex) {
+        RenderGraphPass& pass = passes[passIndex];
+        if (pass.bCulled) { continue; }
+
+        for (const RenderGraphImageUse& use : pass.uses) {
+            GraphImage& image = images[use.image];
+            ImageState& state = states[use.image];
+            const RenderGraphAccessInfo info = getAccessInfo(use.access);
+            const VkAccessFlags2 writeAccess = info.accessMask & WRITE_ACCESS_MASK;
+
+            const bool bFirstUse = image.firstPass == passIndex;
+            const int32_t lastPass = lastPasses[use.image];
+            const bool bQueueTransfer = lastPass >= 0 && passes[lastPass].queue != pass.queue;
+            const bool bLayoutChange = state.layout != info.layout;
+            bool bBarrier = false;
+            bool bVisibilityChanged = false;
+
+            if (bFirstUse && image.bTransient) {
+                BlockState& blockState = blockStates[image.memoryBlock];
+                pass.barriers.push_back(createBarrier(blockState.stages, blockState.writeAccess, info.stageMask, info.accessMask,
+                                                      VK_IMAGE_LAYOUT_UNDEFINED, info.layout, image.aspect));
+                pass.barrierImages.push_back(use.image);
+                if (!blockState.bUsed) {
+                    wrappingBarriers.emplace_back(passIndex, pass.barriers.size() - 1);
+                }
+                blockState.bUsed = true;
+                bBarrier = true;
+                bVisibilityChanged = true;
+            }
+            else if (bFirstUse && !image.importedImage) {
+                // Per frame import, previous contents are discarded
+                pass.barriers.push_back(createBarrier(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_NONE, info.stageMask, info.accessMask,
+                                                      VK_IMAGE_LAYOUT_UNDEFINED, info.layout, image.aspect));
+                pass.barrierImages.push_back(use.image);
+                bBarrier = true;
+                bVisibilityChanged = true;
+            }
+            else if (bQueueTransfer) {
+                // Released after the last pass on the other queue and acquired here, the layout transition happens once between the two
+                RenderGraphPass& releasePass = passes[lastPass];
+                const uint32_t srcFamily = queues[static_cast<size_t>(releasePass.queue)].family;
+                const uint32_t dstFamily = queues[static_cast<size_t>(pass.queue)].family;
+
+                VkImageMemoryBarrier2 release = createBarrier(state.writeStages | state.readStages, state.writeAccess, VK_PIPELINE_STAGE_2_NONE,
+                                                              VK_ACCESS_2_NONE, state.layout, info.layout, image.aspect);
+                release.srcQueueFamilyIndex = srcFamily;
+                release.dstQueueFamilyIndex = dstFamily;
+                releasePass.releaseBarriers.push_back(release);
+                releasePass.releaseBarrierImages.push_back(use.image);
+
+                VkImageMemoryBarrier2 acquire = createBarrier(VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, info.stageMask, info.accessMask,
+                                                              state.layout, info.layout, image.aspect);
+                acquire.srcQueueFamilyIndex = srcFamily;
+                acquire.dstQueueFamilyIndex = dstFamily;
+                pass.barriers.push_back(acquire);
+                pass.barrierImages.push_back(use.image);
+
+                if (std::ranges::find(pass.dependencies, lastPass) == pass.dependencies.end()) {
+                    pass.dependencies.push_back(lastPass);
+                }
+                statistics.barrierCount++;
+                statistics.queueOwnershipTransferCount++;
+                bBarrier = true;
+                bVisibilityChanged = true;
+            }
+            else if (bLayoutChange || info.bWrite) {
+                const VkPipelineStageFlags2 srcStages = state.writeStages | state.readStages;
+                if (bLayoutChange || srcStages != VK_PIPELINE_STAGE_2_NONE) {
+                    pass.barriers.push_back(createBarrier(srcStages, state.writeAccess, info.stageMask, info.accessMask,
+                                                          state.layout, info.layout, image.aspect));
+                    pass.barrierImages.push_back(use.image);
+                    bBarrier = true;
+                }
+                bVisibilityChanged = true;
+            }
+            else {
+                // Read in the same layout, only needs to wait if the last write isn't visible to this stage yet
+                const bool bVisible = (info.stageMask & ~state.visibleStages) == 0 && (info.accessMask & ~state.visibleAccess) == 0;
+                if (!bVisible && state.writeStages != VK_PIPELINE_STAGE_2_NONE) {
+                    pass.barriers.push_back(createBarrier(state.writeStages, state.writeAccess, info.stageMask, info.accessMask,
+                                                          state.layout, info.layout, image.aspect));
+                    pass.barrierImages.push_back(use.image);
+                    bBarrier = true;
+                }
+            }
+
+            if (bVisibilityChanged) {
+                state.layout = info.layout;
+                // A layout transition is a write that later accesses can chain off of through this pass' stages
+                state.writeStages = info.stageMask;
+                state.writeAccess = writeAccess;
+                state.readStages = info.bWrite ? VK_PIPELINE_STAGE_2_NONE : info.stageMask;
+                state.visibleStages = info.stageMask;
+                state.visibleAccess = info.accessMask;
+            }
+            else {
+                state.readStages |= info.stageMask;
+                if (bBarrier) {
+                    state.visibleStages |= info.stageMask;
+                    state.visibleAccess |= info.accessMask;
+                }
+            }
+
+            if (image.bTransient) {
+                BlockState& blockState = blockStates[image.memoryBlock];
+                blockState.stages = state.writeStages | state.readStages;
+                blockState.writeAccess = state.writeAccess;
+            }
+            lastPasses[use.image] = passIndex;
+        }
+
+        statistics.barrierCount += static_cast<uint32_t>(pass.barriers.size());
+    }
+
+    for (const auto& [passIndex, barrierIndex] : wrappingBarriers) {
+        VkImageMemoryBarrier2& barrier = passes[passIndex].barriers[barrierIndex];
+        const BlockState& blockState = blockStates[images[passes[passIndex].barrierImages[barrierIndex]].memoryBlock];
+        barrier.srcStageMask = blockState.stages;
+        barrier.srcAccessMask = blockState.writeAccess;
+    }
+
+    for (RenderGraphPass& pass : passes) {
+        if (pass.queue != RenderGraphQueue::AsyncCompute) { continue; }
+        for (VkImageMemoryBarrier2& barrier : pass.barriers) {
+            sanitizeComputeQueueBarrier(barrier);
+        }
+        for (VkImageMemoryBarrier2& barrier : pass.releaseBarriers) {
+            sanitizeComputeQueueBarrier(barrier);
+        }
+    }
+
+    finalBarriers.clear();
+    finalBarrierImages.clear();
+    for (RenderGraphImageHandle i = 0; i < images.size(); ++i) {
+        GraphImage& image = images[i];
+        const ImageState& state = states[i];
+        image.endLayout = state.layout;
+
+        if (image.firstPass < 0 || image.bTransient || image.importedImage || image.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED) { continue; }
+
+        finalBarriers.push_back(createBarrier(state.writeStages | state.readStages, state.writeAccess, VK_PIPELINE_STAGE_2_NONE,
+                                              VK_ACCESS_2_NONE, state.layout, image.finalLayout, image.aspect));
+        finalBarrierImages.push_back(i);
+        image.endLayout = image.finalLayout;
+    }
+    statistics.barrierCount += static_cast<uint32_t>(finalBarriers.size());
+}
+
+void RenderGraph::buildSegments()
+{
+    segments.clear();
+    endSubmits.clear();
+    std::array<int32_t, RENDER_GRAPH_QUEUE_COUNT> openSegments{};
+    openSegments.fill(-1);
+
+    const auto openSegment = [this, &openSegments](const RenderGraphQueue queue) {
+        segments.push_back({.queue = queue});
+        openSegments[static_cast<size_t>(queue)] = static_cast<int32_t>(segments.size() - 1);
+    };
+    const auto closeSegment = [this, &openSegments](const int32_t segmentIndex, const int32_t beforePass) {
+        Segment& segment = segments[segmentIndex];
+        segment.bOpen = false;
+        openSegments[static_cast<size_t>(segment.queue)] = -1;
+        if (beforePass >= 0) {
+            passes[beforePass].submitBefore.push_back(segmentIndex);
+        }
+        else {
+            endSubmits.push_back(segmentIndex);
+        }
+    };
+
+    openSegment(RenderGraphQueue::Graphics);
+    for (int32_t passIndex = 0; passIndex < static_cast<int32_t>(passes.size()); ++passIndex) {
+        RenderGraphPass& pass = passes[passIndex];
+        pass.submitBefore.clear();
+        pass.segment = -1;
+        if (pass.bCulled) { continue; }
+
+        int32_t waitSegment = -1;
+        for (const int32_t dependency : pass.dependencies) {
+            const RenderGraphPass& other = passes[dependency];
+            if (other.bCulled || other.queue == pass.queue) { continue; }
+            waitSegment = std::max(waitSegment, other.segment);
+        }
+        if (pass.queue == RenderGraphQueue::AsyncCompute) {
+            // Uploads recorded before the graph executes are in the first graphics segment
+            waitSegment = std::max(waitSegment, 0);
+        }
+
+        const auto queueIndex = static_cast<size_t>(pass.queue);
+        if (waitSegment >= 0) {
+            if (segments[waitSegment].bOpen) {
+                closeSegment(waitSegment, passIndex);
+            }
+            // Waits happen at the start of a submission, so work already recorded on this queue is submitted on its own
+            const int32_t currentSegment = openSegments[queueIndex];
+            if (currentSegment >= 0 && segments[currentSegment].waitSegment < waitSegment) {
+                closeSegment(currentSegment, passIndex);
+            }
+        }
+
+        if (openSegments[queueIndex] < 0) {
+            openSegment(pass.queue);
+        }
+        Segment& segment = segments[openSegments[queueIndex]];
+        segment.waitSegment = std::max(segment.waitSegment, waitSegment);
+        pass.segment = openSegments[queueIndex];
+    }
+
+    if (const int32_t computeSegment = openSegments[static_cast<size_t>(RenderGraphQueue::AsyncCompute)]; computeSegment >= 0) {
+        closeSegment(computeSegment, -1);
+    }
+    if (openSegments[static_cast<size_t>(RenderGraphQueue::Graphics)] < 0) {
+        openSegment(RenderGraphQueue::Graphics);
+    }
+    finalSegment = openSegments[static_cast<size_t>(RenderGraphQueue::Graphics)];
+
+    // The frame's fence is signaled by the final submission, so it has to include all compute work
+    for (int32_t i = static_cast<int32_t>(segments.size()) - 1; i >= 0; --i) {
+        if (segments[i].queue == RenderGraphQueue::AsyncCompute) {
+            segments[finalSegment].waitSegment = std::max(segments[finalSegment].waitSegment, i);
+            break;
+        }
+    }
+
+    for (RenderGraphImageHandle i = 0; i < images.size(); ++i) {
+        const GraphImage& image = images[i];
+        if (image.firstPass < 0 || image.bTransient || image.importedImage) { continue; }
+        if (passes[image.firstPass].segment != finalSegment) {
+            fmt::print("Warning: Render graph image {} is used before the final submission, which waits on its availability\n", image.name);
+        }
+    }
+
+    statistics.submissionCount = static_cast<uint32_t>(segments.size());
+}
+
+void RenderGraph::createCommandBuffers()
+{
+    std::array<uint32_t, RENDER_GRAPH_QUEUE_COUNT> counts{};
+    // Segment 0 is recorded into the command buffer passed to execute
+    for (size_t i = 1; i < segments.size(); ++i) {
+        Segment& segment = segments[i];
+        segment.commandBufferIndex = counts[static_cast<size_t>(segment.queue)]++;
+    }
+
+    for (size_t queueIndex = 0; queueIndex < queues.size(); ++queueIndex) {
+        if (counts[queueIndex] == 0) { continue; }
+
+        QueueData& queue = queues[queueIndex];
+        for (int32_t frame = 0; frame < FRAME_OVERLAP; ++frame) {
+            const VkCommandPoolCreateInfo poolInfo = vk_helpers::commandPoolCreateInfo(queue.family, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+            VK_CHECK(vkCreateCommandPool(resourceManager.getDevice(), &poolInfo, nullptr, &queue.commandPools[frame]));
+
+            queue.commandBuffers[frame].resize(counts[queueIndex]);
+            const VkCommandBufferAllocateInfo allocInfo = vk_helpers::commandBufferAllocateInfo(queue.commandPools[frame], counts[queueIndex]);
+            VK_CHECK(vkAllocateCommandBuffers(resourceManager.getDevice(), &allocInfo, queue.commandBuffers[frame].data()));
+        }
+    }
+}
+
+void RenderGraph::setImportedImage(const RenderGraphImageHandle image, const VkImage vkImage)
+{
+    images[image].externalImage = vkImage;
+}
+
+void RenderGraph::setImportedImage(const RenderGraphImageHandle image, ImageResource* resource)
+{
+    images[image].importedImage = resource;
+}
+
+VkCommandBuffer RenderGraph::execute(VkCommandBuffer cmd, const int32_t frameOverlap, GpuProfiler* profiler)
+{
+    WILL_PROFILE_ZONE("Render Graph Execute");
+    finalWaitSemaphores.clear();
+    if (!bCompiled) {
+        fmt::print("Warning: Render graph executed before it was compiled\n");
+        return cmd;
+    }
+
+    for (const QueueData& queue : queues) {
+        if (queue.commandPools[frameOverlap] != VK_NULL_HANDLE) {
+            VK_CHECK(vkResetCommandPool(resourceManager.getDevice(), queue.commandPools[frameOverlap], 0));
+        }
+    }
+
+    const VkCommandBufferBeginInfo beginInfo = vk_helpers::commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    segments[0].commandBuffer = cmd;
+    for (size_t i = 1; i < segments.size(); ++i) {
+        Segment& segment = segments[i];
+        segment.commandBuffer = queues[static_cast<size_t>(segment.queue)].commandBuffers[frameOverlap][segment.commandBufferIndex];
+        VK_CHECK(vkBeginCommandBuffer(segment.commandBuffer, &beginInfo));
+    }
+
+    for (RenderGraphPass& pass : passes) {
+        if (pass.bCulled) { continue; }
+
+        for (const int32_t segmentIndex : pass.submitBefore) {
+            submitSegment(segmentIndex);
+        }
+
+        VkCommandBuffer passCmd = segments[pass.segment].commandBuffer;
+        recordBarriers(passCmd, pass.barriers, pass.barrierImages);
+        if (profiler) {
+            // Async compute passes only get timestamps, pipeline statistics queries are graphics only
+            profiler->beginScope(passCmd, pass.name, pass.queue != RenderGraphQueue::Graphics);
+        }
+        pass.execute(passCmd);
+        if (profiler) {
+            profiler->endScope(passCmd);
+        }
+        recordBarriers(passCmd, pass.releaseBarriers, pass.releaseBarrierImages);
+    }
+
+    for (const int32_t segmentIndex : endSubmits) {
+        submitSegment(segmentIndex);
+    }
+
+    const Segment& lastSegment = segments[finalSegment];
+    recordBarriers(lastSegment.commandBuffer, finalBarriers, finalBarrierImages);
+    if (lastSegment.waitSegment >= 0) {
+        const Segment& waitSegment = segments[lastSegment.waitSegment];
+        VkSemaphoreSubmitInfo waitInfo = vk_helpers::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                         queues[static_cast<size_t>(waitSegment.queue)].timeline);
+        waitInfo.value = waitSegment.signalValue;
+        finalWaitSemaphores.push_back(waitInfo);
+    }
+
+    for (GraphImage& image : images) {
+        if (image.firstPass < 0) { continue; }
+
+        if (image.importedImage) {
+            image.importedImage->imageLayout = image.endLayout;
+        }
+        else if (image.transientImage) {
+            image.transientImage->imageLayout = image.endLayout;
+        }
+    }
+
+    return lastSegment.commandBuffer;
+}
+
+void RenderGraph::submitSegment(const int32_t segmentIndex)
+{
+    Segment& segment = segments[segmentIndex];
+    QueueData& queue = queues[static_cast<size_t>(segment.queue)];
+    VK_CHECK(vkEndCommandBuffer(segment.commandBuffer));
+
+    segment.signalValue = ++queue.timelineValue;
+    const VkCommandBufferSubmitInfo cmdSubmitInfo = vk_helpers::commandBufferSubmitInfo(segment.commandBuffer);
+    VkSemaphoreSubmitInfo signalInfo = vk_helpers::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, queue.timeline);
+    signalInfo.value = segment.signalValue;
+
+    VkSemaphoreSubmitInfo waitInfo{};
+    if (segment.waitSegment >= 0) {
+        const Segment& waitSegment = segments[segment.waitSegment];
+        waitInfo = vk_helpers::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, queues[static_cast<size_t>(waitSegment.queue)].timeline);
+        waitInfo.value = waitSegment.signalValue;
+    }
+
+    const VkSubmitInfo2 submit = vk_helpers::submitInfo(&cmdSubmitInfo, &signalInfo, segment.waitSegment >= 0 ? &waitInfo : nullptr);
+    VK_CHECK(vkQueueSubmit2(queue.queue, 1, &submit, VK_NULL_HANDLE));
+}
+
+RenderTarget* RenderGraph::getImage(const RenderGraphImageHandle image) const
+{
+    if (image >= images.size()) { return nullptr; }
+    return images[image].transientImage.get();
+}
+
+VkImage RenderGraph::getVkImage(const RenderGraphImageHandle image) const
+{
+    const GraphImage& graphImage = images[image];
+    if (graphImage.transientImage) { return graphImage.transientImage->image; }
+    if (graphImage.importedImage) { return graphImage.importedImage->image; }
+    return graphImage.externalImage;
+}
+
+void RenderGraph::recordBarriers(VkCommandBuffer cmd, const std::vector<VkImageMemoryBarrier2>& barriers,
+                                 const std::vector<RenderGraphImageHandle>& barrierImages)
+{
+    if (barriers.empty()) { return; }
+
+    barrierScratch.assign(barriers.begin(), barriers.end());
+    for (size_t i = 0; i < barrierScratch.size(); ++i) {
+        VkImageMemoryBarrier2& barrier = barrierScratch[i];
+        barrier.image = getVkImage(barrierImages[i]);
+        if (barrier.oldLayout == CURRENT_IMAGE_LAYOUT) {
+            barrier.oldLayout = images[barrierImages[i]].importedImage->imageLayout;
+        }
+    }
+
+    VkDependencyInfo dependencyInfo{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(barrierScratch.size());
+    dependencyInfo.pImageMemoryBarriers = barrierScratch.data();
+    vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+}
+}
@@ -0,0 +1,320 @@
+//
+// Created by William on 2025-07-06.
+//
+
+#ifndef RENDER_GRAPH_H
+#define RENDER_GRAPH_H
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "render_graph_types.h"
+#include "engine/renderer/renderer_constants.h"
+#include "engine/renderer/resources/resources_fwd.h"
+
+namespace will_engine
+{
+class VulkanContext;
+}
+
+namespace will_engine::renderer
+{
+class ResourceManager;
+class GpuProfiler;
+struct ImageResource;
+
+class RenderGraphPass
+{
+public:
+    RenderGraphPass(std::string name, std::function<void(VkCommandBuffer)>&& execute);
+
+    /**
+     * Declares that this pass accesses \code image\endcode. Passes may only touch graph images they declared.
+     */
+    RenderGraphPass& use(RenderGraphImageHandle image, RenderGraphAccess access);
+
+    /**
+     * The pass does work the graph can't see (e.g. writes its own images or buffers) and is never culled.
+     */
+    RenderGraphPass& setSideEffects();
+
+    /**
+     * Runs the pass on the async compute queue if the graph has one. The pass may only record compute and transfer work
+     * and can't use imported images, otherwise it stays on the graphics queue.
+     */
+    RenderGraphPass& setAsyncCompute();
+
+    /**
+     * Orders this pass after \code passName\endcode for work the graph can't see, e.g. images owned by the pipeline of a side effect pass.
+     * Only matters across queues, passes on the same queue synchronize their own resources.
+     */
+    RenderGraphPass& dependsOn(const std::string& passName);
+
+private:
+    std::string name;
+    std::function<void(VkCommandBuffer)> execute;
+    std::vector<RenderGraphImageUse> uses;
+    std::vector<std::string> dependencyNames;
+    bool bSideEffects{false};
+    bool bAsyncCompute{false};
+
+    bool bCulled{false};
+    RenderGraphQueue queue{RenderGraphQueue::Graphics};
+    /**
+     * Earlier passes this pass runs after, declared with \code dependsOn\endcode or using an image last used on the other queue
+     */
+    std::vector<int32_t> dependencies;
+    int32_t segment{-1};
+    /**
+     * Segments submitted before this pass is recorded, so the pass' segment can wait on them
+     */
+    std::vector<int32_t> submitBefore;
+    /**
+     * Barriers recorded before the pass executes, \code image\endcode is filled in when executing
+     */
+    std::vector<VkImageMemoryBarrier2> barriers;
+    std::vector<RenderGraphImageHandle> barrierImages;
+    /**
+     * Queue family ownership releases recorded after the pass executes
+     */
+    std::vector<VkImageMemoryBarrier2> releaseBarriers;
+    std::vector<RenderGraphImageHandle> releaseBarrierImages;
+
+    friend class RenderGraph;
+};
+
+/**
+ * Frame graph for the main render loop. Passes declare the images they use, \code compile\endcode then
+ * \n - culls passes that don't contribute to an output image or have side effects
+ * \n - derives the minimal set of sync2 barriers/layout transitions between passes
+ * \n - assigns non-overlapping transient images to shared memory blocks and creates them
+ * \n - splits the frame into submissions per queue if async compute is enabled, see \code enableAsyncCompute\endcode
+ *
+ * The graph is declared and compiled once (and again on resize), pass callbacks read the per frame state they need when executed.
+ * Buffers are not tracked, pipelines synchronize their own buffers.
+ */
+class RenderGraph
+{
+public:
+    explicit RenderGraph(ResourceManager& resourceManager);
+
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+public: // Declaration
+    /**
+     * Lets passes marked with \code setAsyncCompute\endcode run on the compute queue, overlapping the graphics work recorded alongside them.
+     * The queues are synchronized with timeline semaphores and images handed between them are transferred with queue family ownership barriers.
+     * Must be called before \code compile\endcode, does nothing if the device has no separate compute queue family.
+     */
+    void enableAsyncCompute(const VulkanContext& context);
+
+    /**
+     * Creates an image owned by the graph. Its contents are undefined before its first write each frame.
+     */
+    RenderGraphImageHandle createImage(const std::string& name, const RenderGraphImageDescription& description);
+
+    /**
+     * Imports an image whose contents persist across frames (e.g. history buffers). Its layout is read from and written back to \code image\endcode.
+     */
+    RenderGraphImageHandle importImage(const std::string& name, ImageResource* image, VkImageAspectFlags aspect);
+
+    /**
+     * Imports an image that changes every frame (e.g. the swapchain), see \code setImportedImage\endcode. Its contents are discarded at the start of
+     * the frame and it is transitioned to \code finalLayout\endcode after its last use.
+     */
+    RenderGraphImageHandle importImage(const std::string& name, VkImageAspectFlags aspect, VkImageLayout finalLayout);
+
+    /**
+     * Images that are used after the graph executes, passes contributing to them aren't culled.
+     */
+    void markOutput(RenderGraphImageHandle image);
+
+    /**
+     * @return the pass, only valid until the next call to \code addPass\endcode
+     */
+    RenderGraphPass& addPass(const std::string& name, std::function<void(VkCommandBuffer)>&& execute);
+
+    /**
+     * Culls passes, allocates transient images and derives barriers. Can only be called once, images created by the graph are available afterward.
+     * @param bAliasTransientImages if false, every transient image gets its own allocation (e.g. to inspect render targets after the frame)
+     * @return false if the graph is invalid
+     */
+    bool compile(bool bAliasTransientImages = true);
+
+public: // Execution
+    void setImportedImage(RenderGraphImageHandle image, VkImage vkImage);
+
+    /**
+     * Swaps the resource behind a persistent import, e.g. to ping-pong history buffers. The resource must match the one it replaces.
+     */
+    void setImportedImage(RenderGraphImageHandle image, ImageResource* resource);
+
+    /**
+     * Records every pass. Work that has to run before async compute passes is submitted by the graph, \code cmd\endcode must be in the
+     * recording state and is ended and submitted by the graph in that case.
+     * @param frameOverlap selects the command buffers of the graph's own submissions, they must have finished executing
+     * @param profiler if set, every graphics pass is measured as a scope named after the pass
+     * @return the command buffer holding the end of the frame, still recording. Its submission has to wait on \code getFinalWaitSemaphores\endcode.
+     */
+    VkCommandBuffer execute(VkCommandBuffer cmd, int32_t frameOverlap, GpuProfiler* profiler = nullptr);
+
+    /**
+     * @return the semaphores the submission of the command buffer returned by \code execute\endcode waits on, empty without async compute
+     */
+    [[nodiscard]] const std::vector<VkSemaphoreSubmitInfo>& getFinalWaitSemaphores() const { return finalWaitSemaphores; }
+
+public:
+    /**
+     * @return the image created by the graph, nullptr before \code compile\endcode or if it was culled
+     */
+    [[nodiscard]] RenderTarget* getImage(RenderGraphImageHandle image) const;
+
+    [[nodiscard]] const RenderGraphStatistics& getStatistics() const { return statistics; }
+
+private:
+    struct ImageState
+    {
+        VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+        VkPipelineStageFlags2 writeStages{VK_PIPELINE_STAGE_2_NONE};
+        VkAccessFlags2 writeAccess{VK_ACCESS_2_NONE};
+        /**
+         * Stages that read the image since the last write, a write has to wait on them
+         */
+        VkPipelineStageFlags2 readStages{VK_PIPELINE_STAGE_2_NONE};
+        /**
+         * Stages/accesses the last write has been made visible to
+         */
+        VkPipelineStageFlags2 visibleStages{VK_PIPELINE_STAGE_2_NONE};
+        VkAccessFlags2 visibleAccess{VK_ACCESS_2_NONE};
+    };
+
+    struct GraphImage
+    {
+        std::string name;
+        RenderGraphImageDescription description{};
+        VkImageAspectFlags aspect{VK_IMAGE_ASPECT_COLOR_BIT};
+
+        bool bTransient{false};
+        bool bOutput{false};
+        /**
+         * Persistent imported image, layout tracked on the resource
+         */
+        ImageResource* importedImage{nullptr};
+        /**
+         * Per frame imported image
+         */
+        VkImage externalImage{VK_NULL_HANDLE};
+        VkImageLayout finalLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+        RenderTargetPtr transientImage{nullptr};
+        VkMemoryRequirements memoryRequirements{};
+        int32_t firstPass{-1};
+        int32_t lastPass{-1};
+        int32_t memoryBlock{-1};
+        /**
+         * Used by a pass on the async compute queue, never aliased
+         */
+        bool bAsyncComputeUse{false};
+
+        VkImageLayout endLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+    };
+
+    struct MemoryBlock
+    {
+        VkMemoryRequirements requirements{};
+        std::vector<RenderGraphImageHandle> images;
+        MemoryAllocationPtr allocation{nullptr};
+    };
+
+    /**
+     * Consecutive passes on one queue that are submitted together
+     */
+    struct Segment
+    {
+        RenderGraphQueue queue{RenderGraphQueue::Graphics};
+        /**
+         * Segment on the other queue that has to finish before this one starts
+         */
+        int32_t waitSegment{-1};
+        /**
+         * Index into the per frame command buffers of the queue
+         */
+        uint32_t commandBufferIndex{0};
+        bool bOpen{true};
+
+        VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+        uint64_t signalValue{0};
+    };
+
+    struct QueueData
+    {
+        VkQueue queue{VK_NULL_HANDLE};
+        uint32_t family{VK_QUEUE_FAMILY_IGNORED};
+        VkSemaphore timeline{VK_NULL_HANDLE};
+        uint64_t timelineValue{0};
+        std::array<VkCommandPool, FRAME_OVERLAP> commandPools{};
+        std::array<std::vector<VkCommandBuffer>, FRAME_OVERLAP> commandBuffers{};
+    };
+
+    ResourceManager& resourceManager;
+
+    std::vector<GraphImage> images;
+    std::vector<RenderGraphPass> passes;
+    std::vector<MemoryBlock> memoryBlocks;
+    std::vector<VkImageMemoryBarrier2> finalBarriers;
+    std::vector<RenderGraphImageHandle> finalBarrierImages;
+
+    bool bCompiled{false};
+    RenderGraphStatistics statistics{};
+
+    bool bAsyncComputeEnabled{false};
+    std::array<QueueData, RENDER_GRAPH_QUEUE_COUNT> queues{};
+    /**
+     * Segment 0 is always the graphics segment recorded into the command buffer passed to \code execute\endcode
+     */
+    std::vector<Segment> segments;
+    /**
+     * Segments submitted after the last pass, before the final graphics segment is returned
+     */
+    std::vector<int32_t> endSubmits;
+    int32_t finalSegment{0};
+    std::vector<VkSemaphoreSubmitInfo> finalWaitSemaphores;
+
+    /**
+     * Scratch space so executing doesn't allocate
+     */
+    std::vector<VkImageMemoryBarrier2> barrierScratch;
+
+    bool resolveDependencies();
+
+    void cullPasses();
+
+    void assignQueues();
+
+    void computeLifetimes();
+
+    bool allocateTransientImages(bool bAliasTransientImages);
+
+    void buildBarriers();
+
+    void buildSegments();
+
+    void createCommandBuffers();
+
+    void submitSegment(int32_t segmentIndex);
+
+    [[nodiscard]] VkImage getVkImage(RenderGraphImageHandle image) const;
+
+    void recordBarriers(VkCommandBuffer cmd, const std::vector<VkImageMemoryBarrier2>& barriers, const std::vector<RenderGraphImageHandle>& barrierImages);
+};
+}
+
+#endif //RENDER_GRAPH_H
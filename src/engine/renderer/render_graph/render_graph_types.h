@@ -0,0 +1,107 @@
+//
+// Created by William on 2025-07-06.
+//
+
+#ifndef RENDER_GRAPH_TYPES_H
+#define RENDER_GRAPH_TYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <vulkan/vulkan_core.h>
+
+namespace will_engine::renderer
+{
+using RenderGraphImageHandle = uint32_t;
+constexpr RenderGraphImageHandle INVALID_RENDER_GRAPH_IMAGE = std::numeric_limits<uint32_t>::max();
+
+/**
+ * How a pass uses an image. Each access maps to the stage, access mask and layout the graph synchronizes against.
+ */
+enum class RenderGraphAccess : uint8_t
+{
+    /**
+     * Loaded and stored color attachment, also used for blending
+     */
+    ColorAttachment,
+    /**
+     * Depth/stencil attachment with depth or stencil writes
+     */
+    DepthStencilAttachment,
+    /**
+     * Depth tested without writes
+     */
+    DepthStencilAttachmentRead,
+    SampledFragment,
+    SampledCompute,
+    StorageReadCompute,
+    StorageWriteCompute,
+    StorageReadWriteCompute,
+    TransferSrc,
+    TransferDst,
+};
+
+enum class RenderGraphQueue : uint8_t
+{
+    Graphics,
+    /**
+     * Compute queue separate from the graphics queue, runs alongside it
+     */
+    AsyncCompute,
+};
+
+static constexpr size_t RENDER_GRAPH_QUEUE_COUNT = 2;
+
+struct RenderGraphAccessInfo
+{
+    VkPipelineStageFlags2 stageMask{VK_PIPELINE_STAGE_2_NONE};
+    VkAccessFlags2 accessMask{VK_ACCESS_2_NONE};
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+    bool bRead{false};
+    bool bWrite{false};
+};
+
+/**
+ * Description of an image created and owned by the graph. Transient images only hold data between their first and last use
+ * in a frame and may share memory with other transient images.
+ */
+struct RenderGraphImageDescription
+{
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkExtent3D extent{};
+    VkImageUsageFlags usage{0};
+    VkImageAspectFlags aspect{VK_IMAGE_ASPECT_COLOR_BIT};
+};
+
+struct RenderGraphImageUse
+{
+    RenderGraphImageHandle image{INVALID_RENDER_GRAPH_IMAGE};
+    RenderGraphAccess access{RenderGraphAccess::SampledCompute};
+};
+
+struct RenderGraphStatistics
+{
+    uint32_t passCount{0};
+    uint32_t culledPassCount{0};
+    uint32_t barrierCount{0};
+    uint32_t transientImageCount{0};
+    uint32_t transientAllocationCount{0};
+    /**
+     * Sum of the sizes of all transient images, i.e. the memory they would take without aliasing
+     */
+    VkDeviceSize transientImageMemory{0};
+    VkDeviceSize transientAllocatedMemory{0};
+    uint32_t asyncComputePassCount{0};
+    /**
+     * Queue submissions per frame, including the final graphics submission
+     */
+    uint32_t submissionCount{1};
+    /**
+     * Images handed between the graphics and async compute queue per frame
+     */
+    uint32_t queueOwnershipTransferCount{0};
+};
+}
+
+#endif //RENDER_GRAPH_TYPES_H
@@ -8,7 +8,10 @@
 
 namespace will_engine
 {
-constexpr int32_t FRAME_OVERLAP = 2;
+/**
+ * Number of per-frame resource slots, the most frames that can be in flight. How many actually are is set at runtime (see \code FramePacingSettings\endcode)
+ */
+constexpr int32_t FRAME_OVERLAP = 3;
 constexpr char ENGINE_NAME[] = "Will Engine";
 constexpr bool USING_REVERSED_DEPTH_BUFFER = true;
 constexpr VkDeviceSize ZERO_DEVICE_SIZE = 0;
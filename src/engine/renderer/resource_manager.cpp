@@ -181,6 +181,18 @@ ResourceManager::ResourceManager(VulkanContext& context, ImmediateSubmitter& imm
         );
         terrainUniformLayout = createResource<DescriptorSetLayout>(layoutCreateInfo);
     }
+    // Terrain Heightmap (height + oct normal)
+    {
+        DescriptorLayoutBuilder layoutBuilder{2};
+        layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        VkDescriptorSetLayoutCreateInfo layoutCreateInfo = layoutBuilder.build(
+            static_cast<VkShaderStageFlagBits>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
+                                               VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT | VK_SHADER_STAGE_COMPUTE_BIT),
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+        );
+        terrainHeightmapLayout = createResource<DescriptorSetLayout>(layoutCreateInfo);
+    }
 
     for (int32_t i = 0; i < FRAME_OVERLAP; ++i) {
         destructionQueues[i].resources.reserve(100);
@@ -209,6 +221,7 @@ ResourceManager::~ResourceManager()
     destroyResource(std::move(renderTargetsLayout));
     destroyResource(std::move(terrainTexturesLayout));
     destroyResource(std::move(terrainUniformLayout));
+    destroyResource(std::move(terrainHeightmapLayout));
 
     flushDestructionQueue();
 
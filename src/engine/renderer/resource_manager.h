@@ -95,6 +95,26 @@ public:
 
     [[nodiscard]] ktxVulkanDeviceInfo* getKtxVulkanDeviceInfo() const { return vulkanDeviceInfo; }
 
+    /**
+     * Shares the image between the graphics and async compute queue, for images written on one queue and read on the other without ownership
+     * transfers. Does nothing if the device has no separate compute queue.
+     */
+    void setAsyncComputeSharing(VkImageCreateInfo& createInfo) const
+    {
+        if (!context.hasAsyncComputeQueue()) { return; }
+        createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        createInfo.queueFamilyIndexCount = static_cast<uint32_t>(context.sharedQueueFamilies.size());
+        createInfo.pQueueFamilyIndices = context.sharedQueueFamilies.data();
+    }
+
+    void setAsyncComputeSharing(VkBufferCreateInfo& createInfo) const
+    {
+        if (!context.hasAsyncComputeQueue()) { return; }
+        createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        createInfo.queueFamilyIndexCount = static_cast<uint32_t>(context.sharedQueueFamilies.size());
+        createInfo.pQueueFamilyIndices = context.sharedQueueFamilies.data();
+    }
+
 private:
     VulkanContext& context;
     const ImmediateSubmitter& immediate;
@@ -185,6 +205,7 @@ public:
     [[nodiscard]] VkDescriptorSetLayout getRenderTargetsLayout() const { return renderTargetsLayout->layout; }
     [[nodiscard]] VkDescriptorSetLayout getTerrainTexturesLayout() const { return terrainTexturesLayout->layout; }
     [[nodiscard]] VkDescriptorSetLayout getTerrainUniformLayout() const { return terrainUniformLayout->layout; }
+    [[nodiscard]] VkDescriptorSetLayout getTerrainHeightmapLayout() const { return terrainHeightmapLayout->layout; }
 
 private:
     ImageResourcePtr whiteImage{};
@@ -213,6 +234,7 @@ private:
 
     DescriptorSetLayoutPtr terrainTexturesLayout{};
     DescriptorSetLayoutPtr terrainUniformLayout{};
+    DescriptorSetLayoutPtr terrainHeightmapLayout{};
 };
 
 class CustomIncluder final : public shaderc::CompileOptions::IncluderInterface
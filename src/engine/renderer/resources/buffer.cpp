@@ -10,16 +10,20 @@
 namespace will_engine::renderer
 {
 Buffer::Buffer(ResourceManager* resourceManager, BufferType type, size_t size,
-               VkBufferUsageFlags additionalUsages) : VulkanResource(resourceManager)
+               VkBufferUsageFlags additionalUsages, const bool bAsyncComputeShared) : VulkanResource(resourceManager)
 {
     auto [bufferUsage, allocFlags, memoryUsage, requiredFlags] = getBufferConfig(type, additionalUsages);
 
-    const VkBufferCreateInfo bufferInfo{
+    VkBufferCreateInfo bufferInfo{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = size,
         .usage = bufferUsage,
         .sharingMode = VK_SHARING_MODE_EXCLUSIVE
     };
+    // Passes on the async compute queue don't transfer ownership
+    if (bAsyncComputeShared) {
+        resourceManager->setAsyncComputeSharing(bufferInfo);
+    }
 
     const VmaAllocationCreateInfo allocInfo{
         .flags = allocFlags,
@@ -33,7 +37,7 @@ Buffer::Buffer(ResourceManager* resourceManager, BufferType type, size_t size,
 Buffer::Buffer(ResourceManager* resourceManager, size_t size, VkBufferUsageFlags usage,
                VmaMemoryUsage memoryUsage) : VulkanResource(resourceManager)
 {
-    const VkBufferCreateInfo bufferInfo = {
+    VkBufferCreateInfo bufferInfo = {
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .pNext = nullptr,
         .size = size,
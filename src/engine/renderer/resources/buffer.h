@@ -32,7 +32,11 @@ struct Buffer final : VulkanResource
     VmaAllocationInfo info{};
 
 
-    Buffer(ResourceManager* resourceManager, BufferType type, size_t size, VkBufferUsageFlags additionalUsages = 0);
+    /**
+     * @param bAsyncComputeShared share the buffer between the graphics and async compute queue (see \code ResourceManager::setAsyncComputeSharing\endcode).
+     * Only for buffers the async compute passes read, concurrent sharing can be slower on some hardware
+     */
+    Buffer(ResourceManager* resourceManager, BufferType type, size_t size, VkBufferUsageFlags additionalUsages = 0, bool bAsyncComputeShared = false);
 
     Buffer(ResourceManager* resourceManager, size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage);
 
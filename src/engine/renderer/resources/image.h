@@ -23,6 +23,12 @@ struct Image : ImageResource
     Image(ResourceManager* resourceManager, const VkImageCreateInfo& createInfo, const VmaAllocationCreateInfo& allocInfo, VkImageViewCreateInfo& viewInfo);
 
     ~Image() override;
+
+protected:
+    /**
+     * For derived images that create the VkImage themselves
+     */
+    explicit Image(ResourceManager* resourceManager) : ImageResource(resourceManager) {}
 };
 }
 
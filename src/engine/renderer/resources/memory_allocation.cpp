@@ -0,0 +1,25 @@
+//
+// Created by William on 2025-07-06.
+//
+
+#include "memory_allocation.h"
+
+#include "engine/renderer/resource_manager.h"
+#include "engine/renderer/vk_helpers.h"
+
+namespace will_engine::renderer
+{
+MemoryAllocation::MemoryAllocation(ResourceManager* resourceManager, const VkMemoryRequirements& requirements, const VmaAllocationCreateInfo& allocInfo)
+    : VulkanResource(resourceManager)
+{
+    VK_CHECK(vmaAllocateMemory(resourceManager->getAllocator(), &requirements, &allocInfo, &allocation, &info));
+}
+
+MemoryAllocation::~MemoryAllocation()
+{
+    if (allocation != VK_NULL_HANDLE) {
+        vmaFreeMemory(manager->getAllocator(), allocation);
+        allocation = VK_NULL_HANDLE;
+    }
+}
+}
@@ -0,0 +1,30 @@
+//
+// Created by William on 2025-07-06.
+//
+
+#ifndef MEMORY_ALLOCATION_H
+#define MEMORY_ALLOCATION_H
+
+#include <vulkan/vulkan_core.h>
+#include <vma/vk_mem_alloc.h>
+
+#include "vulkan_resource.h"
+
+namespace will_engine::renderer
+{
+/**
+ * A block of device memory that isn't bound to any single resource, e.g. memory shared by aliased render targets.
+ * \n Resources bound to it must not be used after it is destroyed.
+ */
+struct MemoryAllocation : VulkanResource
+{
+    VmaAllocation allocation{VK_NULL_HANDLE};
+    VmaAllocationInfo info{};
+
+    MemoryAllocation(ResourceManager* resourceManager, const VkMemoryRequirements& requirements, const VmaAllocationCreateInfo& allocInfo);
+
+    ~MemoryAllocation() override;
+};
+}
+
+#endif //MEMORY_ALLOCATION_H
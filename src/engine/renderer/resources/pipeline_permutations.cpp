@@ -0,0 +1,113 @@
+//
+// Created by William on 2025-07-10.
+//
+
+#include "pipeline_permutations.h"
+
+#include <bit>
+#include <ranges>
+
+#include "pipeline.h"
+#include "shader_module.h"
+#include "engine/renderer/resource_manager.h"
+
+namespace will_engine::renderer
+{
+void SpecializationConstants::add(const uint32_t constantId, const bool value)
+{
+    addRaw(constantId, value ? VK_TRUE : VK_FALSE);
+}
+
+void SpecializationConstants::add(const uint32_t constantId, const uint32_t value)
+{
+    addRaw(constantId, value);
+}
+
+void SpecializationConstants::add(const uint32_t constantId, const int32_t value)
+{
+    addRaw(constantId, std::bit_cast<uint32_t>(value));
+}
+
+void SpecializationConstants::add(const uint32_t constantId, const float value)
+{
+    addRaw(constantId, std::bit_cast<uint32_t>(value));
+}
+
+const VkSpecializationInfo* SpecializationConstants::getInfo()
+{
+    if (entries.empty()) {
+        return nullptr;
+    }
+
+    info.mapEntryCount = static_cast<uint32_t>(entries.size());
+    info.pMapEntries = entries.data();
+    info.dataSize = data.size() * sizeof(uint32_t);
+    info.pData = data.data();
+    return &info;
+}
+
+void SpecializationConstants::addRaw(const uint32_t constantId, const uint32_t bits)
+{
+    entries.push_back({constantId, static_cast<uint32_t>(data.size() * sizeof(uint32_t)), sizeof(uint32_t)});
+    data.push_back(bits);
+}
+
+ComputePipelinePermutations::ComputePipelinePermutations(ResourceManager& resourceManager, std::filesystem::path shaderPath,
+                                                         const VkPipelineLayout pipelineLayout, SpecializeFunction specialize)
+    : resourceManager(resourceManager), shaderPath(std::move(shaderPath)), pipelineLayout(pipelineLayout), specialize(std::move(specialize))
+{
+    shader = resourceManager.createResource<ShaderModule>(this->shaderPath);
+}
+
+ComputePipelinePermutations::~ComputePipelinePermutations()
+{
+    for (auto& pipeline : variants | std::views::values) {
+        resourceManager.destroyResource(std::move(pipeline));
+    }
+    resourceManager.destroyResourceImmediate(std::move(shader));
+}
+
+VkPipeline ComputePipelinePermutations::get(const uint32_t permutation)
+{
+    if (const auto it = variants.find(permutation); it != variants.end()) {
+        return it->second->pipeline;
+    }
+
+    SpecializationConstants constants{};
+    specialize(permutation, constants);
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.pNext = nullptr;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = shader->shader;
+    stageInfo.pName = "main";
+    stageInfo.pSpecializationInfo = constants.getInfo();
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = nullptr;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+    PipelinePtr pipeline = resourceManager.createResource<Pipeline>(pipelineInfo);
+    const VkPipeline handle = pipeline->pipeline;
+    variants.emplace(permutation, std::move(pipeline));
+    return handle;
+}
+
+void ComputePipelinePermutations::reset()
+{
+    // Compile first so a broken shader leaves the current variants untouched
+    ShaderModulePtr newShader = resourceManager.createResource<ShaderModule>(shaderPath);
+
+    for (auto& pipeline : variants | std::views::values) {
+        resourceManager.destroyResource(std::move(pipeline));
+    }
+    variants.clear();
+
+    resourceManager.destroyResourceImmediate(std::move(shader));
+    shader = std::move(newShader);
+}
+}
@@ -0,0 +1,92 @@
+//
+// Created by William on 2025-07-10.
+//
+
+#ifndef PIPELINE_PERMUTATIONS_H
+#define PIPELINE_PERMUTATIONS_H
+
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "resources_fwd.h"
+
+namespace will_engine::renderer
+{
+class ResourceManager;
+
+/**
+ * Packs specialization constant values for a single pipeline variant. All values are 4 bytes, bools are written as \code VkBool32\endcode.
+ */
+class SpecializationConstants
+{
+public:
+    void add(uint32_t constantId, bool value);
+
+    void add(uint32_t constantId, uint32_t value);
+
+    void add(uint32_t constantId, int32_t value);
+
+    void add(uint32_t constantId, float value);
+
+    /**
+     * @return nullptr if no constants were added. Invalidated by any further \code add\endcode.
+     */
+    const VkSpecializationInfo* getInfo();
+
+private:
+    void addRaw(uint32_t constantId, uint32_t bits);
+
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<uint32_t> data;
+    VkSpecializationInfo info{};
+};
+
+/**
+ * Lazily creates and caches one compute pipeline per permutation key of a single shader.
+ * The shader is compiled once, each variant only specializes it, so inactive feature branches are stripped by the driver rather than evaluated at runtime.
+ */
+class ComputePipelinePermutations
+{
+public:
+    /**
+     * Fills the specialization constants of the variant identified by \code permutation\endcode
+     */
+    using SpecializeFunction = std::function<void(uint32_t permutation, SpecializationConstants& constants)>;
+
+    ComputePipelinePermutations(ResourceManager& resourceManager, std::filesystem::path shaderPath, VkPipelineLayout pipelineLayout,
+                                SpecializeFunction specialize);
+
+    ~ComputePipelinePermutations();
+
+    ComputePipelinePermutations(const ComputePipelinePermutations&) = delete;
+
+    ComputePipelinePermutations& operator=(const ComputePipelinePermutations&) = delete;
+
+    /**
+     * @return the pipeline of \code permutation\endcode, created on first use
+     */
+    VkPipeline get(uint32_t permutation);
+
+    /**
+     * Recompiles the shader and discards every cached variant. Variants are recreated as they are requested again.
+     */
+    void reset();
+
+    [[nodiscard]] size_t getVariantCount() const { return variants.size(); }
+
+private:
+    ResourceManager& resourceManager;
+    std::filesystem::path shaderPath;
+    VkPipelineLayout pipelineLayout;
+    SpecializeFunction specialize;
+
+    ShaderModulePtr shader{};
+    std::unordered_map<uint32_t, PipelinePtr> variants;
+};
+}
+
+#endif //PIPELINE_PERMUTATIONS_H
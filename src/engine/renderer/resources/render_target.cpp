@@ -4,14 +4,44 @@
 
 #include "render_target.h"
 
+#include <volk/volk.h>
+
 #include "image.h"
+#include "engine/renderer/resource_manager.h"
+#include "engine/renderer/vk_helpers.h"
 
 namespace will_engine::renderer
 {
 RenderTarget::RenderTarget(ResourceManager* resourceManager, const VkImageCreateInfo& createInfo, const VmaAllocationCreateInfo& allocInfo,
-                           VkImageViewCreateInfo& viewInfo, const VkImageLayout afterClearFormat)
+                           VkImageViewCreateInfo& viewInfo)
     : Image(resourceManager, createInfo, allocInfo, viewInfo)
+{}
+
+RenderTarget::RenderTarget(ResourceManager* resourceManager, const VkImageCreateInfo& createInfo, VkImageViewCreateInfo& viewInfo,
+                           VmaAllocation aliasedAllocation, const VkDeviceSize allocationOffset)
+    : Image(resourceManager)
+{
+    bAliased = true;
+    imageFormat = createInfo.format;
+    imageExtent = createInfo.extent;
+    mipLevels = createInfo.mipLevels;
+    VK_CHECK(vmaCreateAliasingImage2(resourceManager->getAllocator(), aliasedAllocation, allocationOffset, &createInfo, &image));
+    viewInfo.image = image;
+    VK_CHECK(vkCreateImageView(resourceManager->getDevice(), &viewInfo, nullptr, &imageView));
+}
+
+RenderTarget::~RenderTarget()
 {
-    this->afterClearFormat = afterClearFormat;
+    // Aliased images don't own their allocation, so Image's destructor can't release them
+    if (bAliased) {
+        if (imageView != VK_NULL_HANDLE) {
+            vkDestroyImageView(manager->getDevice(), imageView, nullptr);
+            imageView = VK_NULL_HANDLE;
+        }
+        if (image != VK_NULL_HANDLE) {
+            vkDestroyImage(manager->getDevice(), image, nullptr);
+            image = VK_NULL_HANDLE;
+        }
+    }
 }
 }
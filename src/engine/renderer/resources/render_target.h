@@ -8,18 +8,24 @@
 
 namespace will_engine::renderer
 {
-
 struct RenderTarget : Image
 {
     /**
-     * The format the render target will be when the format first exits the
-    */
-    VkImageLayout afterClearFormat;
+     * True if the image is bound to memory it doesn't own (see \code RenderGraph\endcode transient images).
+     * Its contents are undefined at the start of every use, other images may overwrite them in between.
+     */
+    bool bAliased{false};
 
+    RenderTarget(ResourceManager* resourceManager, const VkImageCreateInfo& createInfo, const VmaAllocationCreateInfo& allocInfo, VkImageViewCreateInfo& viewInfo);
 
-    RenderTarget(ResourceManager* resourceManager, const VkImageCreateInfo& createInfo, const VmaAllocationCreateInfo& allocInfo, VkImageViewCreateInfo& viewInfo, VkImageLayout afterClearFormat);
-};
+    /**
+     * Creates the image inside of an existing allocation. The allocation must outlive the render target.
+     */
+    RenderTarget(ResourceManager* resourceManager, const VkImageCreateInfo& createInfo, VkImageViewCreateInfo& viewInfo, VmaAllocation aliasedAllocation,
+                 VkDeviceSize allocationOffset);
 
+    ~RenderTarget() override;
+};
 }
 
 #endif //RENDER_TARGET_H
@@ -18,6 +18,7 @@ struct ImageView;
 struct Image;
 struct ImageKtx;
 struct ImageResource;
+struct MemoryAllocation;
 struct Sampler;
 struct Pipeline;
 struct PipelineLayout;
@@ -32,6 +33,7 @@ using ImagePtr = std::unique_ptr<Image>;
 using ImageKtxPtr = std::unique_ptr<ImageKtx>;
 using ImageResourcePtr = std::unique_ptr<ImageResource>;
 using RenderTargetPtr = std::unique_ptr<RenderTarget>;
+using MemoryAllocationPtr = std::unique_ptr<MemoryAllocation>;
 using DescriptorSetLayoutPtr = std::unique_ptr<DescriptorSetLayout>;
 using SamplerPtr = std::unique_ptr<Sampler>;
 using PipelineLayoutPtr = std::unique_ptr<PipelineLayout>;
@@ -4,6 +4,8 @@
 
 #include "terrain_chunk.h"
 
+#include <algorithm>
+#include <fmt/format.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
 
@@ -13,34 +15,42 @@
 #include "engine/physics/physics.h"
 #include "engine/physics/physics_filters.h"
 #include "engine/physics/physics_utils.h"
+#include "engine/renderer/vk_helpers.h"
 
 namespace will_engine::terrain
 {
-TerrainChunk::TerrainChunk(renderer::ResourceManager& resourceManager, const std::vector<float>& heightMapData, int32_t width, int32_t height,
-                           TerrainConfig terrainConfig) : resourceManager(resourceManager),
-                                                          terrainConfig(terrainConfig)
+TerrainChunk::TerrainChunk(renderer::ResourceManager& resourceManager, const std::vector<float>& heightMapData, const int32_t width, const int32_t height,
+                           const TerrainConfig terrainConfig)
+    : TerrainChunk(resourceManager, buildMesh(heightMapData, width, height, terrainConfig, getCenteredPlacement(width, height)), getCenteredPlacement(width, height))
+{}
+
+TerrainChunk::TerrainChunk(renderer::ResourceManager& resourceManager, TerrainMeshData&& meshData, const TerrainChunkPlacement& placement)
+    : TerrainChunk(resourceManager, uploadMesh(resourceManager, std::move(meshData)), placement)
+{}
+
+TerrainChunk::TerrainChunk(renderer::ResourceManager& resourceManager, TerrainGpuMeshData&& meshData, const TerrainChunkPlacement& placement)
+    : resourceManager(resourceManager), gridWidth(meshData.width), gridHeight(meshData.height), placement(placement), terrainConfig(meshData.config),
+      heightImage(std::move(meshData.heightImage)), normalImage(std::move(meshData.normalImage))
 {
-    generateMesh(width, height, heightMapData);
-
-    const size_t vertexBufferSize = vertices.size() * sizeof(TerrainVertex);
-    renderer::BufferPtr vertexStagingBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Staging, vertexBufferSize);
-    memcpy(vertexStagingBuffer->info.pMappedData, vertices.data(), vertexBufferSize);
-    vertexBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-
-    const size_t indexBufferSize = indices.size() * sizeof(uint32_t);
-    renderer::BufferPtr indexStagingBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Staging, indexBufferSize);
-    memcpy(indexStagingBuffer->info.pMappedData, indices.data(), indexBufferSize);
-    indexBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device, indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
-
-    std::array<renderer::BufferCopyInfo, 2> bufferCopies = {
-        renderer::BufferCopyInfo(vertexStagingBuffer->buffer, 0, vertexBuffer->buffer, 0, vertexBufferSize),
-        {indexStagingBuffer->buffer,0, indexBuffer->buffer, 0, indexBufferSize},
+    heightmapDescriptorBuffer = resourceManager.createResource<renderer::DescriptorBufferSampler>(resourceManager.getTerrainHeightmapLayout(), 1);
+    std::vector<DescriptorImageData> heightmapDescriptors{
+        {
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            {.sampler = resourceManager.getDefaultSamplerNearest(), .imageView = heightImage->imageView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+            false
+        },
+        {
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            {.sampler = resourceManager.getDefaultSamplerNearest(), .imageView = normalImage->imageView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+            false
+        },
     };
+    heightmapDescriptorBuffer->setupData(heightmapDescriptors, 0);
 
-    resourceManager.copyBufferImmediate(bufferCopies);
-
-    resourceManager.destroyResourceImmediate(std::move(vertexStagingBuffer));
-    resourceManager.destroyResourceImmediate(std::move(indexStagingBuffer));
+    const glm::ivec2 patchCount = getPatchCount();
+    patchBoundsBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device,
+                                                                         sizeof(TerrainPatchBounds) * glm::max(patchCount.x * patchCount.y, 1));
+    patchBoundsAddress = resourceManager.getBufferAddress(*patchBoundsBuffer);
 
     for (int i{0}; i < FRAME_OVERLAP; i++) {
         terrainUniformBuffers[i] = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::HostSequential, sizeof(TerrainProperties));
@@ -55,18 +65,38 @@ TerrainChunk::TerrainChunk(renderer::ResourceManager& resourceManager, const std
     }
 
     // Physics
-    physics::Physics* physics = physics::Physics::get();
-    constexpr float halfWidth = static_cast<float>(512 - 1) * 0.5f;
-    constexpr float halfHeight = static_cast<float>(512 - 1) * 0.5f;
-    JPH::HeightFieldShapeSettings heightFieldSettings{
-        heightMapData.data(),
-        JPH::Vec3(-halfWidth, 0.0f, -halfHeight),
-        JPH::Vec3(1.0f, 1.0f, 1.0f),
-        512,
-        {},
-    };
+    if (placement.bCreatePhysics) {
+        if (meshData.heights.size() != static_cast<size_t>(gridWidth) * gridHeight) {
+            fmt::print("Warning: Terrain chunk has no height data on the CPU, no physics height field will be created\n");
+        }
+        else {
+            if (gridWidth != gridHeight) {
+                fmt::print("Warning: Terrain height fields must be square ({}x{}), physics will only use the first {} rows\n", gridWidth, gridHeight, gridWidth);
+            }
+
+            JPH::HeightFieldShapeSettings heightFieldSettings{
+                meshData.heights.data(),
+                JPH::Vec3(placement.origin.x, 0.0f, placement.origin.y),
+                JPH::Vec3(placement.sampleSpacing, 1.0f, placement.sampleSpacing),
+                static_cast<JPH::uint32>(gridWidth),
+                {},
+            };
+            // Heights are quantized over this range, leave room for sculpting (SetHeights can't grow it)
+            const auto [minHeight, maxHeight] = std::ranges::minmax(meshData.heights);
+            heightFieldSettings.mMinHeightValue = minHeight - TERRAIN_EDIT_HEIGHT_MARGIN;
+            heightFieldSettings.mMaxHeightValue = maxHeight + TERRAIN_EDIT_HEIGHT_MARGIN;
+
+            physics::Physics::get()->setupRigidbody(this, heightFieldSettings, JPH::EMotionType::Static, physics::Layers::TERRAIN);
+        }
+    }
 
-    physics->setupRigidbody(this, heightFieldSettings, JPH::EMotionType::Static, physics::Layers::TERRAIN);
+    // Jolt copied the heights, keep them for editing
+    if (meshData.heights.size() == static_cast<size_t>(gridWidth) * gridHeight) {
+        heights = std::move(meshData.heights);
+        const auto [minHeight, maxHeight] = std::ranges::minmax(heights);
+        minEditHeight = minHeight - TERRAIN_EDIT_HEIGHT_MARGIN;
+        maxEditHeight = maxHeight + TERRAIN_EDIT_HEIGHT_MARGIN;
+    }
 
     textureIds[0] = DEFAULT_TERRAIN_GRASS_TEXTURE_ID;
     textureIds[1] = DEFAULT_TERRAIN_ROCKS_TEXTURE_ID;
@@ -84,8 +114,10 @@ TerrainChunk::~TerrainChunk()
             terrainBodyId = JPH::BodyID(JPH::BodyID::cMaxBodyIndex);
         }
     }
-    resourceManager.destroyResource(std::move(vertexBuffer));
-    resourceManager.destroyResource(std::move(indexBuffer));
+    resourceManager.destroyResource(std::move(heightImage));
+    resourceManager.destroyResource(std::move(normalImage));
+    resourceManager.destroyResource(std::move(heightmapDescriptorBuffer));
+    resourceManager.destroyResource(std::move(patchBoundsBuffer));
 
     for (renderer::BufferPtr& terrainUniformBuffer : terrainUniformBuffers) {
         resourceManager.destroyResource(std::move(terrainUniformBuffer));
@@ -95,63 +127,75 @@ TerrainChunk::~TerrainChunk()
     resourceManager.destroyResource(std::move(uniformDescriptorBuffer));
 }
 
-void TerrainChunk::generateMesh(const int32_t width, const int32_t height, const std::vector<float>& heightData)
+void TerrainChunk::dirty()
 {
-    vertices.clear();
-    indices.clear();
-    vertices.reserve(width * height);
-
-    const float halfWidth = static_cast<float>(width - 1) * 0.5f;
-    const float halfHeight = static_cast<float>(height - 1) * 0.5f;
-
-    for (int32_t z = 0; z < height; z++) {
-        for (int32_t x = 0; x < width; x++) {
-            TerrainVertex vertex{};
-
-            const float xPos = static_cast<float>(x) - halfWidth;
-            const float zPos = static_cast<float>(z) - halfHeight;
-            const float yPos = heightData[z * width + x];
-
-            vertex.position = glm::vec3(xPos, yPos, zPos);
-
-            const float uvX = static_cast<float>(x) / static_cast<float>(width - 1);
-            const float uvY = static_cast<float>(z) / static_cast<float>(height - 1);
-            vertex.uv.x = uvX * terrainConfig.uvScale.x + terrainConfig.uvOffset.x;
-            vertex.uv.y = uvY * terrainConfig.uvScale.y + terrainConfig.uvOffset.y;
-
-            vertex.materialIndex = 0;
-
-            vertex.color = terrainConfig.baseColor;
-
-            vertices.push_back(vertex);
-        }
+    bIsPhysicsDirty = true;
+    if (physics::Physics* physics = physics::Physics::get()) {
+        physics->markTransformDirty(terrainBodyId);
     }
+}
 
-    for (int32_t z = 0; z < height; z++) {
-        for (int32_t x = 0; x < width; x++) {
-            vertices[z * width + x].normal = calculateNormal(x, z, width, height, heightData);
+TerrainMeshData TerrainChunk::buildMesh(const std::vector<float>& heightData, const int32_t width, const int32_t height, const TerrainConfig& terrainConfig,
+                                        const TerrainChunkPlacement& placement)
+{
+    TerrainMeshData meshData;
+    const int32_t border = placement.border;
+    meshData.width = width - border * 2;
+    meshData.height = height - border * 2;
+    meshData.config = terrainConfig;
+
+    const size_t sampleCount = static_cast<size_t>(meshData.width) * meshData.height;
+    meshData.heights.reserve(sampleCount);
+    std::vector<glm::vec3> normals;
+    normals.reserve(sampleCount);
+
+    for (int32_t z = 0; z < meshData.height; z++) {
+        for (int32_t x = 0; x < meshData.width; x++) {
+            meshData.heights.push_back(heightData[(z + border) * width + x + border]);
+            // Border samples let edge normals see the neighbouring tile's heights
+            normals.push_back(calculateNormal(x + border, z + border, width, height, heightData, placement.sampleSpacing));
         }
     }
 
-    smoothNormals(vertices, width, height);
+    smoothNormals(normals, meshData.width, meshData.height);
 
-    // Quads
-    for (uint32_t z = 0; z < height - 1; z++) {
-        for (uint32_t x = 0; x < width - 1; x++) {
-            // Top-left
-            indices.push_back(z * width + x);
-            // Top-right
-            indices.push_back(z * width + x + 1);
-            // Bottom-left
-            indices.push_back((z + 1) * width + x);
-            // Bottom-right
-            indices.push_back((z + 1) * width + x + 1);
-        }
+    meshData.normals.reserve(sampleCount);
+    for (const glm::vec3& normal : normals) {
+        meshData.normals.push_back(encodeNormal(normal));
     }
+
+    return meshData;
+}
+
+TerrainChunkPlacement TerrainChunk::getCenteredPlacement(const int32_t width, const int32_t height)
+{
+    return {
+        .origin = {-static_cast<float>(width - 1) * 0.5f, -static_cast<float>(height - 1) * 0.5f},
+        .sampleSpacing = 1.0f,
+        .border = 0,
+        .bCreatePhysics = true,
+    };
+}
+
+TerrainGpuMeshData TerrainChunk::uploadMesh(renderer::ResourceManager& resourceManager, TerrainMeshData&& meshData)
+{
+    TerrainGpuMeshData gpuMeshData;
+    gpuMeshData.width = meshData.width;
+    gpuMeshData.height = meshData.height;
+    gpuMeshData.config = meshData.config;
+
+    const VkExtent3D gridExtent{static_cast<uint32_t>(meshData.width), static_cast<uint32_t>(meshData.height), 1};
+    gpuMeshData.heightImage = resourceManager.createImageFromData(meshData.heights.data(), meshData.heights.size() * sizeof(float), gridExtent,
+                                                                  VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_SAMPLED_BIT);
+    gpuMeshData.normalImage = resourceManager.createImageFromData(meshData.normals.data(), meshData.normals.size() * sizeof(uint32_t), gridExtent,
+                                                                  VK_FORMAT_R16G16_SNORM, VK_IMAGE_USAGE_SAMPLED_BIT);
+    // Border samples are already cropped, the interior heights are exactly what the physics height field needs
+    gpuMeshData.heights = std::move(meshData.heights);
+    return gpuMeshData;
 }
 
 glm::vec3 TerrainChunk::calculateNormal(const int32_t x, const int32_t z, const int32_t width, const int32_t height,
-                                        const std::vector<float>& heightData)
+                                        const std::vector<float>& heightData, const float sampleSpacing)
 {
     const int32_t xLeft = glm::max(0, x - 1);
     const int32_t xRight = glm::min(width - 1, x + 1);
@@ -173,11 +217,11 @@ glm::vec3 TerrainChunk::calculateNormal(const int32_t x, const int32_t z, const
 
     const float scale = 1.0f / (4.0f * (xRight - xLeft));
 
-    const glm::vec3 normal(-dX * scale, 1.0f, -dZ * scale);
+    const glm::vec3 normal(-dX * scale, sampleSpacing, -dZ * scale);
     return glm::normalize(normal);
 }
 
-void TerrainChunk::smoothNormals(std::vector<TerrainVertex>& vertices, const int32_t width, const int32_t height)
+void TerrainChunk::smoothNormals(std::vector<glm::vec3>& normals, const int32_t width, const int32_t height)
 {
     std::vector<glm::vec3> smoothedNormals(width * height);
 
@@ -188,7 +232,7 @@ void TerrainChunk::smoothNormals(std::vector<TerrainVertex>& vertices, const int
 
             for (int32_t nz = glm::max(0, z - 1); nz <= glm::min(height - 1, z + 1); nz++) {
                 for (int32_t nx = glm::max(0, x - 1); nx <= glm::min(width - 1, x + 1); nx++) {
-                    avgNormal += vertices[nz * width + nx].normal;
+                    avgNormal += normals[nz * width + nx];
                     count++;
                 }
             }
@@ -200,20 +244,228 @@ void TerrainChunk::smoothNormals(std::vector<TerrainVertex>& vertices, const int
         }
     }
 
-    for (int32_t i = 0; i < width * height; i++) {
-        vertices[i].normal = smoothedNormals[i];
+    normals = std::move(smoothedNormals);
+}
+
+uint32_t TerrainChunk::encodeNormal(const glm::vec3& normal)
+{
+    glm::vec2 oct = glm::vec2(normal.x, normal.z) / (glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z));
+    // Terrain normals point up, but fold the lower hemisphere anyway so any unit vector round trips
+    if (normal.y < 0.0f) {
+        const glm::vec2 signs{oct.x >= 0.0f ? 1.0f : -1.0f, oct.y >= 0.0f ? 1.0f : -1.0f};
+        oct = (1.0f - glm::abs(glm::vec2(oct.y, oct.x))) * signs;
+    }
+
+    const auto x = static_cast<int16_t>(glm::round(glm::clamp(oct.x, -1.0f, 1.0f) * 32767.0f));
+    const auto y = static_cast<int16_t>(glm::round(glm::clamp(oct.y, -1.0f, 1.0f) * 32767.0f));
+    return static_cast<uint32_t>(static_cast<uint16_t>(x)) | static_cast<uint32_t>(static_cast<uint16_t>(y)) << 16;
+}
+
+size_t TerrainChunk::getMemoryUsage() const
+{
+    // Height (r32) and normal (rg16) textures, patch bounds, plus the heights kept on the CPU for editing
+    const size_t sampleCount = static_cast<size_t>(gridWidth) * gridHeight;
+    const glm::ivec2 patchCount = getPatchCount();
+    return sampleCount * (sizeof(float) + sizeof(uint32_t)) + static_cast<size_t>(patchCount.x) * patchCount.y * sizeof(TerrainPatchBounds)
+           + heights.size() * sizeof(float) + FRAME_OVERLAP * sizeof(TerrainProperties);
+}
+
+void TerrainChunk::update(VkCommandBuffer cmd, const int32_t currentFrameOverlap, const int32_t previousFrameOverlap)
+{
+    if (bufferFramesToUpdate > 0) {
+        const renderer::BufferPtr& currentFrameUniformBuffer = terrainUniformBuffers[currentFrameOverlap];
+        const auto pUniformBuffer = reinterpret_cast<TerrainProperties*>(static_cast<char*>(currentFrameUniformBuffer->info.pMappedData));
+        memcpy(pUniformBuffer, &terrainProperties, sizeof(TerrainProperties));
+
+        bufferFramesToUpdate--;
+    }
+
+    if (pendingUploadRect.isEmpty()) { return; }
+
+    // All edits since the last frame are uploaded together
+    const TerrainDirtyRect rect = pendingUploadRect;
+    pendingUploadRect = {};
+
+    std::vector<uint32_t> normals;
+    rebuildNormals(rect, normals);
+
+    const size_t rectSampleCount = static_cast<size_t>(rect.getWidth()) * rect.getHeight();
+    const size_t heightsSize = rectSampleCount * sizeof(float);
+    renderer::BufferPtr stagingBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Staging,
+                                                                                         heightsSize + rectSampleCount * sizeof(uint32_t));
+    auto* stagingHeights = static_cast<float*>(stagingBuffer->info.pMappedData);
+    for (int32_t z = rect.min.y; z < rect.max.y; z++) {
+        std::copy_n(heights.data() + static_cast<size_t>(z) * gridWidth + rect.min.x, rect.getWidth(),
+                    stagingHeights + static_cast<size_t>(z - rect.min.y) * rect.getWidth());
+    }
+    memcpy(static_cast<char*>(stagingBuffer->info.pMappedData) + heightsSize, normals.data(), normals.size() * sizeof(uint32_t));
+
+    VkBufferImageCopy copyRegion{};
+    copyRegion.bufferRowLength = 0;
+    copyRegion.bufferImageHeight = 0;
+    copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copyRegion.imageSubresource.mipLevel = 0;
+    copyRegion.imageSubresource.baseArrayLayer = 0;
+    copyRegion.imageSubresource.layerCount = 1;
+    copyRegion.imageOffset = {rect.min.x, rect.min.y, 0};
+    copyRegion.imageExtent = {static_cast<uint32_t>(rect.getWidth()), static_cast<uint32_t>(rect.getHeight()), 1};
+
+    // The transition waits for the previous frame's terrain draws to finish reading
+    renderer::vk_helpers::imageBarrier(cmd, heightImage.get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    renderer::vk_helpers::imageBarrier(cmd, normalImage.get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    copyRegion.bufferOffset = 0;
+    vkCmdCopyBufferToImage(cmd, stagingBuffer->buffer, heightImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+    copyRegion.bufferOffset = heightsSize;
+    vkCmdCopyBufferToImage(cmd, stagingBuffer->buffer, normalImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+    renderer::vk_helpers::imageBarrier(cmd, heightImage.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    renderer::vk_helpers::imageBarrier(cmd, normalImage.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+    bPatchBoundsDirty = true;
+
+    // Still read by this frame's command buffer
+    resourceManager.destroyResource(std::move(stagingBuffer));
+}
+
+bool TerrainChunk::applyBrush(const TerrainBrush& brush)
+{
+    if (heights.empty()) {
+        fmt::print("Warning: Terrain chunk has no height data on the CPU, it can't be edited\n");
+        return false;
+    }
+
+    const glm::vec2 gridCenter = (brush.center - placement.origin) / placement.sampleSpacing;
+    const float gridRadius = brush.radius / placement.sampleSpacing;
+    if (gridRadius <= 0.0f) { return false; }
+
+    TerrainDirtyRect rect{glm::ivec2(glm::floor(gridCenter - gridRadius)), glm::ivec2(glm::floor(gridCenter + gridRadius)) + 1};
+    rect = rect.expanded(0, gridWidth, gridHeight);
+    if (rect.isEmpty()) { return false; }
+
+    const float blend = glm::clamp(brush.strength, 0.0f, 1.0f);
+    // Computed separately so smoothing reads the unmodified neighbours
+    std::vector<float> newHeights;
+    newHeights.reserve(static_cast<size_t>(rect.getWidth()) * rect.getHeight());
+    for (int32_t z = rect.min.y; z < rect.max.y; z++) {
+        for (int32_t x = rect.min.x; x < rect.max.x; x++) {
+            float height = heights[z * gridWidth + x];
+            const float distance = glm::length(glm::vec2(x, z) - gridCenter) / gridRadius;
+            if (distance >= 1.0f) {
+                newHeights.push_back(height);
+                continue;
+            }
+
+            const float falloff = 1.0f - glm::smoothstep(0.0f, 1.0f, distance);
+            switch (brush.mode) {
+                case TerrainBrushMode::Raise:
+                    height += brush.strength * falloff;
+                    break;
+                case TerrainBrushMode::Lower:
+                    height -= brush.strength * falloff;
+                    break;
+                case TerrainBrushMode::Flatten:
+                    height = glm::mix(height, brush.targetHeight, blend * falloff);
+                    break;
+                case TerrainBrushMode::Smooth:
+                {
+                    float sum = 0.0f;
+                    int32_t count = 0;
+                    for (int32_t nz = glm::max(0, z - 1); nz <= glm::min(gridHeight - 1, z + 1); nz++) {
+                        for (int32_t nx = glm::max(0, x - 1); nx <= glm::min(gridWidth - 1, x + 1); nx++) {
+                            sum += heights[nz * gridWidth + nx];
+                            count++;
+                        }
+                    }
+                    height = glm::mix(height, sum / static_cast<float>(count), blend * falloff);
+                    break;
+                }
+            }
+
+            newHeights.push_back(glm::clamp(height, minEditHeight, maxEditHeight));
+        }
+    }
+
+    for (int32_t z = rect.min.y; z < rect.max.y; z++) {
+        std::copy_n(newHeights.data() + static_cast<size_t>(z - rect.min.y) * rect.getWidth(), rect.getWidth(),
+                    heights.data() + static_cast<size_t>(z) * gridWidth + rect.min.x);
     }
+
+    onHeightsChanged(rect);
+    return true;
 }
 
-void TerrainChunk::update(const int32_t currentFrameOverlap, const int32_t previousFrameOverlap)
+bool TerrainChunk::setHeights(const TerrainDirtyRect& rect, const std::span<const float> rectHeights)
 {
-    if (bufferFramesToUpdate <= 0) { return; }
+    if (heights.empty()) {
+        fmt::print("Warning: Terrain chunk has no height data on the CPU, it can't be edited\n");
+        return false;
+    }
+    if (rect.isEmpty() || rectHeights.size() != static_cast<size_t>(rect.getWidth()) * rect.getHeight()) {
+        fmt::print("Warning: Terrain height stamp size does not match its rectangle\n");
+        return false;
+    }
 
-    const renderer::BufferPtr& currentFrameUniformBuffer = terrainUniformBuffers[currentFrameOverlap];
-    const auto pUniformBuffer = reinterpret_cast<TerrainProperties*>(static_cast<char*>(currentFrameUniformBuffer->info.pMappedData));
-    memcpy(pUniformBuffer, &terrainProperties, sizeof(TerrainProperties));
+    // Parts of the stamp outside the chunk are ignored
+    const TerrainDirtyRect clippedRect = rect.expanded(0, gridWidth, gridHeight);
+    if (clippedRect.isEmpty()) { return false; }
+
+    for (int32_t z = clippedRect.min.y; z < clippedRect.max.y; z++) {
+        for (int32_t x = clippedRect.min.x; x < clippedRect.max.x; x++) {
+            const float height = rectHeights[static_cast<size_t>(z - rect.min.y) * rect.getWidth() + (x - rect.min.x)];
+            heights[z * gridWidth + x] = glm::clamp(height, minEditHeight, maxEditHeight);
+        }
+    }
 
-    bufferFramesToUpdate--;
+    onHeightsChanged(clippedRect);
+    return true;
+}
+
+void TerrainChunk::onHeightsChanged(const TerrainDirtyRect& rect)
+{
+    // Physics only uses the first gridWidth rows (square height fields)
+    if (terrainBodyId.GetIndex() != JPH::BodyID::cMaxBodyIndex) {
+        if (physics::Physics* physics = physics::Physics::get()) {
+            const int32_t physicsRows = glm::min(gridWidth, gridHeight);
+            if (rect.min.y < physicsRows) {
+                physics->setHeightFieldHeights(this, heights.data(), gridWidth, physicsRows, rect.min.x, rect.min.y, rect.getWidth(),
+                                               glm::min(rect.max.y, physicsRows) - rect.min.y);
+            }
+        }
+    }
+
+    // Normals are filtered twice (Sobel, then a 3x3 average), so they change up to 2 samples past the edited heights
+    pendingUploadRect.merge(rect.expanded(2, gridWidth, gridHeight));
+}
+
+void TerrainChunk::rebuildNormals(const TerrainDirtyRect& rect, std::vector<uint32_t>& outNormals) const
+{
+    const TerrainDirtyRect sobelRect = rect.expanded(1, gridWidth, gridHeight);
+    std::vector<glm::vec3> normals;
+    normals.reserve(static_cast<size_t>(sobelRect.getWidth()) * sobelRect.getHeight());
+    for (int32_t z = sobelRect.min.y; z < sobelRect.max.y; z++) {
+        for (int32_t x = sobelRect.min.x; x < sobelRect.max.x; x++) {
+            normals.push_back(calculateNormal(x, z, gridWidth, gridHeight, heights, placement.sampleSpacing));
+        }
+    }
+
+    // Same as smoothNormals, restricted to the rectangle
+    outNormals.clear();
+    outNormals.reserve(static_cast<size_t>(rect.getWidth()) * rect.getHeight());
+    for (int32_t z = rect.min.y; z < rect.max.y; z++) {
+        for (int32_t x = rect.min.x; x < rect.max.x; x++) {
+            glm::vec3 avgNormal(0.0f);
+            int count = 0;
+
+            for (int32_t nz = glm::max(0, z - 1); nz <= glm::min(gridHeight - 1, z + 1); nz++) {
+                for (int32_t nx = glm::max(0, x - 1); nx <= glm::min(gridWidth - 1, x + 1); nx++) {
+                    avgNormal += normals[(nz - sobelRect.min.y) * sobelRect.getWidth() + (nx - sobelRect.min.x)];
+                    count++;
+                }
+            }
+
+            outNormals.push_back(encodeNormal(normalize(avgNormal / static_cast<float>(count))));
+        }
+    }
 }
 
 void TerrainChunk::setTerrainBufferData(const TerrainProperties& terrainProperties, const std::array<uint32_t, MAX_TERRAIN_TEXTURE_COUNT>& textureIds)
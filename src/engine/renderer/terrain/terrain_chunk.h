@@ -6,6 +6,7 @@
 #define TERRAIN_CHUNK_H
 
 #include <array>
+#include <span>
 #include <glm/detail/type_quat.hpp>
 
 #include "terrain_constants.h"
@@ -16,23 +17,84 @@
 #include "engine/renderer/vk_types.h"
 #include "engine/renderer/assets/texture/texture_resource.h"
 #include "engine/renderer/resources/buffer.h"
+#include "engine/renderer/resources/image_resource.h"
 
 namespace will_engine::terrain
 {
 class TerrainChunk : public IPhysicsBody
 {
 public:
+    /**
+     * Centers the chunk on the world origin with a sample spacing of 1
+     */
     TerrainChunk(renderer::ResourceManager& resourceManager, const std::vector<float>& heightMapData, int32_t width, int32_t height, TerrainConfig terrainConfig);
 
-    ~TerrainChunk() override;
-
-    void generateMesh(int32_t width, int32_t height, const std::vector<float>& heightData);
+    /**
+     * Creates a chunk from a mesh built ahead of time (see \code buildMesh\endcode), e.g. on a background thread.
+     */
+    TerrainChunk(renderer::ResourceManager& resourceManager, TerrainMeshData&& meshData, const TerrainChunkPlacement& placement);
 
-    static glm::vec3 calculateNormal(int32_t x, int32_t z, int32_t width, int32_t height, const std::vector<float>& heightData);
+    /**
+     * Creates a chunk from textures generated on the GPU (see \code TerrainGenerator\endcode).
+     * \n The physics height field is built from \code meshData.heights\endcode, so it must have been read back if \code placement.bCreatePhysics\endcode is set.
+     */
+    TerrainChunk(renderer::ResourceManager& resourceManager, TerrainGpuMeshData&& meshData, const TerrainChunkPlacement& placement);
 
-    static void smoothNormals(std::vector<TerrainVertex>& vertices, int32_t width, int32_t height);
+    ~TerrainChunk() override;
 
-    void update(int32_t currentFrameOverlap, int32_t previousFrameOverlap);
+    /**
+     * Builds the height and normal samples the terrain shaders read. Does not touch any GPU or physics state, safe to call from any thread.
+     * @param heightData \code width * height\endcode samples, including \code placement.border\endcode samples around each edge
+     * @param width
+     * @param height
+     * @param terrainConfig
+     * @param placement
+     * @return
+     */
+    static TerrainMeshData buildMesh(const std::vector<float>& heightData, int32_t width, int32_t height, const TerrainConfig& terrainConfig,
+                                     const TerrainChunkPlacement& placement);
+
+    static glm::vec3 calculateNormal(int32_t x, int32_t z, int32_t width, int32_t height, const std::vector<float>& heightData, float sampleSpacing = 1.0f);
+
+    static void smoothNormals(std::vector<glm::vec3>& normals, int32_t width, int32_t height);
+
+    /**
+     * Centers a \code width * height\endcode grid on the world origin with a sample spacing of 1
+     */
+    static TerrainChunkPlacement getCenteredPlacement(int32_t width, int32_t height);
+
+    /**
+     * Octahedral encoding of a unit vector into two snorm16, matches \code octDecode\endcode in terrain.glsl
+     */
+    static uint32_t encodeNormal(const glm::vec3& normal);
+
+    /**
+     * Records the uploads of any edited heights/normals into \code cmd\endcode, before the terrain is drawn this frame
+     * @param cmd
+     * @param currentFrameOverlap
+     * @param previousFrameOverlap
+     */
+    void update(VkCommandBuffer cmd, int32_t currentFrameOverlap, int32_t previousFrameOverlap);
+
+    /**
+     * Sculpts the heights under the brush. Only the affected rectangle is recomputed, its normals and heights are uploaded on the next \code update\endcode and the physics height field is updated immediately.
+     * @param brush
+     * @return false if nothing was changed (brush outside the chunk, or the chunk has no CPU heights)
+     */
+    bool applyBrush(const TerrainBrush& brush);
+
+    /**
+     * Stamps heights into a rectangle of the chunk, same partial update as \code applyBrush\endcode
+     * @param rect in height samples
+     * @param rectHeights \code rect.getWidth() * rect.getHeight()\endcode row-major heights
+     * @return
+     */
+    bool setHeights(const TerrainDirtyRect& rect, std::span<const float> rectHeights);
+
+    /**
+     * Height samples kept on the CPU for editing, empty if the chunk was created without them
+     */
+    [[nodiscard]] const std::vector<float>& getHeights() const { return heights; }
 
     void setTerrainBufferData(const TerrainProperties& terrainProperties, const std::array<uint32_t, MAX_TERRAIN_TEXTURE_COUNT>& textureIds);
 
@@ -46,14 +108,53 @@ public:
     }
 
 public:
-    [[nodiscard]] const VkBuffer getVertexBuffer() const { return vertexBuffer->buffer; }
-    [[nodiscard]] const VkBuffer getIndexBuffer() const { return indexBuffer->buffer; }
+    /**
+     * Terrain is drawn without vertex or index buffers, each patch is 4 vertices whose positions are pulled from the height map
+     */
+    /**
+     * Tessellation patches along x and z, same as getPatchCount in terrain.glsl
+     */
+    [[nodiscard]] glm::ivec2 getPatchCount() const
+    {
+        return {(gridWidth - 1 + TERRAIN_PATCH_TEXELS - 1) / TERRAIN_PATCH_TEXELS, (gridHeight - 1 + TERRAIN_PATCH_TEXELS - 1) / TERRAIN_PATCH_TEXELS};
+    }
+
+    /**
+     * Grid patches followed by one skirt patch per edge patch if the chunk has skirts, 4 vertices each
+     */
+    [[nodiscard]] uint32_t getPatchVertexCount() const
+    {
+        const glm::ivec2 patchCount = getPatchCount();
+        const int32_t skirtPatchCount = placement.skirtDepth > 0.0f ? (patchCount.x + patchCount.y) * 2 : 0;
+        return static_cast<uint32_t>((patchCount.x * patchCount.y + skirtPatchCount) * 4);
+    }
+
+    [[nodiscard]] int32_t getGridWidth() const { return gridWidth; }
+    [[nodiscard]] int32_t getGridHeight() const { return gridHeight; }
+    [[nodiscard]] const TerrainChunkPlacement& getPlacement() const { return placement; }
+    [[nodiscard]] const TerrainConfig& getTerrainConfig() const { return terrainConfig; }
 
-    [[nodiscard]] size_t getIndexCount() const { return indices.size(); }
-    const std::vector<uint32_t>& getIndices() { return indices; }
+    /**
+     * Approximate CPU + GPU memory held by this chunk, used for streaming budgets
+     */
+    [[nodiscard]] size_t getMemoryUsage() const;
 
     [[nodiscard]] renderer::DescriptorBufferSampler* getTextureDescriptorBuffer() const { return textureDescriptorBuffer.get(); }
     [[nodiscard]] renderer::DescriptorBufferUniform* getUniformDescriptorBuffer() const { return uniformDescriptorBuffer.get(); }
+    [[nodiscard]] renderer::DescriptorBufferSampler* getHeightmapDescriptorBuffer() const { return heightmapDescriptorBuffer.get(); }
+
+    /**
+     * One \code PatchBounds\endcode (terrain.glsl) per grid patch, written by \code TerrainPipeline::updatePatchBounds\endcode
+     */
+    [[nodiscard]] renderer::Buffer* getPatchBoundsBuffer() const { return patchBoundsBuffer.get(); }
+    [[nodiscard]] VkDeviceAddress getPatchBoundsAddress() const { return patchBoundsAddress; }
+
+    /**
+     * True when the chunk was just created or its heights were uploaded since the patch bounds were last computed
+     */
+    [[nodiscard]] bool arePatchBoundsDirty() const { return bPatchBoundsDirty; }
+
+    void clearPatchBoundsDirty() { bPatchBoundsDirty = false; }
 
 public: // Physics
     void setTransform(const glm::vec3& position, const glm::quat& rotation) override {}
@@ -66,27 +167,46 @@ public: // Physics
 
     [[nodiscard]] JPH::BodyID getPhysicsBodyId() const override { return terrainBodyId; }
 
-    void dirty() override { bIsPhysicsDirty = true; }
+    void dirty() override;
 
     void undirty() override { bIsPhysicsDirty = false; }
 
     bool isTransformDirty() override { return bIsPhysicsDirty; }
 
+private:
+    static TerrainGpuMeshData uploadMesh(renderer::ResourceManager& resourceManager, TerrainMeshData&& meshData);
+
+    /**
+     * Pushes edited heights to physics and queues the GPU upload of \code rect\endcode, including the normals it affects
+     */
+    void onHeightsChanged(const TerrainDirtyRect& rect);
+
+    /**
+     * Recomputes the encoded normals of \code rect\endcode from the CPU heights, same filters as \code buildMesh\endcode.
+     * Border samples are gone after creation so edges clamp to the chunk.
+     */
+    void rebuildNormals(const TerrainDirtyRect& rect, std::vector<uint32_t>& outNormals) const;
+
 private:
     renderer::ResourceManager& resourceManager;
-    TerrainConfig terrainConfig;
 
 private: // Buffer Data
     TerrainProperties terrainProperties{};
     std::array<uint32_t, MAX_TERRAIN_TEXTURE_COUNT> textureIds{};
 
 private: // Model Data
-    std::vector<TerrainVertex> vertices;
-    std::vector<uint32_t> indices;
+    int32_t gridWidth{0};
+    int32_t gridHeight{0};
+    TerrainChunkPlacement placement{};
+    TerrainConfig terrainConfig{};
 
 private: // Buffer Data
-    renderer::BufferPtr vertexBuffer{};
-    renderer::BufferPtr indexBuffer{};
+    renderer::ImageResourcePtr heightImage{};
+    renderer::ImageResourcePtr normalImage{};
+    renderer::DescriptorBufferSamplerPtr heightmapDescriptorBuffer;
+    renderer::BufferPtr patchBoundsBuffer{};
+    VkDeviceAddress patchBoundsAddress{0};
+    bool bPatchBoundsDirty{true};
 
     renderer::DescriptorBufferSamplerPtr textureDescriptorBuffer;
     renderer::DescriptorBufferUniformPtr uniformDescriptorBuffer;
@@ -95,6 +215,18 @@ private: // Buffer Data
     std::vector<std::shared_ptr<renderer::TextureResource> > textureResources{};
     int32_t bufferFramesToUpdate{FRAME_OVERLAP};
 
+private: // Editing
+    /**
+     * Interior heights, edits are applied here first and then uploaded
+     */
+    std::vector<float> heights{};
+    float minEditHeight{0.0f};
+    float maxEditHeight{0.0f};
+    /**
+     * Heights and normals that changed since the last \code update\endcode
+     */
+    TerrainDirtyRect pendingUploadRect{};
+
 private: // Physics
     JPH::BodyID terrainBodyId{JPH::BodyID::cMaxBodyIndex};
 
@@ -12,6 +12,14 @@ static constexpr uint32_t DEFAULT_TERRAIN_GRASS_TEXTURE_ID{3813767237};
 static constexpr uint32_t DEFAULT_TERRAIN_ROCKS_TEXTURE_ID{219859308};
 static constexpr uint32_t DEFAULT_TERRAIN_SAND_TEXTURE_ID{3986109841};
 static constexpr int32_t MAX_TERRAIN_TEXTURE_COUNT{8};
+/**
+ * Sculpting can move heights this far past the generated min/max. The physics height field is quantized over this range so it can't grow later
+ */
+static constexpr float TERRAIN_EDIT_HEIGHT_MARGIN{64.0f};
+/**
+ * Heightmap texels along each edge of a tessellation patch, must match PATCH_TEXELS in terrain.glsl
+ */
+static constexpr int32_t TERRAIN_PATCH_TEXELS{16};
 
 }
 
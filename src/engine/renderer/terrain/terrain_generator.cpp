@@ -0,0 +1,222 @@
+//
+// Created by William on 2025-07-02.
+//
+
+#include "terrain_generator.h"
+
+#include <algorithm>
+#include <array>
+
+#include "engine/renderer/immediate_submitter.h"
+#include "engine/renderer/resource_manager.h"
+#include "engine/renderer/vk_helpers.h"
+#include "engine/renderer/resources/buffer.h"
+#include "engine/renderer/resources/image.h"
+#include "engine/renderer/resources/pipeline.h"
+#include "engine/renderer/resources/pipeline_layout.h"
+#include "engine/renderer/resources/shader_module.h"
+
+namespace will_engine::terrain
+{
+static constexpr uint32_t TERRAIN_GENERATION_GROUP_SIZE = 8;
+
+TerrainGenerator::TerrainGenerator(renderer::ResourceManager& resourceManager, renderer::ImmediateSubmitter& immediate)
+    : resourceManager(resourceManager), immediate(immediate)
+{
+    // Every pass reads and writes through buffer device addresses, no descriptor sets
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(TerrainGenerationPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 0;
+    layoutInfo.pSetLayouts = nullptr;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    pipelineLayout = resourceManager.createResource<renderer::PipelineLayout>(layoutInfo);
+
+    generateHeightsPipeline = createPipeline("shaders/terrain/terrain_generate_heights.comp");
+    normalizeHeightsPipeline = createPipeline("shaders/terrain/terrain_normalize_heights.comp");
+    generateNormalsPipeline = createPipeline("shaders/terrain/terrain_generate_normals.comp");
+    smoothNormalsPipeline = createPipeline("shaders/terrain/terrain_smooth_normals.comp");
+}
+
+TerrainGenerator::~TerrainGenerator()
+{
+    resourceManager.destroyResource(std::move(generateHeightsPipeline));
+    resourceManager.destroyResource(std::move(normalizeHeightsPipeline));
+    resourceManager.destroyResource(std::move(generateNormalsPipeline));
+    resourceManager.destroyResource(std::move(smoothNormalsPipeline));
+    resourceManager.destroyResource(std::move(pipelineLayout));
+}
+
+TerrainGpuMeshData TerrainGenerator::generate(const uint32_t width, const uint32_t height, const uint32_t seed, const NoiseSettings& settings,
+                                              const TerrainConfig& terrainConfig, const bool bReadbackHeights)
+{
+    TerrainGpuMeshData meshData;
+    meshData.width = static_cast<int32_t>(width);
+    meshData.height = static_cast<int32_t>(height);
+    meshData.config = terrainConfig;
+
+    const size_t sampleCount = static_cast<size_t>(width) * height;
+    const int32_t octaves = glm::max(settings.octaves, 0);
+
+    // Same random octave offsets as HeightmapUtil::generateFromNoise
+    renderer::BufferPtr octaveOffsetBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::HostSequential,
+                                                                                               sizeof(glm::vec2) * glm::max(octaves, 1));
+    const std::vector<glm::vec2> octaveOffsets = HeightmapUtil::generateOctaveOffsets(seed, settings);
+    std::ranges::copy(octaveOffsets, static_cast<glm::vec2*>(octaveOffsetBuffer->info.pMappedData));
+
+    renderer::BufferPtr heightBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device, sampleCount * sizeof(float),
+                                                                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    renderer::BufferPtr normalBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device, sampleCount * sizeof(glm::vec4));
+    renderer::BufferPtr encodedNormalBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device, sampleCount * sizeof(uint32_t),
+                                                                                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    renderer::BufferPtr heightRangeBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Device, sizeof(uint32_t) * 2);
+    renderer::BufferPtr readbackBuffer{};
+    if (bReadbackHeights) {
+        readbackBuffer = resourceManager.createResource<renderer::Buffer>(renderer::BufferType::Receiving, sampleCount * sizeof(float));
+    }
+
+    const VkExtent3D gridExtent{width, height, 1};
+    meshData.heightImage = resourceManager.createResource<renderer::Image>(gridExtent, VK_FORMAT_R32_SFLOAT,
+                                                                           VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, false);
+    meshData.normalImage = resourceManager.createResource<renderer::Image>(gridExtent, VK_FORMAT_R16G16_SNORM,
+                                                                           VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, false);
+
+    TerrainGenerationPushConstants pushConstants{};
+    pushConstants.heightBuffer = resourceManager.getBufferAddress(*heightBuffer);
+    pushConstants.normalBuffer = resourceManager.getBufferAddress(*normalBuffer);
+    pushConstants.encodedNormalBuffer = resourceManager.getBufferAddress(*encodedNormalBuffer);
+    pushConstants.heightRangeBuffer = resourceManager.getBufferAddress(*heightRangeBuffer);
+    pushConstants.octaveOffsetBuffer = resourceManager.getBufferAddress(*octaveOffsetBuffer);
+    pushConstants.size = {static_cast<int32_t>(width), static_cast<int32_t>(height)};
+    pushConstants.seed = static_cast<int32_t>(seed);
+    pushConstants.octaves = octaves;
+    pushConstants.invScale = 1.0f / settings.scale;
+    pushConstants.persistence = settings.persistence;
+    pushConstants.lacunarity = settings.lacunarity;
+    pushConstants.heightScale = settings.heightScale;
+
+    const uint32_t groupsX = (width + TERRAIN_GENERATION_GROUP_SIZE - 1) / TERRAIN_GENERATION_GROUP_SIZE;
+    const uint32_t groupsY = (height + TERRAIN_GENERATION_GROUP_SIZE - 1) / TERRAIN_GENERATION_GROUP_SIZE;
+
+    immediate.submit([&](VkCommandBuffer cmd) {
+        VkDebugUtilsLabelEXT label = {};
+        label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        label.pLabelName = "Terrain Generation";
+        vkCmdBeginDebugUtilsLabelEXT(cmd, &label);
+
+        vkCmdPushConstants(cmd, pipelineLayout->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(TerrainGenerationPushConstants), &pushConstants);
+
+        // Ordered uint min/max, see floatToOrderedUint in terrain_generation.glsl
+        vkCmdFillBuffer(cmd, heightRangeBuffer->buffer, 0, sizeof(uint32_t), 0xFFFFFFFF);
+        vkCmdFillBuffer(cmd, heightRangeBuffer->buffer, sizeof(uint32_t), sizeof(uint32_t), 0);
+        vk_helpers::bufferBarrier(cmd, heightRangeBuffer->buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, generateHeightsPipeline->pipeline);
+        vkCmdDispatch(cmd, groupsX, groupsY, 1);
+
+        // Normalization needs the range of the whole map
+        const std::array heightBarriers{
+            vk_helpers::BufferBarrierInfo{
+                heightBuffer->buffer,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT
+            },
+            vk_helpers::BufferBarrierInfo{
+                heightRangeBuffer->buffer,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT
+            },
+        };
+        vk_helpers::bufferBarriers(cmd, heightBarriers);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, normalizeHeightsPipeline->pipeline);
+        vkCmdDispatch(cmd, groupsX, groupsY, 1);
+
+        vk_helpers::bufferBarrier(cmd, heightBuffer->buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                  VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, generateNormalsPipeline->pipeline);
+        vkCmdDispatch(cmd, groupsX, groupsY, 1);
+
+        // Smoothing reads neighbouring normals, so it can't be fused with the Sobel pass
+        vk_helpers::bufferBarrier(cmd, normalBuffer->buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, smoothNormalsPipeline->pipeline);
+        vkCmdDispatch(cmd, groupsX, groupsY, 1);
+
+        vk_helpers::bufferBarrier(cmd, encodedNormalBuffer->buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+
+        vk_helpers::imageBarrier(cmd, meshData.heightImage.get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+        vk_helpers::imageBarrier(cmd, meshData.normalImage.get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+
+        VkBufferImageCopy copyRegion{};
+        copyRegion.bufferOffset = 0;
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel = 0;
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent = gridExtent;
+
+        vkCmdCopyBufferToImage(cmd, heightBuffer->buffer, meshData.heightImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        vkCmdCopyBufferToImage(cmd, encodedNormalBuffer->buffer, meshData.normalImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+        if (readbackBuffer) {
+            vk_helpers::copyBuffer(cmd, heightBuffer->buffer, 0, readbackBuffer->buffer, 0, sampleCount * sizeof(float));
+            // Make the copy visible to the host before the heights are read back
+            vk_helpers::bufferBarrier(cmd, readbackBuffer->buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                      VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT);
+        }
+
+        vk_helpers::imageBarrier(cmd, meshData.heightImage.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+        vk_helpers::imageBarrier(cmd, meshData.normalImage.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+
+        vkCmdEndDebugUtilsLabelEXT(cmd);
+    });
+
+    if (readbackBuffer) {
+        const auto heights = static_cast<const float*>(readbackBuffer->info.pMappedData);
+        meshData.heights.assign(heights, heights + sampleCount);
+    }
+
+    // Submit already waited on the GPU
+    resourceManager.destroyResourceImmediate(std::move(octaveOffsetBuffer));
+    resourceManager.destroyResourceImmediate(std::move(heightBuffer));
+    resourceManager.destroyResourceImmediate(std::move(normalBuffer));
+    resourceManager.destroyResourceImmediate(std::move(encodedNormalBuffer));
+    resourceManager.destroyResourceImmediate(std::move(heightRangeBuffer));
+    resourceManager.destroyResourceImmediate(std::move(readbackBuffer));
+
+    return meshData;
+}
+
+renderer::PipelinePtr TerrainGenerator::createPipeline(const char* shaderPath) const
+{
+    renderer::ShaderModulePtr shader = resourceManager.createResource<renderer::ShaderModule>(shaderPath);
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.pNext = nullptr;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = shader->shader;
+    stageInfo.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = nullptr;
+    pipelineInfo.layout = pipelineLayout->layout;
+    pipelineInfo.stage = stageInfo;
+
+    return resourceManager.createResource<renderer::Pipeline>(pipelineInfo);
+}
+}
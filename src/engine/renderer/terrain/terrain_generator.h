@@ -0,0 +1,78 @@
+//
+// Created by William on 2025-07-02.
+//
+
+#ifndef TERRAIN_GENERATOR_H
+#define TERRAIN_GENERATOR_H
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include "terrain_types.h"
+#include "engine/renderer/resources/resources_fwd.h"
+#include "engine/util/heightmap_utils.h"
+
+namespace will_engine::renderer
+{
+class ImmediateSubmitter;
+class ResourceManager;
+}
+
+namespace will_engine::terrain
+{
+struct TerrainGenerationPushConstants
+{
+    VkDeviceAddress heightBuffer;
+    VkDeviceAddress normalBuffer;
+    VkDeviceAddress encodedNormalBuffer;
+    VkDeviceAddress heightRangeBuffer;
+    VkDeviceAddress octaveOffsetBuffer;
+    glm::ivec2 size;
+    int32_t seed;
+    int32_t octaves;
+    float invScale;
+    float persistence;
+    float lacunarity;
+    float heightScale;
+};
+
+/**
+ * Compute shader equivalent of \code HeightmapUtil::generateFromNoise\endcode + \code TerrainChunk::buildMesh\endcode.
+ * Heights, Sobel normals and the smoothing pass all stay on the GPU and are copied straight into the terrain textures.
+ */
+class TerrainGenerator
+{
+public:
+    TerrainGenerator(renderer::ResourceManager& resourceManager, renderer::ImmediateSubmitter& immediate);
+
+    ~TerrainGenerator();
+
+    /**
+     * Blocks until the GPU is done.
+     * @param width
+     * @param height
+     * @param seed
+     * @param settings
+     * @param terrainConfig
+     * @param bReadbackHeights copies the heights back to the CPU (\code TerrainGpuMeshData::heights\endcode), needed for the physics height field
+     * @return
+     */
+    TerrainGpuMeshData generate(uint32_t width, uint32_t height, uint32_t seed, const NoiseSettings& settings, const TerrainConfig& terrainConfig,
+                                bool bReadbackHeights);
+
+private:
+    renderer::PipelinePtr createPipeline(const char* shaderPath) const;
+
+private:
+    renderer::ResourceManager& resourceManager;
+    renderer::ImmediateSubmitter& immediate;
+
+    renderer::PipelineLayoutPtr pipelineLayout{};
+    renderer::PipelinePtr generateHeightsPipeline{};
+    renderer::PipelinePtr normalizeHeightsPipeline{};
+    renderer::PipelinePtr generateNormalsPipeline{};
+    renderer::PipelinePtr smoothNormalsPipeline{};
+};
+}
+
+#endif //TERRAIN_GENERATOR_H
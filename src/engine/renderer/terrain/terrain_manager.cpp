@@ -4,7 +4,348 @@
 
 #include "terrain_manager.h"
 
-namespace will_engine {
-namespace terrain {
-} // terrain
-} // will_engine
\ No newline at end of file
+#include <algorithm>
+#include <ranges>
+
+#include "engine/core/engine.h"
+#include "engine/core/profiler/memory_tracker.h"
+#include "engine/core/profiler/trace_profiler.h"
+
+namespace will_engine::terrain
+{
+TerrainManager* TerrainManager::instance = nullptr;
+
+TerrainManager::TerrainManager(renderer::ResourceManager& resourceManager, const int32_t workerCount) : resourceManager(resourceManager)
+{
+    workers.reserve(glm::max(workerCount, 1));
+    for (int32_t i = 0; i < glm::max(workerCount, 1); ++i) {
+        workers.emplace_back([this](const std::stop_token& stopToken) { workerLoop(stopToken); });
+    }
+}
+
+TerrainManager::~TerrainManager()
+{
+    for (std::jthread& worker : workers) {
+        worker.request_stop();
+    }
+    queueCondition.notify_all();
+    workers.clear();
+
+    clear();
+}
+
+void TerrainManager::update(const glm::vec3& cameraPosition)
+{
+    if (!streamingSettings.bEnabled) {
+        if (!residentTiles.empty()) { clear(); }
+        return;
+    }
+
+    const glm::vec2 cameraPositionXZ{cameraPosition.x, cameraPosition.z};
+
+    frameRequests.clear();
+    frameRequestedKeys.clear();
+
+    // The root is always kept around as the last resort fallback
+    constexpr TerrainTileKey rootKey{0, 0, 0};
+    requestTile(rootKey, getDistanceToNode(rootKey, cameraPositionXZ));
+
+    std::vector<TerrainTile*> selectedTiles;
+    selectNode(rootKey, cameraPositionXZ, selectedTiles);
+
+    {
+        std::lock_guard lock(queueMutex);
+        pendingRequests.clear();
+        for (const TileRequest& request : frameRequests) {
+            if (!generatingTiles.contains(request.key)) {
+                pendingRequests.push_back(request);
+            }
+        }
+        std::ranges::sort(pendingRequests, [](const TileRequest& a, const TileRequest& b) { return a.distance > b.distance; });
+    }
+    queueCondition.notify_all();
+
+    uploadGeneratedTiles();
+
+    setActiveTiles(selectedTiles);
+
+    evictTiles(cameraPositionXZ);
+}
+
+bool TerrainManager::selectNode(const TerrainTileKey& key, const glm::vec2& cameraPosition, std::vector<TerrainTile*>& outTiles)
+{
+    const float distance = getDistanceToNode(key, cameraPosition);
+    if (distance > streamingSettings.viewDistance) {
+        // Nothing to draw, counts as covered
+        return true;
+    }
+
+    const auto residentIt = residentTiles.find(key);
+    TerrainTile* residentTile = residentIt != residentTiles.end() ? residentIt->second.get() : nullptr;
+
+    const bool bShouldSplit = key.level < streamingSettings.maxDepth && distance < streamingSettings.lodDistanceFactor * getNodeSize(key.level);
+    if (!bShouldSplit) {
+        if (residentTile) {
+            outTiles.push_back(residentTile);
+            return true;
+        }
+        requestTile(key, distance);
+        return false;
+    }
+
+    const size_t firstChildTile = outTiles.size();
+    bool bChildrenCovered = true;
+    for (int32_t i = 0; i < 4; ++i) {
+        const TerrainTileKey childKey{key.level + 1, key.x * 2 + (i & 1), key.z * 2 + (i >> 1)};
+        bChildrenCovered &= selectNode(childKey, cameraPosition, outTiles);
+    }
+
+    if (bChildrenCovered) { return true; }
+
+    // Draw this node instead of a partial set of children until they are all resident, avoids holes and overlapping tiles
+    if (residentTile) {
+        outTiles.resize(firstChildTile);
+        outTiles.push_back(residentTile);
+        return true;
+    }
+
+    return false;
+}
+
+void TerrainManager::requestTile(const TerrainTileKey& key, const float distance)
+{
+    if (residentTiles.contains(key)) { return; }
+    if (frameRequestedKeys.insert(key).second) {
+        frameRequests.push_back({key, distance});
+    }
+}
+
+void TerrainManager::workerLoop(const std::stop_token& stopToken)
+{
+    WILL_PROFILE_THREAD("Terrain Worker");
+    WILL_MEMORY_TAG(Terrain);
+    while (!stopToken.stop_requested()) {
+        TileRequest request;
+        TerrainStreamingSettings settings;
+        NoiseSettings noise;
+        TerrainConfig baseConfig;
+        uint32_t requestGeneration;
+        {
+            std::unique_lock lock(queueMutex);
+            if (!queueCondition.wait(lock, stopToken, [this] { return !pendingRequests.empty(); })) {
+                return;
+            }
+
+            request = pendingRequests.back();
+            pendingRequests.pop_back();
+            generatingTiles.insert(request.key);
+
+            settings = streamingSettings;
+            noise = noiseSettings;
+            baseConfig = terrainConfig;
+            requestGeneration = generation;
+        }
+
+        WILL_PROFILE_ZONE("Generate Terrain Tile");
+
+        const float rootSize = settings.tileSize * static_cast<float>(1 << settings.maxDepth);
+        const float nodeSize = rootSize / static_cast<float>(1 << request.key.level);
+        const glm::vec2 worldMin{-rootSize * 0.5f};
+        const glm::vec2 origin = worldMin + glm::vec2(request.key.x, request.key.z) * nodeSize;
+
+        GeneratedTile generatedTile;
+        generatedTile.key = request.key;
+        generatedTile.generation = requestGeneration;
+        generatedTile.placement = {
+            .origin = origin,
+            .sampleSpacing = nodeSize / static_cast<float>(settings.tileResolution - 1),
+            .border = 1,
+            .bCreatePhysics = request.key.level == settings.maxDepth,
+            // Neighbours can be any number of levels coarser, a gap along the shared edge is at most the noise height range
+            .skirtDepth = noise.heightScale,
+        };
+        const int32_t sampleCount = settings.tileResolution + generatedTile.placement.border * 2;
+
+        const float borderOffset = generatedTile.placement.sampleSpacing * static_cast<float>(generatedTile.placement.border);
+        const std::vector<float> heights = HeightmapUtil::generateTileFromNoise(sampleCount, sampleCount, settings.seed, noise, origin - glm::vec2(borderOffset),
+                                                                                generatedTile.placement.sampleSpacing);
+
+        // Texture coordinates continue across tiles, one repeat per finest tile
+        TerrainConfig tileConfig = baseConfig;
+        tileConfig.uvScale = baseConfig.uvScale * (nodeSize / settings.tileSize);
+        tileConfig.uvOffset = baseConfig.uvOffset + baseConfig.uvScale * ((origin - worldMin) / settings.tileSize);
+
+        generatedTile.meshData = TerrainChunk::buildMesh(heights, sampleCount, sampleCount, tileConfig, generatedTile.placement);
+
+        std::lock_guard lock(queueMutex);
+        completedTiles.push_back(std::move(generatedTile));
+    }
+}
+
+void TerrainManager::uploadGeneratedTiles()
+{
+    std::vector<GeneratedTile> tilesToUpload;
+    {
+        std::lock_guard lock(queueMutex);
+        const size_t uploadCount = glm::min(completedTiles.size(), static_cast<size_t>(glm::max(streamingSettings.maxUploadsPerFrame, 1)));
+
+        // Anything no longer requested is dropped without an upload
+        for (auto it = completedTiles.begin(); it != completedTiles.end();) {
+            if (it->generation != generation || !frameRequestedKeys.contains(it->key)) {
+                generatingTiles.erase(it->key);
+                it = completedTiles.erase(it);
+                continue;
+            }
+            if (tilesToUpload.size() < uploadCount) {
+                generatingTiles.erase(it->key);
+                tilesToUpload.push_back(std::move(*it));
+                it = completedTiles.erase(it);
+                continue;
+            }
+            ++it;
+        }
+    }
+
+    TerrainProperties terrainProperties{};
+    terrainProperties.maxHeight = noiseSettings.heightScale;
+
+    for (GeneratedTile& generatedTile : tilesToUpload) {
+        if (residentTiles.contains(generatedTile.key)) { continue; }
+
+        auto chunk = std::make_unique<TerrainChunk>(resourceManager, std::move(generatedTile.meshData), generatedTile.placement);
+        chunk->setTerrainBufferData(terrainProperties, TerrainChunk::getDefaultTextureIds());
+        memoryUsage += chunk->getMemoryUsage();
+
+        residentTiles.emplace(generatedTile.key, std::make_unique<TerrainTile>(generatedTile.key, std::move(chunk)));
+    }
+}
+
+void TerrainManager::setActiveTiles(const std::vector<TerrainTile*>& tiles)
+{
+    Engine* engine = Engine::get();
+    const std::unordered_set<TerrainTile*> newActiveTiles{tiles.begin(), tiles.end()};
+
+    for (TerrainTile* tile : activeTiles) {
+        if (!newActiveTiles.contains(tile) && engine) {
+            engine->removeFromActiveTerrain(tile);
+        }
+    }
+
+    for (TerrainTile* tile : newActiveTiles) {
+        if (!activeTiles.contains(tile) && engine) {
+            engine->addToActiveTerrain(tile);
+        }
+    }
+
+    activeTiles = newActiveTiles;
+}
+
+void TerrainManager::evictTiles(const glm::vec2& cameraPosition)
+{
+    const size_t memoryBudget = static_cast<size_t>(glm::max(streamingSettings.memoryBudgetMb, 0)) * 1024 * 1024;
+    if (memoryUsage <= memoryBudget) { return; }
+
+    std::vector<std::pair<float, TerrainTileKey>> candidates;
+    candidates.reserve(residentTiles.size());
+    for (const auto& [key, tile] : residentTiles) {
+        if (activeTiles.contains(tile.get()) || key.level == 0) { continue; }
+        candidates.emplace_back(getDistanceToNode(key, cameraPosition), key);
+    }
+
+    std::ranges::sort(candidates, [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (const auto& key : candidates | std::views::values) {
+        if (memoryUsage <= memoryBudget) { break; }
+        releaseTile(key);
+    }
+}
+
+void TerrainManager::releaseTile(const TerrainTileKey& key)
+{
+    const auto it = residentTiles.find(key);
+    if (it == residentTiles.end()) { return; }
+
+    TerrainTile* tile = it->second.get();
+    if (activeTiles.erase(tile) > 0) {
+        if (Engine* engine = Engine::get()) {
+            engine->removeFromActiveTerrain(tile);
+        }
+    }
+
+    if (const TerrainChunk* chunk = tile->getTerrainChunk()) {
+        memoryUsage -= glm::min(memoryUsage, chunk->getMemoryUsage());
+    }
+    residentTiles.erase(it);
+}
+
+void TerrainManager::clear()
+{
+    setActiveTiles({});
+    residentTiles.clear();
+    memoryUsage = 0;
+
+    std::lock_guard lock(queueMutex);
+    pendingRequests.clear();
+    // Tiles mid-generation still finish, this drops them when they are uploaded
+    generation++;
+    for (const GeneratedTile& completedTile : completedTiles) {
+        generatingTiles.erase(completedTile.key);
+    }
+    completedTiles.clear();
+}
+
+void TerrainManager::setStreamingSettings(const TerrainStreamingSettings& settings)
+{
+    TerrainStreamingSettings newSettings = settings;
+    newSettings.tileSize = glm::max(newSettings.tileSize, 1.0f);
+    newSettings.tileResolution = glm::clamp(newSettings.tileResolution, 3, 1025);
+    newSettings.maxDepth = glm::clamp(newSettings.maxDepth, 0, 12);
+    newSettings.lodDistanceFactor = glm::max(newSettings.lodDistanceFactor, 0.0f);
+    newSettings.maxUploadsPerFrame = glm::max(newSettings.maxUploadsPerFrame, 1);
+
+    const bool bLayoutChanged = newSettings.tileSize != streamingSettings.tileSize || newSettings.tileResolution != streamingSettings.tileResolution ||
+                                newSettings.maxDepth != streamingSettings.maxDepth || newSettings.seed != streamingSettings.seed;
+    if (bLayoutChanged) {
+        clear();
+    }
+
+    std::lock_guard lock(queueMutex);
+    streamingSettings = newSettings;
+}
+
+void TerrainManager::setNoiseSettings(const NoiseSettings& settings)
+{
+    clear();
+
+    std::lock_guard lock(queueMutex);
+    noiseSettings = settings;
+}
+
+size_t TerrainManager::getPendingTileCount()
+{
+    std::lock_guard lock(queueMutex);
+    return pendingRequests.size() + generatingTiles.size();
+}
+
+float TerrainManager::getRootSize() const
+{
+    return streamingSettings.tileSize * static_cast<float>(1 << streamingSettings.maxDepth);
+}
+
+float TerrainManager::getNodeSize(const int32_t level) const
+{
+    return getRootSize() / static_cast<float>(1 << level);
+}
+
+glm::vec2 TerrainManager::getNodeOrigin(const TerrainTileKey& key) const
+{
+    const float nodeSize = getNodeSize(key.level);
+    return glm::vec2(-getRootSize() * 0.5f) + glm::vec2(key.x, key.z) * nodeSize;
+}
+
+float TerrainManager::getDistanceToNode(const TerrainTileKey& key, const glm::vec2& cameraPosition) const
+{
+    const glm::vec2 nodeMin = getNodeOrigin(key);
+    const glm::vec2 nodeMax = nodeMin + glm::vec2(getNodeSize(key.level));
+    return glm::distance(cameraPosition, glm::clamp(cameraPosition, nodeMin, nodeMax));
+}
+} // will_engine::terrain
@@ -4,28 +4,205 @@
 
 #ifndef TERRAIN_MANAGER_H
 #define TERRAIN_MANAGER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "terrain_types.h"
+#include "engine/core/game_object/terrain.h"
 #include "engine/renderer/resource_manager.h"
+#include "engine/util/heightmap_utils.h"
 
 
-namespace will_engine::terrain {
+namespace will_engine::terrain
+{
+struct TerrainTileKey
+{
+    int32_t level{0};
+    int32_t x{0};
+    int32_t z{0};
 
-class TerrainManager {
-    static TerrainManager* Get() { return instance; }
-    static void Set(TerrainManager* manager) { instance = manager; }
-    static TerrainManager* instance;
+    bool operator==(const TerrainTileKey& other) const = default;
+};
+
+struct TerrainTileKeyHasher
+{
+    size_t operator()(const TerrainTileKey& key) const
+    {
+        return std::hash<uint64_t>{}(static_cast<uint64_t>(key.level) << 56 ^ static_cast<uint64_t>(static_cast<uint32_t>(key.x)) << 28 ^ static_cast<uint32_t>(key.z));
+    }
+};
 
+/**
+ * A resident quadtree tile. Goes through the engine's active terrain set, so it is drawn and casts shadows like any other terrain.
+ */
+class TerrainTile final : public ITerrain
+{
 public:
+    TerrainTile(const TerrainTileKey key, std::unique_ptr<TerrainChunk> chunk) : key(key), chunk(std::move(chunk)) {}
 
-    explicit TerrainManager(renderer::ResourceManager& resourceManager)
-        : resourceManager(resourceManager) {}
+    TerrainChunk* getTerrainChunk() override { return chunk.get(); }
 
+    /**
+     * Tiles are generated by the \code TerrainManager\endcode
+     */
+    void generateTerrain() override {}
+
+    void generateTerrain(const TerrainProperties terrainProperties, const std::array<uint32_t, MAX_TERRAIN_TEXTURE_COUNT> textures) override
+    {
+        if (chunk) { chunk->setTerrainBufferData(terrainProperties, textures); }
+    }
+
+    void destroyTerrain() override { chunk.reset(); }
+
+    [[nodiscard]] TerrainTileKey getKey() const { return key; }
 
 private:
-    renderer::ResourceManager& resourceManager;
+    TerrainTileKey key;
+    std::unique_ptr<TerrainChunk> chunk;
 };
 
-} // terrain
-// will_engine
+/**
+ * Streams a quadtree of terrain tiles around the camera.
+ * \n Every tile has the same sample resolution, so deeper levels are finer. Heights and meshes are generated on worker threads,
+ * uploads and physics registration (finest level only) happen on the main thread a few tiles per frame.
+ * Tiles that are not drawn are kept as a cache and evicted farthest first once the memory budget is exceeded.
+ * \n Neighbouring tiles of different levels sample heights at different spacings, every tile has skirts to hide the cracks along their edges.
+ */
+class TerrainManager
+{
+public:
+    static TerrainManager* get() { return instance; }
+    static void set(TerrainManager* manager) { instance = manager; }
+
+    explicit TerrainManager(renderer::ResourceManager& resourceManager, int32_t workerCount = 2);
+
+    ~TerrainManager();
+
+    TerrainManager(const TerrainManager&) = delete;
+
+    TerrainManager& operator=(const TerrainManager&) = delete;
+
+    /**
+     * Selects the tiles to draw around the camera, queues missing tiles, uploads finished ones and evicts over budget. Main thread only.
+     * @param cameraPosition
+     */
+    void update(const glm::vec3& cameraPosition);
+
+    /**
+     * Releases every tile. Tiles being generated are discarded when they complete.
+     */
+    void clear();
+
+    [[nodiscard]] TerrainStreamingSettings getStreamingSettings() const { return streamingSettings; }
+
+    /**
+     * Changing the tile layout or seed regenerates all tiles.
+     * @param settings
+     */
+    void setStreamingSettings(const TerrainStreamingSettings& settings);
+
+    [[nodiscard]] NoiseSettings getNoiseSettings() const { return noiseSettings; }
+
+    void setNoiseSettings(const NoiseSettings& settings);
+
+public: // Stats
+    [[nodiscard]] size_t getResidentTileCount() const { return residentTiles.size(); }
+    [[nodiscard]] size_t getActiveTileCount() const { return activeTiles.size(); }
+    [[nodiscard]] size_t getMemoryUsage() const { return memoryUsage; }
+    [[nodiscard]] size_t getPendingTileCount();
+
+private:
+    struct TileRequest
+    {
+        TerrainTileKey key;
+        float distance;
+    };
+
+    struct GeneratedTile
+    {
+        TerrainTileKey key;
+        uint32_t generation;
+        TerrainMeshData meshData;
+        TerrainChunkPlacement placement;
+    };
+
+    void workerLoop(const std::stop_token& stopToken);
+
+    /**
+     * Fills \code outTiles\endcode with the tiles to draw under this node.
+     * @return true if the node's area is fully covered by resident tiles
+     */
+    bool selectNode(const TerrainTileKey& key, const glm::vec2& cameraPosition, std::vector<TerrainTile*>& outTiles);
+
+    void requestTile(const TerrainTileKey& key, float distance);
+
+    void uploadGeneratedTiles();
+
+    void evictTiles(const glm::vec2& cameraPosition);
+
+    void setActiveTiles(const std::vector<TerrainTile*>& tiles);
+
+    void releaseTile(const TerrainTileKey& key);
+
+    [[nodiscard]] float getRootSize() const;
+
+    [[nodiscard]] float getNodeSize(int32_t level) const;
+
+    [[nodiscard]] glm::vec2 getNodeOrigin(const TerrainTileKey& key) const;
+
+    [[nodiscard]] float getDistanceToNode(const TerrainTileKey& key, const glm::vec2& cameraPosition) const;
+
+private:
+    static TerrainManager* instance;
+
+    renderer::ResourceManager& resourceManager;
+
+    TerrainStreamingSettings streamingSettings{};
+    NoiseSettings noiseSettings{
+        .scale = 100.0f,
+        .persistence = 0.5f,
+        .lacunarity = 2.0f,
+        .octaves = 4,
+        .offset = {0.0f, 0.0f},
+        .heightScale = 50.0f
+    };
+    TerrainConfig terrainConfig{
+        .uvOffset = {0.0f, 0.0f},
+        .uvScale = {1.0f, 1.0f},
+        .baseColor = {1.0f, 1.0f, 1.0f, 1.0f}
+    };
+
+    std::unordered_map<TerrainTileKey, std::unique_ptr<TerrainTile>, TerrainTileKeyHasher> residentTiles;
+    std::unordered_set<TerrainTile*> activeTiles;
+    std::vector<TileRequest> frameRequests;
+    std::unordered_set<TerrainTileKey, TerrainTileKeyHasher> frameRequestedKeys;
+    size_t memoryUsage{0};
+
+private: // Shared with workers, guarded by queueMutex
+    std::mutex queueMutex;
+    std::condition_variable_any queueCondition;
+    /**
+     * Sorted farthest first, workers take from the back
+     */
+    std::vector<TileRequest> pendingRequests;
+    /**
+     * Tiles that are being generated or waiting to be uploaded
+     */
+    std::unordered_set<TerrainTileKey, TerrainTileKeyHasher> generatingTiles;
+    std::vector<GeneratedTile> completedTiles;
+    /**
+     * Bumped whenever generation inputs change so stale results are dropped
+     */
+    uint32_t generation{0};
+
+    std::vector<std::jthread> workers;
+};
+} // will_engine::terrain
 
 #endif //TERRAIN_MANAGER_H
@@ -5,23 +5,17 @@
 #ifndef TERRAIN_TYPES_H
 #define TERRAIN_TYPES_H
 #include <cstdint>
+#include <vector>
 #include <glm/glm.hpp>
 #include <json/json.hpp>
 
+#include "engine/renderer/resources/resources_fwd.h"
+
 namespace will_engine::terrain
 {
 using ordered_json = nlohmann::ordered_json;
 
 
-struct TerrainVertex
-{
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec2 uv;
-    int32_t materialIndex;
-    glm::vec4 color;
-};
-
 struct TerrainConfig
 {
     glm::vec2 uvOffset;
@@ -42,6 +36,172 @@ struct TerrainProperties
     float maxHeight = 100.0f;
 };
 
+/**
+ * Height and normal samples of a chunk, uploaded as textures and sampled by the terrain shaders. Excludes border samples.
+ */
+struct TerrainMeshData
+{
+    int32_t width{0};
+    int32_t height{0};
+    std::vector<float> heights;
+    /**
+     * Octahedral encoded normals, two snorm16 packed per sample (x in the low bits)
+     */
+    std::vector<uint32_t> normals;
+    TerrainConfig config{};
+};
+
+/**
+ * Height and normal textures of a chunk generated on the GPU (see \code TerrainGenerator\endcode), in the same formats as the uploaded \code TerrainMeshData\endcode.
+ */
+struct TerrainGpuMeshData
+{
+    int32_t width{0};
+    int32_t height{0};
+    renderer::ImageResourcePtr heightImage{};
+    renderer::ImageResourcePtr normalImage{};
+    /**
+     * Heights read back for the physics height field, empty if the readback was not requested
+     */
+    std::vector<float> heights;
+    TerrainConfig config{};
+};
+
+/**
+ * Where a chunk's height samples sit in the world
+ */
+struct TerrainChunkPlacement
+{
+    /**
+     * World XZ of the first (non-border) height sample
+     */
+    glm::vec2 origin{0.0f};
+    float sampleSpacing{1.0f};
+    /**
+     * Extra samples around each edge of the height data, only used to compute seamless normals
+     */
+    int32_t border{0};
+    bool bCreatePhysics{true};
+    /**
+     * How far the skirts around the chunk's edges hang below the surface, 0 draws none. Streamed tiles need them to hide the cracks
+     * against neighbours of a different quadtree level.
+     */
+    float skirtDepth{0.0f};
+};
+
+/**
+ * Height range and normal cone of one tessellation patch, matches \code PatchBounds\endcode in terrain.glsl
+ */
+struct TerrainPatchBounds
+{
+    float minHeight;
+    float maxHeight;
+    uint32_t coneAxis;
+    float coneCutoff;
+};
+
+/**
+ * Rectangle of a chunk's height samples, \code min\endcode inclusive and \code max\endcode exclusive
+ */
+struct TerrainDirtyRect
+{
+    glm::ivec2 min{0};
+    glm::ivec2 max{0};
+
+    [[nodiscard]] bool isEmpty() const { return max.x <= min.x || max.y <= min.y; }
+
+    [[nodiscard]] int32_t getWidth() const { return max.x - min.x; }
+    [[nodiscard]] int32_t getHeight() const { return max.y - min.y; }
+
+    void merge(const TerrainDirtyRect& other)
+    {
+        if (other.isEmpty()) { return; }
+        if (isEmpty()) {
+            *this = other;
+            return;
+        }
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    [[nodiscard]] TerrainDirtyRect expanded(const int32_t amount, const int32_t width, const int32_t height) const
+    {
+        return {glm::max(min - amount, glm::ivec2(0)), glm::min(max + amount, glm::ivec2(width, height))};
+    }
+};
+
+enum class TerrainBrushMode : uint8_t
+{
+    Raise,
+    Lower,
+    /**
+     * Moves heights towards \code TerrainBrush::targetHeight\endcode
+     */
+    Flatten,
+    /**
+     * Moves heights towards the average of their neighbours
+     */
+    Smooth,
+};
+
+struct TerrainBrush
+{
+    /**
+     * World XZ
+     */
+    glm::vec2 center{0.0f};
+    float radius{8.0f};
+    /**
+     * Height change at the center per application for Raise/Lower, blend factor (0-1) for Flatten/Smooth. Falls off smoothly towards the radius
+     */
+    float strength{1.0f};
+    TerrainBrushMode mode{TerrainBrushMode::Raise};
+    float targetHeight{0.0f};
+};
+
+struct TerrainStreamingSettings
+{
+    bool bEnabled{false};
+    /**
+     * World size of the finest tiles. The quadtree root covers \code tileSize * 2^maxDepth\endcode
+     */
+    float tileSize{256.0f};
+    /**
+     * Height samples along each side of a tile, every level has the same resolution
+     */
+    int32_t tileResolution{129};
+    int32_t maxDepth{4};
+    /**
+     * A node splits when the camera is closer than \code lodDistanceFactor * nodeSize\endcode
+     */
+    float lodDistanceFactor{1.5f};
+    float viewDistance{3000.0f};
+    int32_t memoryBudgetMb{256};
+    int32_t maxUploadsPerFrame{2};
+    uint32_t seed{13};
+};
+
+struct TerrainTessellationSettings
+{
+    /**
+     * Target on-screen length of a tessellated edge in pixels. Lower values tessellate more densely
+     */
+    float targetEdgeLength{16.0f};
+    /**
+     * Both max levels are also capped at the texels a patch edge covers (\code TERRAIN_PATCH_TEXELS\endcode), one segment per heightmap cell
+     */
+    float maxTessLevel{16.0f};
+    /**
+     * Target length of a tessellated edge in the shadow cascades, in shadow map texels
+     */
+    float shadowTargetEdgeLength{32.0f};
+    float shadowMaxTessLevel{16.0f};
+    /**
+     * Discard patches outside the view frustum or facing away from the camera (light for shadows) in the control shader
+     */
+    bool bCullPatches{true};
+};
+
 inline void to_json(ordered_json& j, const TerrainConfig& config)
 {
     j = {
@@ -39,11 +39,21 @@ struct SceneData
      * x,y is current; z,w is previous
      */
     glm::vec4 jitter{0.0f};
+    /**
+     * Rendered region / allocated render target size. x,y is current; z,w is previous
+     */
+    glm::vec4 viewportScale{1.0f};
 
     // vec4 + vec4
     DirectionalLightData mainLightData{};
 
+    /**
+     * Size of the rendered region, can be smaller than the render targets with dynamic resolution
+     */
     glm::vec2 renderTargetSize{};
+    /**
+     * 1 / size of the render targets
+     */
     glm::vec2 texelSize{};
 
     glm::vec2 cameraPlanes{1000.0f, 0.1f};
@@ -25,6 +25,7 @@ VulkanContext::VulkanContext(SDL_Window* window, bool useValidationLayers)
             .use_default_debug_messenger()
             .require_api_version(1, 3)
             .enable_extensions(enabledInstanceExtensions)
+            .set_headless(window == nullptr)
             .build();
 
     vkb::Instance vkb_inst = inst_ret.value();
@@ -32,7 +33,9 @@ VulkanContext::VulkanContext(SDL_Window* window, bool useValidationLayers)
     volkLoadInstance(instance);
     debugMessenger = vkb_inst.debug_messenger;
 
-    SDL_Vulkan_CreateSurface(window, instance, nullptr, &surface);
+    if (window) {
+        SDL_Vulkan_CreateSurface(window, instance, nullptr, &surface);
+    }
 
     // vk 1.3
     VkPhysicalDeviceVulkan13Features features{};
@@ -48,6 +51,7 @@ VulkanContext::VulkanContext(SDL_Window* window, bool useValidationLayers)
     features12.runtimeDescriptorArray = VK_TRUE;
     features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
     features12.drawIndirectCount = VK_TRUE;
+    features12.timelineSemaphore = VK_TRUE;
 
     VkPhysicalDeviceFeatures otherFeatures{};
     otherFeatures.multiDrawIndirect = VK_TRUE;
@@ -73,6 +77,11 @@ VulkanContext::VulkanContext(SDL_Window* window, bool useValidationLayers)
             .select()
             .value();
 
+    // Only used for profiling, so not required
+    VkPhysicalDeviceFeatures optionalFeatures{};
+    optionalFeatures.pipelineStatisticsQuery = VK_TRUE;
+    bPipelineStatisticsQuery = targetDevice.enable_features_if_present(optionalFeatures);
+
     vkb::DeviceBuilder deviceBuilder{targetDevice};
     deviceBuilder.add_pNext(&descriptorBufferFeatures);
     vkb::Device vkbDevice = deviceBuilder.build().value();
@@ -84,6 +93,21 @@ VulkanContext::VulkanContext(SDL_Window* window, bool useValidationLayers)
     graphicsQueue = vkbDevice.get_queue(vkb::QueueType::graphics).value();
     graphicsQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
 
+    // Prefer a family without graphics support, any other compute family still runs alongside the graphics queue
+    if (auto dedicatedCompute = vkbDevice.get_dedicated_queue(vkb::QueueType::compute); dedicatedCompute.has_value()) {
+        computeQueue = dedicatedCompute.value();
+        computeQueueFamily = vkbDevice.get_dedicated_queue_index(vkb::QueueType::compute).value();
+    }
+    else if (auto separateCompute = vkbDevice.get_queue(vkb::QueueType::compute); separateCompute.has_value()) {
+        computeQueue = separateCompute.value();
+        computeQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::compute).value();
+    }
+    else {
+        computeQueue = graphicsQueue;
+        computeQueueFamily = graphicsQueueFamily;
+    }
+    sharedQueueFamilies = {graphicsQueueFamily, computeQueueFamily};
+
     VmaAllocatorCreateInfo allocatorInfo = {};
     allocatorInfo.physicalDevice = physicalDevice;
     allocatorInfo.device = device;
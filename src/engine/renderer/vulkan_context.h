@@ -5,6 +5,8 @@
 #ifndef VULKAN_CONTEXT_H
 #define VULKAN_CONTEXT_H
 
+#include <array>
+
 #include <SDL.h>
 #include <vulkan/vulkan_core.h>
 #include <vma/vk_mem_alloc.h>
@@ -14,6 +16,9 @@ namespace will_engine::renderer
 class VulkanContext
 {
 public:
+    /**
+     * @param window if null, the context is headless and has no surface or swapchain support
+     */
     VulkanContext(SDL_Window* window, bool useValidationLayers);
 
     ~VulkanContext();
@@ -29,10 +34,25 @@ public:
     VkDevice device{};
     VkQueue graphicsQueue{};
     uint32_t graphicsQueueFamily{};
+    /**
+     * Same as the graphics queue unless the device has a separate compute capable queue family, see \code hasAsyncComputeQueue\endcode
+     */
+    VkQueue computeQueue{};
+    uint32_t computeQueueFamily{};
+    /**
+     * Graphics and compute family, for resources shared concurrently between the two queues
+     */
+    std::array<uint32_t, 2> sharedQueueFamilies{};
     VmaAllocator allocator{};
     VkDebugUtilsMessengerEXT debugMessenger{};
 
     VkPhysicalDeviceDescriptorBufferPropertiesEXT deviceDescriptorBufferProperties{};
+
+    bool bPipelineStatisticsQuery{false};
+
+    [[nodiscard]] bool isHeadless() const { return surface == VK_NULL_HANDLE; }
+
+    [[nodiscard]] bool hasAsyncComputeQueue() const { return computeQueueFamily != graphicsQueueFamily; }
 };
 }
 
@@ -12,6 +12,7 @@
 namespace will_engine::file
 {
 static const std::filesystem::path imagesSavePath = std::filesystem::current_path() / "assets" / "images";
+static const std::filesystem::path profilingSavePath = std::filesystem::current_path() / "assets" / "profiling";
 
 static bool getOrCreateDirectory(const std::filesystem::path& path)
 {
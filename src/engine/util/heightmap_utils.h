@@ -5,11 +5,13 @@
 #ifndef HEIGHTMAP_UTILS_H
 #define HEIGHTMAP_UTILS_H
 
+#include <algorithm>
 #include <random>
 
 #include <glm/glm.hpp>
 #include <FastNoiseLite.h>
 
+#include "noise_utils.h"
 #include "engine/renderer/resource_manager.h"
 
 namespace will_engine
@@ -28,59 +30,148 @@ struct NoiseSettings
 class HeightmapUtil
 {
 public:
+    /**
+     * FBM over FastNoiseLite Perlin, normalized to \code [0, heightScale]\endcode by the min/max of the map.
+     * \n Rows are generated in parallel and the Perlin noise is vectorized (see \code noise_utils\endcode), the result only depends on the arguments.
+     * @param width
+     * @param height
+     * @param seed
+     * @param settings
+     * @return
+     */
     static std::vector<float> generateFromNoise(const uint32_t width, const uint32_t height, const uint32_t seed, const NoiseSettings& settings = NoiseSettings{})
     {
         std::vector<float> heightData(width * height);
-        std::vector<glm::vec2> octaveOffsets(settings.octaves);
-        std::mt19937 rng(seed);
-        std::uniform_real_distribution dist(-100000.0f, 100000.0f);
-
-        for (int i = 0; i < settings.octaves; i++) {
-            const float offsetX = dist(rng) + settings.offset.x;
-            const float offsetY = dist(rng) + settings.offset.y;
-            octaveOffsets[i] = glm::vec2(offsetX, offsetY);
-        }
-
-        float maxHeight = std::numeric_limits<float>::lowest();
-        float minHeight = std::numeric_limits<float>::max();
-
-        FastNoiseLite noise;
-        noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-        noise.SetSeed(seed);
-        noise.SetFrequency(1.0f);
+        const std::vector<glm::vec2> octaveOffsets = generateOctaveOffsets(seed, settings);
 
         const float halfWidth = width / 2.0f;
         const float halfHeight = height / 2.0f;
         const float invScale = 1.0f / settings.scale;
 
-        for (uint32_t y = 0; y < height; y++) {
-            for (uint32_t x = 0; x < width; x++) {
+        // Reduced per row so the result doesn't depend on how rows were split between threads
+        std::vector<float> rowMinHeights(height, std::numeric_limits<float>::max());
+        std::vector<float> rowMaxHeights(height, std::numeric_limits<float>::lowest());
+
+        noise_utils::parallelForRows(height, width, [&](const uint32_t rowBegin, const uint32_t rowEnd) {
+            std::vector<float> sampleX(width);
+            std::vector<float> octaveNoise(width);
+
+            for (uint32_t y = rowBegin; y < rowEnd; y++) {
+                float* row = &heightData[y * width];
                 float amplitude = 1.0f;
                 float frequency = 1.0f;
-                float noiseHeight = 0.0f;
 
                 // Accumulate noise from each octave
                 for (int i = 0; i < settings.octaves; i++) {
-                    const float sampleX = (x - halfWidth) * invScale * frequency + octaveOffsets[i].x;
-                    const float sampleY = (y - halfHeight) * invScale * frequency + octaveOffsets[i].y;
+                    for (uint32_t x = 0; x < width; x++) {
+                        sampleX[x] = (static_cast<float>(x) - halfWidth) * invScale * frequency + octaveOffsets[i].x;
+                    }
+                    const float sampleY = (static_cast<float>(y) - halfHeight) * invScale * frequency + octaveOffsets[i].y;
 
-                    const float perlinValue = noise.GetNoise(sampleX, sampleY);
-                    noiseHeight += perlinValue * amplitude;
+                    noise_utils::perlinNoiseRow(static_cast<int32_t>(seed), sampleX.data(), sampleY, width, octaveNoise.data());
+                    for (uint32_t x = 0; x < width; x++) {
+                        row[x] += octaveNoise[x] * amplitude;
+                    }
 
                     amplitude *= settings.persistence;
                     frequency *= settings.lacunarity;
                 }
 
-                heightData[y * width + x] = noiseHeight;
-
-                maxHeight = std::max(maxHeight, noiseHeight);
-                minHeight = std::min(minHeight, noiseHeight);
+                const auto [minHeight, maxHeight] = std::minmax_element(row, row + width);
+                rowMinHeights[y] = *minHeight;
+                rowMaxHeights[y] = *maxHeight;
             }
-        }
+        });
 
+        const float minHeight = *std::ranges::min_element(rowMinHeights);
+        const float maxHeight = *std::ranges::max_element(rowMaxHeights);
+
+        // A flat map (e.g. no octaves) has no range to normalize by, it stays at 0
+        const float heightRange = maxHeight - minHeight;
         for (uint32_t i = 0; i < width * height; i++) {
-            heightData[i] = ((heightData[i] - minHeight) / (maxHeight - minHeight)) * settings.heightScale;
+            heightData[i] = heightRange > 0.0f ? ((heightData[i] - minHeight) / heightRange) * settings.heightScale : 0.0f;
+        }
+
+        return heightData;
+    }
+
+    /**
+     * Random per-octave sample offsets of \code generateFromNoise\endcode and \code generateTileFromNoise\endcode, also uploaded by \code TerrainGenerator\endcode
+     */
+    static std::vector<glm::vec2> generateOctaveOffsets(const uint32_t seed, const NoiseSettings& settings)
+    {
+        std::vector<glm::vec2> octaveOffsets(glm::max(settings.octaves, 0));
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution dist(-100000.0f, 100000.0f);
+
+        for (glm::vec2& octaveOffset : octaveOffsets) {
+            const float offsetX = dist(rng) + settings.offset.x;
+            const float offsetY = dist(rng) + settings.offset.y;
+            octaveOffset = glm::vec2(offsetX, offsetY);
+        }
+
+        return octaveOffsets;
+    }
+
+    /**
+     * Samples the same fractal noise as \code generateFromNoise\endcode, but at world space positions so neighbouring tiles line up.
+     * \n Heights are normalized by the total octave amplitude instead of the min/max of the map, which would differ between tiles.
+     * @param width
+     * @param height
+     * @param seed
+     * @param settings
+     * @param origin world XZ of the first sample
+     * @param sampleSpacing world distance between samples
+     * @return
+     */
+    static std::vector<float> generateTileFromNoise(const uint32_t width, const uint32_t height, const uint32_t seed, const NoiseSettings& settings, const glm::vec2 origin,
+                                                    const float sampleSpacing)
+    {
+        std::vector<float> heightData(width * height);
+        const std::vector<glm::vec2> octaveOffsets = generateOctaveOffsets(seed, settings);
+
+        float amplitudeSum = 0.0f;
+        float amplitude = 1.0f;
+        for (int i = 0; i < settings.octaves; i++) {
+            amplitudeSum += amplitude;
+            amplitude *= settings.persistence;
         }
+        const float invAmplitudeSum = amplitudeSum > 0.0f ? 1.0f / amplitudeSum : 0.0f;
+
+        const float invScale = 1.0f / settings.scale;
+
+        noise_utils::parallelForRows(height, width, [&](const uint32_t rowBegin, const uint32_t rowEnd) {
+            std::vector<float> sampleX(width);
+            std::vector<float> octaveNoise(width);
+
+            for (uint32_t y = rowBegin; y < rowEnd; y++) {
+                float* row = &heightData[y * width];
+                const float worldY = origin.y + static_cast<float>(y) * sampleSpacing;
+
+                float octaveAmplitude = 1.0f;
+                float frequency = 1.0f;
+
+                for (int i = 0; i < settings.octaves; i++) {
+                    for (uint32_t x = 0; x < width; x++) {
+                        const float worldX = origin.x + static_cast<float>(x) * sampleSpacing;
+                        sampleX[x] = worldX * invScale * frequency + octaveOffsets[i].x;
+                    }
+                    const float sampleY = worldY * invScale * frequency + octaveOffsets[i].y;
+
+                    noise_utils::perlinNoiseRow(static_cast<int32_t>(seed), sampleX.data(), sampleY, width, octaveNoise.data());
+                    for (uint32_t x = 0; x < width; x++) {
+                        row[x] += octaveNoise[x] * octaveAmplitude;
+                    }
+
+                    octaveAmplitude *= settings.persistence;
+                    frequency *= settings.lacunarity;
+                }
+
+                for (uint32_t x = 0; x < width; x++) {
+                    row[x] = (row[x] * invAmplitudeSum * 0.5f + 0.5f) * settings.heightScale;
+                }
+            }
+        });
 
         return heightData;
     }
@@ -89,22 +180,25 @@ public:
     {
         std::vector<float> noiseData(width * height);
 
-        FastNoiseLite noise;
-        noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-        noise.SetSeed(seed);
-        noise.SetFrequency(1.0f);
-
         const float invScale = 1.0f / scale;
 
-        for (uint32_t y = 0; y < height; y++) {
+        noise_utils::parallelForRows(height, width, [&](const uint32_t rowBegin, const uint32_t rowEnd) {
+            std::vector<float> sampleX(width);
             for (uint32_t x = 0; x < width; x++) {
-                noiseData[y * width + x] = noise.GetNoise(x * invScale, y * invScale);
+                sampleX[x] = static_cast<float>(x) * invScale;
             }
-        }
+
+            for (uint32_t y = rowBegin; y < rowEnd; y++) {
+                noise_utils::perlinNoiseRow(static_cast<int32_t>(seed), sampleX.data(), static_cast<float>(y) * invScale, width, &noiseData[y * width]);
+            }
+        });
 
         return noiseData;
     }
 
+    /**
+     * OpenSimplex2S is not vectorized, only split across threads
+     */
     static std::vector<float> generateRawSimplexNoise(const uint32_t width, const uint32_t height, const uint32_t seed = 123456u, const float scale = 50.0f)
     {
         std::vector<float> noiseData(width * height);
@@ -116,11 +210,13 @@ public:
 
         const float invScale = 1.0f / scale;
 
-        for (uint32_t y = 0; y < height; y++) {
-            for (uint32_t x = 0; x < width; x++) {
-                noiseData[y * width + x] = noise.GetNoise(x * invScale, y * invScale);
+        noise_utils::parallelForRows(height, width, [&](const uint32_t rowBegin, const uint32_t rowEnd) {
+            for (uint32_t y = rowBegin; y < rowEnd; y++) {
+                for (uint32_t x = 0; x < width; x++) {
+                    noiseData[y * width + x] = noise.GetNoise(x * invScale, y * invScale);
+                }
             }
-        }
+        });
 
         return noiseData;
     }
@@ -0,0 +1,317 @@
+//
+// Created by William on 2025-07-03.
+//
+
+#include "noise_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <FastNoiseLite.h>
+
+#include "engine/core/profiler/trace_profiler.h"
+
+#if defined(__SSE4_1__) || defined(JPH_USE_SSE4_1)
+#define WILL_ENGINE_NOISE_SSE 1
+#include <smmintrin.h>
+#endif
+
+namespace will_engine::noise_utils
+{
+#if WILL_ENGINE_NOISE_SSE
+namespace
+{
+constexpr int32_t PRIME_X = 501125321;
+constexpr int32_t PRIME_Y = 1136930381;
+constexpr int32_t HASH_MULTIPLIER = 0x27d4eb2d;
+
+/**
+ * FastNoiseLite's Gradients2D (private to FastNoiseLite), the 24 gradients repeated 5 times followed by 8 more. Interleaved x, y.
+ */
+constexpr std::array<float, 256> makeGradients()
+{
+    constexpr std::array<float, 48> gradients{
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f,
+        0.608761429008721f, 0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f,
+        0.923879532511287f, -0.38268343236509f, 0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f,
+        -0.923879532511287f, 0.130526192220052f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f, -0.923879532511287f, -0.38268343236509f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f, -0.793353340291235f, 0.608761429008721f,
+        -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    };
+    constexpr std::array<float, 16> tail{
+        0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f,
+        -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f,
+        -0.38268343236509f, 0.923879532511287f,
+    };
+
+    std::array<float, 256> result{};
+    for (size_t i = 0; i < 240; ++i) {
+        result[i] = gradients[i % gradients.size()];
+    }
+    for (size_t i = 0; i < tail.size(); ++i) {
+        result[240 + i] = tail[i];
+    }
+    return result;
+}
+
+constexpr std::array<float, 256> GRADIENTS_2D = makeGradients();
+
+int32_t fastFloor(const float f)
+{
+    return f >= 0 ? static_cast<int32_t>(f) : static_cast<int32_t>(f) - 1;
+}
+
+float interpQuintic(const float t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+__m128i fastFloor(const __m128 f)
+{
+    // Truncate, then subtract 1 for negative values (the comparison mask is -1)
+    const __m128i negativeMask = _mm_castps_si128(_mm_cmplt_ps(f, _mm_setzero_ps()));
+    return _mm_add_epi32(_mm_cvttps_epi32(f), negativeMask);
+}
+
+__m128 interpQuintic(const __m128 t)
+{
+    const __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    const __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(t3, inner);
+}
+
+__m128 lerp(const __m128 a, const __m128 b, const __m128 t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+__m128 gradCoord(const __m128i seed, const __m128i xPrimed, const __m128i yPrimed, const __m128 xd, const __m128 yd)
+{
+    __m128i hash = _mm_xor_si128(_mm_xor_si128(seed, xPrimed), yPrimed);
+    hash = _mm_mullo_epi32(hash, _mm_set1_epi32(HASH_MULTIPLIER));
+    hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+    hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+    // No gather in SSE, the table is small enough to stay in L1
+    alignas(16) int32_t indices[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices), hash);
+    const __m128 xg = _mm_setr_ps(GRADIENTS_2D[indices[0]], GRADIENTS_2D[indices[1]], GRADIENTS_2D[indices[2]], GRADIENTS_2D[indices[3]]);
+    const __m128 yg = _mm_setr_ps(GRADIENTS_2D[indices[0] | 1], GRADIENTS_2D[indices[1] | 1], GRADIENTS_2D[indices[2] | 1], GRADIENTS_2D[indices[3] | 1]);
+
+    return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+}
+
+/**
+ * Mirrors FastNoiseLite::SinglePerlin operation for operation so results stay bit-identical
+ */
+__m128 perlinNoise4(const __m128i seed, const __m128 x, const __m128i y0Primed, const __m128i y1Primed, const __m128 yd0, const __m128 yd1, const __m128 ys)
+{
+    const __m128i x0 = fastFloor(x);
+    const __m128 xd0 = _mm_sub_ps(x, _mm_cvtepi32_ps(x0));
+    const __m128 xd1 = _mm_sub_ps(xd0, _mm_set1_ps(1.0f));
+    const __m128 xs = interpQuintic(xd0);
+
+    const __m128i x0Primed = _mm_mullo_epi32(x0, _mm_set1_epi32(PRIME_X));
+    const __m128i x1Primed = _mm_add_epi32(x0Primed, _mm_set1_epi32(PRIME_X));
+
+    const __m128 xf0 = lerp(gradCoord(seed, x0Primed, y0Primed, xd0, yd0), gradCoord(seed, x1Primed, y0Primed, xd1, yd0), xs);
+    const __m128 xf1 = lerp(gradCoord(seed, x0Primed, y1Primed, xd0, yd1), gradCoord(seed, x1Primed, y1Primed, xd1, yd1), xs);
+
+    return _mm_mul_ps(lerp(xf0, xf1, ys), _mm_set1_ps(1.4247691104677813f));
+}
+}
+#endif
+
+void perlinNoiseRow(const int32_t seed, const float* sampleX, const float sampleY, const uint32_t count, float* outNoise)
+{
+#if WILL_ENGINE_NOISE_SSE
+    // Everything that only depends on y is shared by the whole row. Primes are multiplied unsigned, signed overflow is UB in C++ (not in SSE)
+    const int32_t y0 = fastFloor(sampleY);
+    const float yd0 = sampleY - static_cast<float>(y0);
+    const uint32_t y0Primed = static_cast<uint32_t>(y0) * static_cast<uint32_t>(PRIME_Y);
+    const uint32_t y1Primed = y0Primed + static_cast<uint32_t>(PRIME_Y);
+
+    const __m128i seedV = _mm_set1_epi32(seed);
+    const __m128i y0PrimedV = _mm_set1_epi32(static_cast<int32_t>(y0Primed));
+    const __m128i y1PrimedV = _mm_set1_epi32(static_cast<int32_t>(y1Primed));
+    const __m128 yd0V = _mm_set1_ps(yd0);
+    const __m128 yd1V = _mm_set1_ps(yd0 - 1);
+    const __m128 ysV = _mm_set1_ps(interpQuintic(yd0));
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_loadu_ps(sampleX + i);
+        _mm_storeu_ps(outNoise + i, perlinNoise4(seedV, x, y0PrimedV, y1PrimedV, yd0V, yd1V, ysV));
+    }
+
+    // Tail goes through the same vector path so every sample is computed the same way
+    if (i < count) {
+        alignas(16) float tailX[4]{};
+        alignas(16) float tailNoise[4];
+        std::copy(sampleX + i, sampleX + count, tailX);
+        _mm_store_ps(tailNoise, perlinNoise4(seedV, _mm_load_ps(tailX), y0PrimedV, y1PrimedV, yd0V, yd1V, ysV));
+        std::copy_n(tailNoise, count - i, outNoise + i);
+    }
+#else
+    FastNoiseLite noise;
+    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    noise.SetSeed(seed);
+    noise.SetFrequency(1.0f);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        outNoise[i] = noise.GetNoise(sampleX[i], sampleY);
+    }
+#endif
+}
+
+namespace
+{
+/**
+ * Workers for \code parallelForRows\endcode, started on first use and kept alive until exit. Runs one job at a time.
+ */
+class RowWorkerPool
+{
+public:
+    static RowWorkerPool& get()
+    {
+        static RowWorkerPool pool;
+        return pool;
+    }
+
+    [[nodiscard]] uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+    /**
+     * Runs every tile on the workers and the calling thread, blocks until all are done.
+     * @return false without running anything if another thread is using the pool
+     */
+    bool tryRun(const uint32_t tileCount, const std::function<void(uint32_t tile)>& runTile)
+    {
+        std::unique_lock dispatchLock(dispatchMutex, std::try_to_lock);
+        if (!dispatchLock.owns_lock()) { return false; }
+
+        {
+            std::lock_guard lock(jobMutex);
+            job = &runTile;
+            jobTileCount = tileCount;
+            nextTile.store(0, std::memory_order_relaxed);
+            ++jobGeneration;
+        }
+        jobCondition.notify_all();
+
+        runTiles(runTile, tileCount);
+
+        std::unique_lock lock(jobMutex);
+        doneCondition.wait(lock, [this] { return activeWorkerCount == 0; });
+        // Workers that wake after this see no job, so none can reach runTile once it goes out of scope
+        job = nullptr;
+        return true;
+    }
+
+    RowWorkerPool(const RowWorkerPool&) = delete;
+
+    RowWorkerPool& operator=(const RowWorkerPool&) = delete;
+
+private:
+    RowWorkerPool()
+    {
+        const uint32_t workerCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+        workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back([this](const std::stop_token& stopToken) { workerLoop(stopToken); });
+        }
+    }
+
+    ~RowWorkerPool()
+    {
+        for (std::jthread& worker : workers) {
+            worker.request_stop();
+        }
+        jobCondition.notify_all();
+        workers.clear();
+    }
+
+    void runTiles(const std::function<void(uint32_t tile)>& runTile, const uint32_t tileCount)
+    {
+        for (uint32_t tile = nextTile.fetch_add(1); tile < tileCount; tile = nextTile.fetch_add(1)) {
+            runTile(tile);
+        }
+    }
+
+    void workerLoop(const std::stop_token& stopToken)
+    {
+        WILL_PROFILE_THREAD("Noise Worker");
+        uint32_t seenGeneration = 0;
+        while (!stopToken.stop_requested()) {
+            const std::function<void(uint32_t tile)>* runTile;
+            uint32_t tileCount;
+            {
+                std::unique_lock lock(jobMutex);
+                if (!jobCondition.wait(lock, stopToken, [this, seenGeneration] { return jobGeneration != seenGeneration; })) {
+                    return;
+                }
+                seenGeneration = jobGeneration;
+                if (job == nullptr) { continue; }
+                runTile = job;
+                tileCount = jobTileCount;
+                ++activeWorkerCount;
+            }
+
+            runTiles(*runTile, tileCount);
+
+            {
+                std::lock_guard lock(jobMutex);
+                --activeWorkerCount;
+            }
+            doneCondition.notify_one();
+        }
+    }
+
+    /**
+     * Held by the thread running a job for its whole duration
+     */
+    std::mutex dispatchMutex;
+    std::mutex jobMutex;
+    std::condition_variable_any jobCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(uint32_t tile)>* job{nullptr};
+    uint32_t jobTileCount{0};
+    uint32_t jobGeneration{0};
+    uint32_t activeWorkerCount{0};
+    std::atomic<uint32_t> nextTile{0};
+
+    std::vector<std::jthread> workers;
+};
+}
+
+void parallelForRows(const uint32_t rowCount, const uint32_t rowWidth, const std::function<void(uint32_t rowBegin, uint32_t rowEnd)>& function)
+{
+    constexpr uint32_t ROWS_PER_TILE = 16;
+    // Below this, waking the workers costs more than it saves (e.g. streamed terrain tiles, which are already generated on worker threads)
+    constexpr size_t MIN_PARALLEL_SAMPLES = 128 * 128 * 4;
+
+    if (rowCount == 0) { return; }
+
+    const uint32_t tileCount = (rowCount + ROWS_PER_TILE - 1) / ROWS_PER_TILE;
+
+    if (tileCount <= 1 || static_cast<size_t>(rowCount) * rowWidth < MIN_PARALLEL_SAMPLES) {
+        function(0, rowCount);
+        return;
+    }
+
+    const auto runTile = [&](const uint32_t tile) {
+        const uint32_t rowBegin = tile * ROWS_PER_TILE;
+        function(rowBegin, std::min(rowBegin + ROWS_PER_TILE, rowCount));
+    };
+
+    RowWorkerPool& pool = RowWorkerPool::get();
+    if (pool.getWorkerCount() == 0 || !pool.tryRun(tileCount, runTile)) {
+        function(0, rowCount);
+    }
+}
+}
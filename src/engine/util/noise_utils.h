@@ -5,9 +5,32 @@
 #ifndef NOISE_UTILS_H
 #define NOISE_UTILS_H
 
+#include <cstdint>
+#include <functional>
+
 namespace will_engine::noise_utils
 {
+/**
+ * Evaluates FastNoiseLite's 2D Perlin noise (frequency 1, no fractal) for a row of samples that share a y coordinate.
+ * \n Uses SSE4.1 when available, 4 samples at a time. Results don't depend on \code count\endcode or where the row starts, and match
+ * \code FastNoiseLite::GetNoise\endcode bit for bit unless the compiler is allowed to fuse multiply-adds (e.g. -mfma with GCC).
+ * @param seed
+ * @param sampleX \code count\endcode x coordinates
+ * @param sampleY
+ * @param count
+ * @param outNoise \code count\endcode results
+ */
+void perlinNoiseRow(int32_t seed, const float* sampleX, float sampleY, uint32_t count, float* outNoise);
 
+/**
+ * Splits \code [0, rowCount)\endcode into tiles of rows and runs them on a persistent worker pool, the calling thread helps. Blocks until all rows are done.
+ * Small maps run inline on the calling thread, e.g. when already called from the terrain streaming workers, as does a call made while another thread is using the pool.
+ * \n Each row must only depend on its own inputs so results don't depend on how rows were scheduled.
+ * @param rowCount
+ * @param rowWidth samples per row, used to decide whether threading is worth it
+ * @param function called with the \code [begin, end)\endcode rows of each tile, possibly concurrently
+ */
+void parallelForRows(uint32_t rowCount, uint32_t rowWidth, const std::function<void(uint32_t rowBegin, uint32_t rowEnd)>& function);
 }
 
 #endif //NOISE_UTILS_H
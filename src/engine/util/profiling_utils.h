@@ -4,7 +4,9 @@
 
 #ifndef PROFILING_UTILS_H
 #define PROFILING_UTILS_H
+#include <algorithm>
 #include <chrono>
+#include <vector>
 
 struct ProfilingData
 {
@@ -15,15 +17,37 @@ struct ProfilingData
     void begin()
     {
         start = std::chrono::steady_clock::now();
+        bRunning = true;
     }
 
+    /**
+     * Does nothing if the timer was not begun or was cancelled
+     */
     void end()
     {
+        if (!bRunning) { return; }
+        bRunning = false;
         const auto now = std::chrono::steady_clock::now();
         const float elapsedTime = static_cast<float>(
                                       std::chrono::duration_cast<std::chrono::microseconds>(now - start).count()
                                   ) / 1000.0f;
 
+        addSample(elapsedTime);
+    }
+
+    /**
+     * Drops the running measurement, e.g. when the frame it measures is abandoned
+     */
+    void cancel()
+    {
+        bRunning = false;
+    }
+
+    /**
+     * Adds a time measured elsewhere (e.g. on the GPU), in milliseconds
+     */
+    void addSample(const float elapsedTime)
+    {
         const float alpha = sampleCount / INITIAL_SAMPLE_COUNT;
         accumulatedTime = accumulatedTime * (1 - alpha) + elapsedTime * alpha;
         if (sampleCount > FINAL_SAMPLE_COUNT) {
@@ -37,6 +61,44 @@ private:
     float accumulatedTime{0.0f};
     std::chrono::steady_clock::time_point start{};
     int32_t sampleCount{INITIAL_SAMPLE_COUNT_INT};
+    bool bRunning{false};
+};
+
+/**
+ * Summary of a series of timings, in milliseconds
+ */
+struct TimingStatistics
+{
+    double mean{0.0};
+    double p50{0.0};
+    double p90{0.0};
+    double p99{0.0};
+    double max{0.0};
+
+    static TimingStatistics compute(std::vector<double> times)
+    {
+        TimingStatistics statistics{};
+        if (times.empty()) { return statistics; }
+
+        std::ranges::sort(times);
+        double total = 0.0;
+        for (const double time : times) {
+            total += time;
+        }
+        statistics.mean = total / static_cast<double>(times.size());
+        statistics.p50 = percentile(times, 0.50);
+        statistics.p90 = percentile(times, 0.90);
+        statistics.p99 = percentile(times, 0.99);
+        statistics.max = times.back();
+        return statistics;
+    }
+
+private:
+    static double percentile(const std::vector<double>& sortedTimes, const double fraction)
+    {
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(sortedTimes.size() - 1) + 0.5);
+        return sortedTimes[std::min(index, sortedTimes.size() - 1)];
+    }
 };
 
 #endif //PROFILING_UTILS_H